@@ -29,6 +29,6 @@ if(LIBCLANG_LIBRARIES AND LIBCLANG_INCLUDE_PATH)
 	message(STATUS "Using clang headers: ${LIBCLANG_INCLUDE_PATH}")
 	set(VC4C_ENABLE_LIBCLANG ON)
 else()
-	message(WARNING "Clang library precompilation enabled, but no clang libraries were found")
+	message(STATUS "No clang libraries found, falling back to running the clang executable for precompilation")
 	set(VC4C_ENABLE_LIBCLANG OFF)
 endif()
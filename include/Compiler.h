@@ -11,9 +11,13 @@
 
 #include "config.h"
 
+#include <exception>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <vector>
 
 namespace vc4c
 {
@@ -36,12 +40,33 @@ namespace vc4c
     // Declared in Precompiler.h
     class CompilationData;
 
+    /*
+     * A single input of a batch compilation, see Compiler#compileAll()
+     */
+    struct BatchCompilationInput
+    {
+        // Points to the input data, which needs to stay valid until the compilation of this input is finished
+        const CompilationData* input;
+        Configuration config;
+        std::string options;
+        std::string outputFile;
+    };
+
     /*
      * Base class for the compilation process
      */
     class Compiler
     {
     public:
+        using Result = std::pair<CompilationData, std::size_t>;
+        /*
+         * Callback invoked for every finished input of a batch compilation with the index of the input and either the
+         * compilation result or the error thrown.
+         *
+         * NOTE: The callback is called on the worker thread which compiled the input and must not throw.
+         */
+        using BatchCallback = std::function<void(std::size_t, const Result*, std::exception_ptr)>;
+
         /**
          * Helper-function to easily compile a single input with the given configuration into the given output.
          *
@@ -53,6 +78,21 @@ namespace vc4c
          */
         static std::pair<CompilationData, std::size_t> compile(const CompilationData& input,
             const Configuration& config = {}, const std::string& options = "", const std::string& outputFile = "");
+
+        /**
+         * Compiles all the given inputs concurrently.
+         *
+         * The inputs are compiled on a worker pool shared by all batch compilations of the process. All process-wide
+         * state (e.g. the in-process front-end, the VC4CL standard-library module and the pre-compiled headers) is
+         * shared between the inputs.
+         *
+         * \param inputs The inputs with their per-input configuration, compiler-options and output file
+         * \param callback Optional callback to be invoked as soon as the compilation of any single input finished
+         * \return the futures for the results of the inputs, in the same order as the inputs. The futures re-throw
+         * any error occurred while compiling the associated input.
+         */
+        static std::vector<std::future<Result>> compileAll(
+            const std::vector<BatchCompilationInput>& inputs, const BatchCallback& callback = {});
     };
 
     /*
@@ -136,6 +136,15 @@ namespace vc4c
         {
         }
 
+        /**
+         * References the given raw data without copying it. The buffer is owned by the caller and needs to stay valid
+         * (and unmodified) as long as this object (or any copy of it) is used.
+         *
+         * NOTE: If the type is not given, parts of the buffer are copied to determine the type.
+         */
+        explicit CompilationData(const uint8_t* rawData, std::size_t numBytes, SourceType type = SourceType::UNKNOWN,
+            const std::string& name = "");
+
         explicit CompilationData(std::shared_ptr<CompilationDataPrivate>&& data);
 
         SourceType getType() const noexcept;
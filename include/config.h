@@ -206,6 +206,11 @@ namespace vc4c
          * Whether to stop compilation when instruction verification failed
          */
         bool stopWhenVerificationFailed = true;
+        /*
+         * The path of the file to write the mapping of the generated machine code to the basic blocks and loops of the
+         * kernels into, e.g. to aggregate the emulator profile by these. The mapping is not written if empty.
+         */
+        std::string profileMappingFile;
     };
 
     /*
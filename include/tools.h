@@ -36,6 +36,36 @@ namespace vc4c
             std::array<uint32_t, 3> globalOffsets = {{0, 0, 0}};
         };
 
+        /*
+         * A memory area of the host (e.g. a memory-mapped file) which can be directly accessed by the emulated kernel
+         */
+        struct HostBuffer
+        {
+            uint8_t* data;
+            std::size_t size;
+        };
+
+        /*
+         * The host-side setup of an image parameter, see EmulationData#images
+         */
+        struct ImageSetup
+        {
+            /*
+             * The offset in words of the image-configuration of the image parameter in the global data
+             */
+            uint32_t configurationOffset;
+            /*
+             * The TMU texture type of the texels, see Broadcom specification, table 16
+             */
+            uint8_t textureType;
+            uint16_t width;
+            uint16_t height;
+            /*
+             * The OpenCL channel order of the image (e.g. CL_RGBA), zero if not set
+             */
+            uint16_t channelOrder = 0;
+        };
+
         /*
          * Data container for all configuration required to emulate a kernel-execution
          */
@@ -65,7 +95,7 @@ namespace vc4c
             /*
              * The maximum number of cycles to execute before terminating the emulation
              */
-            uint32_t maxEmulationCycles = std::numeric_limits<uint32_t>::max();
+            uint64_t maxEmulationCycles = std::numeric_limits<uint64_t>::max();
             /*
              * The path to dump the contents of the memory into
              */
@@ -74,6 +104,72 @@ namespace vc4c
              * The path to dump the results of the instrumentation
              */
             std::string instrumentationDump;
+            /*
+             * Whether to translate the kernel code ahead-of-time into host code.
+             *
+             * Translated instructions bypass the instruction cache and are executed without any periphery timing, so
+             * this gives a functional (not cycle-accurate) emulation. Instructions accessing periphery are still
+             * executed by the interpreter.
+             */
+            bool translateCode = false;
+            /*
+             * Host memory areas used as buffer for the parameter with the given index without any copying, e.g. for
+             * large inputs read from memory-mapped files.
+             *
+             * The kernel reads and writes the host memory directly, so the corresponding entries in #parameter are
+             * ignored and no result data is copied into the EmulationResult for these parameters.
+             */
+            std::map<std::size_t, HostBuffer> hostBuffers;
+            /*
+             * The setup of the image parameters with the given index. The texels are given as buffer in #parameter,
+             * which is placed at an address aligned to the texture base address.
+             *
+             * As done by the host on setting an image as kernel parameter, the image-configuration incl. the texture
+             * setups for all combinations of addressing and filter mode is written into the global data.
+             */
+            std::map<std::size_t, ImageSetup> images;
+            /*
+             * The path of the file to periodically write a snapshot of the complete emulation state into. Only the
+             * last snapshot is kept.
+             *
+             * Snapshots are only written if a #snapshotInterval is set and only in cycles without any pending memory
+             * access, SFU calculation or branch, so the actual distance between two snapshots might be larger.
+             */
+            std::string snapshotFile;
+            /*
+             * The minimum number of cycles between two snapshots, see #snapshotFile
+             */
+            uint32_t snapshotInterval = 0;
+            /*
+             * The path of a snapshot to resume the emulation from.
+             *
+             * The snapshot needs to be written by an emulation of the same kernel code with the same memory layout,
+             * i.e. with the same module, kernel, parameter sizes and work-group configuration.
+             */
+            std::string restoreSnapshot;
+            /*
+             * The path of the file to stream the binary execution trace into (e.g. executed instructions, stall reasons
+             * and periphery accesses per QPU and cycle), no trace is written if empty.
+             *
+             * The trace can be converted to the Chrome trace / Perfetto JSON format with the qpu_trace_converter tool.
+             */
+            std::string traceFile;
+            /*
+             * The path of the mapping of the machine code to basic blocks and loops written by the compiler (see
+             * Configuration#profileMappingFile), used to aggregate the instrumentation results for the profile reports
+             * below.
+             */
+            std::string profileMapping;
+            /*
+             * The path to write the report of the hot-spots (cycles, stalls and ALU utilization per basic block and
+             * loop) into, requires a #profileMapping
+             */
+            std::string profileReport;
+            /*
+             * The path to write the cycles per basic block in the folded stack format for flame graphs into, requires a
+             * #profileMapping
+             */
+            std::string profileFoldedStacks;
 
             std::size_t calcParameterSize() const;
             uint32_t calcNumWorkItems() const;
@@ -116,15 +212,35 @@ namespace vc4c
             /*
              * The maximum number of cycles to execute before terminating the emulation
              */
-            uint32_t maxEmulationCycles = std::numeric_limits<uint32_t>::max();
+            uint64_t maxEmulationCycles = std::numeric_limits<uint64_t>::max();
             /*
              * The path to dump the results of the instrumentation
              */
             std::string instrumentationDump;
+            /*
+             * Whether to translate the kernel code ahead-of-time into host code, see EmulationData#translateCode
+             */
+            bool translateCode = false;
+            /*
+             * The path of the file to periodically write snapshots into, see EmulationData#snapshotFile
+             */
+            std::string snapshotFile;
+            /*
+             * The minimum number of cycles between two snapshots, see EmulationData#snapshotFile
+             */
+            uint32_t snapshotInterval = 0;
+            /*
+             * The path of a snapshot to resume the emulation from, see EmulationData#restoreSnapshot
+             */
+            std::string restoreSnapshot;
+            /*
+             * The path of the file to stream the binary execution trace into, see EmulationData#traceFile
+             */
+            std::string traceFile;
 
             LowLevelEmulationData(const std::map<uint32_t, std::reference_wrapper<std::vector<uint8_t>>>& buffers,
                 uint64_t* startAddress, uint32_t numInstructions, const std::vector<uint32_t>& uniformAddresses,
-                uint32_t maxCycles = std::numeric_limits<uint32_t>::max()) :
+                uint64_t maxCycles = std::numeric_limits<uint64_t>::max()) :
                 buffers(buffers),
                 kernelAddress(startAddress), numInstructions(numInstructions), uniformAddresses(uniformAddresses),
                 maxEmulationCycles(maxCycles)
@@ -165,10 +281,20 @@ namespace vc4c
              * access or periphery)
              */
             unsigned numStalls;
+            /*
+             * Counts the number of executions of this instruction which stalled on acquiring the hardware mutex locked
+             * by another QPU. These stalls are also included in #numStalls.
+             */
+            unsigned numMutexStalls;
             /*
              * Counts the total number, this instruction was executed
              */
             unsigned numExecutions;
+            /*
+             * Counts the number of executions of this instruction via the ahead-of-time translated host code (see
+             * EmulationData#translateCode). These executions are also included in #numExecutions.
+             */
+            unsigned numTranslatedExecutions;
 
             std::string to_string() const;
         };
@@ -196,6 +322,10 @@ namespace vc4c
              * the indices of the instruction in the executed kernel
              */
             std::vector<InstrumentationResult> instrumentation{};
+            /*
+             * The total number of cycles all QPUs spent waiting to acquire the hardware mutex
+             */
+            uint64_t mutexWaitCycles = 0;
         };
 
         /*
@@ -217,6 +347,10 @@ namespace vc4c
              * the indices of the instruction in the executed kernel
              */
             std::vector<InstrumentationResult> instrumentation{};
+            /*
+             * The total number of cycles all QPUs spent waiting to acquire the hardware mutex
+             */
+            uint64_t mutexWaitCycles = 0;
         };
 
         /*
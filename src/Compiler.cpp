@@ -241,6 +241,49 @@ std::pair<CompilationData, std::size_t> Compiler::compile(const CompilationData&
     }
 }
 
+static ThreadPool& getBatchPool()
+{
+    // Shared by all batch compilations to not create and destroy the worker threads for every batch. The tasks of this
+    // pool never schedule further tasks on it, so they cannot block waiting for a task queued behind them.
+    static ThreadPool pool("BatchCompiler");
+    return pool;
+}
+
+std::vector<std::future<Compiler::Result>> Compiler::compileAll(
+    const std::vector<BatchCompilationInput>& inputs, const BatchCallback& callback)
+{
+    PROFILE_COUNTER(vc4c::profiler::COUNTER_GENERAL, "Batch compilation inputs", inputs.size());
+    std::vector<std::future<Result>> results;
+    results.reserve(inputs.size());
+    for(std::size_t i = 0; i < inputs.size(); ++i)
+    {
+        auto promise = std::make_shared<std::promise<Result>>();
+        results.emplace_back(promise->get_future());
+        // the input is copied, since the task might still be running when the list of inputs is destroyed
+        auto task = [i, input{inputs[i]}, callback, promise]() {
+            Result result{};
+            std::exception_ptr error = nullptr;
+            try
+            {
+                result = compile(*input.input, input.config, input.options, input.outputFile);
+            }
+            catch(...)
+            {
+                error = std::current_exception();
+            }
+            if(callback)
+                callback(i, error ? nullptr : &result, error);
+            if(error)
+                promise->set_exception(error);
+            else
+                promise->set_value(std::move(result));
+        };
+        // the future of the task itself is not needed, all results and errors are passed via the promise
+        ignoreReturnValue(getBatchPool().schedule(std::move(task), THREAD_LOGGER.get()));
+    }
+    return results;
+}
+
 LCOV_EXCL_START
 std::unique_ptr<logging::Logger> logging::DEFAULT_LOGGER(
     new logging::ColoredLogger(std::wcout, logging::Level::WARNING));
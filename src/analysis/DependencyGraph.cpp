@@ -421,11 +421,25 @@ static void createSemaphoreDepencies(DependencyGraph& graph, DependencyNode& nod
     }
 }
 
+/*
+ * Texture lookups read the texture setup from the UNIFORMs (Broadcom specification, page 40). Since we cannot
+ * distinguish the triggering write of the s-coordinate from general-memory lookups, treat all TMU coordinate writes as
+ * reading UNIFORMs.
+ */
+static bool readsUniform(const intermediate::IntermediateInstruction& inst)
+{
+    return inst.readsRegister(REG_UNIFORM) || inst.writesRegister(REG_TMU0_COORD_S_U_X) ||
+        inst.writesRegister(REG_TMU0_COORD_T_V_Y) || inst.writesRegister(REG_TMU0_COORD_R_BORDER_COLOR) ||
+        inst.writesRegister(REG_TMU0_COORD_B_LOD_BIAS) || inst.writesRegister(REG_TMU1_COORD_S_U_X) ||
+        inst.writesRegister(REG_TMU1_COORD_T_V_Y) || inst.writesRegister(REG_TMU1_COORD_R_BORDER_COLOR) ||
+        inst.writesRegister(REG_TMU1_COORD_B_LOD_BIAS);
+}
+
 static void createUniformDependencies(DependencyGraph& graph, DependencyNode& node,
     const intermediate::IntermediateInstruction* lastWriteOfUniformAddress,
     const intermediate::IntermediateInstruction* lastReadOfUniform)
 {
-    if(node.key->readsRegister(REG_UNIFORM))
+    if(readsUniform(*node.key))
     {
         if(lastWriteOfUniformAddress != nullptr)
         {
@@ -831,7 +845,7 @@ std::unique_ptr<DependencyGraph> DependencyGraph::createGraph(const BasicBlock&
         }
         if(dynamic_cast<const intermediate::SemaphoreAdjustment*>(inst.get()))
             lastSemaphoreAccess = inst.get();
-        if(inst->readsRegister(REG_UNIFORM))
+        if(readsUniform(*inst))
             lastReadOfUniform = inst.get();
         if(inst->writesRegister(REG_UNIFORM_ADDRESS))
             lastWriteOfUniformAddress = inst.get();
@@ -4,6 +4,9 @@
 #include "../Expression.h"
 #include "../GlobalValues.h"
 #include "../Profiler.h"
+#include "../periphery/VPM.h"
+#include "ControlFlowGraph.h"
+#include "ControlFlowLoop.h"
 #include "log.h"
 
 #include <cmath>
@@ -553,3 +556,149 @@ Optional<IdenticalWorkGroupUniformPartsResult> analysis::checkWorkGroupUniformPa
         return {};
     return IdenticalWorkGroupUniformPartsResult{accessRange, *elementType};
 }
+
+// the minimum number of reads outside of any loop for a read-only memory area to be worth caching in VPM
+static constexpr unsigned MIN_CACHED_READS = 4;
+
+Optional<uint32_t> analysis::determineCacheableReadOnlyElements(Method& method, const Local* baseAddr,
+    const FastMap<TypedInstructionWalker<intermediate::MemoryInstruction>, const Local*>& accessInstructions)
+{
+    auto global = baseAddr->as<Global>();
+    auto pointerType = global ? global->type.getPointerType() : nullptr;
+    auto arrayType = pointerType ? pointerType->elementType.getArrayType() : nullptr;
+    // the whole buffer is loaded with a single element per VPM row, which we only support for 32-bit elements for now
+    if(!global || !global->residesInConstantMemory() || !arrayType || !arrayType->elementType.isScalarType() ||
+        arrayType->elementType.getScalarBitCount() != 32)
+        return {};
+
+    for(const auto& access : accessInstructions)
+    {
+        auto mem = access.first.get();
+        if(!mem || mem->op != intermediate::MemoryOperation::READ || !mem->getNumEntries().hasLiteral(Literal(1u)) ||
+            mem->getDestination().type != arrayType->elementType)
+            return {};
+    }
+
+    bool isHot = accessInstructions.size() >= MIN_CACHED_READS;
+    if(!isHot)
+    {
+        auto loops = method.getCFG().findLoops(false);
+        isHot = std::any_of(accessInstructions.begin(), accessInstructions.end(), [&](const auto& access) -> bool {
+            return std::any_of(loops.begin(), loops.end(), [&](const ControlFlowLoop& loop) -> bool {
+                return loop.findInLoop(access.first.base()) != nullptr;
+            });
+        });
+    }
+    if(!isHot)
+        return {};
+
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Constant buffer " << baseAddr->to_string() << " with " << arrayType->size
+            << " elements is read often enough to be cached in VPM" << logging::endl);
+    return arrayType->size;
+}
+
+static FastSet<const BasicBlock*> findReachableBlocks(
+    ControlFlowGraph& cfg, const FastSet<const BasicBlock*>& startBlocks, bool forward)
+{
+    FastSet<const BasicBlock*> reachableBlocks(startBlocks);
+    std::vector<const BasicBlock*> pendingBlocks(startBlocks.begin(), startBlocks.end());
+    while(!pendingBlocks.empty())
+    {
+        auto& node = cfg.assertNode(const_cast<BasicBlock*>(pendingBlocks.back()));
+        pendingBlocks.pop_back();
+        auto visitNeighbor = [&](const CFGNode& neighbor, const CFGEdge&) -> bool {
+            if(reachableBlocks.emplace(neighbor.key).second)
+                pendingBlocks.push_back(neighbor.key);
+            return true;
+        };
+        if(forward)
+            node.forAllOutgoingEdges(visitNeighbor);
+        else
+            node.forAllIncomingEdges(visitNeighbor);
+    }
+    return reachableBlocks;
+}
+
+periphery::VPMLiveRange analysis::determineVPMLiveRange(Method& method,
+    const FastMap<TypedInstructionWalker<intermediate::MemoryInstruction>, const Local*>& accessInstructions)
+{
+    periphery::VPMLiveRange liveRange{};
+    FastSet<const BasicBlock*> accessBlocks;
+    for(const auto& access : accessInstructions)
+    {
+        if(auto block = access.first.base().getBasicBlock())
+            accessBlocks.emplace(block);
+        else
+            return liveRange;
+    }
+    if(accessBlocks.empty())
+        return liveRange;
+
+    auto& cfg = method.getCFG();
+    // The memory is in use in all blocks which can be reached from any access and reach any other access. This also
+    // includes all blocks of loops containing an access.
+    auto forwardBlocks = findReachableBlocks(cfg, accessBlocks, true);
+    auto backwardBlocks = findReachableBlocks(cfg, accessBlocks, false);
+
+    FastMap<const BasicBlock*, std::size_t> blockIndices;
+    std::vector<std::size_t> barrierBlocks;
+    liveRange.firstBlock = std::numeric_limits<std::size_t>::max();
+    liveRange.lastBlock = 0;
+    for(auto& block : method)
+    {
+        auto index = blockIndices.size();
+        blockIndices.emplace(&block, index);
+        if(block.getLabel()->hasDecoration(intermediate::InstructionDecorations::CONTROL_FLOW_BARRIER))
+            barrierBlocks.push_back(index);
+        if(forwardBlocks.find(&block) != forwardBlocks.end() && backwardBlocks.find(&block) != backwardBlocks.end())
+        {
+            liveRange.firstBlock = std::min(liveRange.firstBlock, index);
+            liveRange.lastBlock = std::max(liveRange.lastBlock, index);
+        }
+    }
+
+    if(method.metaData.getMaximumInstancesCount() == 1u)
+    {
+        // only a single QPU executes the kernel code at any time, so the code sections are the blocks themselves
+        liveRange.firstSection = liveRange.firstBlock;
+        liveRange.lastSection = liveRange.lastBlock;
+        return liveRange;
+    }
+
+    // A control flow barrier only separates the code before from the code after it, if it is not skipped by any branch
+    // and is not located inside a loop, i.e. if there is no branch jumping across it in either direction.
+    std::vector<std::pair<std::size_t, std::size_t>> branches;
+    for(auto& block : method)
+    {
+        cfg.assertNode(&block).forAllOutgoingEdges([&](const CFGNode& successor, const CFGEdge&) -> bool {
+            branches.emplace_back(blockIndices.at(&block), blockIndices.at(successor.key));
+            return true;
+        });
+    }
+    std::vector<std::size_t> sectionStarts;
+    for(auto barrierIndex : barrierBlocks)
+    {
+        if(std::none_of(branches.begin(), branches.end(), [&](const std::pair<std::size_t, std::size_t>& branch) {
+               return (branch.first < barrierIndex && branch.second > barrierIndex) ||
+                   (branch.first >= barrierIndex && branch.second < barrierIndex);
+           }))
+            sectionStarts.push_back(barrierIndex);
+    }
+
+    auto getSection = [&](std::size_t blockIndex) -> std::size_t {
+        return static_cast<std::size_t>(std::count_if(sectionStarts.begin(), sectionStarts.end(),
+            [&](std::size_t startIndex) -> bool { return startIndex <= blockIndex; }));
+    };
+    liveRange.firstSection = getSection(liveRange.firstBlock);
+    liveRange.lastSection = getSection(liveRange.lastBlock);
+    if(!sectionStarts.empty() && liveRange.lastSection == sectionStarts.size())
+    {
+        // The code after the last barrier is followed by the code before the first barrier (of the next work-group
+        // loop iteration), so other work-items might still execute the last section while this one is already in the
+        // first section.
+        liveRange.lastSection = liveRange.firstSection == liveRange.lastSection ? 0 : liveRange.lastSection - 1;
+        liveRange.firstSection = 0;
+    }
+    return liveRange;
+}
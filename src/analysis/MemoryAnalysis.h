@@ -17,6 +17,11 @@
 
 namespace vc4c
 {
+    namespace periphery
+    {
+        struct VPMLiveRange;
+    } // namespace periphery
+
     namespace analysis
     {
         /**
@@ -99,6 +104,29 @@ namespace vc4c
         Optional<IdenticalWorkGroupUniformPartsResult> checkWorkGroupUniformParts(
             FastAccessList<MemoryAccessRange>& accessRanges);
 
+        /**
+         * Checks whether the given read-only memory area is worth to be loaded once into the VPM and read from there
+         * instead of being read from RAM via TMU on every access.
+         *
+         * This is the case for constant global buffers of statically known size, which are accessed within loops or at
+         * several places and where all accesses read single elements of the buffer's element type.
+         *
+         * Returns the number of elements to be cached or an empty value if the area should not be cached.
+         */
+        Optional<uint32_t> determineCacheableReadOnlyElements(Method& method, const Local* baseAddr,
+            const FastMap<TypedInstructionWalker<intermediate::MemoryInstruction>, const Local*>& accessInstructions);
+
+        /**
+         * Determines the part of the kernel code in which the memory accessed by the given instructions is in use, if
+         * it is lowered into the VPM.
+         *
+         * The memory is in use in all basic blocks lying on any path between two of the accesses. Since other QPUs
+         * might execute any code between the same two control flow barriers, these blocks are also mapped to the
+         * surrounding sections of code separated by control flow barriers.
+         */
+        periphery::VPMLiveRange determineVPMLiveRange(Method& method,
+            const FastMap<TypedInstructionWalker<intermediate::MemoryInstruction>, const Local*>& accessInstructions);
+
         /**
          * Returns the single writer of a value (usually an address local).
          *
@@ -9,6 +9,7 @@
 #include "../InstructionWalker.h"
 #include "../Module.h"
 #include "../Profiler.h"
+#include "../analysis/ControlFlowGraph.h"
 #include "../optimization/Optimizer.h"
 #include "../optimization/Peephole.h"
 #include "GraphColoring.h"
@@ -18,6 +19,7 @@
 
 #include <cassert>
 #include <climits>
+#include <fstream>
 #include <map>
 #include <sstream>
 
@@ -79,6 +81,35 @@ static FastMap<const Local*, std::size_t> mapLabels(Method& method)
     return labelsMap;
 }
 
+static std::string toLabelName(const BasicBlock& block)
+{
+    return block.getLabel()->getLabel()->name;
+}
+
+/*
+ * Returns the labels of the headers of all loops containing the given block, from the outermost to the innermost loop
+ */
+static FastMap<const BasicBlock*, std::vector<std::string>> mapLoopHeaders(Method& method)
+{
+    FastMap<const BasicBlock*, std::vector<std::string>> headers;
+    auto cfg = analysis::ControlFlowGraph::createCFG(method);
+    auto loops = cfg->findLoops(true, false);
+    // outer loops contain more blocks than the loops nested inside of them
+    std::sort(loops.begin(), loops.end(),
+        [](const analysis::ControlFlowLoop& one, const analysis::ControlFlowLoop& other) -> bool {
+            return one.size() > other.size();
+        });
+    for(const auto& loop : loops)
+    {
+        auto header = loop.getHeader();
+        if(!header)
+            continue;
+        for(const auto* node : loop)
+            headers[node->key].emplace_back(toLabelName(*header->key));
+    }
+    return headers;
+}
+
 static FixupResult runRegisterFixupStep(const RegisterFixupStep& step, Method& method, const Configuration& config,
     std::unique_ptr<GraphColoring>& coloredGraph)
 {
@@ -162,6 +193,11 @@ const FastAccessList<DecoratedInstruction>& CodeGenerator::generateInstructions(
 
     std::string s = "kernel " + method.name;
 
+    std::vector<tools::CodeRegion> regions;
+    FastMap<const BasicBlock*, std::vector<std::string>> loopHeaders;
+    if(!config.profileMappingFile.empty())
+        loopHeaders = mapLoopHeaders(method);
+
     generatedInstructions.reserve(method.countInstructions());
     for(const auto& bb : method)
     {
@@ -176,6 +212,7 @@ const FastAccessList<DecoratedInstruction>& CodeGenerator::generateInstructions(
         auto label = dynamic_cast<const intermediate::BranchLabel*>(it->get());
         assert(label != nullptr);
         ++it;
+        auto firstIndex = index;
 
         auto instr = it->get();
         if(instr->mapsToASMInstruction())
@@ -199,6 +236,20 @@ const FastAccessList<DecoratedInstruction>& CodeGenerator::generateInstructions(
             }
             ++it;
         }
+
+        if(!config.profileMappingFile.empty() && index > firstIndex)
+        {
+            auto loopIt = loopHeaders.find(&bb);
+            regions.emplace_back(tools::CodeRegion{method.name, static_cast<uint32_t>(firstIndex),
+                static_cast<uint32_t>(index - firstIndex), toLabelName(bb),
+                loopIt != loopHeaders.end() ? loopIt->second : std::vector<std::string>{}});
+        }
+    }
+
+    if(!config.profileMappingFile.empty())
+    {
+        std::lock_guard<std::mutex> guard(instructionsLock);
+        codeRegions[&method] = std::move(regions);
     }
 
     CPPLOG_LAZY(logging::Level::DEBUG, log << "-----" << logging::endl);
@@ -280,6 +331,17 @@ std::size_t CodeGenerator::writeOutput(std::ostream& stream)
         }
     }
     stream.flush();
+
+    if(!config.profileMappingFile.empty())
+    {
+        std::vector<tools::CodeRegion> regions;
+        for(const auto& pair : allInstructions)
+            regions.insert(regions.end(), codeRegions[pair.first].begin(), codeRegions[pair.first].end());
+        std::ofstream mappingStream(config.profileMappingFile);
+        tools::writeCodeRegions(mappingStream, regions);
+        CPPLOG_LAZY(logging::Level::INFO,
+            log << "Written code region mapping to: " << config.profileMappingFile << logging::endl);
+    }
     return numBytes;
 }
 
@@ -8,6 +8,7 @@
 #define CODEGENERATOR_H
 
 #include "../performance.h"
+#include "../tools/Profile.h"
 #include "Instruction.h"
 #include "RegisterFixes.h"
 #include "config.h"
@@ -39,6 +40,10 @@ namespace vc4c
             Configuration config;
             const Module& module;
             std::map<Method*, FastAccessList<qpu_asm::DecoratedInstruction>> allInstructions;
+            /*
+             * The instruction ranges generated for the basic blocks, only collected if a profile mapping is written
+             */
+            std::map<Method*, std::vector<tools::CodeRegion>> codeRegions;
             std::mutex instructionsLock;
             std::vector<RegisterFixupStep> fixupSteps;
 
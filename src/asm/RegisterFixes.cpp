@@ -511,7 +511,8 @@ static bool isInMutexLock(InstructionWalker it)
             return mutex->locksMutex();
         it.previousInBlock();
     }
-    return false;
+    // the block might be entered with the mutex already locked, e.g. for asynchronous DMA accesses in loops
+    return it.has() && it->hasDecoration(intermediate::InstructionDecorations::MUTEX_LOCKED);
 }
 
 static const LocalUser* findPreviousAccess(
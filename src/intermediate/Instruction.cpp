@@ -51,6 +51,8 @@ std::string intermediate::toString(const InstructionDecorations decoration)
         res.append("delay ");
     if(has_flag(decoration, InstructionDecorations::ELEMENT_INSERTION))
         res.append("single_element ");
+    if(has_flag(decoration, InstructionDecorations::CONTROL_FLOW_BARRIER))
+        res.append("barrier ");
     if(has_flag(decoration, InstructionDecorations::WORK_GROUP_UNIFORM_VALUE))
         res.append("group_uniform ");
     if(has_flag(decoration, InstructionDecorations::VPM_READ_CONFIGURATION))
@@ -78,6 +80,8 @@ std::string intermediate::toString(const InstructionDecorations decoration)
         res.append("Z ");
     if(has_flag(decoration, InstructionDecorations::DIMENSION_SCALAR))
         res.append("XYZ ");
+    if(has_flag(decoration, InstructionDecorations::MUTEX_LOCKED))
+        res.append("mutex_locked ");
     return res.substr(0, res.empty() ? 0 : res.size() - 1);
 }
 LCOV_EXCL_STOP
@@ -369,10 +373,11 @@ Value IntermediateInstruction::renameValue(
         return orig;
     if(auto alloc = origLocal->as<StackAllocation>())
     {
-        if(method.findStackAllocation(prefix + alloc->name) != nullptr)
-            return method.findStackAllocation(prefix + alloc->name)->createReference();
+        auto name = prefix + alloc->name;
+        if(auto existing = method.findStackAllocation(name))
+            return existing->createReference();
         auto pos = method.stackAllocations.emplace(
-            StackAllocation(prefix + alloc->name, alloc->type, alloc->size, alloc->alignment));
+            StackAllocation(name, alloc->type, alloc->size, alloc->alignment));
         return pos.first->createReference();
     }
     auto it = localMapping.find(origLocal);
@@ -81,7 +81,9 @@ namespace vc4c
             MANDATORY_DELAY = 1u << 15u,
             // The instructions inserts a single element into a vector
             ELEMENT_INSERTION = 1u << 16u,
-            // 1 << 17 IS UNUSED
+            // The label is the first instruction after a control flow barrier, i.e. all work-items of the work-group
+            // have reached this label before any continues with the code following it
+            CONTROL_FLOW_BARRIER = 1u << 17u,
             // The result of the instruction is the same for all work-items within a single work-group
             WORK_GROUP_UNIFORM_VALUE = 1u << 18u,
             // The instruction calculates VPM read configuration
@@ -111,7 +113,9 @@ namespace vc4c
             // Value indicating the set built-in flag is present in the Z-dimension (2nd)
             DIMENSION_Z = 1u << 29u,
             // Value indicating the set built-in flag is scalar (added up across all dimensions)
-            DIMENSION_SCALAR = 1u << 30u
+            DIMENSION_SCALAR = 1u << 30u,
+            // The label starts a block which is entered with the hardware mutex already locked
+            MUTEX_LOCKED = 1u << 31u
         };
 
         std::string toString(InstructionDecorations decoration);
@@ -8,13 +8,19 @@
 
 #include "../Module.h"
 #include "../intermediate/VectorHelper.h"
+#include "../intermediate/operators.h"
+#include "../periphery/SFU.h"
 #include "../periphery/TMU.h"
 #include "log.h"
 
+#include <array>
+
 using namespace vc4c;
 using namespace vc4c::intermediate;
+using namespace vc4c::operators;
 
-static constexpr unsigned IMAGE_CONFIG_NUM_UNIFORMS{6};
+// 6 entries for the image-configuration and 2 entries per texture setup
+static constexpr unsigned IMAGE_CONFIG_NUM_UNIFORMS{6 + 2 * NUM_TEXTURE_SETUPS};
 
 // The first entry is the base texture setup
 const Value IMAGE_CONFIG_BASE_OFFSET(INT_ZERO);
@@ -29,6 +35,12 @@ const Value IMAGE_CONFIG_CHANNEL_OFFSET(Literal(4 * static_cast<uint32_t>(sizeof
 // The sixth entry is the array-size or image-depth
 const Value IMAGE_CONFIG_ARRAY_SIZE_OFFSET(Literal(5 * static_cast<uint32_t>(sizeof(unsigned))), TYPE_INT32);
 const Value IMAGE_CONFIG_IMAGE_DEPTH_OFFSET = IMAGE_CONFIG_ARRAY_SIZE_OFFSET;
+// The seventh and following entries are the texture setups for the different samplers
+static constexpr uint32_t IMAGE_CONFIG_TEXTURE_SETUP_OFFSET{6 * static_cast<uint32_t>(sizeof(unsigned))};
+
+// The OpenCL channel orders CL_R, CL_RG, CL_RGB and CL_LUMINANCE, which have no alpha channel and use the border color
+// (0, 0, 0, 1) for CLK_ADDRESS_CLAMP
+static constexpr std::array<uint32_t, 4> CHANNEL_ORDERS_WITHOUT_ALPHA{{0x10B0, 0x10B2, 0x10B4, 0x10B9}};
 
 Global* intermediate::reserveImageConfiguration(Module& module, Parameter& image)
 {
@@ -40,12 +52,41 @@ Global* intermediate::reserveImageConfiguration(Module& module, Parameter& image
     CPPLOG_LAZY(logging::Level::DEBUG,
         log << "Reserving a buffer of " << IMAGE_CONFIG_NUM_UNIFORMS << " UNIFORMs for the image-configuration of "
             << image.to_string() << logging::endl);
+    // the configuration has more entries than fit into a vector
+    DataType configType(module.createArrayType(TYPE_INT32, IMAGE_CONFIG_NUM_UNIFORMS));
+    std::vector<CompoundConstant> elements(IMAGE_CONFIG_NUM_UNIFORMS, CompoundConstant(TYPE_INT32, Literal(0u)));
     auto it = module.globalData.emplace(module.globalData.end(), ImageType::toImageConfigurationName(image.name),
-        DataType(module.createPointerType(TYPE_INT32.toVectorType(IMAGE_CONFIG_NUM_UNIFORMS), AddressSpace::GLOBAL)),
-        CompoundConstant(TYPE_INT32.toVectorType(IMAGE_CONFIG_NUM_UNIFORMS), Literal(0u)), false);
+        DataType(module.createPointerType(configType, AddressSpace::GLOBAL)),
+        CompoundConstant(configType, std::move(elements)), false);
     return &(*it);
 }
 
+unsigned intermediate::getTextureSetupIndex(Sampler sampler)
+{
+    return static_cast<unsigned>(sampler.getAddressingMode()) * 2 +
+        (sampler.getFilterMode() == FilterMode::LINEAR ? 1 : 0);
+}
+
+TextureWrapMode intermediate::toTextureWrapMode(AddressingMode mode)
+{
+    switch(mode)
+    {
+    case AddressingMode::NONE:
+    case AddressingMode::CLAMP_TO_EDGE:
+        return TextureWrapMode::CLAMP;
+    case AddressingMode::CLAMP:
+        // the border color is transparent black, as required by OpenCL for images with alpha channel. For images
+        // without alpha channel, the alpha component is set to 1.0 after the lookup, see #insertTextureRead()
+        return TextureWrapMode::BORDER;
+    case AddressingMode::REPEAT:
+        return TextureWrapMode::REPEAT;
+    case AddressingMode::MIRRORED_REPEAT:
+        return TextureWrapMode::MIRROR;
+    }
+    throw CompilationError(
+        CompilationStep::GENERAL, "Unhandled addressing mode", std::to_string(static_cast<unsigned>(mode)));
+}
+
 static NODISCARD InstructionWalker insertLoadImageConfig(
     InstructionWalker it, Method& method, const Value& image, const Value& dest, const Value& offset)
 {
@@ -67,6 +108,178 @@ static NODISCARD InstructionWalker insertLoadArraySizeOrImageDepth(
     return insertLoadImageConfig(it, method, image, dest, IMAGE_CONFIG_ARRAY_SIZE_OFFSET);
 }
 
+static NODISCARD InstructionWalker insertLoadImageWidth(
+    InstructionWalker it, Method& method, const Value& image, const Value& dest)
+{
+    const Value valTemp = method.addNewLocal(TYPE_INT32, "%image_config");
+    it = insertLoadImageConfig(it, method, image, valTemp, IMAGE_CONFIG_ACCESS_OFFSET);
+    const Value widthTemp = method.addNewLocal(TYPE_INT32, "%image_config");
+    it.emplace(std::make_unique<Operation>(OP_SHR, widthTemp, valTemp, Value(Literal(8u), TYPE_INT8)));
+    it.nextInBlock();
+    it.emplace(std::make_unique<Operation>(
+                   OP_AND, dest, widthTemp, Value(Literal(Bitfield<uint32_t>::MASK_Undecuple), TYPE_INT32)))
+        .setSetFlags(SetFlag::SET_FLAGS);
+    it.nextInBlock();
+    // 0 => 2048
+    it.emplace(std::make_unique<MoveOperation>(dest, Value(Literal(2048u), TYPE_INT32), COND_ZERO_SET));
+    it.nextInBlock();
+    return it;
+}
+
+static NODISCARD InstructionWalker insertLoadImageHeight(
+    InstructionWalker it, Method& method, const Value& image, const Value& dest)
+{
+    const Value valTemp = method.addNewLocal(TYPE_INT32, "%image_config");
+    it = insertLoadImageConfig(it, method, image, valTemp, IMAGE_CONFIG_ACCESS_OFFSET);
+    const Value heightTemp = method.addNewLocal(TYPE_INT32, "%image_config");
+    it.emplace(std::make_unique<Operation>(OP_SHR, heightTemp, valTemp, Value(Literal(20u), TYPE_INT8)));
+    it.nextInBlock();
+    it.emplace(std::make_unique<Operation>(
+                   OP_AND, dest, heightTemp, Value(Literal(Bitfield<uint32_t>::MASK_Undecuple), TYPE_INT32)))
+        .setSetFlags(SetFlag::SET_FLAGS);
+    it.nextInBlock();
+    // 0 => 2048
+    it.emplace(std::make_unique<MoveOperation>(dest, Value(Literal(2048u), TYPE_INT32), COND_ZERO_SET));
+    it.nextInBlock();
+    return it;
+}
+
+/*
+ * Reads the texel at the given coordinates via a TMU texture lookup, which performs the wrapping, filtering and the
+ * conversion of the pixel format to RGBA8888 in hardware.
+ *
+ * The std-lib calls vc4cl_image_read(image, sampler, coordinates) only for read_imagef() of 1D and 2D images with a
+ * format natively supported by the TMU. The coordinates are float, float2, int or int2 and are normalized at run-time
+ * according to the MASK_NORMALIZED_COORDS flag of the sampler, integer coordinates address the center of the texel.
+ * The result is a float4 with the RGBA channels normalized to [0, 1].
+ *
+ * The TMU reads the texture setup from the UNIFORMs, so the UNIFORM pointer is redirected to the entry of the texture
+ * setup table of the image-configuration matching the sampler. Since the UNIFORM pointer is not restored, the remaining
+ * kernel UNIFORMs are read before any texture lookup, see the work-group loop.
+ *
+ * The border color of the TMU is left at transparent black, since writing it via the r-parameter would make the TMU
+ * read an additional UNIFORM not reserved in the texture setup table. For images without alpha channel, OpenCL requires
+ * the border color (0, 0, 0, 1) and all texels are opaque, so the alpha component of the result is set to 1.0 instead.
+ */
+static NODISCARD InstructionWalker insertTextureRead(InstructionWalker it, Method& method, const Value& image,
+    const Value& sampler, const Value& coordinates, const Value& dest)
+{
+    const ImageType* imageType = image.type.getImageType();
+    if(!imageType || imageType->dimensions > 2 || imageType->isImageArray || imageType->isImageBuffer)
+        throw CompilationError(
+            CompilationStep::GENERAL, "Texture lookups are only supported for 1D and 2D images", image.to_string());
+    const Global* imageConfig =
+        method.findGlobal(ImageType::toImageConfigurationName(image.local()->getBase(false)->name));
+    if(imageConfig == nullptr)
+        throw CompilationError(CompilationStep::GENERAL, "Image-configuration is not yet reserved", image.to_string());
+    if(!dest.type.isFloatingType())
+        // the TMU converts all texels to RGBA8888, so the integer channel values of read_imagei()/read_imageui() cannot
+        // be restored from the lookup result
+        throw CompilationError(CompilationStep::GENERAL,
+            "Texture lookups are only supported for reading normalized floating-point colors", dest.to_string());
+
+    // the TMU expects normalized coordinates, so the coordinates are scaled by the reciprocal of the image size unless
+    // the sampler uses normalized coordinates. The image size is loaded before redirecting the UNIFORM pointer.
+    auto coordinateType = TYPE_FLOAT.toVectorType(coordinates.type.getVectorWidth());
+    auto floatCoordinates = coordinates;
+    if(!coordinates.type.isFloatingType())
+    {
+        floatCoordinates = assign(it, coordinateType, "%texture_coords") = itof(coordinates);
+        floatCoordinates = assign(it, coordinateType, "%texture_coords") =
+            floatCoordinates + Value(Literal(0.5f), TYPE_FLOAT);
+    }
+    auto width = method.addNewLocal(TYPE_INT32, "%image_width");
+    it = insertLoadImageWidth(it, method, image, width);
+    auto sScale = assign(it, TYPE_FLOAT, "%texture_s_scale") = itof(width);
+    it = periphery::insertSFUCall(REG_SFU_RECIP, it, sScale);
+    sScale = assign(it, TYPE_FLOAT, "%texture_s_scale") = Value(REG_SFU_OUT, TYPE_FLOAT);
+    Value tScale = FLOAT_ONE;
+    if(coordinates.type.getVectorWidth() > 1)
+    {
+        auto height = method.addNewLocal(TYPE_INT32, "%image_height");
+        it = insertLoadImageHeight(it, method, image, height);
+        tScale = assign(it, TYPE_FLOAT, "%texture_t_scale") = itof(height);
+        it = periphery::insertSFUCall(REG_SFU_RECIP, it, tScale);
+        tScale = assign(it, TYPE_FLOAT, "%texture_t_scale") = Value(REG_SFU_OUT, TYPE_FLOAT);
+    }
+    // the index of the alpha element of the result, or an index never matching the element number if the image format
+    // has an alpha channel. The channel order is loaded before redirecting the UNIFORM pointer too.
+    auto channelOrder = method.addNewLocal(TYPE_INT32, "%image_channel_order");
+    it = insertQueryChannelOrder(it, method, image, channelOrder);
+    auto alphaElement = assign(it, TYPE_INT8, "%alpha_element") =
+        Value(Literal(static_cast<uint32_t>(NATIVE_VECTOR_SIZE)), TYPE_INT8);
+    for(auto order : CHANNEL_ORDERS_WITHOUT_ALPHA)
+    {
+        assign(it, NOP_REGISTER) = (channelOrder ^ Value(Literal(order), TYPE_INT32), SetFlag::SET_FLAGS);
+        assign(it, alphaElement) = (Value(Literal(3u), TYPE_INT8), COND_ZERO_SET);
+    }
+    assign(it, NOP_REGISTER) =
+        (sampler & Value(Literal(Sampler::MASK_NORMALIZED_COORDS), TYPE_INT8), SetFlag::SET_FLAGS);
+    assign(it, sScale) = (FLOAT_ONE, COND_ZERO_CLEAR);
+    if(coordinates.type.getVectorWidth() > 1)
+        assign(it, tScale) = (FLOAT_ONE, COND_ZERO_CLEAR);
+
+    // setup offset = addressing mode * 16 + (filter mode - 1) * 8, see #getTextureSetupIndex()
+    auto addressingOffset = assign(it, TYPE_INT32, "%texture_setup_offset") =
+        sampler & Value(Literal(Sampler::MASK_ADDRESSING_MODE), TYPE_INT8);
+    addressingOffset = assign(it, TYPE_INT32, "%texture_setup_offset") = addressingOffset << 3_val;
+    auto filterOffset = assign(it, TYPE_INT32, "%texture_setup_offset") =
+        sampler & Value(Literal(Sampler::MASK_FILTER_MODE), TYPE_INT8);
+    filterOffset = assign(it, TYPE_INT32, "%texture_setup_offset") = as_unsigned{filterOffset} >> 1_val;
+    auto setupOffset = assign(it, TYPE_INT32, "%texture_setup_offset") = addressingOffset + filterOffset;
+    setupOffset = assign(it, TYPE_INT32, "%texture_setup_offset") =
+        setupOffset + Value(Literal(IMAGE_CONFIG_TEXTURE_SETUP_OFFSET - 8u), TYPE_INT32);
+    auto setupAddress = assign(it, method.createPointerType(TYPE_INT32, AddressSpace::GLOBAL), "%texture_setup") =
+        imageConfig->createReference() + setupOffset;
+    assign(it, Value(REG_UNIFORM_ADDRESS, TYPE_INT32)) = setupAddress;
+    // "[...] there must be at least two nonuniform-accessing instructions following a pointer change before uniforms
+    // can be accessed once more." - Broadcom specification, page 22
+    nop(it, DelayType::WAIT_UNIFORM);
+    nop(it, DelayType::WAIT_UNIFORM);
+
+    // every SIMD element performs its own lookup, so replicate the coordinates to get the same texel in all elements
+    auto vectorType = TYPE_FLOAT.toVectorType(NATIVE_VECTOR_SIZE);
+    auto sCoordinate = method.addNewLocal(vectorType, "%texture_s");
+    auto tCoordinate = Value(Literal(0.5f), TYPE_FLOAT);
+    if(coordinates.type.getVectorWidth() > 1)
+    {
+        auto tmp = method.addNewLocal(TYPE_FLOAT, "%texture_s");
+        it = insertVectorExtraction(it, method, floatCoordinates, INT_ZERO, tmp);
+        tmp = assign(it, TYPE_FLOAT, "%texture_s") = tmp * sScale;
+        it = insertReplication(it, tmp, sCoordinate);
+        tmp = method.addNewLocal(TYPE_FLOAT, "%texture_t");
+        it = insertVectorExtraction(it, method, floatCoordinates, INT_ONE, tmp);
+        tmp = assign(it, TYPE_FLOAT, "%texture_t") = tmp * tScale;
+        tCoordinate = method.addNewLocal(vectorType, "%texture_t");
+        it = insertReplication(it, tmp, tCoordinate);
+    }
+    else
+    {
+        // 1D images are stored as 2D textures with a height of 1, the lookup always uses the center of the single row
+        auto tmp = assign(it, TYPE_FLOAT, "%texture_s") = floatCoordinates * sScale;
+        it = insertReplication(it, tmp, sCoordinate);
+    }
+
+    // "General-memory lookups are performed by writing to just the s-parameter [...]", so write the t-parameter first,
+    // the write of the s-parameter triggers the lookup (Broadcom specification, page 41)
+    assign(it, periphery::TMU0.getYCoord()) = tCoordinate;
+    assign(it, periphery::TMU0.getXCoord()) = sCoordinate;
+    nop(it, DelayType::WAIT_TMU, periphery::TMU0.signal);
+    it.copy().previousInBlock()->addDecorations(InstructionDecorations::MANDATORY_DELAY);
+    auto texel = assign(it, TYPE_INT32.toVectorType(NATIVE_VECTOR_SIZE), "%texel") = periphery::TMU_READ_REGISTER;
+
+    // element i of the result is the color channel i of the RGBA8888 texel, normalized to [0, 1]
+    auto channelType = TYPE_INT32.toVectorType(dest.type.getVectorWidth());
+    auto shift = assign(it, channelType, "%texel_shift") = mul24(ELEMENT_NUMBER_REGISTER, 8_val);
+    auto channel = assign(it, channelType, "%texel_channel") = as_unsigned{texel} >> shift;
+    channel = assign(it, channelType, "%texel_channel") = channel & Value(Literal(0xFFu), TYPE_INT32);
+    auto tmp = assign(it, dest.type, "%texel_channel") = itof(channel);
+    assign(it, dest) = tmp * Value(Literal(1.0f / 255.0f), TYPE_FLOAT);
+    assign(it, NOP_REGISTER) = (ELEMENT_NUMBER_REGISTER ^ alphaElement, SetFlag::SET_FLAGS);
+    assign(it, dest) = (FLOAT_ONE, COND_ZERO_SET);
+    return it;
+}
+
 bool intermediate::intrinsifyImageFunction(InstructionWalker it, Method& method)
 {
     if(auto callSite = it.get<MethodCall>())
@@ -187,7 +400,10 @@ bool intermediate::intrinsifyImageFunction(InstructionWalker it, Method& method)
         }
         else if(callSite->methodName.find("vc4cl_image_read") != std::string::npos)
         {
-            // TODO
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Intrinsifying image read via TMU texture lookup: " << callSite->to_string() << logging::endl);
+            it = insertTextureRead(it, method, callSite->assertArgument(0), callSite->assertArgument(1),
+                callSite->assertArgument(2), callSite->getOutput().value());
             it.erase();
             return true;
         }
@@ -217,42 +433,6 @@ InstructionWalker intermediate::insertQueryChannelOrder(
     return it;
 }
 
-static NODISCARD InstructionWalker insertLoadImageWidth(
-    InstructionWalker it, Method& method, const Value& image, const Value& dest)
-{
-    const Value valTemp = method.addNewLocal(TYPE_INT32, "%image_config");
-    it = insertLoadImageConfig(it, method, image, valTemp, IMAGE_CONFIG_ACCESS_OFFSET);
-    const Value widthTemp = method.addNewLocal(TYPE_INT32, "%image_config");
-    it.emplace(std::make_unique<Operation>(OP_SHR, widthTemp, valTemp, Value(Literal(8u), TYPE_INT8)));
-    it.nextInBlock();
-    it.emplace(std::make_unique<Operation>(
-                   OP_AND, dest, widthTemp, Value(Literal(Bitfield<uint32_t>::MASK_Undecuple), TYPE_INT32)))
-        .setSetFlags(SetFlag::SET_FLAGS);
-    it.nextInBlock();
-    // 0 => 2048
-    it.emplace(std::make_unique<MoveOperation>(dest, Value(Literal(2048u), TYPE_INT32), COND_ZERO_SET));
-    it.nextInBlock();
-    return it;
-}
-
-static NODISCARD InstructionWalker insertLoadImageHeight(
-    InstructionWalker it, Method& method, const Value& image, const Value& dest)
-{
-    const Value valTemp = method.addNewLocal(TYPE_INT32, "%image_config");
-    it = insertLoadImageConfig(it, method, image, valTemp, IMAGE_CONFIG_ACCESS_OFFSET);
-    const Value heightTemp = method.addNewLocal(TYPE_INT32, "%image_config");
-    it.emplace(std::make_unique<Operation>(OP_SHR, heightTemp, valTemp, Value(Literal(20u), TYPE_INT8)));
-    it.nextInBlock();
-    it.emplace(std::make_unique<Operation>(
-                   OP_AND, dest, heightTemp, Value(Literal(Bitfield<uint32_t>::MASK_Undecuple), TYPE_INT32)))
-        .setSetFlags(SetFlag::SET_FLAGS);
-    it.nextInBlock();
-    // 0 => 2048
-    it.emplace(std::make_unique<MoveOperation>(dest, Value(Literal(2048u), TYPE_INT32), COND_ZERO_SET));
-    it.nextInBlock();
-    return it;
-}
-
 InstructionWalker intermediate::insertQueryMeasurements(
     InstructionWalker it, Method& method, const Value& image, const Value& dest)
 {
@@ -98,6 +98,40 @@ namespace vc4c
             }
         };
 
+        /*
+         * The wrap modes of the TMU texture lookup, see Broadcom specification, table 15
+         *
+         * !!These values need to match the runtime/kernel equivalent!!
+         */
+        enum class TextureWrapMode : unsigned char
+        {
+            REPEAT = 0,
+            CLAMP = 1,
+            MIRROR = 2,
+            BORDER = 3
+        };
+
+        /*
+         * The image-configuration is followed by a table of texture setups, one entry per combination of OpenCL
+         * addressing mode and filter mode, which is also written host-side on setting the image as kernel-parameter.
+         *
+         * Every entry consists of the texture config parameters 0 and 1 (see Broadcom specification, tables 14 and 15)
+         * as read by the TMU from the UNIFORMs on a texture lookup. The entries only differ in the wrap modes (see
+         * #toTextureWrapMode()) and the minification and magnification filters (nearest for FilterMode::NEAREST,
+         * linear for FilterMode::LINEAR). The index of the entry for a sampler is given by #getTextureSetupIndex().
+         *
+         * NOTE: Only 2D textures with a single mipmap level are supported, 1D images are read as 2D images with a
+         * height of 1.
+         */
+        constexpr unsigned NUM_TEXTURE_SETUPS{10};
+
+        /*
+         * Returns the index of the entry in the texture setup table to be used for the given sampler, which is
+         * addressing mode * 2 + (0 for nearest, 1 for linear filtering)
+         */
+        unsigned getTextureSetupIndex(Sampler sampler);
+        TextureWrapMode toTextureWrapMode(AddressingMode mode);
+
         /*
          * Prepares a segment of the global data to be used as buffer for the image-configuration for this image
          *
@@ -12,6 +12,7 @@
 #include "../intermediate/VectorHelper.h"
 #include "../intermediate/operators.h"
 #include "../periphery/SFU.h"
+#include "../tools/PrefixTrie.h"
 
 #include "Comparisons.h"
 #include "Images.h"
@@ -22,7 +23,6 @@
 #include <climits>
 #include <cmath>
 #include <cstdbool>
-#include <map>
 #include <vector>
 
 using namespace vc4c;
@@ -429,16 +429,18 @@ static UnaryInstruction calculateIntrinsic(DataType resultBaseType, Func&& func)
 }
 
 /*
- * NOTE: We sort intrinsics in descending order on purpose, to correctly select e.g. fmaxabs for vc4cl_fmaxabs (and not
- * fmax)
+ * NOTE: All intrinsic names need to start with INTRINSIC_PREFIX. We select the longest matching name on purpose, to
+ * correctly select e.g. fmaxabs for vc4cl_fmaxabs (and not fmax)
  */
-const static std::map<std::string, Intrinsic, std::greater<std::string>> nonaryInstrinsics = {
+static const std::string INTRINSIC_PREFIX = "vc4cl_";
+
+const static tools::PrefixTrie<Intrinsic> nonaryInstrinsics = {
     {"vc4cl_mutex_lock", Intrinsic{intrinsifyMutexAccess(true)}},
     {"vc4cl_mutex_unlock", Intrinsic{intrinsifyMutexAccess(false)}},
     {"vc4cl_element_number", Intrinsic{intrinsifyValueRead(ELEMENT_NUMBER_REGISTER)}},
     {"vc4cl_qpu_number", Intrinsic{intrinsifyValueRead(Value(REG_QPU_NUMBER, TYPE_INT8))}}};
 
-const static std::map<std::string, Intrinsic, std::greater<std::string>> unaryIntrinsicMapping = {
+const static tools::PrefixTrie<Intrinsic> unaryIntrinsicMapping = {
     {"vc4cl_ftoi",
         Intrinsic{intrinsifyUnaryALUInstruction(OP_FTOI.name),
             [](const Value& val) { return OP_FTOI(val, NO_VALUE).first.value(); }}},
@@ -492,7 +494,7 @@ const static std::map<std::string, Intrinsic, std::greater<std::string>> unaryIn
     {"vc4cl_popcount", Intrinsic{intrinsifyPopcount}},
 };
 
-const static std::map<std::string, Intrinsic, std::greater<std::string>> binaryIntrinsicMapping = {
+const static tools::PrefixTrie<Intrinsic> binaryIntrinsicMapping = {
     {"vc4cl_fmax",
         Intrinsic{intrinsifyBinaryALUInstruction(OP_FMAX.name),
             [](const Value& val0, const Value& val1) { return OP_FMAX(val0, val1).first.value(); }}},
@@ -550,11 +552,10 @@ const static std::map<std::string, Intrinsic, std::greater<std::string>> binaryI
     {"vc4cl_vstore3", Intrinsic{intrinsifyMemoryAccess(MemoryAccess::WRITE, true)}},
     {"vc4cl_mul_hi", Intrinsic{intrinsifyIntegerMultiplicationHighPart}}};
 
-const static std::map<std::string, Intrinsic, std::greater<std::string>> ternaryIntrinsicMapping = {
+const static tools::PrefixTrie<Intrinsic> ternaryIntrinsicMapping = {
     {"vc4cl_dma_copy", Intrinsic{intrinsifyMemoryAccess(MemoryAccess::COPY, false)}}};
 
-const static std::map<std::string, std::pair<Intrinsic, Optional<Value>>, std::greater<std::string>>
-    typeCastIntrinsics = {
+const static tools::PrefixTrie<std::pair<Intrinsic, Optional<Value>>> typeCastIntrinsics = {
         // since we run all the (not intrinsified) calculations with 32-bit, don't truncate signed conversions to
         // smaller types
         // TODO correct?? Since we do not discard out-of-bounds values!
@@ -588,19 +589,32 @@ const static std::map<std::string, std::pair<Intrinsic, Optional<Value>>, std::g
                  calculateIntrinsic(TYPE_FLOAT, [](const Literal& lit) { return lit; })},
                 NO_VALUE}}};
 
+/*
+ * Returns the intrinsic with the longest name contained in the (possibly mangled) name of the called function
+ */
+template <typename T>
+static const T* findIntrinsic(const tools::PrefixTrie<T>& intrinsics, const std::string& methodName)
+{
+    // only need to check the positions the common prefix of all intrinsics occurs at, which for most functions is none
+    for(auto pos = methodName.find(INTRINSIC_PREFIX); pos != std::string::npos;
+        pos = methodName.find(INTRINSIC_PREFIX, pos + 1))
+    {
+        if(auto intrinsic = intrinsics.findLongestPrefix(methodName, pos).first)
+            return intrinsic;
+    }
+    return nullptr;
+}
+
 static bool intrinsifyNoArgs(Method& method, TypedInstructionWalker<MethodCall> it)
 {
     if(it->getArguments().size() > 1 /* check for sign-flag too*/)
     {
         return false;
     }
-    for(const auto& pair : nonaryInstrinsics)
+    if(auto intrinsic = findIntrinsic(nonaryInstrinsics, it->methodName))
     {
-        if(it->methodName.find(pair.first) != std::string::npos)
-        {
-            pair.second.func(method, it);
-            return true;
-        }
+        intrinsic->func(method, it);
+        return true;
     }
     return false;
 }
@@ -615,53 +629,46 @@ static bool intrinsifyUnary(Method& method, TypedInstructionWalker<MethodCall> i
     }
     const Value& arg = callSite.assertArgument(0);
     Optional<Value> result = NO_VALUE;
-    for(const auto& pair : unaryIntrinsicMapping)
+    if(auto intrinsic = findIntrinsic(unaryIntrinsicMapping, callSite.methodName))
     {
-        if(callSite.methodName.find(pair.first) != std::string::npos)
+        if((arg.getLiteralValue() || arg.checkVector()) && intrinsic->unaryInstr &&
+            (result = intrinsic->unaryInstr.value()(arg)))
         {
-            if((arg.getLiteralValue() || arg.checkVector()) && pair.second.unaryInstr &&
-                (result = pair.second.unaryInstr.value()(arg)))
-            {
-                CPPLOG_LAZY(logging::Level::DEBUG,
-                    log << "Intrinsifying unary '" << callSite.to_string()
-                        << "' to pre-calculated value: " << result->to_string() << logging::endl);
-                it.reset(std::make_unique<MoveOperation>(callSite.getOutput().value(), result.value()));
-            }
-            else
-                pair.second.func(method, inIt);
-            return true;
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Intrinsifying unary '" << callSite.to_string()
+                    << "' to pre-calculated value: " << result->to_string() << logging::endl);
+            it.reset(std::make_unique<MoveOperation>(callSite.getOutput().value(), result.value()));
         }
+        else
+            intrinsic->func(method, inIt);
+        return true;
     }
-    for(const auto& pair : typeCastIntrinsics)
+    if(auto typeCast = findIntrinsic(typeCastIntrinsics, callSite.methodName))
     {
-        if(callSite.methodName.find(pair.first) != std::string::npos)
+        // TODO support constant type-cast for constant containers
+        if(arg.checkLiteral() && typeCast->first.unaryInstr && (result = typeCast->first.unaryInstr.value()(arg)))
         {
-            // TODO support constant type-cast for constant containers
-            if(arg.checkLiteral() && pair.second.first.unaryInstr &&
-                (result = pair.second.first.unaryInstr.value()(arg)))
-            {
-                CPPLOG_LAZY(logging::Level::DEBUG,
-                    log << "Intrinsifying type-cast '" << callSite.to_string()
-                        << "' to pre-calculated value: " << result->to_string() << logging::endl);
-                it.reset(std::make_unique<MoveOperation>(callSite.getOutput().value(), result.value()));
-            }
-            else if(!pair.second.second) // there is no value to apply -> simple move
-            {
-                CPPLOG_LAZY(logging::Level::DEBUG,
-                    log << "Intrinsifying '" << callSite.to_string() << "' to simple move" << logging::endl);
-                it.reset(std::make_unique<MoveOperation>(callSite.getOutput().value(), arg));
-            }
-            else
-            {
-                // TODO could use pack-mode here, but only for UNSIGNED values!!
-                CPPLOG_LAZY(logging::Level::DEBUG,
-                    log << "Intrinsifying '" << callSite.to_string() << "' to operation with constant "
-                        << pair.second.second.to_string() << logging::endl);
-                callSite.setArgument(1, pair.second.second.value());
-                pair.second.first.func(method, inIt);
-            }
-            return true;
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Intrinsifying type-cast '" << callSite.to_string()
+                    << "' to pre-calculated value: " << result->to_string() << logging::endl);
+            it.reset(std::make_unique<MoveOperation>(callSite.getOutput().value(), result.value()));
+        }
+        else if(!typeCast->second) // there is no value to apply -> simple move
+        {
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Intrinsifying '" << callSite.to_string() << "' to simple move" << logging::endl);
+            it.reset(std::make_unique<MoveOperation>(callSite.getOutput().value(), arg));
         }
+        else
+        {
+            // TODO could use pack-mode here, but only for UNSIGNED values!!
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Intrinsifying '" << callSite.to_string() << "' to operation with constant "
+                    << typeCast->second.to_string() << logging::endl);
+            callSite.setArgument(1, typeCast->second.value());
+            typeCast->first.func(method, inIt);
+        }
+        return true;
     }
     return false;
 }
@@ -674,24 +681,21 @@ static bool intrinsifyBinary(Method& method, TypedInstructionWalker<MethodCall>
     {
         return false;
     }
-    for(const auto& pair : binaryIntrinsicMapping)
+    if(auto intrinsic = findIntrinsic(binaryIntrinsicMapping, callSite.methodName))
     {
-        if(callSite.methodName.find(pair.first) != std::string::npos)
+        if(callSite.assertArgument(0).checkLiteral() && callSite.assertArgument(1).checkLiteral() &&
+            intrinsic->binaryInstr &&
+            intrinsic->binaryInstr.value()(callSite.assertArgument(0), callSite.assertArgument(1)))
         {
-            if(callSite.assertArgument(0).checkLiteral() && callSite.assertArgument(1).checkLiteral() &&
-                pair.second.binaryInstr &&
-                pair.second.binaryInstr.value()(callSite.assertArgument(0), callSite.assertArgument(1)))
-            {
-                CPPLOG_LAZY(logging::Level::DEBUG,
-                    log << "Intrinsifying binary '" << callSite.to_string() << "' to pre-calculated value"
-                        << logging::endl);
-                it.reset(std::make_unique<MoveOperation>(callSite.getOutput().value(),
-                    pair.second.binaryInstr.value()(callSite.assertArgument(0), callSite.assertArgument(1)).value()));
-            }
-            else
-                pair.second.func(method, inIt);
-            return true;
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Intrinsifying binary '" << callSite.to_string() << "' to pre-calculated value"
+                    << logging::endl);
+            it.reset(std::make_unique<MoveOperation>(callSite.getOutput().value(),
+                intrinsic->binaryInstr.value()(callSite.assertArgument(0), callSite.assertArgument(1)).value()));
         }
+        else
+            intrinsic->func(method, inIt);
+        return true;
     }
     return false;
 }
@@ -703,13 +707,10 @@ static bool intrinsifyTernary(Method& method, TypedInstructionWalker<MethodCall>
     {
         return false;
     }
-    for(const auto& pair : ternaryIntrinsicMapping)
+    if(auto intrinsic = findIntrinsic(ternaryIntrinsicMapping, callSite.methodName))
     {
-        if(callSite.methodName.find(pair.first) != std::string::npos)
-        {
-            pair.second.func(method, it);
-            return true;
-        }
+        intrinsic->func(method, it);
+        return true;
     }
     return false;
 }
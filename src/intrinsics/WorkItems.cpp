@@ -685,6 +685,7 @@ static void lowerBarrier(Method& method, InstructionWalker it,
     auto beforeAfterIt = it.copy().previousInMethod();
     auto afterLabel = method.addNewLocal(TYPE_LABEL, "%barrier_after").local();
     it = method.emplaceLabel(it, std::make_unique<BranchLabel>(*afterLabel));
+    it->addDecorations(InstructionDecorations::CONTROL_FLOW_BARRIER);
     it.nextInBlock();
 
     auto skipBarrierLabel = afterLabel;
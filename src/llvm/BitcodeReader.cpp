@@ -8,6 +8,7 @@
 
 #ifdef USE_LLVM_LIBRARY
 
+#include "../Profiler.h"
 #include "../intermediate/IntermediateInstruction.h"
 #include "../intrinsics/Images.h"
 #include "../precompilation/LLVMLibrary.h"
@@ -23,6 +24,7 @@
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Operator.h"
 
+#include <algorithm>
 #include <limits>
 #include <regex>
 #include <system_error>
@@ -77,7 +79,8 @@ LCOV_EXCL_STOP
 
 BitcodeReader::BitcodeReader(const precompilation::TypedCompilationData<SourceType::LLVM_IR_BIN>& inputData)
 {
-    auto tmp = precompilation::loadLLVMModule(inputData, nullptr);
+    // Only the functions reachable from any kernel are parsed, so do not deserialize the bodies of all other functions
+    auto tmp = precompilation::loadLazyLLVMModule(inputData, nullptr);
     context = std::move(tmp.context);
     llvmModule = std::move(tmp.module);
 
@@ -482,6 +485,11 @@ void BitcodeReader::parse(Module& module)
         }
     }
 
+    PROFILE_COUNTER(vc4c::profiler::COUNTER_FRONTEND, "LLVM functions materialized", parsedFunctions.size());
+    PROFILE_COUNTER_SCOPE(vc4c::profiler::COUNTER_FRONTEND, "LLVM functions skipped",
+        static_cast<std::size_t>(std::count_if(functions.begin(), functions.end(),
+            [](const llvm::Function& func) -> bool { return func.isMaterializable(); })));
+
     // map instructions to intermediate representation
     for(auto& method : parsedFunctions)
     {
@@ -676,6 +684,17 @@ Method& BitcodeReader::parseFunction(Module& module, const llvm::Function& func)
     if(it != parsedFunctions.end())
         return *it->second.first;
 
+#if LLVM_LIBRARY_VERSION >= 40
+    if(func.isMaterializable())
+    {
+        // the module was loaded lazily, so the function body is only deserialized now that we actually need it
+        PROFILE_SCOPE(MaterializeLLVMFunction);
+        if(auto error = const_cast<llvm::Function&>(func).materialize())
+            throw CompilationError(CompilationStep::PARSER, "Failed to materialize LLVM function",
+                static_cast<std::string>(func.getName()) + ": " + llvm::toString(std::move(error)));
+    }
+#endif
+
     Method* method = new Method(module);
     module.methods.emplace_back(method);
     parsedFunctions[&func] = std::make_pair(method, LLVMInstructionList{});
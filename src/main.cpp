@@ -12,6 +12,7 @@
 #include "config.h"
 #include "git_commit.h"
 #include "log.h"
+#include "precompilation/FileCache.h"
 #include "precompilation/FrontendCompiler.h"
 #include "tool_paths.h"
 #include "tools.h"
@@ -78,6 +79,9 @@ static void printHelp()
     std::cout << "\t--llvm\t\t\tExplicitely use the LLVM-IR front-end" << std::endl;
     std::cout << "\t--verification-error\tAbort if instruction verification failed" << std::endl;
     std::cout << "\t--no-verification-error\tContinue if instruction verification failed" << std::endl;
+    std::cout << "\t--profile-map=<file>\tWrite the mapping of the machine code to basic blocks and loops into the "
+                 "given file, for profiling with the emulator"
+              << std::endl;
     std::cout << "\tany other option is passed to the pre-compiler" << std::endl;
 
     std::cout << "modes:" << std::endl;
@@ -90,6 +94,11 @@ static void printHelp()
     std::cout << "\t--precompile-stdlib\tPre-compiles the the VC4CLStdLib.h header file given as input "
                  "into the folder specified as output. Ignores all other options except for the logging flags"
               << std::endl;
+
+    std::cout << "environment variables:" << std::endl;
+    std::cout << "\tVC4C_CACHE_DIR\t\tThe directory to store the persistent compilation caches (e.g. precompiled "
+                 "headers) in, defaults to $HOME/.cache/vc4c"
+              << std::endl;
 }
 
 static std::string toVersionString(unsigned version)
@@ -139,6 +148,8 @@ static void printInfo()
         std::cout << err.what() << std::endl;
     }
 
+    std::cout << "Cache location: " << precompilation::getCacheDirectory() << '\n' << std::endl;
+
     std::cout << "Tool locations:" << std::endl;
     for(const auto& tool : std::vector<FrontendTool>{
             CLANG_TOOL, SPIRV_LLVM_SPIRV_TOOL, LLVM_LINK_TOOL, LLVM_DIS_TOOL, LLVM_AS_TOOL, SPIRV_LINK_TOOL})
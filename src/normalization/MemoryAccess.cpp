@@ -10,6 +10,7 @@
 #include "../InstructionWalker.h"
 #include "../Module.h"
 #include "../Profiler.h"
+#include "../analysis/MemoryAnalysis.h"
 #include "../intermediate/IntermediateInstruction.h"
 #include "../intermediate/operators.h"
 #include "../optimization/Optimizer.h"
@@ -397,8 +398,27 @@ void normalization::mapMemoryAccess(const Module& module, Method& method, const
         // gather more information about the memory areas and modify the access types. E.g. if the preferred access type
         // cannot be used, use the fall-back
         infos.reserve(memoryAccessInfo.memoryAccesses.size());
+        // Memory lowered into VPM only occupies its VPM rows while it is in use. Allocating the VPM areas in the order
+        // of the start of their live ranges (like greedy interval graph coloring) allows areas used in disjoint parts
+        // of the kernel code to share the same VPM rows.
+        std::vector<std::pair<const Local* const, MemoryAccess>*> orderedMappings;
+        orderedMappings.reserve(memoryAccessInfo.memoryAccesses.size());
         for(auto& mapping : memoryAccessInfo.memoryAccesses)
         {
+            if(mapping.second.preferred == MemoryAccessType::VPM_SHARED_ACCESS ||
+                mapping.second.preferred == MemoryAccessType::VPM_PER_QPU)
+                mapping.second.liveRange = analysis::determineVPMLiveRange(method, mapping.second.accessInstructions);
+            orderedMappings.push_back(&mapping);
+        }
+        std::stable_sort(orderedMappings.begin(), orderedMappings.end(),
+            [](const std::pair<const Local* const, MemoryAccess>* one,
+                const std::pair<const Local* const, MemoryAccess>* other) -> bool {
+                return std::make_pair(one->second.liveRange.firstSection, one->second.liveRange.firstBlock) <
+                    std::make_pair(other->second.liveRange.firstSection, other->second.liveRange.firstBlock);
+            });
+        for(auto* mappingEntry : orderedMappings)
+        {
+            auto& mapping = *mappingEntry;
             auto it = infos.emplace(mapping.first, checkMemoryMapping(method, mapping.first, mapping.second)).first;
             CPPLOG_LAZY(logging::Level::DEBUG,
                 log << (it->first->is<Parameter>() ? "Parameter" :
@@ -412,6 +432,23 @@ void normalization::mapMemoryAccess(const Module& module, Method& method, const
                 localsCachedInVPM.emplace(it->first, CacheMemoryData{&it->second, false, false});
                 it->second.type = MemoryAccessType::VPM_SHARED_ACCESS;
             }
+            else if(allowVPMCaching && it->second.type == MemoryAccessType::RAM_LOAD_TMU &&
+                mapping.second.canBeCachedInVPM)
+            {
+                // frequently read constant memory is loaded once into VPM (per work-group) and then read from there
+                auto numElements = analysis::determineCacheableReadOnlyElements(
+                    method, it->first, mapping.second.accessInstructions);
+                auto elementType = it->first->type.getElementType().getElementType();
+                if(auto area = numElements ? method.vpm->addCacheArea(*it->first, elementType, *numElements) : nullptr)
+                {
+                    CPPLOG_LAZY(logging::Level::DEBUG,
+                        log << "Constant memory '" << it->first->to_string() << "' will be cached in "
+                            << area->to_string() << logging::endl);
+                    it->second.type = MemoryAccessType::VPM_SHARED_ACCESS;
+                    it->second.area = area;
+                    localsCachedInVPM.emplace(it->first, CacheMemoryData{&it->second, true, false});
+                }
+            }
             // TODO if we disallow the caching, the VPM cache rows are still allocated!
         }
     }
@@ -1276,7 +1276,7 @@ static MemoryInfo canLowerToSharedVPMArea(Method& method, const Local* baseAddr,
     {
         if(!access.ranges)
             access.ranges = analysis::determineAccessRanges(method, baseAddr, access.accessInstructions);
-        if(auto area = method.vpm->addSharedArea(*baseAddr, access.ranges.value()))
+        if(auto area = method.vpm->addSharedArea(*baseAddr, access.ranges.value(), access.liveRange))
             return toSharedVPMArea(baseAddr, area, {}, convertSmallArrayToRegister(baseAddr));
     }
 
@@ -982,6 +982,64 @@ static InstructionWalker mapMemoryCopy(Method& method, InstructionWalker it, Mem
     }
 }
 
+// the maximum number of VPM rows to be loaded by a single DMA read, see VPM#getMaxCacheVectors()
+static constexpr unsigned MAX_CACHE_LOAD_ROWS = 15;
+
+static InstructionWalker insertCachedMemoryAddress(
+    Method& method, InstructionWalker it, const Local* memoryArea, const MemoryInfo* info, Value& memoryAddress)
+{
+    if(!info->ranges)
+    {
+        // the whole memory area is cached
+        memoryAddress = memoryArea->createReference();
+        return it;
+    }
+
+    // the address is the work-group constant offset to the base address!
+    auto memoryOffset = method.addNewLocal(memoryArea->type, "%cache_uniform_offset");
+    std::vector<MemoryAccessRange> tmpRanges = info->ranges.value();
+    auto tmp = analysis::checkWorkGroupUniformParts(tmpRanges);
+    if(!tmp)
+        throw CompilationError(CompilationStep::NORMALIZER,
+            "Cannot insert cache synchronization code for cached local with different work-group uniform parts",
+            memoryArea->to_string());
+    it = insertAddressToWorkGroupUniformOffset(it, method, memoryOffset, tmpRanges.at(0));
+    // TODO add checks whether the ranges/limits/types are all acceptable 8e.g. in range)!
+    memoryAddress = assign(it, memoryArea->type, "%cache_base_address") = memoryArea->createReference() + memoryOffset;
+    return it;
+}
+
+static InstructionWalker insertPreloadCode(
+    Method& method, InstructionWalker it, const Local* memoryArea, const MemoryInfo* info)
+{
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Inserting code to pre-load data cached in VPM area '" << info->area->to_string()
+            << "' from: " << memoryArea->to_string() << logging::endl);
+
+    // Since this code is only executed for the first work-item while the rest is blocked, we do not have to use the
+    // mutex.
+    Value memoryAddress = UNDEFINED_VALUE;
+    it = insertCachedMemoryAddress(method, it, memoryArea, info, memoryAddress);
+
+    // every element is stored in its own VPM row, so we can load the whole area row by row
+    const auto& area = *info->area;
+    auto elementWidth = area.elementType.getInMemoryWidth();
+    for(unsigned rowOffset = 0; rowOffset < area.numRows; rowOffset += MAX_CACHE_LOAD_ROWS)
+    {
+        auto numRows = std::min(MAX_CACHE_LOAD_ROWS, area.numRows - rowOffset);
+        Value inAreaOffset = INT_ZERO;
+        Value address = memoryAddress;
+        if(rowOffset != 0)
+        {
+            inAreaOffset = Value(Literal(rowOffset * elementWidth), TYPE_INT32);
+            address = assign(it, memoryAddress.type, "%cache_load_address") = memoryAddress + inAreaOffset;
+        }
+        it = method.vpm->insertReadRAM(method, it, address, area.elementType, area, false /* no mutex required */,
+            inAreaOffset, Value(Literal(numRows), TYPE_INT32));
+    }
+    return it;
+}
+
 static InstructionWalker insertWriteBackCode(
     Method& method, InstructionWalker it, const Local* memoryArea, const MemoryInfo* info)
 {
@@ -994,19 +1052,9 @@ static InstructionWalker insertWriteBackCode(
     // Since this code is only executed for the first work-item while the rest is blocked, we do not have to use the
     // mutex.
 
-    // the address is the work-group constant offset to the base address!
-    auto memoryOffset = method.addNewLocal(memoryArea->type, "%cache_uniform_offset");
-    std::vector<MemoryAccessRange> tmpRanges = info->ranges.value();
-    auto tmp = analysis::checkWorkGroupUniformParts(tmpRanges);
-    if(!tmp)
-        throw CompilationError(CompilationStep::NORMALIZER,
-            "Cannot insert write-back code for cached local with different work-group uniform parts",
-            memoryArea->to_string());
-    it = insertAddressToWorkGroupUniformOffset(it, method, memoryOffset, tmpRanges.at(0));
     // TODO how to get number and type of elements? E.g. for char8 per row, don't write upper garbage of rows...
-    // TODO add checks whether the ranges/limits/types are all acceptable 8e.g. in range)!
-    auto memoryAddress = assign(it, memoryArea->type, "%cache_base_address") =
-        memoryArea->createReference() + memoryOffset;
+    Value memoryAddress = UNDEFINED_VALUE;
+    it = insertCachedMemoryAddress(method, it, memoryArea, info, memoryAddress);
     Value numEntries = UNDEFINED_VALUE;
     {
         // FIXME this is only correct if every work-item writes a single entry. tmp.second only lists the maximum number
@@ -1043,6 +1091,21 @@ static InstructionWalker insertWriteBackCode(
 void normalization::insertCacheSynchronizationCode(
     Method& method, const FastMap<const Local*, CacheMemoryData>& cachedLocals)
 {
+    if(std::any_of(cachedLocals.begin(), cachedLocals.end(),
+           [](const auto& cacheEntry) -> bool { return cacheEntry.second.insertPreload; }))
+    {
+        // insert control-flow barrier at beginning of kernel with cache pre-load code
+        auto it = method.walkAllInstructions().nextInBlock();
+        intrinsics::insertControlFlowBarrier(method, it, [&](InstructionWalker blockIt) -> InstructionWalker {
+            for(const auto& entry : cachedLocals)
+            {
+                if(entry.second.insertPreload)
+                    blockIt = insertPreloadCode(method, blockIt, entry.first, entry.second.info);
+            }
+            return blockIt;
+        });
+        method.flags = add_flag(method.flags, MethodFlags::LEADING_CONTROL_FLOW_BARRIER);
+    }
     if(std::any_of(cachedLocals.begin(), cachedLocals.end(),
            [](const auto& cacheEntry) -> bool { return cacheEntry.second.insertWriteBack; }))
     {
@@ -1054,7 +1117,10 @@ void normalization::insertCacheSynchronizationCode(
         it.nextInBlock();
         intrinsics::insertControlFlowBarrier(method, it, [&](InstructionWalker blockIt) -> InstructionWalker {
             for(const auto& entry : cachedLocals)
-                blockIt = insertWriteBackCode(method, blockIt, entry.first, entry.second.info);
+            {
+                if(entry.second.insertWriteBack)
+                    blockIt = insertWriteBackCode(method, blockIt, entry.first, entry.second.info);
+            }
             return blockIt;
         });
         intermediate::redirectAllBranches(*lastBlock, *newBlock);
@@ -7,16 +7,12 @@
 #ifndef VC4C_NORMALIZATION_MEMORY_MAPPING_H
 #define VC4C_NORMALIZATION_MEMORY_MAPPING_H
 
+#include "../periphery/VPM.h"
 #include "../tools/SmallSet.h"
 #include "AddressCalculation.h"
 
 namespace vc4c
 {
-    namespace periphery
-    {
-        struct VPMArea;
-    } // namespace periphery
-
     namespace normalization
     {
         /*
@@ -57,11 +53,16 @@ namespace vc4c
             MemoryAccessType fallback;
             /**
              * Whether the associated memory area can be cached in VPM at all. This flag is only valid for the
-             * RAM_READ_WRITE_VPM access type.
+             * RAM_READ_WRITE_VPM and RAM_LOAD_TMU access types.
              */
             bool canBeCachedInVPM = true;
 
             Optional<std::vector<MemoryAccessRange>> ranges;
+            /**
+             * The part of the kernel code in which the memory area is in use, if it is lowered into VPM. Defaults to
+             * the whole kernel.
+             */
+            periphery::VPMLiveRange liveRange;
         };
 
         using GroupedAccessRanges =
@@ -130,6 +131,9 @@ namespace vc4c
             const tools::SmallSortedPointerSet<const MemoryInfo*>& srcInfos,
             const tools::SmallSortedPointerSet<const MemoryInfo*>& destInfos);
 
+        /*
+         * Information about a memory area located in RAM, but cached in a VPM area
+         */
         struct CacheMemoryData
         {
             const MemoryInfo* info;
@@ -137,6 +141,12 @@ namespace vc4c
             bool insertWriteBack;
         };
 
+        /*
+         * Inserts the code to load the cached memory areas into VPM at the beginning of the kernel and to write them
+         * back to RAM at the end of the kernel.
+         *
+         * The pre-loading and write-back is executed by the first work-item only, guarded by control flow barriers.
+         */
         void insertCacheSynchronizationCode(Method& method, const FastMap<const Local*, CacheMemoryData>& cachedLocals);
     } // namespace normalization
 } // namespace vc4c
@@ -19,6 +19,7 @@
 #include "log.h"
 
 #include <algorithm>
+#include <array>
 #include <map>
 #include <queue>
 #include <set>
@@ -586,6 +587,230 @@ std::size_t optimizations::mergeAdjacentBasicBlocks(const Module& module, Method
     return blocksToMerge.size();
 }
 
+// every branch costs the branch instruction itself and its 3 delay slots, independent of whether it is taken
+static constexpr unsigned BRANCH_CYCLES = 4;
+
+/*
+ * Returns the number of instructions of the given conditional block, if all its instructions can be executed
+ * conditionally without changing the behavior and the block only continues with the given successor
+ */
+static Optional<unsigned> countConditionalInstructions(BasicBlock& block, const BasicBlock& successor)
+{
+    unsigned numInstructions = 0;
+    auto it = block.walk().nextInBlock();
+    while(!it.isEndOfBlock())
+    {
+        if(auto branch = it.get<const Branch>())
+        {
+            if(!branch->isUnconditional() || branch->getSingleTargetLabel() != successor.getLabel()->getLabel() ||
+                !it.copy().nextInBlock().isEndOfBlock())
+                return {};
+        }
+        else
+        {
+            auto inst = it.get<const ExtendedInstruction>();
+            // we cannot execute instructions conditionally which are already conditional or which modify anything
+            // but their local output, e.g. the flags, memory or hardware registers
+            if(!inst || inst->hasConditionalExecution() || inst->hasSideEffects() || !inst->checkOutputLocal())
+                return {};
+            // the flags for the conditional execution are set via the replication register (r5), which is
+            // therefore overwritten
+            if(inst->readsRegister(REG_ACC5) || inst->readsRegister(REG_REPLICATE_ALL) ||
+                inst->readsRegister(REG_REPLICATE_QUAD))
+                return {};
+            ++numInstructions;
+        }
+        it.nextInBlock();
+    }
+    return numInstructions;
+}
+
+static BasicBlock* getNextBlock(Method& method, const BasicBlock& block)
+{
+    auto it = std::find_if(method.begin(), method.end(), [&](const BasicBlock& bb) -> bool { return &bb == &block; });
+    return it != method.end() && ++it != method.end() ? &(*it) : nullptr;
+}
+
+static bool endsWithBranch(BasicBlock& block)
+{
+    auto it = block.walkEnd().previousInBlock();
+    return !it.isStartOfBlock() && it.get<const Branch>();
+}
+
+/*
+ * Tries to convert the conditional blocks (if-else or if without else) branched to at the end of the given block into
+ * conditional execution in the given block.
+ */
+static bool convertConditionalBlocks(Method& method, BasicBlock& header)
+{
+    auto& graph = method.getCFG();
+    // 1. find the successors for the branch condition being true and false
+    BasicBlock* trueSuccessor = nullptr;
+    BasicBlock* falseSuccessor = nullptr;
+    auto branchIt = header.walkEnd();
+    while(!branchIt.copy().previousInBlock().isStartOfBlock() && branchIt.copy().previousInBlock().get<Branch>())
+    {
+        branchIt.previousInBlock();
+        auto branch = branchIt.get<const Branch>();
+        auto target = branch->getSingleTargetLabel() ? method.findBasicBlock(branch->getSingleTargetLabel()) : nullptr;
+        // as created by intermediate#insertBranchCondition(), see also the documentation there
+        if(target && branch->branchCondition == BRANCH_ALL_Z_CLEAR && !trueSuccessor)
+            trueSuccessor = target;
+        else if(target && branch->branchCondition == BRANCH_ANY_Z_SET && !falseSuccessor)
+            falseSuccessor = target;
+        else
+            return false;
+    }
+    if(!trueSuccessor && !falseSuccessor)
+        return false;
+    bool isTrueBranchExplicit = trueSuccessor != nullptr;
+    bool isFalseBranchExplicit = falseSuccessor != nullptr;
+    if(!trueSuccessor || !falseSuccessor)
+    {
+        // the other successor is executed by falling through to the next block
+        auto next = header.fallsThroughToNextBlock() ? getNextBlock(method, header) : nullptr;
+        if(!next)
+            return false;
+        (trueSuccessor ? falseSuccessor : trueSuccessor) = next;
+    }
+    if(trueSuccessor == falseSuccessor || trueSuccessor == &header || falseSuccessor == &header)
+        return false;
+
+    auto setterIt = header.findLastSettingOfFlags(branchIt);
+    auto condition = intermediate::getBranchCondition(setterIt ? setterIt->get<const ExtendedInstruction>() : nullptr);
+    if(!condition.first || condition.second != 0x1)
+        // we can only handle branches depending on a single element
+        return false;
+
+    // 2. determine whether we have a if-else (diamond) or an if without else (triangle) control flow
+    const auto& headerNode = graph.assertNode(&header);
+    auto getSuccessor = [&](BasicBlock* block) -> BasicBlock* {
+        const auto& node = graph.assertNode(block);
+        auto successor = node.getSinglePredecessor() == &headerNode ? node.getSingleSuccessor() : nullptr;
+        return successor && successor->key != block ? successor->key : nullptr;
+    };
+    auto trueJoin = getSuccessor(trueSuccessor);
+    auto falseJoin = getSuccessor(falseSuccessor);
+    BasicBlock* join = nullptr;
+    // the blocks executed conditionally if the condition is true and false
+    std::array<BasicBlock*, 2> conditionalBlocks{trueSuccessor, falseSuccessor};
+    if(trueJoin && trueJoin == falseJoin)
+        join = trueJoin;
+    else if(trueJoin == falseSuccessor)
+    {
+        join = falseSuccessor;
+        conditionalBlocks[1] = nullptr;
+    }
+    else if(falseJoin == trueSuccessor)
+    {
+        join = trueSuccessor;
+        conditionalBlocks[0] = nullptr;
+    }
+    if(!join || join == &header)
+        return false;
+
+    // 3. compare the cycles of executing all conditional blocks vs. branching over the longer path
+    unsigned numConditionalInstructions = 0;
+    unsigned numBranchingCycles = 0;
+    unsigned numHeaderBranches = (isTrueBranchExplicit ? 1u : 0u) + (isFalseBranchExplicit ? 1u : 0u);
+    for(std::size_t i = 0; i < conditionalBlocks.size(); ++i)
+    {
+        unsigned pathCycles = numHeaderBranches * BRANCH_CYCLES;
+        if(auto block = conditionalBlocks[i])
+        {
+            auto numInstructions = countConditionalInstructions(*block, *join);
+            if(!numInstructions)
+                return false;
+            numConditionalInstructions += *numInstructions;
+            pathCycles += *numInstructions + (endsWithBranch(*block) ? BRANCH_CYCLES : 0);
+        }
+        numBranchingCycles = std::max(numBranchingCycles, pathCycles);
+    }
+    // setting the flags for all elements requires an additional replication for non-splat conditions
+    unsigned numSetupCycles = condition.first->isAllSame() ? 1 : 2;
+    if(numConditionalInstructions + numSetupCycles > numBranchingCycles)
+    {
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Skipping conversion of branch to conditional execution, since executing "
+                << numConditionalInstructions << " instructions is more expensive than branching: "
+                << header.to_string() << logging::endl);
+        return false;
+    }
+
+    // 4. move the instructions of the conditional blocks into the header block and execute them conditionally
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Converting branches at the end of '" << header.to_string() << "' to conditional execution of "
+            << numConditionalInstructions << " instructions, saving up to "
+            << (numBranchingCycles - numConditionalInstructions - numSetupCycles) << " cycles" << logging::endl);
+    auto insertIt = branchIt;
+    if(condition.first->isAllSame())
+        assign(insertIt, NOP_REGISTER) = (*condition.first, SetFlag::SET_FLAGS);
+    else
+    {
+        // the branch only depends on the first element, so we need to replicate it to set the flags for all elements
+        assign(insertIt, Value(REG_REPLICATE_ALL, condition.first->type)) = *condition.first;
+        assign(insertIt, NOP_REGISTER) = (Value(REG_REPLICATE_ALL, condition.first->type), SetFlag::SET_FLAGS);
+    }
+    for(std::size_t i = 0; i < conditionalBlocks.size(); ++i)
+    {
+        auto block = conditionalBlocks[i];
+        if(!block)
+            continue;
+        auto cond = i == 0 ? COND_ZERO_CLEAR : COND_ZERO_SET;
+        auto it = block->walk().nextInBlock();
+        while(!it.isEndOfBlock())
+        {
+            if(it.get<const Branch>())
+            {
+                it.erase();
+                continue;
+            }
+            it.get<ExtendedInstruction>()->setCondition(cond);
+            insertIt.emplace(it.release());
+            insertIt.nextInBlock();
+            it.nextInBlock();
+        }
+    }
+    // remove the original branches
+    while(!insertIt.isEndOfBlock())
+        insertIt.erase();
+    for(auto block : conditionalBlocks)
+    {
+        if(block && !method.removeBlock(*block))
+            throw CompilationError(
+                CompilationStep::OPTIMIZER, "Failed to remove converted conditional block", block->to_string());
+    }
+    if(getNextBlock(method, header) != join)
+        header.walkEnd().emplace(std::make_unique<Branch>(join->getLabel()->getLabel()));
+    return true;
+}
+
+std::size_t optimizations::convertToConditionalExecution(
+    const Module& module, Method& method, const Configuration& config)
+{
+    std::size_t numChanges = 0;
+    bool changedBlocks = true;
+    while(changedBlocks)
+    {
+        // converting the conditional blocks removes blocks and might allow further conversions (e.g. for nested
+        // conditional blocks), so start again after every conversion
+        changedBlocks = false;
+        for(auto& block : method)
+        {
+            if(convertConditionalBlocks(method, block))
+            {
+                ++numChanges;
+                changedBlocks = true;
+                break;
+            }
+        }
+    }
+    if(numChanges > 0)
+        PROFILE_COUNTER(
+            vc4c::profiler::COUNTER_OPTIMIZATION, "Branches converted to conditional execution", numChanges);
+    return numChanges;
+}
+
 using BasicBlockIterator = decltype(std::declval<Method>().begin());
 
 static std::size_t reorderNode(Method& method, const DominatorTreeNode& node,
@@ -747,26 +972,58 @@ NODISCARD static bool moveGroupIdInitializers(Method& method, BasicBlock& defaul
     return groupIdsOnlyRead;
 }
 
+/*
+ * Returns the position directly after the last UNIFORM read before the UNIFORM pointer is changed for the first time in
+ * the given block
+ */
+static InstructionWalker findEndOfUniformReads(BasicBlock& block)
+{
+    auto insertIt = block.walk().nextInBlock();
+    for(auto it = insertIt; !it.isEndOfBlock(); it.nextInBlock())
+    {
+        if(!it.has())
+            continue;
+        if(it->writesRegister(REG_UNIFORM_ADDRESS))
+            break;
+        if(it->readsRegister(REG_UNIFORM))
+            insertIt = it.copy().nextInBlock();
+    }
+    return insertIt;
+}
+
 // After the main kernel code executed, insert a block which
 // - reads uniform address
 // - reads maximum values for all group id dimensions
 // - resets uniform pointer to previously read address
-NODISCARD static InstructionWalker insertAddressResetBlock(
-    Method& method, InstructionWalker it, const Value& maxGroupIdX, const Value& maxGroupIdY, const Value& maxGroupIdZ)
+NODISCARD static InstructionWalker insertAddressResetBlock(Method& method, InstructionWalker it,
+    BasicBlock& defaultBlock, const Value& maxGroupIdX, const Value& maxGroupIdY, const Value& maxGroupIdZ)
 {
+    // If the kernel code redirects the UNIFORM pointer (e.g. for texture lookups), the trailing UNIFORMs can no longer
+    // be read after the kernel code, so read them directly after the kernel parameters instead.
+    bool redirectsUniforms = false;
+    for(auto checkIt = method.walkAllInstructions(); !checkIt.isEndOfMethod(); checkIt.nextInMethod())
+    {
+        if(checkIt.has() && checkIt->writesRegister(REG_UNIFORM_ADDRESS))
+        {
+            redirectsUniforms = true;
+            break;
+        }
+    }
+
     it = method.emplaceLabel(
         it, std::make_unique<BranchLabel>(*method.addNewLocal(TYPE_LABEL, "", "%work_group_repetition").local()));
 
     // insert after label, not before
     it.nextInBlock();
 
+    auto readIt = redirectsUniforms ? findEndOfUniformReads(defaultBlock) : it;
     // NOTE: This is NOT work-group uniform, since every QPU has its own UNIFORM values (e.g. for local ID)
-    auto tmp = assign(it, TYPE_INT32) = (UNIFORM_REGISTER, InstructionDecorations::IDENTICAL_ELEMENTS);
+    auto tmp = assign(readIt, TYPE_INT32) = (UNIFORM_REGISTER, InstructionDecorations::IDENTICAL_ELEMENTS);
     auto decorations =
         add_flag(InstructionDecorations::WORK_GROUP_UNIFORM_VALUE, InstructionDecorations::IDENTICAL_ELEMENTS);
-    assign(it, maxGroupIdX) = (UNIFORM_REGISTER, decorations);
-    assign(it, maxGroupIdY) = (UNIFORM_REGISTER, decorations);
-    assign(it, maxGroupIdZ) = (UNIFORM_REGISTER, decorations);
+    assign(readIt, maxGroupIdX) = (UNIFORM_REGISTER, decorations);
+    assign(readIt, maxGroupIdY) = (UNIFORM_REGISTER, decorations);
+    assign(readIt, maxGroupIdZ) = (UNIFORM_REGISTER, decorations);
     assign(it, Value(REG_UNIFORM_ADDRESS, TYPE_INT32)) = (tmp, InstructionDecorations::IDENTICAL_ELEMENTS);
     return it;
 }
@@ -835,15 +1092,14 @@ NODISCARD static InstructionWalker insertSingleDimensionRepetitionBlock(Method&
     return it;
 }
 
-static void insertRepetitionBlocks(
-    Method& method, const BasicBlock& defaultBlock, BasicBlock& lastBlock, bool mergeGroupIds)
+static void insertRepetitionBlocks(Method& method, BasicBlock& defaultBlock, BasicBlock& lastBlock, bool mergeGroupIds)
 {
     auto maxGroupIdX = method.findOrCreateBuiltin(BuiltinLocal::Type::MAX_GROUP_ID_X)->createReference();
     auto maxGroupIdY = method.findOrCreateBuiltin(BuiltinLocal::Type::MAX_GROUP_ID_Y)->createReference();
     auto maxGroupIdZ = method.findOrCreateBuiltin(BuiltinLocal::Type::MAX_GROUP_ID_Z)->createReference();
 
     auto it = lastBlock.walk();
-    it = insertAddressResetBlock(method, it, maxGroupIdX, maxGroupIdY, maxGroupIdZ);
+    it = insertAddressResetBlock(method, it, defaultBlock, maxGroupIdX, maxGroupIdY, maxGroupIdZ);
 
     auto groupIdX = method.findOrCreateBuiltin(BuiltinLocal::Type::GROUP_ID_X)->createReference();
     it = insertSingleDimensionRepetitionBlock(method, defaultBlock, groupIdX, maxGroupIdX, it, nullptr,
@@ -913,10 +1169,10 @@ static bool insertSynchronizationBlock(Method& method, BasicBlock& lastBlock)
         return false;
     }
 
-    if(method.metaData.getFixedWorkGroupSize() == 1u)
+    if(method.metaData.getMaximumInstancesCount() == 1u)
     {
-        // Only a single work-item (per work-group), so no need to synchronize, since all work-items/work-groups are
-        // guaranteed to be executed serially.
+        // Only a single work-item (or all work-items merged into a single execution) per work-group, so no need to
+        // synchronize, since all work-items/work-groups are guaranteed to be executed serially.
         CPPLOG_LAZY(logging::Level::DEBUG,
             log << "Skipping work-item synchronization block due to single work-item per work-group!" << logging::endl);
         return false;
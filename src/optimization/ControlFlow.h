@@ -52,6 +52,33 @@ namespace vc4c
          */
         std::size_t mergeAdjacentBasicBlocks(const Module& module, Method& method, const Configuration& config);
 
+        /*
+         * Converts short conditional blocks without side-effects (if-else and if without else) into conditional
+         * execution of their instructions, if executing the instructions of all conditional blocks is cheaper than
+         * the branches (each branch costs 4 cycles including its delay slots).
+         *
+         * Example:
+         *   - = %cond | elem_num (setf)
+         *   br.ifallzc %then
+         *   br.ifanyzs %else
+         *   label: %then
+         *   %a = %b
+         *   br %join
+         *   label: %else
+         *   %a = %c
+         *   label: %join
+         *
+         * is converted to:
+         *   - = %cond | elem_num (setf)
+         *   - = %cond (setf)
+         *   %a = %b (ifzc)
+         *   %a = %c (ifz)
+         *   label: %join
+         *
+         * NOTE: The header and the join block are merged afterwards by #mergeAdjacentBasicBlocks, if possible.
+         */
+        std::size_t convertToConditionalExecution(const Module& module, Method& method, const Configuration& config);
+
         /*
          * Reorders basic blocks so as much transitions as possible can be replaced by implicit transitions in
          * #simplifyBranches.
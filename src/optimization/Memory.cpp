@@ -1374,17 +1374,78 @@ std::size_t optimizations::groupTMUAccess(const Module& module, Method& method,
     return numChanges;
 }
 
-struct TMULoadOffset
+/*
+ * An address accessed within a loop, which is calculated from a loop-invariant base address and an offset depending on
+ * an induction variable of the loop
+ */
+struct LoopAddressOffset
 {
     const Local* baseLocal;
     analysis::InductionVariable inductionVariable;
     SubExpression offsetExpression;
 };
 
-static FastMap<TypedInstructionWalker<intermediate::RAMAccessInstruction>, TMULoadOffset> findTMULoadsInLoop(
+static Optional<LoopAddressOffset> findInductionVariableAddress(const Value& address,
+    const FastAccessList<analysis::InductionVariable>& inductionVariables, const Local* globalDataAddress)
+{
+    auto addressWriter = address.getSingleWriter();
+    if(!addressWriter)
+        return {};
+
+    auto expr = Expression::createRecursiveExpression(*addressWriter);
+    if(!expr || expr->code != OP_ADD)
+        return {};
+
+    const Local* baseLocal = nullptr;
+    SubExpression addressOffset{};
+    auto leftLocal = expr->arg0.checkLocal(true);
+    if(leftLocal && (leftLocal->residesInMemory() || leftLocal == globalDataAddress))
+    {
+        baseLocal = leftLocal;
+        addressOffset = expr->arg1;
+    }
+    auto rightLocal = expr->arg1.checkLocal(true);
+    if(rightLocal && (rightLocal->residesInMemory() || rightLocal == globalDataAddress))
+    {
+        baseLocal = rightLocal;
+        addressOffset = expr->arg0;
+    }
+
+    // TODO allow also for base address + offset + induction-variable depending offset
+    // does this allow for any more hits??
+
+    if(!baseLocal)
+        return {};
+
+    const analysis::InductionVariable* matchingInductionVar = nullptr;
+
+    if(auto offsetLoc = addressOffset.checkLocal())
+    {
+        auto varIt = std::find_if(inductionVariables.begin(), inductionVariables.end(),
+            [&](const analysis::InductionVariable& var) -> bool { return var.local == offsetLoc; });
+        if(varIt != inductionVariables.end())
+            matchingInductionVar = &(*varIt);
+    }
+    else if(auto offsetExpr = addressOffset.checkExpression())
+    {
+        auto varIt = std::find_if(inductionVariables.begin(), inductionVariables.end(),
+            [&](const analysis::InductionVariable& var) -> bool {
+                return (var.local == offsetExpr->arg0.checkLocal(true) && offsetExpr->arg1.getConstantExpression()) ||
+                    (var.local == offsetExpr->arg1.checkLocal(true) && offsetExpr->arg0.getConstantExpression());
+            });
+        if(varIt != inductionVariables.end())
+            matchingInductionVar = &(*varIt);
+    }
+
+    if(!matchingInductionVar)
+        return {};
+    return LoopAddressOffset{baseLocal, *matchingInductionVar, addressOffset};
+}
+
+static FastMap<TypedInstructionWalker<intermediate::RAMAccessInstruction>, LoopAddressOffset> findTMULoadsInLoop(
     const analysis::ControlFlowLoop& loop, Method& method, const analysis::DataDependencyGraph& dependencyGraph)
 {
-    std::array<FastMap<TypedInstructionWalker<intermediate::RAMAccessInstruction>, TMULoadOffset>, 2>
+    std::array<FastMap<TypedInstructionWalker<intermediate::RAMAccessInstruction>, LoopAddressOffset>, 2>
         relevantTMULoads{};
     std::array<unsigned, 2> numTMULoads{};
     auto inductionVariables = loop.findInductionVariables(dependencyGraph, false);
@@ -1399,68 +1460,24 @@ static FastMap<TypedInstructionWalker<intermediate::RAMAccessInstruction>, TMULo
                 auto cacheEntry = ramAccess->getTMUCacheEntry();
                 ++numTMULoads[cacheEntry->getTMUIndex()];
 
-                auto addressWriter = ramAccess->getMemoryAddress().getSingleWriter();
-                if(!addressWriter)
-                    continue;
-
-                auto expr = Expression::createRecursiveExpression(*addressWriter);
-                if(!expr || expr->code != OP_ADD)
-                    continue;
-
-                const Local* baseLocal = nullptr;
-                SubExpression addressOffset{};
-                auto leftLocal = expr->arg0.checkLocal(true);
-                if(leftLocal && (leftLocal->residesInMemory() || leftLocal == globalDataAddress))
-                {
-                    baseLocal = leftLocal;
-                    addressOffset = expr->arg1;
-                }
-                auto rightLocal = expr->arg1.checkLocal(true);
-                if(rightLocal && (rightLocal->residesInMemory() || rightLocal == globalDataAddress))
-                {
-                    baseLocal = rightLocal;
-                    addressOffset = expr->arg0;
-                }
-
-                // TODO allow also for base address + offset + induction-variable depending offset
-                // does this allow for any more hits??
-
-                if(!baseLocal)
-                    continue;
-
-                const analysis::InductionVariable* matchingInductionVar = nullptr;
-
-                if(auto offsetLoc = addressOffset.checkLocal())
-                {
-                    auto varIt = std::find_if(inductionVariables.begin(), inductionVariables.end(),
-                        [&](const analysis::InductionVariable& var) -> bool { return var.local == offsetLoc; });
-                    if(varIt != inductionVariables.end())
-                        matchingInductionVar = &(*varIt);
-                }
-                else if(auto offsetExpr = addressOffset.checkExpression())
-                {
-                    auto varIt = std::find_if(inductionVariables.begin(), inductionVariables.end(),
-                        [&](const analysis::InductionVariable& var) -> bool {
-                            return (var.local == offsetExpr->arg0.checkLocal(true) &&
-                                       offsetExpr->arg1.getConstantExpression()) ||
-                                (var.local == offsetExpr->arg1.checkLocal(true) &&
-                                    offsetExpr->arg0.getConstantExpression());
-                        });
-                    if(varIt != inductionVariables.end())
-                        matchingInductionVar = &(*varIt);
-                }
-
-                if(!matchingInductionVar)
+                auto addressOffset =
+                    findInductionVariableAddress(ramAccess->getMemoryAddress(), inductionVariables, globalDataAddress);
+                if(!addressOffset)
                     continue;
 
                 CPPLOG_LAZY(logging::Level::DEBUG,
-                    log << "Found TMU RAM address derived from induction variable with base '" << baseLocal->to_string()
-                        << "' and offset: " << addressOffset.to_string() << " (induction variable: "
-                        << matchingInductionVar->local->to_string() << ')' << logging::endl);
+                    log << "Found TMU RAM address derived from induction variable with base '"
+                        << addressOffset->baseLocal->to_string()
+                        << "' and offset: " << addressOffset->offsetExpression.to_string() << " (induction variable: "
+                        << addressOffset->inductionVariable.local->to_string() << ')' << logging::endl);
 
-                relevantTMULoads[cacheEntry->getTMUIndex()].emplace(
-                    typeSafe(it, *ramAccess), TMULoadOffset{baseLocal, *matchingInductionVar, addressOffset});
+                relevantTMULoads[cacheEntry->getTMUIndex()].emplace(typeSafe(it, *ramAccess), *addressOffset);
             }
+            else if(it.has() && it->writesRegister(REG_TMU0_COORD_S_U_X))
+                // direct TMU lookups (e.g. texture lookups) also use the TMU FIFO
+                ++numTMULoads[0];
+            else if(it.has() && it->writesRegister(REG_TMU1_COORD_S_U_X))
+                ++numTMULoads[1];
         }
     }
 
@@ -1471,7 +1488,7 @@ static FastMap<TypedInstructionWalker<intermediate::RAMAccessInstruction>, TMULo
     if(numTMULoads[0] + numTMULoads[1] != 1)
         return {};
 
-    FastMap<TypedInstructionWalker<intermediate::RAMAccessInstruction>, TMULoadOffset> result;
+    FastMap<TypedInstructionWalker<intermediate::RAMAccessInstruction>, LoopAddressOffset> result;
     result.insert(relevantTMULoads[0].begin(), relevantTMULoads[0].end());
     result.insert(relevantTMULoads[1].begin(), relevantTMULoads[1].end());
 
@@ -1500,6 +1517,62 @@ static Value calculateAddress(InstructionWalker& it, const analysis::InductionVa
     return assign(it, addressType, "%prefetch_tmu_address") = (baseLocal->createReference() + tmpOffset);
 }
 
+/*
+ * Inserts the calculation of the address accessed in the first loop iteration after the initial assignment of the
+ * induction variable the given walker points to and moves the walker after the inserted instructions
+ */
+static Value insertFirstIterationAddress(
+    Method& method, InstructionWalker& it, const LoopAddressOffset& address, DataType addressType)
+{
+    auto assignmentInst = it.get<intermediate::ExtendedInstruction>();
+    it.nextInBlock();
+    if(assignmentInst && assignmentInst->hasConditionalExecution())
+    {
+        /*
+         * In some cases where the loop might be skipped completely, the induction variable is only written
+         * conditionally (if the loop will be taken).
+         *
+         * To make sure the address offset is written unconditionally (since we cannot conditionally read from
+         * memory), insert a dummy offset in case the loop is not entered.
+         */
+        if(auto constant = assignmentInst->getMoveSource() & &Value::getLiteralValue)
+            // if we write a constant value (have no data dependencies) just make the assignment unconditional
+            assignmentInst->setCondition(COND_ALWAYS);
+        else
+            assign(it, address.inductionVariable.local->createReference()) =
+                (INT_ZERO, assignmentInst->getCondition().invert());
+    }
+    return calculateAddress(
+        it, address.inductionVariable, address.offsetExpression, method, addressType, address.baseLocal);
+}
+
+/*
+ * Inserts the calculation of the address accessed in the next loop iteration, where the given branch is the branch
+ * repeating the loop
+ */
+static Value insertNextIterationAddress(Method& method, InstructionWalker& it, InstructionWalker repeatBranch,
+    const BasicBlock& header, const LoopAddressOffset& address, const Value& firstIterationAddress,
+    DataType addressType)
+{
+    auto nextIterationAddress = calculateAddress(
+        it, address.inductionVariable, address.offsetExpression, method, addressType, address.baseLocal);
+    if(auto branch = repeatBranch.get<intermediate::Branch>())
+    {
+        /*
+         * If the loop is not repeated anymore (this is our last iteration), we would prefetch a memory address
+         * which is not intended to be addressed and therefore might not be allocated at all.
+         *
+         * To mitigate this, we re-load the first address instead, if we don't repeat the loop anymore. This memory
+         * address should already be cached and also has already been accessed, so we know we can access it anyway.
+         */
+        auto branchCond = branch->branchCondition;
+        if(branch->getSingleTargetLabel() == header.getLabel()->getLabel())
+            branchCond = branchCond.invert();
+        assign(it, nextIterationAddress) = (firstIterationAddress, branchCond.toConditionCode());
+    }
+    return nextIterationAddress;
+}
+
 NODISCARD static bool prefetchTMULoadsInLoop(const analysis::ControlFlowLoop& loop, Method& method,
     const analysis::DataDependencyGraph& dependencyGraph, const analysis::DominatorTree& dominators)
 {
@@ -1529,47 +1602,16 @@ NODISCARD static bool prefetchTMULoadsInLoop(const analysis::ControlFlowLoop& lo
         auto originalAccess = load.first.get();
 
         // move original TMU RAM load before the loop
-        auto it = initialPrefetchIt->copy().nextInBlock();
-        auto assignmentInst = initialPrefetchIt->get<intermediate::ExtendedInstruction>();
-        if(assignmentInst && assignmentInst->hasConditionalExecution())
-        {
-            /*
-             * In some cases where the loop might be skipped completely, the induction variable is only written
-             * conditionally (if the loop will be taken).
-             *
-             * To make sure the address offset is written unconditionally (since we cannot conditionally read from
-             * memory), insert a dummy offset in case the loop is not entered.
-             */
-            if(auto constant = assignmentInst->getMoveSource() & &Value::getLiteralValue)
-                // if we write a constant value (have no data dependencies) just make the assignment unconditional
-                assignmentInst->setCondition(COND_ALWAYS);
-            else
-                assign(it, load.second.inductionVariable.local->createReference()) =
-                    (INT_ZERO, assignmentInst->getCondition().invert());
-        }
-        auto firstIterationAddress = calculateAddress(it, load.second.inductionVariable, load.second.offsetExpression,
-            method, originalAccess->getMemoryAddress().type, load.second.baseLocal);
+        auto it = *initialPrefetchIt;
+        auto firstIterationAddress =
+            insertFirstIterationAddress(method, it, load.second, originalAccess->getMemoryAddress().type);
         it.emplace(const_cast<TypedInstructionWalker<intermediate::RAMAccessInstruction>&>(load.first).release());
         it.get<intermediate::RAMAccessInstruction>()->setMemoryAddress(firstIterationAddress);
 
         // add instruction prefetching the value for the next iteration into the TMU FIFO
         it = successivePrefetchIt.copy().previousInBlock();
-        auto nextIterationAddress = calculateAddress(it, load.second.inductionVariable, load.second.offsetExpression,
-            method, originalAccess->getMemoryAddress().type, load.second.baseLocal);
-        if(auto branch = successivePrefetchIt.get<intermediate::Branch>())
-        {
-            /*
-             * If the loop is not repeated anymore (this is our last iteration), we would prefetch a memory address
-             * which is not intended to be addressed and therefore might not be allocated at all.
-             *
-             * To mitigate this, we re-load the first address instead, if we don't repeat the loop anymore. This memory
-             * address should already be cached and also has already been accessed, so we know we can access it anyway.
-             */
-            auto branchCond = branch->branchCondition;
-            if(branch->getSingleTargetLabel() == header->key->getLabel()->getLabel())
-                branchCond = branchCond.invert();
-            assign(it, nextIterationAddress) = (firstIterationAddress, branchCond.toConditionCode());
-        }
+        auto nextIterationAddress = insertNextIterationAddress(method, it, successivePrefetchIt, *header->key,
+            load.second, firstIterationAddress, originalAccess->getMemoryAddress().type);
         it.emplace(std::make_unique<intermediate::RAMAccessInstruction>(
             intermediate::MemoryOperation::READ, nextIterationAddress, originalAccess->cache));
 
@@ -1634,7 +1676,7 @@ static bool containsSynchronizationInstruction(const analysis::ControlFlowLoop&
 {
     for(auto block : loop)
     {
-        for(auto it = block->key->walk(); it.isEndOfBlock(); it.nextInBlock())
+        for(auto it = block->key->walk(); !it.isEndOfBlock(); it.nextInBlock())
         {
             if(it.get<intermediate::MemoryBarrier>() || it.get<intermediate::SemaphoreAdjustment>())
                 return true;
@@ -1886,3 +1928,920 @@ std::size_t optimizations::groupLoweredRegisterAccess(const Module& module, Meth
 
     return numChanges;
 }
+
+// the number of bits of the DMA read pitch and write stride setups
+static constexpr uint32_t DMA_PITCH_BITS = 13;
+// checking a pitch only known at run-time costs a few instructions and a branch per group, so require enough rows
+static constexpr std::size_t MIN_DYNAMIC_PITCH_ROWS = 3;
+
+/*
+ * A single row accessed via the VPM scratch area, i.e. a mutex-guarded DMA transfer of a single VPM row between RAM and
+ * a single QPU access of the VPM
+ */
+struct TileRowAccess
+{
+    // the mutex lock, the two memory access instructions (in execution order) and the mutex release
+    std::array<InstructionWalker, 4> instructions;
+    Value address;
+    Value data;
+    DataType type;
+    bool isWrite;
+};
+
+struct TileAccessGroup
+{
+    bool isWrite;
+    FastAccessList<TileRowAccess> rows;
+};
+
+static Optional<TileRowAccess> checkTileRowAccess(InstructionWalker it, const periphery::VPMArea& scratchArea)
+{
+    auto lock = it.get<intermediate::MutexLock>();
+    if(!lock || !lock->locksMutex())
+        return {};
+    TileRowAccess row{{it, it, it, it}, UNDEFINED_VALUE, UNDEFINED_VALUE, TYPE_UNKNOWN, false};
+    for(std::size_t i = 1; i < row.instructions.size(); ++i)
+    {
+        it.nextInBlock();
+        if(it.isEndOfBlock() || !it.has())
+            return {};
+        row.instructions[i] = it;
+    }
+    auto release = row.instructions[3].get<intermediate::MutexLock>();
+    auto firstAccess = row.instructions[1].get<intermediate::MemoryAccessInstruction>();
+    if(!release || !release->releasesMutex() || !firstAccess)
+        return {};
+    const bool isWrite = firstAccess->op == intermediate::MemoryOperation::WRITE;
+    if(!isWrite && firstAccess->op != intermediate::MemoryOperation::READ)
+        return {};
+    // a read transfers RAM -> VPM -> QPU, a write QPU -> VPM -> RAM
+    auto ramAccess = row.instructions[isWrite ? 2 : 1].get<intermediate::RAMAccessInstruction>();
+    auto cacheAccess = row.instructions[isWrite ? 1 : 2].get<intermediate::CacheAccessInstruction>();
+    if(!ramAccess || !cacheAccess || ramAccess->op != firstAccess->op || cacheAccess->op != firstAccess->op ||
+        cacheAccess->upperWord)
+        return {};
+    auto cacheEntry = ramAccess->getVPMCacheEntry();
+    if(!cacheEntry || cacheEntry != cacheAccess->getVPMCacheEntry() || &cacheEntry->area != &scratchArea ||
+        cacheEntry->inAreaByteOffset != INT_ZERO || !cacheEntry->memoryPitch.isUndefined() ||
+        !cacheEntry->memoryElementStride.isUndefined() || !ramAccess->getNumEntries().hasLiteral(1_lit))
+        return {};
+    // the offset of a row in the VPM is calculated by a shift, which requires a power of two row size
+    auto vectorWidth = cacheEntry->getVectorWidth().getLiteralValue();
+    if(!vectorWidth || !isPowerTwo(vectorWidth->unsignedInt()) || cacheEntry->getScalarType().getScalarBitCount() > 32)
+        return {};
+    if(!ramAccess->getMemoryAddress().checkLocal() || !cacheAccess->getData().checkLocal())
+        return {};
+    row.address = ramAccess->getMemoryAddress();
+    row.data = cacheAccess->getData();
+    row.type = cacheEntry->getVectorType();
+    row.isWrite = isWrite;
+    return row;
+}
+
+/*
+ * Checks whether the given instruction located after all the rows of the group allows to move the rows of the group
+ * over it
+ */
+static bool canMoveRowsAcross(const intermediate::IntermediateInstruction& inst, const TileAccessGroup& group)
+{
+    if(inst.hasSideEffects() || dynamic_cast<const intermediate::BranchLabel*>(&inst))
+        return false;
+    for(const auto& row : group.rows)
+    {
+        if(inst.writesLocal(row.address.local()) || inst.writesLocal(row.data.local()))
+            return false;
+        if(!group.isWrite && inst.readsLocal(row.data.local()))
+            // the data read is used before the last row is read
+            return false;
+    }
+    return true;
+}
+
+static bool isIndependentRow(const TileRowAccess& newRow, const TileAccessGroup& group)
+{
+    for(const auto& row : group.rows)
+    {
+        if(newRow.data == row.data || (!group.isWrite && (newRow.address == row.data || newRow.data == row.address)))
+            return false;
+    }
+    return true;
+}
+
+NODISCARD static InstructionWalker findTileAccessGroup(
+    InstructionWalker it, const periphery::VPM& vpm, TileAccessGroup& group)
+{
+    for(; !it.isEndOfBlock(); it.nextInBlock())
+    {
+        if(!it.has())
+            continue;
+        if(auto row = checkTileRowAccess(it, vpm.getScratchArea()))
+        {
+            // the scratch area is sized in 32-bit rows, so also limit the number of rows of smaller types
+            auto maxRows = std::min(vpm.getMaxCacheVectors(row->type, row->isWrite),
+                vpm.getMaxCacheVectors(TYPE_INT32, true));
+            if(!group.rows.empty() && group.isWrite == row->isWrite && group.rows.front().type == row->type &&
+                isIndependentRow(*row, group) && group.rows.size() < maxRows)
+            {
+                group.rows.emplace_back(*row);
+                it = group.rows.back().instructions.back();
+                continue;
+            }
+            if(group.rows.size() > 1)
+                // this row does not fit the group, but might start the next one
+                return it;
+            group.isWrite = row->isWrite;
+            group.rows.clear();
+            group.rows.emplace_back(*row);
+            it = group.rows.back().instructions.back();
+            continue;
+        }
+        if(group.rows.empty() || canMoveRowsAcross(*it.get(), group))
+            continue;
+        if(group.rows.size() > 1)
+            return it.nextInBlock();
+        group.rows.clear();
+    }
+    return it;
+}
+
+/*
+ * Determines the distance between the rows, if it is a compile-time constant
+ */
+static Optional<Literal> determineConstantPitch(const TileAccessGroup& group)
+{
+    Optional<BaseAndOffset> previousBaseAndOffset;
+    Optional<Literal> pitch;
+    for(const auto& row : group.rows)
+    {
+        auto baseAndOffset = findBaseAndOffset(row.address);
+        if(!baseAndOffset || !baseAndOffset->baseAddress)
+            return {};
+        if(previousBaseAndOffset)
+        {
+            if(baseAndOffset->baseAddress != previousBaseAndOffset->baseAddress ||
+                baseAndOffset->dynamicOffset != previousBaseAndOffset->dynamicOffset)
+                return {};
+            auto distance = std::make_shared<Expression>(OP_SUB, baseAndOffset->workGroupConstantOffset,
+                previousBaseAndOffset->workGroupConstantOffset)
+                                ->combineWith({})
+                                ->getConstantExpression() &
+                &Value::getLiteralValue;
+            if(!distance || (pitch && distance != pitch))
+                return {};
+            pitch = distance;
+        }
+        previousBaseAndOffset = baseAndOffset;
+    }
+    return pitch;
+}
+
+static bool isVolatileAccess(const TileAccessGroup& group)
+{
+    return std::any_of(group.rows.begin(), group.rows.end(), [](const TileRowAccess& row) -> bool {
+        auto baseAndOffset = findBaseAndOffset(row.address);
+        if(!baseAndOffset || !baseAndOffset->baseAddress)
+            return false;
+        auto param = baseAndOffset->baseAddress->as<Parameter>();
+        return param && has_flag(param->decorations, ParameterDecorations::VOLATILE);
+    });
+}
+
+static bool readsFlagsAfter(InstructionWalker it)
+{
+    for(; !it.isEndOfBlock(); it.nextInBlock())
+    {
+        if(!it.has())
+            continue;
+        if(it->hasConditionalExecution())
+            return true;
+        if(it->doesSetFlag())
+            break;
+    }
+    return false;
+}
+
+static bool isPitchInRange(int64_t pitch, const TileAccessGroup& group)
+{
+    // for reading, the DMA pitch is the distance from start to start of successive rows (where 0 is not allowed), for
+    // writing the stride is the distance from the end of one row to the start of the next
+    if(group.isWrite)
+        pitch -= static_cast<int64_t>(group.rows.front().type.getInMemoryWidth());
+    else if(pitch == 0)
+        return false;
+    return pitch >= 0 && pitch < (int64_t{1} << DMA_PITCH_BITS);
+}
+
+/*
+ * Inserts the single DMA access of all rows of the group with the given pitch
+ */
+static void insertCoalescedTileAccess(
+    Method& method, InstructionWalker it, const TileAccessGroup& group, const Value& pitch)
+{
+    const auto& scratchArea = method.vpm->getScratchArea();
+    const auto rowType = group.rows.front().type;
+    const auto numRows = static_cast<uint32_t>(group.rows.size());
+    auto ramEntry = std::make_shared<periphery::VPMCacheEntry>(scratchArea, rowType);
+    ramEntry->memoryPitch = pitch;
+    auto ramAccess = std::make_unique<intermediate::RAMAccessInstruction>(group.isWrite ?
+            intermediate::MemoryOperation::WRITE :
+            intermediate::MemoryOperation::READ,
+        group.rows.front().address, ramEntry, Value(Literal(numRows), TYPE_INT32));
+
+    it.emplace(std::make_unique<intermediate::MutexLock>(intermediate::MutexAccess::LOCK));
+    it.nextInBlock();
+    if(!group.isWrite)
+    {
+        it.emplace(std::move(ramAccess));
+        it.nextInBlock();
+    }
+    for(uint32_t i = 0; i < numRows; ++i)
+    {
+        // every row is stored in its own VPM row
+        auto rowOffset = Value(Literal(i * rowType.getInMemoryWidth()), TYPE_INT32);
+        auto cacheEntry = std::make_shared<periphery::VPMCacheEntry>(scratchArea, rowType, rowOffset);
+        it.emplace(std::make_unique<intermediate::CacheAccessInstruction>(group.isWrite ?
+                intermediate::MemoryOperation::WRITE :
+                intermediate::MemoryOperation::READ,
+            group.rows[i].data, cacheEntry));
+        it.nextInBlock();
+    }
+    if(group.isWrite)
+    {
+        it.emplace(std::move(ramAccess));
+        it.nextInBlock();
+    }
+    it.emplace(std::make_unique<intermediate::MutexLock>(intermediate::MutexAccess::RELEASE));
+}
+
+NODISCARD static bool coalesceTileAccess(Method& method, TileAccessGroup& group)
+{
+    if(isVolatileAccess(group))
+        return false;
+    auto constantPitch = determineConstantPitch(group);
+    if(constantPitch && !isPitchInRange(constantPitch->signedInt(), group))
+        return false;
+    auto it = group.rows.back().instructions.back().copy().nextInBlock();
+    if(!constantPitch && (group.rows.size() < MIN_DYNAMIC_PITCH_ROWS || readsFlagsAfter(it)))
+        return false;
+
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Combining " << group.rows.size() << " DMA " << (group.isWrite ? "writes" : "reads")
+            << " of tile rows with " << (constantPitch ? "constant" : "dynamic") << " pitch starting at "
+            << group.rows.front().address.to_string() << " into a single DMA access" << logging::endl);
+
+    // all rows are accessed after the last original access, where all addresses and (for writes) data are available
+    FastAccessList<std::unique_ptr<intermediate::IntermediateInstruction>> originalInstructions;
+    originalInstructions.reserve(group.rows.size() * 4);
+    for(auto& row : group.rows)
+    {
+        for(auto& inst : row.instructions)
+            originalInstructions.emplace_back(inst.release());
+    }
+    method.vpm->updateScratchSize(static_cast<unsigned char>(group.rows.size()));
+
+    if(constantPitch)
+    {
+        insertCoalescedTileAccess(method, it, group, Value(*constantPitch, TYPE_INT32));
+        return true;
+    }
+
+    /*
+     * The pitch is only known at run-time, so check whether all rows have the same distance and the pitch fits into the
+     * DMA setup and select the coalesced or the original accesses:
+     *
+     * mismatch = ((addr1 - addr0) - offset) >> 13 | [(addr1 - addr0) >> 13 |] ((addr2 - addr1) ^ (addr1 - addr0)) | ...
+     * if(mismatch) goto separate else goto coalesced
+     * separate: <original row accesses>, goto after
+     * coalesced: <single DMA access>
+     * after: ...
+     */
+    const auto& rows = group.rows;
+    auto pitch = assign(it, TYPE_INT32, "%tile_pitch") = rows[1].address - rows[0].address;
+    auto pitchOffset = group.isWrite ? Value(Literal(rows.front().type.getInMemoryWidth()), TYPE_INT32) : INT_ONE;
+    auto mismatch = assign(it, TYPE_INT32, "%tile_pitch_mismatch") = pitch - pitchOffset;
+    mismatch = assign(it, TYPE_INT32, "%tile_pitch_mismatch") =
+        as_unsigned{mismatch} >> Value(Literal(DMA_PITCH_BITS), TYPE_INT8);
+    if(!group.isWrite)
+    {
+        // the read pitch needs to be positive (checked above) and fit into the setup itself
+        auto pitchOverflow = assign(it, TYPE_INT32, "%tile_pitch_overflow") =
+            as_unsigned{pitch} >> Value(Literal(DMA_PITCH_BITS), TYPE_INT8);
+        mismatch = assign(it, TYPE_INT32, "%tile_pitch_mismatch") = mismatch | pitchOverflow;
+    }
+    for(std::size_t i = 2; i < rows.size(); ++i)
+    {
+        auto distance = assign(it, TYPE_INT32, "%tile_row_distance") = rows[i].address - rows[i - 1].address;
+        distance = assign(it, TYPE_INT32, "%tile_row_distance") = distance ^ pitch;
+        mismatch = assign(it, TYPE_INT32, "%tile_pitch_mismatch") = mismatch | distance;
+    }
+
+    auto& block = *it.getBasicBlock();
+    auto separateLabel = method.addNewLocal(TYPE_LABEL, "%tile_rows_separate");
+    auto coalescedLabel = method.addNewLocal(TYPE_LABEL, "%tile_rows_coalesced");
+    auto afterLabel = method.addNewLocal(TYPE_LABEL, "%tile_rows_after");
+
+    // we need to insert all blocks before inserting the branches to them to make a possible existing CFG happy!
+    auto separateIt = method.emplaceLabel(it, std::make_unique<intermediate::BranchLabel>(*separateLabel.local()));
+    auto coalescedIt = method.emplaceLabel(
+        separateIt.copy().nextInBlock(), std::make_unique<intermediate::BranchLabel>(*coalescedLabel.local()));
+    ignoreReturnValue(method.emplaceLabel(
+        coalescedIt.copy().nextInBlock(), std::make_unique<intermediate::BranchLabel>(*afterLabel.local())));
+
+    auto branchIt = block.walkEnd();
+    BranchCond cond = BRANCH_ALWAYS;
+    std::tie(branchIt, cond) = intermediate::insertBranchCondition(method, branchIt, mismatch);
+    branch(branchIt, separateLabel.local(), cond);
+    branch(branchIt, coalescedLabel.local(), cond.invert());
+
+    separateIt.nextInBlock();
+    for(auto& inst : originalInstructions)
+    {
+        separateIt.emplace(std::move(inst));
+        separateIt.nextInBlock();
+    }
+    branch(separateIt, afterLabel.local());
+
+    insertCoalescedTileAccess(method, coalescedIt.nextInBlock(), group, pitch);
+    return true;
+}
+
+std::size_t optimizations::coalesceTileDMAAccess(const Module& module, Method& method, const Configuration& config)
+{
+    // collect all groups first, since coalescing groups with a dynamic pitch splits the basic blocks
+    std::vector<TileAccessGroup> groups;
+    for(auto& block : method)
+    {
+        auto it = block.walk();
+        while(!it.isEndOfBlock())
+        {
+            TileAccessGroup group;
+            it = findTileAccessGroup(it, *method.vpm, group);
+            if(group.rows.size() > 1)
+                groups.emplace_back(std::move(group));
+        }
+    }
+
+    std::size_t numChanges = 0;
+    // splitting a basic block only moves the instructions after the group, so handle the last groups first
+    for(auto it = groups.rbegin(); it != groups.rend(); ++it)
+    {
+        if(coalesceTileAccess(method, *it))
+        {
+            ++numChanges;
+            PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION, "DMA tile row groups", it->rows.size());
+        }
+    }
+
+    // clean up empty instructions
+    if(numChanges)
+        method.cleanEmptyInstructions();
+    return numChanges;
+}
+
+/*
+ * A DMA access of a single row within a loop, which can be executed asynchronously to the computation of the loop
+ */
+struct BufferedLoopAccess
+{
+    TileRowAccess row;
+    // the base address of the accessed memory
+    const Local* baseAddress;
+    // only set for reads, the address in relation to the induction variable used to pre-fetch the next iteration
+    Optional<LoopAddressOffset> addressOffset;
+};
+
+static const Parameter* getBaseParameter(const Optional<BufferedLoopAccess>& access)
+{
+    return access && access->baseAddress ? access->baseAddress->as<Parameter>() : nullptr;
+}
+
+static bool isStepAfter(InstructionWalker it, const analysis::InductionVariable& inductionVariable)
+{
+    for(; !it.isEndOfBlock(); it.nextInBlock())
+    {
+        if(it.get() == inductionVariable.inductionStep)
+            return true;
+    }
+    return false;
+}
+
+/*
+ * Returns the position of the first instruction (after the given one) reading the given local or the end of the block
+ * (before any branches).
+ */
+static InstructionWalker findFirstReaderOrEnd(InstructionWalker it, const Local* local)
+{
+    for(; !it.isEndOfBlock(); it.nextInBlock())
+    {
+        if(!it.has())
+            continue;
+        if(it.get<intermediate::Branch>() || it->readsLocal(local) || it->writesLocal(local))
+            break;
+    }
+    return it;
+}
+
+/*
+ * Returns the position of the branches at the end of the given block or the end of the block
+ */
+static InstructionWalker findBranchesOrEnd(BasicBlock& block)
+{
+    auto it = block.walk();
+    for(; !it.isEndOfBlock(); it.nextInBlock())
+    {
+        if(it.get<intermediate::Branch>())
+            break;
+    }
+    return it;
+}
+
+static void releaseRowAccess(TileRowAccess& row)
+{
+    for(auto& inst : row.instructions)
+        inst.reset(nullptr);
+}
+
+/*
+ * Replaces the DMA read of the row with a read from the DMA buffer, which was already filled asynchronously in the
+ * previous iteration (or before the loop).
+ *
+ * The hardware mutex is held for the whole loop, so no mutex locks are inserted here.
+ */
+static void insertBufferedRead(Method& method, const analysis::CFGNode& preheader, InstructionWalker preheaderEnd,
+    const analysis::CFGNode& header, const analysis::CFGEdge& repeatEdge, BufferedLoopAccess& read,
+    const Value& bufferOffset, const periphery::VPMArea& bufferArea)
+{
+    auto cacheEntry = std::make_shared<periphery::VPMCacheEntry>(bufferArea, read.row.type, bufferOffset);
+    cacheEntry->asynchronousDMA = true;
+    auto addressType = read.row.address.type;
+
+    // start the DMA of the first iteration at the end of the pre-header, where the mutex is already locked
+    auto it = *preheader.key->findWalkerForInstruction(read.addressOffset->inductionVariable.initialAssignment);
+    auto firstIterationAddress = insertFirstIterationAddress(method, it, *read.addressOffset, addressType);
+    preheaderEnd.emplace(std::make_unique<intermediate::RAMAccessInstruction>(
+        intermediate::MemoryOperation::READ, firstIterationAddress, cacheEntry));
+
+    // move the wait for the DMA and the read from the VPM to right before the first use of the data
+    auto data = read.row.data;
+    it = findFirstReaderOrEnd(read.row.instructions.back().copy().nextInBlock(), data.local());
+    releaseRowAccess(read.row);
+    it = periphery::insertWaitDMA(it, false);
+    it.emplace(
+        std::make_unique<intermediate::CacheAccessInstruction>(intermediate::MemoryOperation::READ, data, cacheEntry));
+
+    // start the DMA for the next iteration right before repeating the loop
+    auto repeatBranch = repeatEdge.data.getPredecessor(header.key);
+    it = repeatBranch;
+    auto nextIterationAddress = insertNextIterationAddress(
+        method, it, repeatBranch, *header.key, *read.addressOffset, firstIterationAddress, addressType);
+    it.emplace(std::make_unique<intermediate::RAMAccessInstruction>(
+        intermediate::MemoryOperation::READ, nextIterationAddress, cacheEntry));
+}
+
+/*
+ * Replaces the DMA write of the row with a write into alternating halves of the DMA buffer, where the DMA of one half
+ * is running while the other half is filled in the next iteration.
+ *
+ * The hardware mutex is held for the whole loop, so no mutex locks are inserted here.
+ */
+static void insertBufferedWrite(Method& method, InstructionWalker preheaderIt, BufferedLoopAccess& write,
+    const Value& bufferRow, const periphery::VPMArea& bufferArea)
+{
+    auto toggle = assign(preheaderIt, TYPE_INT8, "%dma_buffer_toggle") = INT_ZERO;
+
+    auto it = write.row.instructions.front();
+    auto rowWidth = Value(Literal(write.row.type.getInMemoryWidth()), TYPE_INT8);
+    auto row = assign(it, TYPE_INT8, "%dma_buffer_row") = bufferRow + toggle;
+    auto bufferOffset = assign(it, TYPE_INT32, "%dma_buffer_offset") = mul24(row, rowWidth);
+    auto cacheEntry = std::make_shared<periphery::VPMCacheEntry>(bufferArea, write.row.type, bufferOffset);
+    cacheEntry->asynchronousDMA = true;
+    auto address = write.row.address;
+    auto data = write.row.data;
+    releaseRowAccess(write.row);
+
+    it.emplace(
+        std::make_unique<intermediate::CacheAccessInstruction>(intermediate::MemoryOperation::WRITE, data, cacheEntry));
+    it.nextInBlock();
+    // wait for the DMA of the other half, which was started in the previous iteration
+    it = periphery::insertWaitDMA(it, true);
+    it.emplace(std::make_unique<intermediate::RAMAccessInstruction>(
+        intermediate::MemoryOperation::WRITE, address, cacheEntry));
+    it.nextInBlock();
+    assign(it, toggle) = toggle ^ INT_ONE;
+}
+
+NODISCARD static bool bufferDMAAccessInLoop(const analysis::ControlFlowLoop& loop, Method& method,
+    const analysis::DataDependencyGraph& dependencyGraph, const analysis::DominatorTree& dominators)
+{
+    auto preheader = loop.findPreheader(dominators);
+    auto successor = loop.findSuccessor();
+    auto header = loop.getHeader();
+    auto tail = loop.getTail();
+    auto repeatEdge = tail->getEdge(header);
+
+    if(!preheader || !successor || !header || !tail || !repeatEdge)
+        return false;
+    // the successor releases the mutex locked in the pre-header, so it must not be reachable by skipping the loop
+    if(successor->getSinglePredecessor() != tail)
+        return false;
+
+    auto inductionVariables = loop.findInductionVariables(dependencyGraph, false);
+    const auto* globalDataAddress = method.findBuiltin(BuiltinLocal::Type::GLOBAL_DATA_ADDRESS);
+    Optional<BufferedLoopAccess> read;
+    Optional<BufferedLoopAccess> write;
+    // the memory accesses via RAM which are not buffered (excluding the read-only TMU loads)
+    bool hasOtherReads = false;
+    bool hasOtherWrites = false;
+    // any access of the hardware mutex which is not part of the buffered accesses
+    bool hasOtherMutexAccess = false;
+    for(auto it = header->key->walk(); !it.isEndOfBlock(); it.nextInBlock())
+    {
+        if(!it.has())
+            continue;
+        if(auto row = checkTileRowAccess(it, method.vpm->getScratchArea()))
+        {
+            it = row->instructions.back();
+            auto baseAndOffset = findBaseAndOffset(row->address);
+            const Local* base = baseAndOffset ? baseAndOffset->baseAddress : nullptr;
+            auto param = base ? base->as<Parameter>() : nullptr;
+            bool isVolatile = param && has_flag(param->decorations, ParameterDecorations::VOLATILE);
+            if(row->isWrite)
+            {
+                if(!write && !isVolatile)
+                    write = BufferedLoopAccess{*row, base, {}};
+                else
+                    hasOtherWrites = true;
+                continue;
+            }
+            auto addressOffset = findInductionVariableAddress(row->address, inductionVariables, globalDataAddress);
+            if(!read && !isVolatile && addressOffset &&
+                preheader->key->findWalkerForInstruction(addressOffset->inductionVariable.initialAssignment) &&
+                isStepAfter(row->instructions.back(), addressOffset->inductionVariable))
+                // the address calculated in the loop tail for the next iteration needs to be the same as the address
+                // calculated for the access in the next iteration, which requires the step to be after the access
+                read = BufferedLoopAccess{*row, base, addressOffset};
+            else
+                hasOtherReads = true;
+            continue;
+        }
+        if(it.get<intermediate::MutexLock>() || it->readsRegister(REG_MUTEX) || it->writesRegister(REG_MUTEX))
+            hasOtherMutexAccess = true;
+        if(auto ramAccess = it.get<intermediate::RAMAccessInstruction>())
+        {
+            if(ramAccess->op != intermediate::MemoryOperation::READ)
+                hasOtherWrites = true;
+            else if(!ramAccess->getTMUCacheEntry())
+                hasOtherReads = true;
+        }
+    }
+
+    /*
+     * The asynchronous DMA reorders the memory accesses of the loop. Since there is no guarantee in which order a
+     * pending DMA and any other memory access are executed:
+     * - the buffered write must not alias any memory read in the loop,
+     * - memory read in advance must not be written in the loop.
+     */
+    auto writeParam = getBaseParameter(write);
+    bool isAliasFreeWrite = writeParam && has_flag(writeParam->decorations, ParameterDecorations::RESTRICT);
+    if(write && !isAliasFreeWrite && (read || hasOtherReads))
+    {
+        write = {};
+        hasOtherWrites = true;
+    }
+    if(read && hasOtherWrites)
+        read = {};
+    if(!read && !write)
+        return false;
+
+    /*
+     * A new DMA load or store can only be set up after the previous one is complete, so the mutex needs to be held
+     * while a DMA is pending. Since a DMA started in one iteration is only waited for in the next iteration, the mutex
+     * is locked in the pre-header and released after the loop. Therefore, the loop must not contain any other access
+     * guarded by the mutex, which would dead-lock.
+     */
+    if(hasOtherMutexAccess || hasOtherReads || hasOtherWrites)
+        return false;
+
+    // the write needs 2 rows to alternate between
+    auto rowsPerQPU = (read ? 1u : 0u) + (write ? 2u : 0u);
+    auto bufferArea = method.vpm->addDMABufferArea(rowsPerQPU);
+    if(!bufferArea)
+        return false;
+
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Using asynchronous DMA for " << (read ? "reading " + read->row.address.to_string() + " " : "")
+            << (write ? "writing " + write->row.address.to_string() + " " : "") << "in loop: " << loop.to_string()
+            << logging::endl);
+
+    // every QPU uses its own rows of the buffer area, the write rows are placed before the read row
+    auto it = preheader->key->walk().nextInBlock();
+    auto qpuNumber = assign(it, TYPE_INT8, "%qpu_number") = Value(REG_QPU_NUMBER, TYPE_INT8);
+    auto bufferRow = assign(it, TYPE_INT8, "%dma_buffer_row") =
+        mul24(qpuNumber, Value(Literal(rowsPerQPU), TYPE_INT8));
+
+    auto preheaderEnd = findBranchesOrEnd(*preheader->key);
+    preheaderEnd.emplace(std::make_unique<intermediate::MutexLock>(intermediate::MutexAccess::LOCK));
+    preheaderEnd.nextInBlock();
+
+    if(read)
+    {
+        auto readRow = assign(it, TYPE_INT8, "%dma_buffer_row") =
+            bufferRow + Value(Literal(write ? 2u : 0u), TYPE_INT8);
+        auto readOffset = assign(it, TYPE_INT32, "%dma_buffer_offset") =
+            mul24(readRow, Value(Literal(read->row.type.getInMemoryWidth()), TYPE_INT8));
+        insertBufferedRead(method, *preheader, preheaderEnd, *header, *repeatEdge, *read, readOffset, *bufferArea);
+        PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION, "Asynchronous loop DMA reads", 1);
+    }
+    if(write)
+    {
+        insertBufferedWrite(method, it, *write, bufferRow, *bufferArea);
+        PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION, "Asynchronous loop DMA writes", 1);
+    }
+
+    // the loop and the beginning of the successor are executed with the mutex locked, e.g. for register spilling
+    header->key->getLabel()->addDecorations(intermediate::InstructionDecorations::MUTEX_LOCKED);
+    successor->key->getLabel()->addDecorations(intermediate::InstructionDecorations::MUTEX_LOCKED);
+
+    // wait for the last DMA started in the loop to finish and release the mutex. Since the pre-header always enters
+    // the loop and the successor can only be reached via the loop, a DMA is always pending here.
+    it = successor->key->walk().nextInBlock();
+    if(read)
+        it = periphery::insertWaitDMA(it, false);
+    if(write)
+        it = periphery::insertWaitDMA(it, true);
+    it.emplace(std::make_unique<intermediate::MutexLock>(intermediate::MutexAccess::RELEASE));
+    return true;
+}
+
+std::size_t optimizations::bufferLoopDMAAccess(const Module& module, Method& method, const Configuration& config)
+{
+    // The mutex is held for the whole loop, which only does not stall other QPUs if no other QPU executes this kernel
+    // at the same time, i.e. if only a single work-item is executed per work-group (work-groups run serially).
+    if(method.metaData.getMaximumInstancesCount() != 1u)
+        return 0;
+
+    auto& cfg = method.getCFG();
+    auto dominatorTree = cfg.getDominatorTree();
+    auto loops = cfg.findLoops(false, true);
+    auto dependencyGraph = analysis::DataDependencyGraph::createDependencyGraph(method);
+
+    std::size_t numChanges = 0;
+    for(auto& loop : loops)
+    {
+        // same as for prefetching TMU loads, only handle loops without conditional memory accesses
+        if(loop.size() > 1 || containsSynchronizationInstruction(loop))
+            continue;
+        if(bufferDMAAccessInLoop(loop, method, *dependencyGraph, *dominatorTree))
+            ++numChanges;
+    }
+
+    if(numChanges)
+        method.cleanEmptyInstructions();
+    return numChanges;
+}
+
+// merging critical sections delays other QPUs waiting for the mutex, so limit the length of merged sections
+static constexpr std::size_t MAX_MERGED_MUTEX_SECTION_LENGTH = 32;
+
+/*
+ * A critical section guarded by the hardware mutex within a single basic block
+ */
+struct MutexSection
+{
+    InstructionWalker lock;
+    InstructionWalker release;
+};
+
+static FastAccessList<MutexSection> findMutexSections(BasicBlock& block)
+{
+    FastAccessList<MutexSection> sections;
+    Optional<InstructionWalker> lock;
+    for(auto it = block.walk(); !it.isEndOfBlock(); it.nextInBlock())
+    {
+        if(!it.has())
+            continue;
+        auto mutex = it.get<intermediate::MutexLock>();
+        if(mutex && mutex->locksMutex() && !lock)
+            lock = it;
+        else if(mutex && mutex->releasesMutex() && lock)
+        {
+            sections.emplace_back(MutexSection{*lock, it});
+            lock = {};
+        }
+        else if(mutex || it->readsRegister(REG_MUTEX) || it->writesRegister(REG_MUTEX) ||
+            (lock && it.get<intermediate::Branch>()))
+            // sections spanning multiple blocks or accessing the mutex otherwise are not handled
+            return {};
+    }
+    if(lock)
+        return {};
+    return sections;
+}
+
+static FastAccessList<InstructionWalker> getSectionInstructions(const MutexSection& section)
+{
+    FastAccessList<InstructionWalker> instructions;
+    for(auto it = section.lock.copy().nextInBlock(); it != section.release; it.nextInBlock())
+    {
+        if(it.has())
+            instructions.emplace_back(it);
+    }
+    return instructions;
+}
+
+/*
+ * Only plain calculations on locals are independent of the critical section and can be moved out of it
+ */
+static bool isIndependentOfMutex(const intermediate::IntermediateInstruction& inst)
+{
+    return dynamic_cast<const intermediate::ExtendedInstruction*>(&inst) && inst.checkOutputLocal() &&
+        !inst.hasSideEffects() && !inst.hasConditionalExecution() && !inst.readsRegister();
+}
+
+/*
+ * Returns the locals read by the given memory access via its VPM cache entry (e.g. a dynamic offset into the VPM area),
+ * which are not tracked as arguments of the instruction
+ */
+static FastAccessList<const Local*> getCacheEntryLocals(const intermediate::IntermediateInstruction& inst)
+{
+    FastAccessList<const Local*> locals;
+    auto memoryAccess = dynamic_cast<const intermediate::MemoryAccessInstruction*>(&inst);
+    if(auto cacheEntry = memoryAccess ? memoryAccess->getVPMCacheEntry() : nullptr)
+    {
+        for(const auto& val : {cacheEntry->inAreaByteOffset, cacheEntry->memoryPitch,
+                cacheEntry->memoryElementStride, cacheEntry->getVectorWidth()})
+        {
+            if(auto loc = val.checkLocal())
+                locals.emplace_back(loc);
+        }
+    }
+    return locals;
+}
+
+static bool readsLocalOrCacheEntryLocal(const intermediate::IntermediateInstruction& inst, const Local* local)
+{
+    auto cacheEntryLocals = getCacheEntryLocals(inst);
+    return inst.readsLocal(local) ||
+        std::find(cacheEntryLocals.begin(), cacheEntryLocals.end(), local) != cacheEntryLocals.end();
+}
+
+/*
+ * Whether the two instructions access the same locals in a way that does not allow to swap their order
+ */
+static bool hasLocalDependency(
+    const intermediate::IntermediateInstruction& one, const intermediate::IntermediateInstruction& other)
+{
+    bool dependency = false;
+    auto checkLocal = [&](const Local* local) {
+        if(other.writesLocal(local) || (one.writesLocal(local) && readsLocalOrCacheEntryLocal(other, local)))
+            dependency = true;
+    };
+    one.forUsedLocals(
+        [&](const Local* local, LocalUse::Type, const intermediate::IntermediateInstruction&) { checkLocal(local); });
+    // the locals used by a memory access via its cache entry are read by that instruction too
+    for(auto local : getCacheEntryLocals(one))
+        checkLocal(local);
+    return dependency;
+}
+
+static bool hasLocalDependency(const intermediate::IntermediateInstruction& inst,
+    FastAccessList<InstructionWalker>::const_iterator begin, FastAccessList<InstructionWalker>::const_iterator end)
+{
+    return std::any_of(begin, end,
+        [&](const InstructionWalker& it) -> bool { return it.has() && hasLocalDependency(inst, *it.get()); });
+}
+
+static bool hasLocalDependency(
+    const intermediate::IntermediateInstruction& inst, const FastAccessList<InstructionWalker>& instructions)
+{
+    return hasLocalDependency(inst, instructions.begin(), instructions.end());
+}
+
+/*
+ * Whether the section only accesses VPM areas which are private to the executing QPU and thus do not need to be
+ * guarded by the mutex
+ */
+static bool accessesOnlyPerQPUMemory(const FastAccessList<InstructionWalker>& instructions)
+{
+    bool accessesVPM = false;
+    for(const auto& it : instructions)
+    {
+        // DMA transfers are always guarded, only accesses of the VPM from the QPU side are per-QPU
+        auto cacheAccess = it.get<intermediate::CacheAccessInstruction>();
+        auto cacheEntry = cacheAccess ? cacheAccess->getVPMCacheEntry() : nullptr;
+        if(cacheEntry && cacheEntry->area.isPerQPU())
+            accessesVPM = true;
+        else if(!isIndependentOfMutex(*it.get()))
+            return false;
+    }
+    return accessesVPM;
+}
+
+/*
+ * Moves all instructions not depending on the guarded accesses before the mutex lock or after the mutex release
+ */
+static std::size_t moveIndependentInstructionsOut(const MutexSection& section)
+{
+    std::size_t numMoved = 0;
+    auto instructions = getSectionInstructions(section);
+    for(std::size_t i = 0; i < instructions.size(); ++i)
+    {
+        auto& it = instructions[i];
+        auto pos = instructions.cbegin() + static_cast<std::ptrdiff_t>(i);
+        if(!isIndependentOfMutex(*it.get()) || hasLocalDependency(*it.get(), instructions.cbegin(), pos))
+            continue;
+        section.lock.copy().emplace(it.release());
+        ++numMoved;
+    }
+    for(std::size_t i = instructions.size(); i > 0; --i)
+    {
+        auto& it = instructions[i - 1];
+        auto pos = instructions.cbegin() + static_cast<std::ptrdiff_t>(i);
+        if(!it.has() || !isIndependentOfMutex(*it.get()) || hasLocalDependency(*it.get(), pos, instructions.cend()))
+            continue;
+        // inserting directly after the release keeps the original order of the moved instructions
+        section.release.copy().nextInBlock().emplace(it.release());
+        ++numMoved;
+    }
+    return numMoved;
+}
+
+/*
+ * Tries to merge the two adjacent sections by moving the instructions between them before the first or after the
+ * second section
+ */
+NODISCARD static bool mergeMutexSections(MutexSection& first, const MutexSection& second)
+{
+    auto firstInstructions = getSectionInstructions(first);
+    auto secondInstructions = getSectionInstructions(second);
+    if(firstInstructions.size() + secondInstructions.size() > MAX_MERGED_MUTEX_SECTION_LENGTH)
+        return false;
+
+    FastAccessList<InstructionWalker> moveBefore;
+    FastAccessList<InstructionWalker> moveAfter;
+    for(auto it = first.release.copy().nextInBlock(); it != second.lock; it.nextInBlock())
+    {
+        if(!it.has())
+            continue;
+        if(!isIndependentOfMutex(*it.get()))
+            return false;
+        if(!hasLocalDependency(*it.get(), firstInstructions) && !hasLocalDependency(*it.get(), moveAfter))
+            moveBefore.emplace_back(it);
+        else if(!hasLocalDependency(*it.get(), secondInstructions))
+            moveAfter.emplace_back(it);
+        else
+            return false;
+    }
+
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Merging adjacent mutex-guarded sections: " << first.lock.getBasicBlock()->to_string() << " ("
+            << firstInstructions.size() << " and " << secondInstructions.size() << " instructions)" << logging::endl);
+    for(auto& it : moveBefore)
+        first.lock.copy().emplace(it.release());
+    auto afterIt = second.release.copy().nextInBlock();
+    for(auto& it : moveAfter)
+    {
+        afterIt.emplace(it.release());
+        afterIt.nextInBlock();
+    }
+    first.release.reset(nullptr);
+    second.lock.copy().reset(nullptr);
+    first.release = second.release;
+    return true;
+}
+
+std::size_t optimizations::minimizeMutexSections(const Module& module, Method& method, const Configuration& config)
+{
+    std::size_t numChanges = 0;
+    for(auto& block : method)
+    {
+        auto sections = findMutexSections(block);
+        FastAccessList<MutexSection> remainingSections;
+        for(auto& section : sections)
+        {
+            if(accessesOnlyPerQPUMemory(getSectionInstructions(section)))
+            {
+                CPPLOG_LAZY(logging::Level::DEBUG,
+                    log << "Removing mutex lock for accessing per-QPU VPM memory only in: " << block.to_string()
+                        << logging::endl);
+                section.lock.reset(nullptr);
+                section.release.reset(nullptr);
+                ++numChanges;
+                PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION, "Per-QPU mutex sections removed", 1);
+                continue;
+            }
+            numChanges += moveIndependentInstructionsOut(section);
+            if(!remainingSections.empty() && mergeMutexSections(remainingSections.back(), section))
+            {
+                ++numChanges;
+                PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION, "Mutex sections merged", 1);
+                continue;
+            }
+            remainingSections.emplace_back(section);
+        }
+    }
+
+    if(numChanges)
+        method.cleanEmptyInstructions();
+    return numChanges;
+}
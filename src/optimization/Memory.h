@@ -55,6 +55,34 @@ namespace vc4c
          * Tries to find and group memory accesses to reduce the number of accesses while increasing utilization.
          */
         std::size_t groupLoweredRegisterAccess(const Module& module, Method& method, const Configuration& config);
+
+        /**
+         * Combines the DMA accesses of the single rows of a 2D tile (e.g. an unrolled loop over the rows of a pitched
+         * buffer) into a single DMA access of multiple rows with the pitch of the buffer.
+         *
+         * If the pitch between the rows is not a compile-time constant, it is checked at run-time, falling back to the
+         * separate accesses.
+         */
+        std::size_t coalesceTileDMAAccess(const Module& module, Method& method, const Configuration& config);
+
+        /**
+         * Executes the DMA accesses of single rows in loops asynchronously to the computation of the loop by using
+         * per-QPU buffers in the VPM: the DMA read for the next loop iteration is started at the end of the current
+         * iteration, the DMA write alternates between two buffers so the next write can be prepared while the previous
+         * DMA is still running.
+         *
+         * Since a DMA cannot be set up while another one is pending, the hardware mutex is locked for the whole loop.
+         */
+        std::size_t bufferLoopDMAAccess(const Module& module, Method& method, const Configuration& config);
+
+        /**
+         * Reduces the time the hardware mutex is held by moving independent calculations out of the critical sections
+         * and merges adjacent critical sections to reduce the number of mutex acquisitions.
+         *
+         * Critical sections only accessing VPM areas private to the QPU (e.g. the stack) are proven to not require the
+         * mutex and are no longer guarded by it.
+         */
+        std::size_t minimizeMutexSections(const Module& module, Method& method, const Configuration& config);
     } // namespace optimizations
 } // namespace vc4c
 
@@ -257,11 +257,12 @@ const std::vector<OptimizationPass> Optimizer::ALL_PASSES = {
     /*
      * The first optimizations run modify the control-flow of the method.
      */
-    // XXX not enabled with any optimization level for now, since we cannot yet preload (or determine that this is not
-    // necessary!)
-    // OptimizationPass("CacheMemoryInVPM", PASS_CACHE_MEMORY, nullptr, "caches memory accesses in VPM where
-    // applicable",
-    //     OptimizationType::INITIAL),
+    // Not enabled with any optimization level, since only the preloading of read-only constant data is supported yet.
+    // The actual work is done when lowering the memory accesses, so this entry only registers the parameter.
+    OptimizationPass("CacheMemoryInVPM", PASS_CACHE_MEMORY, nullptr,
+        "caches frequently read constant memory in VPM where applicable", OptimizationType::INITIAL),
+    OptimizationPass("CoarsenWorkItems", "coarsen-work-items", coarsenWorkItems,
+        "merges all work-items of a work-group into the SIMD elements of a single QPU", OptimizationType::INITIAL),
     OptimizationPass("AddWorkGroupLoops", PASS_WORK_GROUP_LOOP, addWorkGroupLoop,
         "merges all work-group executions into a single kernel execution", OptimizationType::INITIAL),
     OptimizationPass("ReorderBasicBlocks", "reorder-blocks", reorderBasicBlocks,
@@ -273,12 +274,27 @@ const std::vector<OptimizationPass> Optimizer::ALL_PASSES = {
         "merges adjacent basic blocks if there are no other conflicting transitions", OptimizationType::INITIAL),
     OptimizationPass("VectorizeLoops", "vectorize-loops", vectorizeLoops, "vectorizes supported types of loops",
         OptimizationType::INITIAL),
+    OptimizationPass("ConvertToConditionalExecution", "if-conversion", convertToConditionalExecution,
+        "converts short conditional blocks without side-effects into conditional execution", OptimizationType::INITIAL),
+    OptimizationPass("MergeConvertedBasicBlocks", "if-conversion", mergeAdjacentBasicBlocks,
+        "merges the basic blocks around conditional blocks converted into conditional execution",
+        OptimizationType::INITIAL),
     OptimizationPass("PrefetchLoads", "prefetch-loads", prefetchTMULoads,
         "pre-fetches read-only memory loaded in loops", OptimizationType::INITIAL),
     OptimizationPass("GroupTMUAccess", "group-memory", groupTMUAccess,
         "merges memory accesses for adjacent memory and cache areas", OptimizationType::INITIAL),
     OptimizationPass("GroupLoweredRegisterAccess", "group-memory", groupLoweredRegisterAccess,
         "merges memory accesses for adjacent memory and cache areas", OptimizationType::INITIAL),
+    OptimizationPass("CoalesceTileDMAAccess", "coalesce-tile-dma", coalesceTileDMAAccess,
+        "combines the DMA accesses of rows of 2D tiles into single accesses with the pitch of the rows",
+        OptimizationType::INITIAL),
+    // Only applied to kernels executed by a single QPU per work-group, since the mutex is locked for the whole loop.
+    // Not enabled with any optimization level, since there are no cycle measurements showing a benefit yet.
+    OptimizationPass("BufferLoopDMAAccess", "async-loop-dma", bufferLoopDMAAccess,
+        "overlaps the DMA accesses in loops with the computation by double-buffering them in the VPM",
+        OptimizationType::INITIAL),
+    OptimizationPass("MinimizeMutexSections", "minimize-mutex", minimizeMutexSections,
+        "shortens and merges critical sections guarded by the hardware mutex", OptimizationType::INITIAL),
     /*
      * Optimization run before this have access to the MemoryAccessInstructions and their accessed CacheEntries.
      * After this step is run, the direct hardware instructions are available instead.
@@ -287,6 +303,9 @@ const std::vector<OptimizationPass> Optimizer::ALL_PASSES = {
         "MANDATORY: lowers the memory access instructions to actual hardware instructions", OptimizationType::INITIAL),
     OptimizationPass("GroupVPMAccess", "group-memory", groupVPMAccess,
         "merges memory accesses for adjacent memory and cache areas", OptimizationType::INITIAL),
+    OptimizationPass("MinimizeLoweredMutexSections", "minimize-lowered-mutex", minimizeMutexSections,
+        "shortens and merges critical sections guarded by the hardware mutex after lowering the memory accesses",
+        OptimizationType::INITIAL),
     OptimizationPass("CompactVectorFolding", "compact-vector-folding", compactVectorFolding,
         "optimizes element-wise vector folding with binary-tree folding", OptimizationType::INITIAL),
     /*
@@ -350,6 +369,9 @@ std::set<std::string> Optimizer::getPasses(OptimizationLevel level)
     {
     case OptimizationLevel::FULL:
         passes.emplace("schedule-instructions");
+        passes.emplace("coalesce-tile-dma");
+        passes.emplace("minimize-mutex");
+        passes.emplace("minimize-lowered-mutex");
         FALL_THROUGH
     case OptimizationLevel::MEDIUM:
         passes.emplace("merge-blocks");
@@ -365,6 +387,7 @@ std::set<std::string> Optimizer::getPasses(OptimizationLevel level)
         passes.emplace("compact-vector-folding");
         passes.emplace("combine-vector-element-copies");
         passes.emplace("vectorize-loops");
+        passes.emplace("if-conversion");
         FALL_THROUGH
     case OptimizationLevel::BASIC:
         passes.emplace("reorder-blocks");
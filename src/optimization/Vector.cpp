@@ -14,6 +14,7 @@
 #include "../analysis/DataDependencyGraph.h"
 #include "../analysis/FlagsAnalysis.h"
 #include "../analysis/PatternMatching.h"
+#include "../analysis/WorkItemAnalysis.h"
 #include "../intermediate/Helper.h"
 #include "../intermediate/VectorHelper.h"
 #include "../intermediate/operators.h"
@@ -93,19 +94,135 @@ static unsigned determineVectorizationFactor(const ControlFlowLoop& loop, Option
     return factor;
 }
 
+// the maximum depth of the calculation of a value followed to determine its stride
+static constexpr unsigned MAX_STRIDE_DEPTH = 16;
+// the number of bits of the DMA read pitch and write stride setups
+static constexpr uint32_t DMA_STRIDE_BITS = 13;
+// the size of a TMU cache line in bytes
+static constexpr unsigned TMU_CACHE_LINE_SIZE = 64;
+
+/*
+ * Returns the stride of the result of the given operation from the strides of its operands, if it is statically known
+ */
+static Optional<int32_t> combineStrides(
+    const Operation& op, const Optional<int32_t>& firstStride, const Optional<int32_t>& secondStride)
+{
+    if(!firstStride || !secondStride)
+        return {};
+    if(op.op == OP_ADD)
+        return *firstStride + *secondStride;
+    if(op.op == OP_SUB)
+        return *firstStride - *secondStride;
+    auto firstLiteral = op.getFirstArg().getLiteralValue();
+    auto secondLiteral = op.getSecondArg() & &Value::getLiteralValue;
+    if(op.op == OP_SHL && secondLiteral && secondLiteral->unsignedInt() < 16)
+        return *firstStride * (1 << secondLiteral->unsignedInt());
+    if(op.op == OP_MUL24 && secondLiteral)
+        return *firstStride * secondLiteral->signedInt();
+    if(op.op == OP_MUL24 && firstLiteral)
+        return *secondStride * firstLiteral->signedInt();
+    return {};
+}
+
+/*
+ * Returns the difference of the given value between two successive loop iterations, if it is statically known.
+ *
+ * NOTE: Since only loops with an induction variable step of +1 are vectorized, this is also the difference between two
+ * adjacent SIMD elements of the vectorized value.
+ */
+static Optional<int32_t> getIterationStride(
+    const Value& val, const ControlFlowLoop& loop, const Local* inductionLocal, unsigned depth = 0)
+{
+    if(val.getLiteralValue())
+        return 0;
+    auto loc = val.checkLocal();
+    if(!loc || depth > MAX_STRIDE_DEPTH)
+        return {};
+    if(loc == inductionLocal)
+        return 1;
+    auto writers = loc->getUsers(LocalUse::Type::WRITER);
+    if(std::none_of(writers.begin(), writers.end(),
+           [&](const LocalUser* writer) -> bool { return loop.findInLoop(writer).has_value(); }))
+        // the value is not changed within the loop
+        return 0;
+    auto writer = loc->getSingleWriter();
+    if(!writer || writer->hasConditionalExecution() || writer->hasUnpackMode() || writer->hasPackMode())
+        return {};
+    if(auto source = writer->getMoveSource())
+        return getIterationStride(*source, loop, inductionLocal, depth + 1);
+    auto op = dynamic_cast<const Operation*>(writer);
+    if(!op || !op->getSecondArg())
+        return {};
+    return combineStrides(*op, getIterationStride(op->getFirstArg(), loop, inductionLocal, depth + 1),
+        getIterationStride(*op->getSecondArg(), loop, inductionLocal, depth + 1));
+}
+
+/*
+ * Returns the size in bytes of the constant table (e.g. a lookup-table in constant memory) the given address points
+ * into, if known
+ */
+static Optional<unsigned> getAccessedTableSize(const Value& address)
+{
+    auto loc = address.checkLocal();
+    auto data = loc ? loc->get<ReferenceData>() : nullptr;
+    auto global = data && data->base ? data->base->as<Global>() : nullptr;
+    if(!global || !global->isConstant)
+        return {};
+    return global->type.getElementType().getInMemoryWidth();
+}
+
+/*
+ * Returns the number of TMU cache lines touched by the given number of accesses of the given size each, which are
+ * located with the given distance in bytes or at arbitrary addresses within the optional table
+ */
+static unsigned getNumCacheLines(
+    unsigned numAccesses, unsigned accessSize, Optional<int32_t> distance, Optional<unsigned> tableSize)
+{
+    auto maxLines = numAccesses * ((accessSize + TMU_CACHE_LINE_SIZE - 1) / TMU_CACHE_LINE_SIZE);
+    if(distance)
+    {
+        auto span = (numAccesses - 1) * static_cast<unsigned>(std::abs(*distance)) + accessSize;
+        maxLines = std::min(maxLines, (span + TMU_CACHE_LINE_SIZE - 1) / TMU_CACHE_LINE_SIZE);
+    }
+    else if(tableSize)
+        // an unaligned table might touch one additional cache line
+        maxLines = std::min(maxLines, (*tableSize + TMU_CACHE_LINE_SIZE - 1) / TMU_CACHE_LINE_SIZE + 1);
+    return maxLines;
+}
+
+/*
+ * Checks whether the given VPM access of non-adjacent elements can be vectorized by transferring every element as its
+ * own memory row, see VPMCacheEntry#memoryElementStride
+ */
+static bool canAccessStrided(const RAMAccessInstruction& access, const periphery::VPMCacheEntry& cacheEntry,
+    Optional<int32_t> stride, bool isDynamicIterationCount)
+{
+    auto elementSize = static_cast<int32_t>(cacheEntry.getScalarType().getInMemoryWidth());
+    return stride && *stride >= elementSize && *stride < (int32_t{1} << DMA_STRIDE_BITS) && !isDynamicIterationCount &&
+        cacheEntry.getScalarType().getScalarBitCount() == 32 && cacheEntry.getVectorWidth().hasLiteral(1_lit) &&
+        access.getNumEntries().hasLiteral(1_lit) && cacheEntry.inAreaByteOffset == INT_ZERO &&
+        cacheEntry.memoryPitch.isUndefined();
+}
+
 /*
  * On the cost-side, we have (as increments):
  * - instructions inserted to construct vectors from scalars
  * - additional delay for writing larger vectors through VPM
+ * - additional memory rows transferred for VPM accesses of non-adjacent elements
+ * - additional TMU cache lines loaded for strided and gathering TMU reads
  * - memory address is read and written from within loop -> abort
  * - vector rotations -> for now abort
  * - vector foldings after loop
+ * - per-element calculation of prefix accumulations inside the loop
  *
  * On the benefit-side, we have (as factors):
  * - the iterations saved (times the number of instructions in an iteration)
+ *
+ * The VPM accesses of non-adjacent elements are returned together with the distance in bytes between their elements.
  */
 static int calculateCostsVsBenefits(const ControlFlowLoop& loop, const InductionVariable& inductionVariable,
-    unsigned vectorizationFactor, unsigned numFoldings, bool isDynamicIterationCount)
+    unsigned vectorizationFactor, unsigned numFoldings, unsigned numScans, bool isDynamicIterationCount,
+    FastMap<const RAMAccessInstruction*, int32_t>& stridedVPMAccesses)
 {
     // TODO benefits are way off, e.g. for test_vectorization.cl#test4, vectorized version uses 1.5k instead of 29k
     // cycles where this calculation estimates a win of ~400cycles!
@@ -166,6 +283,39 @@ static int calculateCostsVsBenefits(const ControlFlowLoop& loop, const Induction
                                     << access->to_string() << logging::endl);
                             return std::numeric_limits<int>::min();
                         }
+                        // The DMA transfers all elements of the vectorized access from/to consecutive memory, unless
+                        // every element is transferred as its own memory row.
+                        auto stride = getIterationStride(access->getMemoryAddress(), loop, inductionVariable.local);
+                        auto accessSize = vpmCacheEntry->getVectorType().getInMemoryWidth();
+                        if(!stride || *stride != static_cast<int32_t>(accessSize))
+                        {
+                            if(!canAccessStrided(*access, *vpmCacheEntry, stride, isDynamicIterationCount))
+                            {
+                                CPPLOG_LAZY(logging::Level::DEBUG,
+                                    log << "Cannot vectorize loop with unsupported access of non-adjacent memory "
+                                           "elements via VPM: "
+                                        << access->to_string() << logging::endl);
+                                return std::numeric_limits<int>::min();
+                            }
+                            stridedVPMAccesses.emplace(access, *stride);
+                            // every element is transferred as a separate memory row
+                            costs += static_cast<int>(vectorizationFactor) - 1;
+                        }
+                    }
+                    if(auto tmuCacheEntry = access->getTMUCacheEntry())
+                    {
+                        // The TMU reads every element from its own address anyway, but addresses not located in the
+                        // same cache line require additional cache lines to be loaded. For gathers (e.g. lookup-tables)
+                        // we do not know the distance of the elements and assume the worst case.
+                        auto numElements = tmuCacheEntry->numVectorElements.getLiteralValue();
+                        auto accessSize =
+                            tmuCacheEntry->elementStrideInBytes * (numElements ? numElements->unsignedInt() : 1u);
+                        auto stride = getIterationStride(access->getMemoryAddress(), loop, inductionVariable.local);
+                        auto numLines = getNumCacheLines(vectorizationFactor, accessSize, stride,
+                            getAccessedTableSize(access->getMemoryAddress()));
+                        auto numAdjacentLines = getNumCacheLines(
+                            vectorizationFactor, accessSize, static_cast<int32_t>(accessSize), Optional<unsigned>{});
+                        costs += static_cast<int>(numLines) - static_cast<int>(std::min(numLines, numAdjacentLines));
                     }
                 }
                 else if(auto access = dynamic_cast<const CacheAccessInstruction*>(it.get()))
@@ -232,6 +382,10 @@ static int calculateCostsVsBenefits(const ControlFlowLoop& loop, const Induction
     // our folding implementation takes 3 * ceil(log2(vector-width)) instructions per folding
     auto foldCosts = 3u * (vc4c::log2(vectorizationFactor) + 1u);
     costs += static_cast<int>(foldCosts * numFoldings);
+    // prefix accumulations additionally take 4 * ceil(log2(vector-width)) instructions to calculate the per-element
+    // accumulation and 3 instructions to replicate the carry for the next iteration
+    auto scanCosts = 4u * (vc4c::log2(vectorizationFactor) + 1u) + 3u;
+    costs += static_cast<int>(scanCosts * numScans);
     // additional calculation of the dynamic element mask
     if(isDynamicIterationCount)
     {
@@ -1020,6 +1174,13 @@ struct AccumulationInfo
     tools::SmallSortedPointerSet<const Local*> toBeMasked;
     Optional<Value> initialValue;
     IntermediateInstruction* initialWriter;
+    // the operation accumulating the values inside the loop and its argument reading the accumulated value
+    IntermediateInstruction* loopOperation;
+    const Local* accumulatedLocal;
+    // the write-back of the accumulation result for the next iteration
+    IntermediateInstruction* loopWrite;
+    // whether the intermediate accumulation results are also used inside the loop, e.g. for prefix sums
+    bool isScan;
 };
 
 /**
@@ -1101,6 +1262,77 @@ static unsigned fixLCSSAElementMask(Method& method, ControlFlowLoop& loop,
     return numModified;
 }
 
+/**
+ * For prefix accumulations (e.g. prefix sums), the intermediate results are also used inside the loop, so every
+ * element needs to hold the accumulation of all previous iterations and elements.
+ *
+ * Since the accumulated local holds the accumulation of all previous iterations in all its elements, we calculate the
+ * inclusive scan of the accumulated values across the elements in log2(vectorization factor) rotate-and-combine
+ * steps, apply the accumulation and replicate the last element of the result for the next iteration:
+ *
+ * %scan = %value
+ * for(step = 1; step < vectorization factor; step *= 2)
+ *   %scan = %scan op (%scan rotated up by step) (only for elements >= step)
+ * %tmp = %acc op %scan
+ * %acc = replicate(%tmp[vectorization factor - 1])
+ */
+static unsigned insertPrefixAccumulations(Method& method, ControlFlowLoop& loop, unsigned vectorizationFactor,
+    const FastMap<const Local*, AccumulationInfo>& accumulationsToFold)
+{
+    unsigned numModified = 0;
+    for(auto& acc : accumulationsToFold)
+    {
+        const auto& info = acc.second;
+        if(!info.isScan)
+            continue;
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Calculating prefix accumulation across vector elements for: " << info.loopOperation->to_string()
+                << logging::endl);
+
+        auto opIt = loop.findInLoop(info.loopOperation);
+        auto writeIt = loop.findInLoop(info.loopWrite);
+        auto move = dynamic_cast<MoveOperation*>(info.loopWrite);
+        auto output = info.loopOperation->checkOutputLocal();
+        if(!opIt || !writeIt || !move || !output || info.loopOperation->getArguments().size() != 2)
+            throw CompilationError(CompilationStep::OPTIMIZER, "Failed to find instructions for prefix accumulation",
+                info.loopOperation->to_string());
+        auto valueIndex = info.loopOperation->assertArgument(0).checkLocal() == info.accumulatedLocal ? 1u : 0u;
+        if(info.loopOperation->assertArgument(valueIndex).checkLocal() == info.accumulatedLocal ||
+            info.loopOperation->assertArgument(1u - valueIndex).checkLocal() != info.accumulatedLocal)
+            throw CompilationError(CompilationStep::OPTIMIZER, "Unhandled operands for prefix accumulation",
+                info.loopOperation->to_string());
+
+        auto vectorType = output->type;
+        auto it = *opIt;
+        auto scan = assign(it, vectorType, "%prefix_scan") = info.loopOperation->assertArgument(valueIndex);
+        ++numModified;
+        for(unsigned step = 1; step < vectorizationFactor; step *= 2)
+        {
+            auto offset = Value(Literal(step), TYPE_INT8);
+            auto rotated = method.addNewLocal(vectorType, "%prefix_scan");
+            it = insertVectorRotation(it, scan, offset, rotated, intermediate::Direction::UP);
+            auto nextScan = assign(it, vectorType, "%prefix_scan") = scan;
+            auto cond = assignNop(it) = as_signed{ELEMENT_NUMBER_REGISTER} >= as_signed{offset};
+            it.emplace(std::make_unique<Operation>(info.op, nextScan, scan, rotated, cond));
+            it.nextInBlock();
+            scan = nextScan;
+            numModified += 4;
+        }
+        info.loopOperation->setArgument(valueIndex, std::move(scan));
+
+        it = *writeIt;
+        auto lastElement = method.addNewLocal(vectorType, "%prefix_carry");
+        it = insertVectorRotation(it, move->getSource(), Value(Literal(vectorizationFactor - 1u), TYPE_INT8),
+            lastElement, intermediate::Direction::DOWN);
+        auto carry = method.addNewLocal(vectorType, "%prefix_carry");
+        it = insertReplication(it, lastElement, carry);
+        move->setSource(std::move(carry));
+        numModified += 3;
+    }
+
+    return numModified;
+}
+
 /**
  * Fold vectorized version into "scalar" version by applying the accumulation function
  * NOTE: The "scalar" version is not required to be actual scalar (vector-width of 1), could just be some other smaller
@@ -1149,7 +1381,11 @@ static void foldVectorizedLocal(ControlFlowLoop& loop, Method& method, unsigned
             CPPLOG_LAZY(logging::Level::DEBUG,
                 log << "Folding vectorized local " << arg.to_string() << " into " << newArg.to_string()
                     << " for: " << inst->to_string() << logging::endl);
-            auto insertIt = insertFoldVector(*it, method, newArg, arg, info.op, closedInstructions);
+            // the last element of prefix accumulations already holds the accumulation of all elements
+            auto insertIt = info.isScan ?
+                insertVectorExtraction(
+                    *it, method, arg, Value(Literal(vectorizationFactor - 1u), TYPE_INT8), newArg) :
+                insertFoldVector(*it, method, newArg, arg, info.op, closedInstructions);
             if(auto initial = info.initialValue)
             {
                 // since the initial value setter will be set for all vector-elements and therefore applied too
@@ -1193,9 +1429,10 @@ static void foldVectorizedLocal(ControlFlowLoop& loop, Method& method, unsigned
  * NOTE: The "scalar" version is not required to be actual scalar (vector-width of 1), could just be some
  * other smaller vector-width.
  */
-static void replicateVectorizedLocal(ControlFlowLoop& loop, Method& method, unsigned vectorizationFactor,
-    FastMap<const intermediate::IntermediateInstruction*, VectorizedAccess>& openInstructions,
-    FastSet<const intermediate::IntermediateInstruction*>& closedInstructions, const IntermediateInstruction* inst)
+/*
+ * Finds the given instruction in the chain of single predecessors leading to the loop
+ */
+static Optional<InstructionWalker> findBeforeLoop(const ControlFlowLoop& loop, const IntermediateInstruction* inst)
 {
     Optional<InstructionWalker> optIt;
     if(auto pred = loop.findPredecessor())
@@ -1204,7 +1441,14 @@ static void replicateVectorizedLocal(ControlFlowLoop& loop, Method& method, unsi
         while(!optIt && (pred = pred->getSinglePredecessor()))
             optIt = pred->key->findWalkerForInstruction(inst);
     }
-    if(optIt)
+    return optIt;
+}
+
+static void replicateVectorizedLocal(ControlFlowLoop& loop, Method& method, unsigned vectorizationFactor,
+    FastMap<const intermediate::IntermediateInstruction*, VectorizedAccess>& openInstructions,
+    FastSet<const intermediate::IntermediateInstruction*>& closedInstructions, const IntermediateInstruction* inst)
+{
+    if(auto optIt = findBeforeLoop(loop, inst))
     {
         // can only be before the loop -> simply replicate the loaded elements
         auto it = *optIt;
@@ -1319,6 +1563,8 @@ static std::size_t vectorize(ControlFlowLoop& loop, const Local* startLocal, Met
         }
     }
 
+    numVectorized += insertPrefixAccumulations(method, loop, vectorizationFactor, accumulationsToFold);
+
     if(dynamicElementCount)
         numVectorized +=
             fixLCSSAElementMask(method, loop, accumulationsToFold, *dynamicElementCount, closedInstructions);
@@ -1460,12 +1706,15 @@ static Optional<AccumulationInfo> determineAccumulation(const Local* loc, const
         return {};
     }
 
+    const Local* accumulatedLocal = loc;
+    tools::SmallSortedPointerSet<const LocalUser*> accumulationMoves;
     while(loopOperationRead->isSimpleMove() && loopOperationRead->checkOutputLocal())
     {
         auto readers = loopOperationRead->checkOutputLocal()->getUsers(LocalUse::Type::READER);
         if(readers.size() == 1 && loop.findInLoop(*readers.begin()))
         {
-            // actualAccumulatedLocal = loopOperationRead->checkOutputLocal();
+            accumulationMoves.emplace(loopOperationRead);
+            accumulatedLocal = loopOperationRead->checkOutputLocal();
             loopOperationRead = *readers.begin();
             // loopTemporaries.emplace(loc);
             // return determineAccumulation(loopOperationRead->checkOutputLocal(), loop);
@@ -1483,9 +1732,45 @@ static Optional<AccumulationInfo> determineAccumulation(const Local* loc, const
         return {};
     }
 
+    // Any other use of the intermediate accumulation results inside the loop (e.g. for prefix sums) requires every
+    // element to hold the accumulation of all previous elements, see #insertPrefixAccumulations
+    auto hasScanRead = [&](const Local* local) -> bool {
+        auto readers = local->getUsers(LocalUse::Type::READER);
+        return std::any_of(readers.begin(), readers.end(), [&](const LocalUser* reader) -> bool {
+            return reader != op && reader != loopWrite && accumulationMoves.find(reader) == accumulationMoves.end() &&
+                !reader->hasDecoration(InstructionDecorations::PHI_NODE) && loop.findInLoop(reader);
+        });
+    };
+    auto output = op->checkOutputLocal();
+    bool isScan = (output && hasScanRead(output)) ||
+        std::any_of(loopTemporaries.begin(), loopTemporaries.end(), hasScanRead);
+    if(isScan && (!loc->type.isScalarType() || !op->op.isAssociative() || !op->op.isCommutative()))
+    {
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Prefix accumulation is only supported for scalar associative and commutative operations: "
+                << op->to_string() << logging::endl);
+        return {};
+    }
+
     auto initialValue = initialWrite->precalculate().first;
-    if(initialValue == op->op.getLeftIdentity())
-        // no initial value to add
+    auto identity = op->op.getLeftIdentity();
+    if(isScan || op->op.isIdempotent())
+    {
+        // all elements of prefix accumulations start with the initial value anyway and applying the initial value to
+        // every element does not change the result of idempotent operations (e.g. min, max, or). This requires the
+        // (possibly non-constant) initial value to be replicated into all elements, which is done together with all
+        // other writes of vectorized locals before the loop, see #replicateVectorizedLocal
+        if(!findBeforeLoop(loop, initialWrite))
+        {
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Cannot replicate initial value of accumulation not written directly before the loop: "
+                    << initialWrite->to_string() << logging::endl);
+            return {};
+        }
+        initialValue = NO_VALUE;
+    }
+    else if(initialValue && identity && initialValue->getLiteralValue() == identity->getLiteralValue())
+        // no initial value to add, also for vector accumulations initializing all elements with the identity
         initialValue = NO_VALUE;
     else if(!initialValue || !initialValue->type.isScalarType() || !op->op.isAssociative() || !op->op.isCommutative() ||
         (!dynamic_cast<const MoveOperation*>(initialWrite) && !dynamic_cast<const LoadImmediate*>(initialWrite)))
@@ -1558,7 +1843,7 @@ static Optional<AccumulationInfo> determineAccumulation(const Local* loc, const
         }
     }
 
-    if(toBeFolded.empty())
+    if(toBeFolded.empty() && !isScan)
     {
         CPPLOG_LAZY(logging::Level::DEBUG,
             log << "Failed to find consumer for local '" << loc->to_string()
@@ -1567,13 +1852,15 @@ static Optional<AccumulationInfo> determineAccumulation(const Local* loc, const
     }
 
     CPPLOG_LAZY(logging::Level::DEBUG,
-        log << "Local '" << loc->to_string() << "' is accumulated with operation '" << op->op.name << "' into {"
+        log << "Local '" << loc->to_string() << "' is " << (isScan ? "prefix-" : "") << "accumulated with operation '"
+            << op->op.name << "' into {"
             << vc4c::to_string<const Local*>(outputLocals) << "}"
             << (toBeMasked.empty() ? "" : (" (masked in " + to_string<const Local*>(toBeMasked) + ")"))
             << " in: " << vc4c::to_string<const LocalUser*>(toBeFolded) << logging::endl);
 
     return AccumulationInfo{loc, op->op, std::move(outputLocals), std::move(toBeFolded), std::move(toBeMasked),
-        initialValue, const_cast<IntermediateInstruction*>(initialWrite)};
+        initialValue, const_cast<IntermediateInstruction*>(initialWrite), const_cast<Operation*>(op), accumulatedLocal,
+        const_cast<IntermediateInstruction*>(loopWrite), isScan};
 }
 
 std::size_t optimizations::vectorizeLoops(const Module& module, Method& method, const Configuration& config)
@@ -1650,7 +1937,17 @@ std::size_t optimizations::vectorizeLoops(const Module& module, Method& method,
             {
                 if(candidate == inductionVariable.local)
                     continue;
-                if(auto info = determineAccumulation(candidate, loop))
+                auto info = determineAccumulation(candidate, loop);
+                if(info && info->isScan && dynamicElementCount)
+                {
+                    // we need to know statically which element holds the accumulation of the whole iteration
+                    CPPLOG_LAZY(logging::Level::DEBUG,
+                        log << "Skipping loop with prefix accumulation and dynamic iteration count: "
+                            << candidate->to_string() << logging::endl);
+                    unknownDependency = true;
+                    continue;
+                }
+                if(info)
                 {
                     outputDependencies.erase(candidate);
                     for(auto otherLoc : info->outputLocals)
@@ -1702,8 +1999,12 @@ std::size_t optimizations::vectorizeLoops(const Module& module, Method& method,
         }
 
         // 5. cost-benefit calculation
+        FastMap<const RAMAccessInstruction*, int32_t> stridedVPMAccesses;
+        auto numScans = std::count_if(accumulationsToFold.begin(), accumulationsToFold.end(),
+            [](const auto& entry) -> bool { return entry.second.isScan; });
         int rating = calculateCostsVsBenefits(loop, inductionVariable, vectorizationFactor,
-            static_cast<unsigned>(accumulationsToFold.size()), dynamicElementCount.has_value());
+            static_cast<unsigned>(accumulationsToFold.size()), static_cast<unsigned>(numScans),
+            dynamicElementCount.has_value(), stridedVPMAccesses);
         if(rating < 0 /* TODO some positive factor to be required before vectorizing loops? */)
         {
             // vectorization (probably) doesn't pay off
@@ -1723,6 +2024,13 @@ std::size_t optimizations::vectorizeLoops(const Module& module, Method& method,
         }
 
         // 7. run vectorization
+        for(const auto& access : stridedVPMAccesses)
+        {
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Accessing elements with a stride of " << access.second
+                    << " bytes as separate memory rows: " << access.first->to_string() << logging::endl);
+            access.first->getVPMCacheEntry()->memoryElementStride = Value(Literal(access.second), TYPE_INT32);
+        }
         vectorize(loop, inductionVariable, method, vectorizationFactor, *stepConstant, accumulationsToFold,
             dynamicElementCount);
         // increasing the iteration step might create a value not fitting into small immediate
@@ -2035,3 +2343,460 @@ std::size_t optimizations::combineVectorElementCopies(const Module& module, Meth
 
     return numChanges;
 }
+
+// maximum depth of recursive look-ups of the writers of locals for the work-item coarsening
+static constexpr unsigned MAX_COARSENING_DEPTH = 16;
+
+namespace
+{
+    /*
+     * The values and instructions which differ between the work-items merged into the SIMD elements of a single QPU
+     */
+    struct CoarseningInfo
+    {
+        // the locals which have different values for the merged work-items
+        FastSet<const Local*> varyingLocals;
+        // the instructions which need to be executed for all merged work-items in their respective SIMD elements
+        FastSet<const IntermediateInstruction*> varyingInstructions;
+        // instructions which need to be executed per merged work-item without accessing any varying local, e.g.
+        // instructions depending on flags set by a varying instruction
+        FastSet<const IntermediateInstruction*> forcedInstructions;
+        // the conditionally executed varying instructions and the instructions setting the flags they depend on
+        FastMap<const IntermediateInstruction*, const IntermediateInstruction*> conditionalInstructions;
+        // the instructions reading the local ID in X dimension
+        FastSet<const IntermediateInstruction*> localIdReads;
+        // the locals written by the local ID reads, which are the source of all varying values
+        FastSet<const Local*> localIdLocals;
+    };
+} // namespace
+
+static bool isVarying(const Value& val, const CoarseningInfo& info)
+{
+    auto loc = val.checkLocal();
+    return loc && info.varyingLocals.find(loc) != info.varyingLocals.end();
+}
+
+static bool isSplatInstruction(const IntermediateInstruction& inst, const CoarseningInfo& info,
+    FastSet<const Local*>& visitedLocals, unsigned depth);
+
+/*
+ * Returns whether all SIMD elements of the given value are guaranteed to contain the same value
+ */
+static bool isSplatValue(
+    const Value& val, const CoarseningInfo& info, FastSet<const Local*>& visitedLocals, unsigned depth = 0)
+{
+    if(isVarying(val, info))
+        return false;
+    if(val.isAllSame() || val.hasRegister(REG_UNIFORM))
+        return true;
+    auto loc = val.checkLocal();
+    if(!loc || depth > MAX_COARSENING_DEPTH)
+        return false;
+    if(loc->is<Parameter>() || loc->is<BuiltinLocal>())
+        // are loaded from UNIFORMs
+        return true;
+    if(!visitedLocals.emplace(loc).second)
+        // (e.g. a loop counter), assume splat here, since all other writers are checked anyway
+        return true;
+    bool allSplat = true;
+    bool hasWriter = false;
+    loc->forUsers(LocalUse::Type::WRITER, [&](const LocalUser* writer) {
+        hasWriter = true;
+        allSplat = allSplat && isSplatInstruction(*writer, info, visitedLocals, depth + 1);
+    });
+    return hasWriter && allSplat;
+}
+
+static bool isSplatInstruction(const IntermediateInstruction& inst, const CoarseningInfo& info,
+    FastSet<const Local*>& visitedLocals, unsigned depth)
+{
+    if(inst.hasConditionalExecution() || inst.getVectorRotation())
+        return false;
+    if(auto load = dynamic_cast<const LoadImmediate*>(&inst))
+        return load->type == LoadType::REPLICATE_INT32;
+    if(!dynamic_cast<const Operation*>(&inst) && !dynamic_cast<const MoveOperation*>(&inst))
+        return false;
+    const auto& args = inst.getArguments();
+    return std::all_of(args.begin(), args.end(),
+        [&](const Value& arg) -> bool { return isSplatValue(arg, info, visitedLocals, depth); });
+}
+
+static bool isSplatValue(const Value& val, const CoarseningInfo& info)
+{
+    FastSet<const Local*> visitedLocals;
+    return isSplatValue(val, info, visitedLocals);
+}
+
+/*
+ * Returns the difference of the given value between two adjacent merged work-items, if it is statically known
+ */
+static Optional<int32_t> getLaneStride(const Value& val, const CoarseningInfo& info, unsigned depth = 0)
+{
+    if(!isVarying(val, info))
+        return 0;
+    auto loc = val.local();
+    if(info.localIdLocals.find(loc) != info.localIdLocals.end())
+        return 1;
+    auto writer = loc->getSingleWriter();
+    if(!writer || depth > MAX_COARSENING_DEPTH || writer->hasConditionalExecution() || writer->hasUnpackMode() ||
+        writer->hasPackMode())
+        return {};
+    if(auto source = writer->getMoveSource())
+        return getLaneStride(*source, info, depth + 1);
+    auto op = dynamic_cast<const Operation*>(writer);
+    if(!op || !op->getSecondArg())
+        return {};
+    return combineStrides(
+        *op, getLaneStride(op->getFirstArg(), info, depth + 1), getLaneStride(*op->getSecondArg(), info, depth + 1));
+}
+
+static bool rejectCoarsening(const IntermediateInstruction& inst, const std::string& reason)
+{
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Cannot merge work-items, " << reason << ": " << inst.to_string() << logging::endl);
+    return false;
+}
+
+/*
+ * Marks the instructions of the same basic block depending on the output or flags of the given varying instruction to
+ * be executed per merged work-item too
+ */
+static bool forceDependentInstructions(InstructionWalker it, CoarseningInfo& info)
+{
+    if(auto reg = it->checkOutputRegister())
+    {
+        if(reg->isSpecialFunctionsUnit())
+        {
+            auto checkIt = it.copy().nextInBlock();
+            while(!checkIt.isEndOfBlock() && !(checkIt.has() && checkIt->readsRegister(REG_SFU_OUT)))
+                checkIt.nextInBlock();
+            if(!checkIt.isEndOfBlock())
+                info.forcedInstructions.emplace(checkIt.get());
+        }
+        else if(*reg != REG_NOP)
+            return rejectCoarsening(*it.get(), "writes varying value to register");
+    }
+    if(it->doesSetFlag())
+    {
+        for(auto checkIt = it.copy().nextInBlock(); !checkIt.isEndOfBlock(); checkIt.nextInBlock())
+        {
+            if(!checkIt.has())
+                continue;
+            if(auto branch = checkIt.get<const Branch>())
+            {
+                if(!branch->isUnconditional())
+                    return rejectCoarsening(*branch, "control flow diverges between work-items");
+            }
+            else if(checkIt->hasConditionalExecution())
+                info.forcedInstructions.emplace(checkIt.get());
+            if(checkIt->doesSetFlag())
+                break;
+        }
+    }
+    return true;
+}
+
+/*
+ * Checks whether the given memory access can be executed for all merged work-items at once and marks the accompanying
+ * accesses of the same cache entry to be executed per merged work-item too
+ */
+static bool checkVaryingMemoryAccess(const RAMAccessInstruction& access, CoarseningInfo& info)
+{
+    auto numEntries = access.getNumEntries().getLiteralValue();
+    if(!isVarying(access.getMemoryAddress(), info) || !numEntries || numEntries->unsignedInt() != 1)
+        return rejectCoarsening(access, "unsupported memory access");
+    if(auto tmuEntry = access.getTMUCacheEntry())
+    {
+        // each SIMD element loads the address of its work-item
+        auto numElements = tmuEntry->numVectorElements.getLiteralValue();
+        if(access.op != MemoryOperation::READ || !numElements || numElements->unsignedInt() != 1)
+            return rejectCoarsening(access, "unsupported TMU access");
+        if(auto reader = tmuEntry->getCacheReader())
+            info.forcedInstructions.emplace(reader);
+        return true;
+    }
+    if(auto vpmEntry = access.getVPMCacheEntry())
+    {
+        // the merged work-items need to access adjacent elements, which are then accessed as a single vector
+        auto stride = getLaneStride(access.getMemoryAddress(), info);
+        auto vectorWidth = vpmEntry->getVectorWidth().getLiteralValue();
+        if(!stride || *stride != static_cast<int32_t>(vpmEntry->getScalarType().getInMemoryWidth()) ||
+            !vectorWidth || vectorWidth->unsignedInt() != 1 || isVarying(vpmEntry->inAreaByteOffset, info) ||
+            (access.op != MemoryOperation::READ && access.op != MemoryOperation::WRITE))
+            return rejectCoarsening(access, "unsupported VPM access");
+        for(auto cacheAccess : vpmEntry->getQPUAccesses())
+            info.forcedInstructions.emplace(cacheAccess);
+        return true;
+    }
+    return rejectCoarsening(access, "unsupported memory access");
+}
+
+/*
+ * Checks whether the given instruction (accessing varying values) can be executed for all merged work-items at once
+ */
+static bool checkVaryingInstruction(InstructionWalker it, CoarseningInfo& info)
+{
+    auto inst = it.get();
+    if(auto loc = inst->checkOutputLocal())
+    {
+        // we can only merge scalar values into the SIMD elements
+        if((!loc->type.isScalarType() && !loc->type.getPointerType()) || loc->get<MultiRegisterData>())
+            return rejectCoarsening(*inst, "non-scalar varying value");
+        info.varyingLocals.emplace(loc);
+    }
+    if(inst->getVectorRotation())
+        return rejectCoarsening(*inst, "varying value is rotated");
+    if(auto access = it.get<const RAMAccessInstruction>())
+    {
+        if(!checkVaryingMemoryAccess(*access, info))
+            return false;
+    }
+    else if(!it.get<const Operation>() && !it.get<const MoveOperation>() && !it.get<const LoadImmediate>() &&
+        !it.get<const CacheAccessInstruction>())
+        return rejectCoarsening(*inst, "unsupported instruction");
+    if(inst->hasConditionalExecution())
+    {
+        auto flagsIt = it.getBasicBlock()->findLastSettingOfFlags(it);
+        if(!flagsIt)
+            return rejectCoarsening(*inst, "unknown flags");
+        info.conditionalInstructions.emplace(inst, flagsIt->get());
+    }
+    return forceDependentInstructions(it, info);
+}
+
+/*
+ * Determines the values and instructions which differ between the merged work-items and checks whether all of them can
+ * be executed for multiple work-items in the SIMD elements of a single QPU
+ */
+static bool determineVaryingInstructions(Method& method, CoarseningInfo& info)
+{
+    auto localIds = method.findBuiltin(BuiltinLocal::Type::LOCAL_IDS);
+    if(!localIds)
+        return false;
+    bool supportedReads = true;
+    localIds->forUsers(LocalUse::Type::READER, [&](const LocalUser* reader) {
+        auto move = dynamic_cast<const MoveOperation*>(reader);
+        auto output = reader->checkOutputLocal();
+        if(move && move->getUnpackMode() == UNPACK_8A_32 && output && output->getSingleWriter() == reader &&
+            !move->hasConditionalExecution() && !move->hasPackMode())
+        {
+            info.localIdReads.emplace(reader);
+            info.localIdLocals.emplace(output);
+            info.varyingLocals.emplace(output);
+        }
+        else if(!move || (move->getUnpackMode() != UNPACK_8B_32 && move->getUnpackMode() != UNPACK_8C_32))
+            // the local IDs in Y and Z dimension are always zero, any other access is not supported
+            supportedReads = false;
+    });
+    if(!supportedReads || info.localIdReads.empty())
+        return false;
+
+    bool changed = true;
+    while(changed)
+    {
+        changed = false;
+        for(auto it = method.walkAllInstructions(); !it.isEndOfMethod(); it.nextInMethod())
+        {
+            if(!it.has() || info.localIdReads.find(it.get()) != info.localIdReads.end() ||
+                info.varyingInstructions.find(it.get()) != info.varyingInstructions.end())
+                continue;
+            const auto& args = it->getArguments();
+            bool isVaryingInstruction = info.forcedInstructions.find(it.get()) != info.forcedInstructions.end() ||
+                (it->getOutput() && isVarying(*it->getOutput(), info)) ||
+                std::any_of(args.begin(), args.end(), [&](const Value& arg) -> bool { return isVarying(arg, info); });
+            if(!isVaryingInstruction)
+                continue;
+            if(!checkVaryingInstruction(it, info))
+                return false;
+            info.varyingInstructions.emplace(it.get());
+            changed = true;
+        }
+    }
+
+    bool hasVaryingWrite = false;
+    for(auto inst : info.varyingInstructions)
+    {
+        auto conditionalIt = info.conditionalInstructions.find(inst);
+        if(conditionalIt != info.conditionalInstructions.end() &&
+            info.varyingInstructions.find(conditionalIt->second) == info.varyingInstructions.end())
+        {
+            // the flags set by a non-varying instruction need to be the same for all SIMD elements
+            FastSet<const Local*> visitedLocals;
+            if(!isSplatInstruction(*conditionalIt->second, info, visitedLocals, 0))
+                return rejectCoarsening(*inst, "depends on non-uniform flags");
+        }
+        if(auto cacheAccess = dynamic_cast<const CacheAccessInstruction*>(inst))
+        {
+            // the cache entry can only be widened if all accesses to it are
+            auto memoryAccesses = cacheAccess->cache->getMemoryAccesses();
+            if(memoryAccesses.empty() ||
+                std::any_of(memoryAccesses.begin(), memoryAccesses.end(), [&](const RAMAccessInstruction* access) {
+                    return info.varyingInstructions.find(access) == info.varyingInstructions.end();
+                }))
+                return rejectCoarsening(*inst, "cache entry is not accessed per work-item");
+        }
+        if(auto ramAccess = dynamic_cast<const RAMAccessInstruction*>(inst))
+            hasVaryingWrite = hasVaryingWrite || ramAccess->op != MemoryOperation::READ;
+    }
+    // without any work-item specific memory write, there is nothing to be gained
+    return hasVaryingWrite;
+}
+
+/*
+ * Rewrites the varying instructions to execute all merged work-items in the SIMD elements of a single QPU
+ */
+static void applyCoarsening(Method& method, const CoarseningInfo& info, uint8_t factor)
+{
+    // the scalar varying locals are replaced with vector locals holding the values of all merged work-items
+    FastMap<const Local*, Value> widenedLocals;
+    for(auto loc : info.varyingLocals)
+    {
+        // pointers are always handled per SIMD element anyway
+        if(!loc->type.getPointerType())
+            widenedLocals.emplace(loc, method.addNewLocal(loc->type.toVectorType(factor), loc->name));
+    }
+    auto toWidenedValue = [&](const Local* loc) -> Value {
+        auto it = widenedLocals.find(loc);
+        return it != widenedLocals.end() ? it->second : loc->createReference();
+    };
+
+    for(auto it = method.walkAllInstructions(); !it.isEndOfMethod(); it.nextInMethod())
+    {
+        if(!it.has())
+            continue;
+        if(info.localIdReads.find(it.get()) != info.localIdReads.end())
+        {
+            // local_id(0) of SIMD element = local_id(0) of first merged work-item (from UNIFORM) + element number
+            auto output = it->checkOutputLocal();
+            auto base = method.addNewLocal(TYPE_INT8, "%local_id_base");
+            it->setOutput(base);
+            auto decorations = it->decoration;
+            it.nextInBlock();
+            assign(it, toWidenedValue(output)) = (base + ELEMENT_NUMBER_REGISTER, decorations);
+            it.previousInBlock();
+            continue;
+        }
+        if(info.varyingInstructions.find(it.get()) == info.varyingInstructions.end())
+            continue;
+
+        auto inst = it.get();
+        inst->decoration = remove_flag(inst->decoration, InstructionDecorations::IDENTICAL_ELEMENTS);
+        inst->decoration = remove_flag(inst->decoration, InstructionDecorations::WORK_GROUP_UNIFORM_VALUE);
+        FastSet<const Local*> varyingLocals;
+        std::vector<Value> uniformArgs;
+        if(auto loc = inst->checkOutputLocal())
+            varyingLocals.emplace(loc);
+        for(const auto& arg : inst->getArguments())
+        {
+            if(isVarying(arg, info))
+                varyingLocals.emplace(arg.local());
+            else if(arg.checkLocal() && !isSplatValue(arg, info))
+                uniformArgs.push_back(arg);
+        }
+        for(auto loc : varyingLocals)
+            inst->replaceLocal(loc, toWidenedValue(loc));
+        for(const auto& arg : uniformArgs)
+        {
+            // make sure all merged work-items see the (first/only valid element of the) uniform value
+            auto splat = method.addNewLocal(
+                arg.type.getPointerType() ? arg.type : arg.type.toVectorType(factor), "%coarsened_splat");
+            it = insertReplication(it, arg, splat);
+            it->replaceValue(arg, splat, LocalUse::Type::READER);
+        }
+
+        if(auto access = it.get<RAMAccessInstruction>())
+        {
+            if(auto tmuEntry = access->getTMUCacheEntry())
+            {
+                // the addresses of the single work-items are already calculated per SIMD element
+                assign(it, tmuEntry->addresses) = access->getMemoryAddress();
+                tmuEntry->customAddressCalculation = true;
+                tmuEntry->numVectorElements = Value(Literal(static_cast<uint32_t>(factor)), TYPE_INT8);
+            }
+            if(auto vpmEntry = access->getVPMCacheEntry())
+                vpmEntry->setStaticElementCount(factor);
+        }
+    }
+    method.metaData.mergedWorkItemsFactor = factor;
+}
+
+/*
+ * Checks via the work-item analysis whether all basic blocks are executed either by all or by none of the merged
+ * work-items, since the control flow cannot diverge between the SIMD elements of a single QPU
+ */
+static bool hasUniformControlFlow(Method& method, uint32_t factor)
+{
+    for(const auto& entry : analysis::determineActiveWorkItems(method, method.getCFG()))
+    {
+        const auto& activeItems = entry.second;
+        bool allActive = true;
+        switch(activeItems.condition)
+        {
+        case analysis::WorkItemCondition::LOCAL_ID_X:
+        case analysis::WorkItemCondition::LOCAL_ID_SCALAR:
+            // the whole work-group is merged, so the merged work-items are exactly the local IDs [0, factor)
+            for(uint32_t i = 0; i < factor; ++i)
+                allActive = allActive && activeItems.isActive(i);
+            break;
+        case analysis::WorkItemCondition::LOCAL_ID_Y:
+        case analysis::WorkItemCondition::LOCAL_ID_Z:
+            // the local IDs in Y and Z dimension are zero for all merged work-items
+            allActive = activeItems.isActive(0);
+            break;
+        case analysis::WorkItemCondition::GLOBAL_ID_X:
+        case analysis::WorkItemCondition::GLOBAL_ID_Y:
+        case analysis::WorkItemCondition::GLOBAL_ID_Z:
+            // we do not know which global IDs are merged into a single QPU execution
+            allActive = activeItems.activeElements.empty() && activeItems.inactiveElements.empty();
+            break;
+        default:
+            // the conditions on the work-group (size or ID) are the same for all merged work-items
+            break;
+        }
+        if(!allActive)
+        {
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Cannot merge work-items, control flow diverges for " << entry.first->to_string() << ": "
+                    << activeItems.to_string() << logging::endl);
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t optimizations::coarsenWorkItems(const Module& module, Method& method, const Configuration& config)
+{
+    if(method.empty() || method.metaData.mergedWorkItemsFactor > 1)
+        return 0;
+    // The whole work-group is merged into a single QPU execution, so the work-group size needs to be known and fit
+    const auto& workGroupSizes = method.metaData.workGroupSizes;
+    auto factor = workGroupSizes[0];
+    if(factor < 2 || factor > NATIVE_VECTOR_SIZE || (factor & (factor - 1)) != 0 || workGroupSizes[1] > 1 ||
+        workGroupSizes[2] > 1)
+        return 0;
+
+    for(auto it = method.walkAllInstructions(); !it.isEndOfMethod(); it.nextInMethod())
+    {
+        // these instructions are not executed once per work-item anymore or cannot be analyzed (yet)
+        if(it.get<SemaphoreAdjustment>() || it.get<MutexLock>() || it.get<MemoryInstruction>() ||
+            it.get<MethodCall>() || it.get<IntrinsicOperation>())
+        {
+            rejectCoarsening(*it.get(), "unsupported instruction");
+            return 0;
+        }
+    }
+
+    if(!hasUniformControlFlow(method, factor))
+        return 0;
+
+    CoarseningInfo info;
+    if(!determineVaryingInstructions(method, info))
+        return 0;
+
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Merging " << factor << " work-items into the SIMD elements of a single QPU for kernel: " << method.name
+            << logging::endl);
+    applyCoarsening(method, info, static_cast<uint8_t>(factor));
+    PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION, "Work-items merged", factor);
+    return info.varyingInstructions.size();
+}
@@ -57,6 +57,28 @@ namespace vc4c
          *   %out = %in (ifzc)
          */
         std::size_t combineVectorElementCopies(const Module& module, Method& method, const Configuration& config);
+        /**
+         * Merges all work-items of a work-group into the SIMD elements of a single QPU execution.
+         *
+         * This is applicable for kernels with a fixed one-dimensional work-group size of up to 16 work-items, where all
+         * work-items execute the same control flow and only the local ID (and values calculated from it) as well as
+         * the accessed memory differs between work-items. E.g. this:
+         *   %id = %local_ids (unpack 8a)
+         *   [...]
+         *   %out = %in_a + %in_b
+         *
+         * is converted to this (for a work-group size of 16):
+         *   %id_base = %local_ids (unpack 8a)
+         *   %id = %id_base + elem_num
+         *   [...]
+         *   %out = %in_a + %in_b (int16 instead of int)
+         *
+         * and sets the merged work-items factor of the kernel, so the run-time only starts one QPU per work-group.
+         *
+         * NOTE: Work-items with diverging control flow, synchronization or memory accesses of non-adjacent elements via
+         * VPM are not supported.
+         */
+        std::size_t coarsenWorkItems(const Module& module, Method& method, const Configuration& config);
 
     } // namespace optimizations
 
@@ -359,6 +359,12 @@ InstructionWalker periphery::insertWriteDMA(
     return it;
 }
 
+InstructionWalker periphery::insertWaitDMA(InstructionWalker it, bool waitForWrite)
+{
+    assign(it, NOP_REGISTER) = waitForWrite ? VPM_DMA_STORE_WAIT_REGISTER : VPM_DMA_LOAD_WAIT_REGISTER;
+    return it;
+}
+
 std::pair<DataType, uint32_t> periphery::getBestVectorSize(uint32_t numBytes)
 {
     for(uint8_t numElements = 16; numElements > 0; --numElements)
@@ -800,11 +806,37 @@ void VPMArea::checkAreaSize(DataType accessElementType, uint32_t numElements) co
     // TODO check for element alignment, e.g. access element type bit-width <= stored element type bit-width?
 }
 
+bool VPMArea::isPerQPU() const
+{
+    return usageType == VPMUsage::REGISTER_SPILLING || usageType == VPMUsage::STACK ||
+        usageType == VPMUsage::DMA_BUFFER;
+}
+
+bool VPMArea::overlaps(const VPMArea& other) const
+{
+    if(rowOffset >= other.rowOffset + other.numRows || other.rowOffset >= rowOffset + numRows)
+        return false;
+    return liveRange.overlaps(other.liveRange, isPerQPU() && other.isPerQPU());
+}
+
 bool VPMArea::operator<(const VPMArea& other) const
 {
     return rowOffset < other.rowOffset;
 }
 
+bool VPMLiveRange::overlaps(const VPMLiveRange& other, bool bothPerQPU) const
+{
+    if(bothPerQPU)
+        return firstBlock <= other.lastBlock && other.firstBlock <= lastBlock;
+    return firstSection <= other.lastSection && other.firstSection <= lastSection;
+}
+
+bool VPMLiveRange::isWholeKernel() const
+{
+    return firstBlock == 0 && lastBlock == std::numeric_limits<std::size_t>::max() && firstSection == 0 &&
+        lastSection == std::numeric_limits<std::size_t>::max();
+}
+
 static DataType simplifyComplexTypes(DataType type)
 {
     if(auto arrayType = type.getArrayType())
@@ -870,9 +902,11 @@ NODISCARD static VPWGenericSetup toWriteSetup(const VPMArea& area, DataType scal
  * element-type and number of rows of the given type.
  *
  * If the data-type is set to unknown, the element-type of the local associated with this area is used
+ *
+ * If transposed is set, the elements of the (single) vector are written as separate memory rows of one element each.
  */
 NODISCARD static InstructionWalker insertWriteDMASetup(InstructionWalker it, Value& setup, const VPMArea& area,
-    DataType scalarType, const Value& vectorWidth, Value numRows)
+    DataType scalarType, const Value& vectorWidth, Value numRows, bool transposed = false)
 {
     if(scalarType.isUnknown())
         throw CompilationError(
@@ -893,7 +927,7 @@ NODISCARD static InstructionWalker insertWriteDMASetup(InstructionWalker it, Val
 
     // by "default", one value per row, so we need to store the number of values as number of rows
     auto rowDepth = vectorWidth;
-    if(area.canBePackedIntoRow())
+    if(area.canBePackedIntoRow() && !transposed)
     {
         // if we have the row packed, we need to calculate the row-width from the maximum row-width and the number of
         // elements
@@ -915,7 +949,7 @@ NODISCARD static InstructionWalker insertWriteDMASetup(InstructionWalker it, Val
     auto units = getSourceValue(numRows);
     units = units.getConstantValue().value_or(units);
     auto horizontal = IS_HORIZONTAL;
-    if(is64BitType)
+    if(is64BitType || transposed)
     {
         // invert Depth and Units, since we also read from VPM vertical
         std::swap(depth, units);
@@ -983,9 +1017,11 @@ NODISCARD static VPRGenericSetup toReadSetup(const VPMArea& area, DataType scala
  * given the element-type and number of rows of the given type.
  *
  * If the data-type is set to unknown, the default element-type of this area is used
+ *
+ * If transposed is set, the elements of the (single) vector are read from separate memory rows of one element each.
  */
 NODISCARD static InstructionWalker insertReadDMASetup(InstructionWalker it, Value& setup, const VPMArea& area,
-    DataType scalarType, const Value& vectorWidth, Value numRows)
+    DataType scalarType, const Value& vectorWidth, Value numRows, bool transposed = false)
 {
     if(scalarType.isUnknown())
         throw CompilationError(
@@ -1018,7 +1054,7 @@ NODISCARD static InstructionWalker insertReadDMASetup(InstructionWalker it, Valu
     numRows = getSourceValue(numRows);
     numRows = numRows.getConstantValue().value_or(numRows);
     bool vertical = !IS_HORIZONTAL;
-    if(is64BitType)
+    if(is64BitType || transposed)
     {
         // invert length and number of rows, since we also write to VPM vertical
         std::swap(rowLength, numRows);
@@ -1065,6 +1101,8 @@ static std::string toUsageString(VPMUsage usage, const Local* local)
         return "scratch area";
     case VPMUsage::STACK:
         return "stack" + (local ? " " + local->to_string() : "");
+    case VPMUsage::DMA_BUFFER:
+        return "DMA buffer";
     }
     throw CompilationError(
         CompilationStep::GENERAL, "Unhandled VPM usage type", std::to_string(static_cast<unsigned>(usage)));
@@ -1093,7 +1131,15 @@ std::string VPMArea::to_string() const
     return toUsageString(usageType, originalAddress) + " with " + elementType.to_string() + " elements, rows[" +
         std::to_string(static_cast<unsigned>(rowOffset)) + ", " +
         std::to_string(static_cast<unsigned>(rowOffset + numRows)) + "[" + ::toString(flags) +
-        (canBePackedIntoRow() ? " (packed)" : "");
+        (canBePackedIntoRow() ? " (packed)" : "") + (liveRange.isWholeKernel() ? "" : " " + liveRange.to_string());
+}
+
+std::string VPMLiveRange::to_string() const
+{
+    if(isWholeKernel())
+        return "live in whole kernel";
+    return "live in blocks [" + std::to_string(firstBlock) + ", " + std::to_string(lastBlock) + "] and sections [" +
+        std::to_string(firstSection) + ", " + std::to_string(lastSection) + "]";
 }
 LCOV_EXCL_STOP
 
@@ -1101,7 +1147,8 @@ LCOV_EXCL_STOP
 static std::atomic_uint vpmCacheEntryCounter{0};
 
 VPMCacheEntry::VPMCacheEntry(const VPMArea& area, DataType type, const Value& innerByteOffset) :
-    index(vpmCacheEntryCounter++), area(area), inAreaByteOffset(innerByteOffset), elementType(type),
+    index(vpmCacheEntryCounter++), area(area), inAreaByteOffset(innerByteOffset), memoryPitch(UNDEFINED_VALUE),
+    memoryElementStride(UNDEFINED_VALUE), asynchronousDMA(false), elementType(type),
     dynamicVectorWidth(Value(Literal(type.getVectorWidth()), TYPE_INT8))
 {
     area.checkAreaSize(type, 1u);
@@ -1114,7 +1161,10 @@ std::string VPMCacheEntry::to_string() const
 {
     return "VPM cache entry " + std::to_string(index) + " (" + elementType.to_string() +
         (!dynamicVectorWidth.isUndefined() ? " with " + dynamicVectorWidth.to_string() + " elements" : "") +
-        " and offset " + inAreaByteOffset.to_string() + " bytes to base " + area.to_string() + ")";
+        " and offset " + inAreaByteOffset.to_string() + " bytes to base " + area.to_string() +
+        (!memoryPitch.isUndefined() ? " with memory pitch " + memoryPitch.to_string() : "") +
+        (!memoryElementStride.isUndefined() ? " with element stride " + memoryElementStride.to_string() : "") +
+        (asynchronousDMA ? " with asynchronous DMA" : "") + ")";
 }
 LCOV_EXCL_STOP
 
@@ -1152,13 +1202,12 @@ void VPMCacheEntry::setDynamicElementCount(const Value& numElements)
     dynamicVectorWidth = numElements;
 }
 
-VPM::VPM(const unsigned totalVPMSize) : maximumVPMSize(std::min(VPM_DEFAULT_SIZE, totalVPMSize)), areas(VPM_NUM_ROWS)
+VPM::VPM(const unsigned totalVPMSize) : maximumVPMSize(std::min(VPM_DEFAULT_SIZE, totalVPMSize))
 {
     // set a size of at least 2 row (for 64-bit data), so if no scratch is used, the first area has an offset of != 0
     // and therefore is different than the scratch-area
-    auto scratch = std::make_shared<VPMArea>(VPMUsage::SCRATCH, 0, 2, TYPE_INT32.toVectorType(NATIVE_VECTOR_SIZE),
-        add_flag(VPMAreaAccessFlags::QPU_ACCESS_VECTOR_ALIGNED, VPMAreaAccessFlags::QPU_ACCESS_SINGLE_VECTOR));
-    areas[0] = areas[1] = scratch;
+    areas.emplace_back(std::make_shared<VPMArea>(VPMUsage::SCRATCH, 0, 2, TYPE_INT32.toVectorType(NATIVE_VECTOR_SIZE),
+        add_flag(VPMAreaAccessFlags::QPU_ACCESS_VECTOR_ALIGNED, VPMAreaAccessFlags::QPU_ACCESS_SINGLE_VECTOR)));
 }
 
 const VPMArea& VPM::getScratchArea() const
@@ -1169,33 +1218,65 @@ const VPMArea& VPM::getScratchArea() const
 const VPMArea* VPM::findArea(const Local* local)
 {
     for(const auto& area : areas)
-        if(area && area->originalAddress == local)
+        if(area->originalAddress == local)
             return area.get();
     return nullptr;
 }
 
-static Optional<uint32_t> findFreeVPMRows(const std::vector<std::shared_ptr<VPMArea>>& rows, uint32_t numRows)
+static bool usesRow(const VPMArea& area, unsigned row)
 {
-    // find free consecutive space in VPM with the requested size and return it
-    // to keep the remaining space free for scratch, we start allocating space from the end of the VPM
-    uint32_t numFreeRows = 0;
-    for(auto i = rows.size() - 1; i > 0 /* index 0 is always reserved for scratch */; --i)
+    return row >= area.rowOffset && row < (area.rowOffset + area.numRows);
+}
+
+Optional<unsigned> VPM::findFreeRows(unsigned numRows, const VPMLiveRange& liveRange, bool perQPU) const
+{
+    // find free consecutive space in VPM with the requested size, which is not used by any other area during the given
+    // live range, and return it.
+    // To keep the remaining space free for scratch, we start allocating space from the end of the VPM
+    if(numRows == 0 || numRows >= VPM_NUM_ROWS)
+        return {};
+    auto offset = VPM_NUM_ROWS - numRows;
+    while(offset > 0 /* index 0 is always reserved for scratch */)
     {
-        if(rows[i])
-        {
-            // row is already reserved
-            numFreeRows = 0;
-            continue;
-        }
-        else
-            ++numFreeRows;
-        if(numFreeRows >= numRows)
-            return static_cast<unsigned>(i);
+        auto conflictIt = std::find_if(areas.begin(), areas.end(), [&](const std::shared_ptr<VPMArea>& area) -> bool {
+            if(area->rowOffset >= offset + numRows || offset >= area->rowOffset + area->numRows)
+                return false;
+            // the scratch area can grow at any time, so it always conflicts
+            return area->usageType == VPMUsage::SCRATCH ||
+                area->liveRange.overlaps(liveRange, perQPU && area->isPerQPU());
+        });
+        if(conflictIt == areas.end())
+            return offset;
+        // skip all rows used by the conflicting area
+        if((*conflictIt)->rowOffset < numRows)
+            break;
+        offset = std::min(offset - 1, (*conflictIt)->rowOffset - numRows);
     }
     return {};
 }
 
-const VPMArea* VPM::addSharedArea(const Local& baseAddress, const FastAccessList<MemoryAccessRange>& accessRanges)
+const VPMArea* VPM::insertArea(std::shared_ptr<VPMArea>&& area)
+{
+    unsigned numReusedRows = 0;
+    for(unsigned row = area->rowOffset; row < (area->rowOffset + area->numRows); ++row)
+    {
+        if(std::any_of(areas.begin(), areas.end(),
+               [&](const std::shared_ptr<VPMArea>& other) -> bool { return usesRow(*other, row); }))
+            ++numReusedRows;
+    }
+    if(numReusedRows > 0)
+    {
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "VPM area " << area->to_string() << " reuses " << numReusedRows
+                << " rows of VPM areas with disjoint live ranges" << logging::endl);
+        PROFILE_COUNTER(vc4c::profiler::COUNTER_GENERAL, "VPM reused rows", numReusedRows);
+    }
+    areas.emplace_back(std::move(area));
+    return areas.back().get();
+}
+
+const VPMArea* VPM::addSharedArea(
+    const Local& baseAddress, const FastAccessList<MemoryAccessRange>& accessRanges, const VPMLiveRange& liveRange)
 {
     auto pointerType = baseAddress.type.getPointerType();
     if(!pointerType)
@@ -1270,7 +1351,7 @@ const VPMArea* VPM::addSharedArea(const Local& baseAddress, const FastAccessList
         uint32_t numVectors = static_cast<uint32_t>(accessedRange.getRange()) / uniformAccessedType->getLogicalWidth();
         if(numVectors == 1u || minAlignment >= uniformAccessedType->getLogicalWidth())
             flags = add_flag(flags, VPMAreaAccessFlags::QPU_ACCESS_SINGLE_VECTOR);
-        return addSharedArea(baseAddress, *uniformAccessedType, numVectors, flags);
+        return addSharedArea(baseAddress, *uniformAccessedType, numVectors, flags, liveRange);
     }
 
     if(uniformElementType && uniformElementType->isScalarType() && largestSingleAccessRange.maxValue > 0)
@@ -1290,17 +1371,18 @@ const VPMArea* VPM::addSharedArea(const Local& baseAddress, const FastAccessList
             uint32_t numVectors = static_cast<uint32_t>(accessedRange.getRange()) / vectorType.getLogicalWidth();
             if(numVectors == 1u || minAlignment >= vectorType.getLogicalWidth())
                 flags = add_flag(flags, VPMAreaAccessFlags::QPU_ACCESS_SINGLE_VECTOR);
-            return addSharedArea(baseAddress, vectorType, numVectors, flags);
+            return addSharedArea(baseAddress, vectorType, numVectors, flags, liveRange);
         }
     }
 
     if(auto arrayContent = pointerType->elementType.getArrayType())
-        return addSharedArea(baseAddress, arrayContent->elementType, arrayContent->size);
-    return addSharedArea(baseAddress, pointerType->elementType, 1);
+        return addSharedArea(
+            baseAddress, arrayContent->elementType, arrayContent->size, VPMAreaAccessFlags::NONE, liveRange);
+    return addSharedArea(baseAddress, pointerType->elementType, 1, VPMAreaAccessFlags::NONE, liveRange);
 }
 
-const VPMArea* VPM::addSharedArea(
-    const Local& baseAddress, DataType elementType, uint32_t numElements, VPMAreaAccessFlags flags)
+const VPMArea* VPM::addSharedArea(const Local& baseAddress, DataType elementType, uint32_t numElements,
+    VPMAreaAccessFlags flags, const VPMLiveRange& liveRange)
 {
     if(!elementType.isSimpleType() && !elementType.getPointerType())
         throw CompilationError(CompilationStep::GENERAL,
@@ -1316,21 +1398,23 @@ const VPMArea* VPM::addSharedArea(
     if(area && area->elementType == elementType && area->numRows >= numRows)
         return area;
 
-    Optional<unsigned> rowOffset = findFreeVPMRows(areas, numRows);
+    Optional<unsigned> rowOffset = findFreeRows(numRows, liveRange, false);
     if(!rowOffset)
+    {
         // no more (big enough) free space on VPM
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Failed to allocate " << numRows << " rows of VPM cache for local '" << baseAddress.to_string(false)
+                << "', " << liveRange.to_string() << logging::endl);
         return nullptr;
+    }
 
-    auto ptr = std::make_shared<VPMArea>(
-        VPMUsage::LOCAL_MEMORY, static_cast<uint8_t>(rowOffset.value()), numRows, elementType, flags, &baseAddress);
-    for(auto i = rowOffset.value(); i < (rowOffset.value() + numRows); ++i)
-        areas[i] = ptr;
     CPPLOG_LAZY(logging::Level::DEBUG,
         log << "Allocating " << numRows << " rows of VPM cache starting at row " << rowOffset.value()
             << " for local '" << baseAddress.to_string(false) << "' with " << numElements << " vectors of type "
             << elementType.to_string() << logging::endl);
     PROFILE_COUNTER(vc4c::profiler::COUNTER_GENERAL, "VPM lowered RAM rows", numRows);
-    return ptr.get();
+    return insertArea(std::make_shared<VPMArea>(VPMUsage::LOCAL_MEMORY, static_cast<uint8_t>(rowOffset.value()),
+        numRows, elementType, flags, &baseAddress, liveRange));
 }
 
 const VPMArea* VPM::addCacheArea(const Local& baseAddress, DataType elementType, uint32_t numElements)
@@ -1343,53 +1427,65 @@ const VPMArea* VPM::addCacheArea(const Local& baseAddress, DataType elementType,
     if(area && area->elementType == elementType && area->numRows >= numRows)
         return area;
 
-    Optional<unsigned> rowOffset = findFreeVPMRows(areas, numRows);
+    // the cache is pre-loaded at the start and written back at the end of the kernel, so it is live in the whole kernel
+    Optional<unsigned> rowOffset = findFreeRows(numRows, VPMLiveRange{}, false);
     if(!rowOffset)
         // no more (big enough) free space on VPM
         return nullptr;
 
-    // for now align all new VPM areas at the beginning of a row
-    auto ptr = std::make_shared<VPMArea>(VPMUsage::RAM_CACHE, static_cast<uint8_t>(rowOffset.value()), numRows,
-        elementType, VPMAreaAccessFlags::NONE, &baseAddress);
-    for(auto i = rowOffset.value(); i < (rowOffset.value() + numRows); ++i)
-        areas[i] = ptr;
     CPPLOG_LAZY(logging::Level::DEBUG,
         log << "Allocating " << numRows << " rows of VPM cache starting at row " << rowOffset.value()
             << " for local '" << baseAddress.to_string(false) << "' as RAM cache with " << numElements
             << " elements of type " << elementType.to_string() << logging::endl);
     PROFILE_COUNTER(vc4c::profiler::COUNTER_GENERAL, "VPM cache RAM rows", numRows);
-    return ptr.get();
+    // for now align all new VPM areas at the beginning of a row
+    return insertArea(std::make_shared<VPMArea>(VPMUsage::RAM_CACHE, static_cast<uint8_t>(rowOffset.value()), numRows,
+        elementType, VPMAreaAccessFlags::NONE, &baseAddress));
 }
 
 const VPMArea* VPM::addSpillArea(unsigned numQPUs)
 {
-    Optional<unsigned> rowOffset = findFreeVPMRows(areas, numQPUs);
+    // the spilled registers are not tracked, so reserve one row per QPU for the whole kernel
+    Optional<unsigned> rowOffset = findFreeRows(numQPUs, VPMLiveRange{}, true);
     if(!rowOffset)
         // no more (big enough) free space on VPM
         return nullptr;
 
-    // for now align all new VPM areas at the beginning of a row
-    auto ptr = std::make_shared<VPMArea>(VPMUsage::REGISTER_SPILLING, static_cast<uint8_t>(rowOffset.value()), numQPUs,
-        TYPE_INT32.toVectorType(NATIVE_VECTOR_SIZE),
-        add_flag(VPMAreaAccessFlags::QPU_ACCESS_FULL_VECTOR, VPMAreaAccessFlags::QPU_ACCESS_SINGLE_VECTOR));
-    for(auto i = rowOffset.value(); i < (rowOffset.value() + numQPUs); ++i)
-        areas[i] = ptr;
     CPPLOG_LAZY(logging::Level::DEBUG,
         log << "Allocating " << numQPUs << " rows of VPM spill cache starting at row " << rowOffset.value()
             << logging::endl);
     PROFILE_COUNTER(vc4c::profiler::COUNTER_GENERAL, "VPM spill register rows", numQPUs);
-    return ptr.get();
+    // for now align all new VPM areas at the beginning of a row
+    return insertArea(std::make_shared<VPMArea>(VPMUsage::REGISTER_SPILLING, static_cast<uint8_t>(rowOffset.value()),
+        numQPUs, TYPE_INT32.toVectorType(NATIVE_VECTOR_SIZE),
+        add_flag(VPMAreaAccessFlags::QPU_ACCESS_FULL_VECTOR, VPMAreaAccessFlags::QPU_ACCESS_SINGLE_VECTOR)));
+}
+
+const VPMArea* VPM::addDMABufferArea(unsigned rowsPerQPU, unsigned numQPUs)
+{
+    // the buffers are accessed across the loop they are used in, so reserve them for the whole kernel
+    Optional<unsigned> rowOffset = findFreeRows(rowsPerQPU * numQPUs, VPMLiveRange{}, true);
+    if(!rowOffset)
+        // no more (big enough) free space on VPM
+        return nullptr;
+
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Allocating " << (rowsPerQPU * numQPUs) << " rows of VPM DMA buffers starting at row "
+            << rowOffset.value() << logging::endl);
+    PROFILE_COUNTER(vc4c::profiler::COUNTER_GENERAL, "VPM DMA buffer rows", rowsPerQPU * numQPUs);
+    return insertArea(std::make_shared<VPMArea>(VPMUsage::DMA_BUFFER, static_cast<uint8_t>(rowOffset.value()),
+        static_cast<uint8_t>(rowsPerQPU * numQPUs), TYPE_INT32.toVectorType(NATIVE_VECTOR_SIZE),
+        add_flag(VPMAreaAccessFlags::QPU_ACCESS_FULL_VECTOR, VPMAreaAccessFlags::QPU_ACCESS_SINGLE_VECTOR)));
 }
 
 unsigned VPM::getMaxCacheVectors(DataType type, bool writeAccess) const
 {
-    unsigned numFreeRows = 0;
+    unsigned numFreeRows = VPM_NUM_ROWS;
     // can possible use up all rows up to the first area
     for(const auto& area : areas)
     {
-        if(area && area->usageType != VPMUsage::SCRATCH)
-            break;
-        ++numFreeRows;
+        if(area->usageType != VPMUsage::SCRATCH)
+            numFreeRows = std::min(numFreeRows, static_cast<unsigned>(area->rowOffset));
     }
 
     if(writeAccess)
@@ -1412,9 +1508,6 @@ void VPM::updateScratchSize(unsigned char requestedRows)
             log << "Increased the scratch size to " << requestedRows << " rows (" << requestedRows * 64 << " bytes)"
                 << logging::endl);
         const_cast<unsigned char&>(getScratchArea().numRows) = requestedRows;
-        // fill areas with scratch
-        for(unsigned i = 1; i < requestedRows; ++i)
-            areas[i] = areas[0];
     }
 }
 
@@ -1473,36 +1566,31 @@ void VPM::dumpUsage() const
     static const unsigned outputWidth = 128;
 
     CPPLOG_LAZY_BLOCK(logging::Level::DEBUG, {
+        // areas with disjoint live ranges can share rows, so group consecutive rows used by the same areas
+        std::vector<std::string> rowNames(VPM_NUM_ROWS);
+        for(unsigned row = 0; row < VPM_NUM_ROWS; ++row)
+        {
+            for(const auto& area : areas)
+            {
+                if(usesRow(*area, row))
+                    rowNames[row] += (rowNames[row].empty() ? "" : " / ") +
+                        toUsageString(area->usageType, area->originalAddress);
+            }
+        }
         logging::debug() << "VPM usage: "
-                         << std::accumulate(areas.begin(), areas.end(), 0u,
-                                [](unsigned sum, const std::shared_ptr<VPMArea>& area) -> unsigned {
-                                    return sum + (area != nullptr);
-                                })
+                         << std::count_if(rowNames.begin(), rowNames.end(),
+                                [](const std::string& name) -> bool { return !name.empty(); })
                          << " of " << VPM_NUM_ROWS << " rows:" << logging::endl;
 
-        std::shared_ptr<VPMArea> lastArea;
-        unsigned numEmpty = 0;
         auto& stream = logging::debug() << "|";
-        for(const auto& area : areas)
+        unsigned groupStart = 0;
+        for(unsigned row = 1; row <= VPM_NUM_ROWS; ++row)
         {
-            if(area == lastArea)
+            if(row < VPM_NUM_ROWS && rowNames[row] == rowNames[groupStart])
                 continue;
-            if(!area)
-            {
-                ++numEmpty;
-                continue;
-            }
-            if(numEmpty > 0)
-            {
-                writeArea(stream, "", (numEmpty * outputWidth) / VPM_NUM_ROWS);
-                numEmpty = 0;
-            }
-            lastArea = area;
-            writeArea(stream, toUsageString(area->usageType, area->originalAddress),
-                (area->numRows * outputWidth) / VPM_NUM_ROWS);
+            writeArea(stream, rowNames[groupStart], ((row - groupStart) * outputWidth) / VPM_NUM_ROWS);
+            groupStart = row;
         }
-        if(numEmpty > 0)
-            writeArea(stream, "", (numEmpty * outputWidth) / VPM_NUM_ROWS);
         stream << logging::endl;
     });
 }
@@ -1721,8 +1809,8 @@ NODISCARD static InstructionWalker lowerReadRAM(
     // initialize VPM DMA for reading from host
     Value dmaSetupBits = UNDEFINED_VALUE;
     // TODO this assumes 1 row = 1 entry, is this always correct?
-    it = insertReadDMASetup(
-        it, dmaSetupBits, cacheEntry.area, cacheEntry.getScalarType(), cacheEntry.getVectorWidth(), numEntries);
+    it = insertReadDMASetup(it, dmaSetupBits, cacheEntry.area, cacheEntry.getScalarType(), cacheEntry.getVectorWidth(),
+        numEntries, !cacheEntry.memoryElementStride.isUndefined());
 
     if(cacheEntry.inAreaByteOffset != INT_ZERO)
     {
@@ -1746,22 +1834,37 @@ NODISCARD static InstructionWalker lowerReadRAM(
     assign(it, VPM_IN_SETUP_REGISTER) = (dmaSetupBits, InstructionDecorations::VPM_READ_CONFIGURATION);
 
     VPRSetup strideSetup(VPRStrideSetup(0));
-    if(numEntries != INT_ONE)
+    if(auto pitch = cacheEntry.memoryPitch.getLiteralValue())
+        // the rows are not consecutive, but located with a fixed distance in memory (e.g. rows of a 2D tile)
+        strideSetup.strideSetup = VPRStrideSetup(static_cast<uint16_t>(pitch->unsignedInt()));
+    else if(auto stride = cacheEntry.memoryElementStride.getLiteralValue())
+        // every element is read as its own memory row
+        strideSetup.strideSetup = VPRStrideSetup(static_cast<uint16_t>(stride->unsignedInt()));
+    else if(numEntries != INT_ONE)
     {
         // NOTE: This for read the pitch (start-to-start) and for write the stride (end-to-start) is set, we need to set
         // this to the data size, but not required for write setup!
         // TODO if we have dynamic vector size, we can't do this, since we cannot statically determine the stride!
         strideSetup.strideSetup = VPRStrideSetup(static_cast<uint16_t>(cacheEntry.getVectorType().getInMemoryWidth()));
     }
-    assign(it, VPM_IN_SETUP_REGISTER) =
-        (load(Literal(strideSetup.value)), InstructionDecorations::VPM_READ_CONFIGURATION);
+    else if(cacheEntry.getScalarType().getScalarBitCount() > 32)
+        // the 64-bit elements are read vertically as memory rows of the lower and upper word each
+        strideSetup.strideSetup = VPRStrideSetup(static_cast<uint16_t>(cacheEntry.getScalarType().getInMemoryWidth()));
+    if(cacheEntry.memoryPitch.isUndefined() || cacheEntry.memoryPitch.getLiteralValue())
+        assign(it, VPM_IN_SETUP_REGISTER) =
+            (load(Literal(strideSetup.value)), InstructionDecorations::VPM_READ_CONFIGURATION);
+    else
+        // the pitch is only known at run-time, the creator of the cache entry guarantees it to fit into the setup
+        assign(it, VPM_IN_SETUP_REGISTER) = (Value(Literal(strideSetup.value), TYPE_INT32) + cacheEntry.memoryPitch,
+            InstructionDecorations::VPM_READ_CONFIGURATION);
 
     //"the actual DMA load or store operation is initiated by writing the memory address to the VCD_LD_ADDR or
     // VCD_ST_ADDR register" (p. 56)
     //-> write output-argument base address + offset/index into VPM_ADDR
     assign(it, VPM_DMA_LOAD_ADDR_REGISTER) = access.getMemoryAddress();
     //"A new DMA load or store operation cannot be started until the previous one is complete" (p. 56)
-    assign(it, NOP_REGISTER) = VPM_DMA_LOAD_WAIT_REGISTER;
+    if(!cacheEntry.asynchronousDMA)
+        assign(it, NOP_REGISTER) = VPM_DMA_LOAD_WAIT_REGISTER;
 
     it.erase();
     return it;
@@ -1780,8 +1883,8 @@ NODISCARD static InstructionWalker lowerWriteRAM(
     // initialize VPM DMA for writing to host
     Value dmaSetupBits = UNDEFINED_VALUE;
     // TODO this assumes 1 row = 1 entry, is this always correct?
-    it = insertWriteDMASetup(
-        it, dmaSetupBits, cacheEntry.area, cacheEntry.getScalarType(), cacheEntry.getVectorWidth(), numEntries);
+    it = insertWriteDMASetup(it, dmaSetupBits, cacheEntry.area, cacheEntry.getScalarType(),
+        cacheEntry.getVectorWidth(), numEntries, !cacheEntry.memoryElementStride.isUndefined());
 
     if(cacheEntry.inAreaByteOffset != INT_ZERO)
     {
@@ -1805,17 +1908,36 @@ NODISCARD static InstructionWalker lowerWriteRAM(
     }
     assign(it, VPM_OUT_SETUP_REGISTER) = (dmaSetupBits, InstructionDecorations::VPM_WRITE_CONFIGURATION);
 
-    // set stride to zero
-    const VPWSetup strideSetup(VPWStrideSetup(0));
-    assign(it, VPM_OUT_SETUP_REGISTER) =
-        (load(Literal(strideSetup.value)), InstructionDecorations::VPM_WRITE_CONFIGURATION);
+    // set stride to zero for consecutive rows
+    VPWSetup strideSetup(VPWStrideSetup(0));
+    // for rows located with a fixed distance in memory, the stride is the distance from the end of a row to the start
+    // of the next row
+    const auto rowWidth = cacheEntry.getVectorType().getInMemoryWidth();
+    if(auto pitch = cacheEntry.memoryPitch.getLiteralValue())
+        strideSetup.strideSetup = VPWStrideSetup(static_cast<uint16_t>(pitch->unsignedInt() - rowWidth));
+    else if(auto stride = cacheEntry.memoryElementStride.getLiteralValue())
+        // every element is written as its own memory row (a column of the vertical access)
+        strideSetup.strideSetup = VPWStrideSetup(
+            static_cast<uint16_t>(stride->unsignedInt() - cacheEntry.getScalarType().getInMemoryWidth()));
+    if(cacheEntry.memoryPitch.isUndefined() || cacheEntry.memoryPitch.getLiteralValue())
+        assign(it, VPM_OUT_SETUP_REGISTER) =
+            (load(Literal(strideSetup.value)), InstructionDecorations::VPM_WRITE_CONFIGURATION);
+    else
+    {
+        // the pitch is only known at run-time, the creator of the cache entry guarantees it to fit into the setup
+        auto stride = assign(it, TYPE_INT32, "%vpw_stride") =
+            cacheEntry.memoryPitch - Value(Literal(rowWidth), TYPE_INT32);
+        assign(it, VPM_OUT_SETUP_REGISTER) = (Value(Literal(strideSetup.value), TYPE_INT32) + stride,
+            InstructionDecorations::VPM_WRITE_CONFIGURATION);
+    }
 
     //"the actual DMA load or store operation is initiated by writing the memory address to the VCD_LD_ADDR or
     // VCD_ST_ADDR register" (p. 56)
     //-> write output-argument base address + offset/index into VPM_ADDR
     assign(it, VPM_DMA_STORE_ADDR_REGISTER) = access.getMemoryAddress();
     //"A new DMA load or store operation cannot be started until the previous one is complete" (p. 56)
-    assign(it, NOP_REGISTER) = VPM_DMA_STORE_WAIT_REGISTER;
+    if(!cacheEntry.asynchronousDMA)
+        assign(it, NOP_REGISTER) = VPM_DMA_STORE_WAIT_REGISTER;
 
     it.erase();
     return it;
@@ -12,6 +12,8 @@
 #include "../Method.h"
 #include "CacheEntry.h"
 
+#include <limits>
+
 namespace vc4c
 {
     const Value VPM_IN_SETUP_REGISTER(REG_VPM_IN_SETUP, TYPE_INT32);
@@ -656,6 +658,11 @@ namespace vc4c
          */
         NODISCARD InstructionWalker insertWriteDMA(
             Method& method, InstructionWalker it, const Value& src, const Value& addr, bool useMutex = true);
+        /*
+         * Inserts a wait for the DMA transfers started by RAM accesses with asynchronous DMA (see
+         * VPMCacheEntry#asynchronousDMA) in the given direction to complete
+         */
+        NODISCARD InstructionWalker insertWaitDMA(InstructionWalker it, bool waitForWrite);
 
         /*
          * Tries to find a combination of a vector of an integer-type and a number of vectors to match the given size in
@@ -701,7 +708,15 @@ namespace vc4c
              * NOTE:
              * The cache needs to be pre-loaded and written back from/to RAM.
              */
-            RAM_CACHE
+            RAM_CACHE,
+            /**
+             * This area contains the per-QPU buffers for DMA transfers running in the background, while the QPU
+             * continues with the execution.
+             *
+             * NOTE:
+             * Its size needs include the buffers for all available QPUs!
+             */
+            DMA_BUFFER
         };
 
         /**
@@ -747,6 +762,17 @@ namespace vc4c
             // NOTE: This usage is not tracked, so any optimization removing unread local MUST not be run yet as long as
             // this cache entry is not lowered!
             Value inAreaByteOffset;
+            // The distance in bytes between the starts of two successive rows in RAM for DMA accesses of multiple rows,
+            // undefined for consecutive rows. A dynamic pitch is required to fit into the DMA stride/pitch setup.
+            // NOTE: This usage is not tracked, see above.
+            Value memoryPitch;
+            // The distance in bytes between two successive elements of a single scalar 32-bit vector in RAM for DMA
+            // accesses of non-adjacent elements (e.g. every n-th element accessed by a vectorized loop), undefined for
+            // adjacent elements. The elements are transferred as single-element memory rows via vertical DMA access.
+            Value memoryElementStride;
+            // Whether the DMA transfer of a RAM access does not wait for its completion. The wait then needs to be
+            // inserted explicitly, see #insertWaitDMA()
+            bool asynchronousDMA;
 
         private:
             DataType elementType;
@@ -778,16 +804,46 @@ namespace vc4c
             RAW_BYTES = 1 << 8
         };
 
+        /*
+         * The part of the kernel code in which a VPM area is in use.
+         *
+         * The part is given as (inclusive) ranges of the indices of the basic blocks (in the order of the method) and
+         * of the sections of code separated by control flow barriers. VPM areas which are used in disjoint parts of the
+         * kernel code can share the same VPM rows.
+         *
+         * A default constructed live range covers the whole kernel code.
+         */
+        struct VPMLiveRange
+        {
+            std::size_t firstBlock = 0;
+            std::size_t lastBlock = std::numeric_limits<std::size_t>::max();
+            std::size_t firstSection = 0;
+            std::size_t lastSection = std::numeric_limits<std::size_t>::max();
+
+            /*
+             * Returns whether the two live ranges overlap.
+             *
+             * Per-QPU areas are only accessed by the owning QPU and thus can be compared by their basic block ranges.
+             * Areas shared between all QPUs need to be compared by their barrier sections, since the other QPUs might
+             * currently execute any code between the same two control flow barriers.
+             */
+            bool overlaps(const VPMLiveRange& other, bool bothPerQPU) const;
+
+            bool isWholeKernel() const;
+
+            std::string to_string() const;
+        };
+
         /*
          * An area of the VPM used for a specific purpose (e.g. cache, register spilling, etc.)
          */
         struct VPMArea
         {
             VPMArea(VPMUsage usage, uint8_t rowOffset, uint8_t numRows, DataType elementType, VPMAreaAccessFlags flags,
-                const Local* basePointer = nullptr) :
+                const Local* basePointer = nullptr, const VPMLiveRange& liveRange = {}) :
                 usageType(usage),
                 rowOffset(rowOffset), numRows(numRows), originalAddress(basePointer), elementType(elementType),
-                flags(flags)
+                flags(flags), liveRange(liveRange)
             {
             }
             VPMArea(const VPMArea&) = delete;
@@ -842,6 +898,12 @@ namespace vc4c
              */
             const VPMAreaAccessFlags flags;
 
+            /**
+             * The part of the kernel code this VPM area is used in. Outside of this part, the rows of this area can be
+             * used by other VPM areas.
+             */
+            const VPMLiveRange liveRange;
+
             /**
              * If we need this VPM area to be transferable via DMA, we cannot pack multiple values into a single row.
              * 16-element vectors make the exception (can be transferred via DMA and packed to one row).
@@ -854,6 +916,17 @@ namespace vc4c
 
             void checkAreaSize(DataType accessElementType, uint32_t numElements) const;
 
+            /*
+             * Returns whether this area holds separate data for every QPU (e.g. spilled registers) as opposed to data
+             * shared by all QPUs.
+             */
+            bool isPerQPU() const;
+
+            /*
+             * Returns whether this area and the given area use the same VPM rows at the same time
+             */
+            bool overlaps(const VPMArea& other) const;
+
             bool operator<(const VPMArea& other) const;
 
             std::string to_string() const;
@@ -881,12 +954,16 @@ namespace vc4c
 
             const VPMArea& getScratchArea() const;
             const VPMArea* findArea(const Local* local);
-            const VPMArea* addSharedArea(
-                const Local& baseAddress, const FastAccessList<analysis::MemoryAccessRange>& accessRanges);
+            const VPMArea* addSharedArea(const Local& baseAddress,
+                const FastAccessList<analysis::MemoryAccessRange>& accessRanges, const VPMLiveRange& liveRange = {});
             const VPMArea* addSharedArea(const Local& baseAddress, DataType elementType, uint32_t numElements,
-                VPMAreaAccessFlags flags = VPMAreaAccessFlags::NONE);
+                VPMAreaAccessFlags flags = VPMAreaAccessFlags::NONE, const VPMLiveRange& liveRange = {});
             const VPMArea* addCacheArea(const Local& baseAddress, DataType elementType, uint32_t numElements);
             const VPMArea* addSpillArea(unsigned numQPUs = NUM_QPUS);
+            /*
+             * Reserves the given number of rows for every QPU to be used as buffers for asynchronous DMA transfers
+             */
+            const VPMArea* addDMABufferArea(unsigned rowsPerQPU, unsigned numQPUs = NUM_QPUS);
 
             /*
              * The maximum number of vectors (of the given type) which can be cached in this VPM.
@@ -952,8 +1029,13 @@ namespace vc4c
 
         private:
             const unsigned maximumVPMSize;
+            // all allocated areas, the first entry is always the scratch area. Areas with disjoint live ranges can
+            // share the same rows.
             std::vector<std::shared_ptr<VPMArea>> areas;
 
+            Optional<unsigned> findFreeRows(unsigned numRows, const VPMLiveRange& liveRange, bool perQPU) const;
+            const VPMArea* insertArea(std::shared_ptr<VPMArea>&& area);
+
             InstructionWalker insertLockMutex(InstructionWalker it, bool useMutex) const;
             InstructionWalker insertUnlockMutex(InstructionWalker it, bool useMutex) const;
 
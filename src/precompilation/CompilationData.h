@@ -8,6 +8,7 @@
 #define VC4C_COMPILATION_DATA
 
 #include "../Optional.h"
+#include "CompilationError.h"
 #include "Precompiler.h"
 #include "tool_paths.h"
 
@@ -60,6 +61,16 @@ namespace vc4c
         {
             return {};
         }
+
+        /**
+         * Returns the underlying in-memory buffer without copying it or NULL if the data is not stored in memory.
+         *
+         * NOTE: The buffer is only valid as long as this object is not modified or destroyed.
+         */
+        virtual std::pair<const uint8_t*, std::size_t> getRawDataBuffer() const
+        {
+            return std::make_pair(nullptr, 0);
+        }
     };
 
     namespace precompilation
@@ -177,10 +188,64 @@ namespace vc4c
                 return data;
             }
 
+            std::pair<const uint8_t*, std::size_t> getRawDataBuffer() const override
+            {
+                return std::make_pair(data.data(), data.size());
+            }
+
             std::vector<uint8_t> data;
             std::string name;
         };
 
+        /*
+         * In-memory data owned by the caller, which needs to stay valid as long as this object is used
+         */
+        template <SourceType Type>
+        struct ExternalCompilationData : TypedCompilationData<Type>
+        {
+            explicit ExternalCompilationData(const uint8_t* data, std::size_t size, const std::string& name = "") :
+                data(data), size(size), name(name)
+            {
+            }
+            ~ExternalCompilationData() noexcept override = default;
+
+            Optional<std::string> getFilePath() const override
+            {
+                return {};
+            }
+
+            std::string to_string() const override
+            {
+                if(!name.empty())
+                    return "(external buffer '" + name + "')";
+                return "(external buffer of " + std::to_string(size) + " bytes)";
+            }
+
+            void readInto(std::ostream& out) const override
+            {
+                out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+            }
+
+            void writeFrom(std::istream& in) override
+            {
+                throw CompilationError(CompilationStep::GENERAL, "Cannot write into external buffer", to_string());
+            }
+
+            Optional<std::vector<uint8_t>> getRawData() const override
+            {
+                return std::vector<uint8_t>(data, data + size);
+            }
+
+            std::pair<const uint8_t*, std::size_t> getRawDataBuffer() const override
+            {
+                return std::make_pair(data, size);
+            }
+
+            const uint8_t* data;
+            std::size_t size;
+            std::string name;
+        };
+
     } /* namespace precompilation */
 } /* namespace vc4c */
 
@@ -0,0 +1,243 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+
+#include "FileCache.h"
+
+#include "../Profiler.h"
+#include "CompilationError.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <iomanip>
+#include <sstream>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace vc4c;
+using namespace vc4c::precompilation;
+
+static const std::string LOCK_EXTENSION = ".lock";
+static const std::string TEMPORARY_EXTENSION = ".tmp";
+// temporary files not published within this time are left over by crashed processes
+static constexpr time_t STALE_TEMPORARY_AGE = 60 * 60;
+
+std::string precompilation::getCacheDirectory()
+{
+    if(auto dir = std::getenv("VC4C_CACHE_DIR"))
+        return dir;
+    if(auto homeDir = std::getenv("HOME"))
+        return std::string(homeDir) + "/.cache/vc4c";
+    return "/tmp/vc4c-cache";
+}
+
+static void createDirectories(const std::string& directory)
+{
+    std::string::size_type pos = 0;
+    do
+    {
+        pos = directory.find('/', pos + 1);
+        auto path = directory.substr(0, pos);
+        if(mkdir(path.data(), 0755) != 0 && errno != EEXIST)
+            throw CompilationError(CompilationStep::PRECOMPILATION, "Failed to create cache directory",
+                path + ": " + strerror(errno));
+    } while(pos != std::string::npos);
+}
+
+static int openLockFile(const std::string& path)
+{
+    int fd = open(path.data(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if(fd < 0)
+        throw CompilationError(
+            CompilationStep::PRECOMPILATION, "Failed to open cache lock file", path + ": " + strerror(errno));
+    return fd;
+}
+
+static void lockFile(int fd, int operation)
+{
+    while(flock(fd, operation) != 0)
+    {
+        if(errno != EINTR)
+            throw CompilationError(CompilationStep::PRECOMPILATION, "Failed to lock cache file", strerror(errno));
+    }
+}
+
+static bool touchIfExists(const std::string& path)
+{
+    // update the modification time, which is used to determine the least recently used entries
+    return utimensat(AT_FDCWD, path.data(), nullptr, 0) == 0;
+}
+
+FileCache::Entry::Entry(Entry&& other) noexcept : path(other.path), lockFile(other.lockFile)
+{
+    other.lockFile = -1;
+}
+
+FileCache::Entry::~Entry() noexcept
+{
+    if(lockFile >= 0)
+        // also releases the lock
+        close(lockFile);
+}
+
+FileCache::FileCache(const std::string& directory, const std::string& fileExtension, uint64_t maxSize) :
+    directory(directory), fileExtension(fileExtension), maxSize(maxSize)
+{
+    createDirectories(directory);
+}
+
+FileCache::Entry FileCache::getOrCreate(
+    const std::string& key, const std::function<void(const std::string&)>& createEntry)
+{
+    auto path = directory + "/" + key + fileExtension;
+    int fd = openLockFile(path + LOCK_EXTENSION);
+    try
+    {
+        lockFile(fd, LOCK_SH);
+        if(touchIfExists(path))
+        {
+            PROFILE_COUNTER(vc4c::profiler::COUNTER_FRONTEND, "File cache hits", 1);
+            return Entry{std::move(path), fd};
+        }
+
+        // Converting the lock is not atomic, so another process might have created the entry in the meantime
+        lockFile(fd, LOCK_EX);
+        if(!touchIfExists(path))
+        {
+            PROFILE_COUNTER(vc4c::profiler::COUNTER_FRONTEND, "File cache misses", 1);
+            auto temporaryPath = path + TEMPORARY_EXTENSION + std::to_string(getpid());
+            try
+            {
+                createEntry(temporaryPath);
+            }
+            catch(...)
+            {
+                std::remove(temporaryPath.data());
+                throw;
+            }
+            if(rename(temporaryPath.data(), path.data()) != 0)
+            {
+                auto error = std::string(strerror(errno));
+                std::remove(temporaryPath.data());
+                throw CompilationError(CompilationStep::PRECOMPILATION, "Failed to publish cache entry", error);
+            }
+            CPPLOG_LAZY(logging::Level::DEBUG, log << "Added file cache entry: " << path << logging::endl);
+        }
+        lockFile(fd, LOCK_SH);
+        evictEntries(path);
+        return Entry{std::move(path), fd};
+    }
+    catch(...)
+    {
+        close(fd);
+        throw;
+    }
+}
+
+std::string FileCache::buildKey(const std::vector<std::string>& components)
+{
+    // 64-bit FNV-1a, which is stable across processes, compilers and standard library implementations
+    uint64_t hash = 0xcbf29ce484222325;
+    for(const auto& component : components)
+    {
+        for(auto c : component)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001b3;
+        }
+        // separate the components, so e.g. {"ab", "c"} and {"a", "bc"} have different hashes
+        hash ^= 0xFF;
+        hash *= 0x100000001b3;
+    }
+    std::stringstream ss;
+    ss << std::hex << std::setfill('0') << std::setw(16) << hash;
+    return ss.str();
+}
+
+namespace
+{
+    struct CacheFileInfo
+    {
+        std::string path;
+        uint64_t size;
+        time_t lastUsed;
+    };
+} // namespace
+
+static bool endsWith(const std::string& name, const std::string& suffix)
+{
+    return name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void FileCache::evictEntries(const std::string& keepPath)
+{
+    // only one process at a time needs to evict entries
+    int dirLock = openLockFile(directory + "/" + LOCK_EXTENSION);
+    if(flock(dirLock, LOCK_EX | LOCK_NB) != 0)
+    {
+        close(dirLock);
+        return;
+    }
+
+    std::vector<CacheFileInfo> entries;
+    uint64_t totalSize = 0;
+    auto now = time(nullptr);
+    if(auto dir = opendir(directory.data()))
+    {
+        while(auto dirEntry = readdir(dir))
+        {
+            std::string name = dirEntry->d_name;
+            auto path = directory + "/" + name;
+            struct stat info;
+            if(stat(path.data(), &info) != 0 || !S_ISREG(info.st_mode))
+                continue;
+            if(name.find(fileExtension + TEMPORARY_EXTENSION) != std::string::npos &&
+                now - info.st_mtime > STALE_TEMPORARY_AGE)
+                std::remove(path.data());
+            else if(endsWith(name, fileExtension))
+            {
+                entries.emplace_back(CacheFileInfo{path, static_cast<uint64_t>(info.st_size), info.st_mtime});
+                totalSize += static_cast<uint64_t>(info.st_size);
+            }
+        }
+        closedir(dir);
+    }
+
+    if(totalSize > maxSize)
+    {
+        std::sort(entries.begin(), entries.end(),
+            [](const CacheFileInfo& one, const CacheFileInfo& other) -> bool { return one.lastUsed < other.lastUsed; });
+        for(const auto& entry : entries)
+        {
+            if(totalSize <= maxSize)
+                break;
+            if(entry.path == keepPath)
+                continue;
+            // skip entries currently used by any process
+            int fd = open((entry.path + LOCK_EXTENSION).data(), O_RDWR | O_CLOEXEC);
+            if(fd >= 0 && flock(fd, LOCK_EX | LOCK_NB) != 0)
+            {
+                close(fd);
+                continue;
+            }
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Evicting least recently used file cache entry: " << entry.path << logging::endl);
+            std::remove(entry.path.data());
+            std::remove((entry.path + LOCK_EXTENSION).data());
+            totalSize -= entry.size;
+            if(fd >= 0)
+                close(fd);
+        }
+    }
+    close(dirLock);
+}
@@ -0,0 +1,83 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+
+#ifndef VC4C_FILE_CACHE_H
+#define VC4C_FILE_CACHE_H
+
+#include "../Optional.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace vc4c
+{
+    namespace precompilation
+    {
+        /*
+         * Returns the directory to store persistent cache files in.
+         *
+         * This is the directory specified by the VC4C_CACHE_DIR environment variable, if set, otherwise the
+         * $HOME/.cache/vc4c directory (or a folder in /tmp, if no home directory is available).
+         */
+        std::string getCacheDirectory();
+
+        /*
+         * Cache of files persisted in a directory and shared across processes.
+         *
+         * Entries are created in a temporary file and atomically published by renaming them to their final name, so
+         * other processes never see partially written entries. Every entry has an accompanying lock file, which is
+         * locked exclusively while the entry is created (so concurrent processes do not create the same entry twice)
+         * and shared while the entry is used (so it is not evicted while in use).
+         *
+         * If the total size of all entries exceeds the maximum size, the least recently used entries are evicted.
+         */
+        class FileCache
+        {
+        public:
+            /*
+             * RAII handle to an entry of the cache, which is guaranteed to not be evicted while the handle exists
+             */
+            class Entry : private NonCopyable
+            {
+            public:
+                Entry(std::string&& path, int lockFile) noexcept : path(std::move(path)), lockFile(lockFile) {}
+                Entry(Entry&& other) noexcept;
+                ~Entry() noexcept;
+
+                Entry& operator=(Entry&&) noexcept = delete;
+
+                const std::string path;
+
+            private:
+                int lockFile;
+            };
+
+            FileCache(const std::string& directory, const std::string& fileExtension, uint64_t maxSize);
+
+            /*
+             * Returns the entry for the given key, creating it by calling the given function with the path of the file
+             * to be written, if it does not exist yet.
+             */
+            Entry getOrCreate(const std::string& key, const std::function<void(const std::string&)>& createEntry);
+
+            /*
+             * Builds a cache key by hashing the given components
+             */
+            static std::string buildKey(const std::vector<std::string>& components);
+
+        private:
+            std::string directory;
+            std::string fileExtension;
+            uint64_t maxSize;
+
+            void evictEntries(const std::string& keepPath);
+        };
+    } // namespace precompilation
+} // namespace vc4c
+
+#endif /* VC4C_FILE_CACHE_H */
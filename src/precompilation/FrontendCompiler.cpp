@@ -11,16 +11,19 @@
 #include "../helper.h"
 #include "../performance.h"
 #include "../spirv/SPIRVToolsParser.h"
+#include "FileCache.h"
 #include "LLVMLibrary.h"
 #include "log.h"
 
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iterator>
 #include <mutex>
 #include <numeric>
 #include <sstream>
+#include <sys/stat.h>
 #include <unistd.h>
 
 using namespace vc4c;
@@ -294,7 +297,8 @@ LLVMIRResult forwardOrCreateResult<SourceType::LLVM_IR_BIN>(LLVMIRResult&& resul
 {
     if(result)
         return std::move(result);
-    if(hasClangLibrary())
+    if(hasLLVMFrontend())
+        // keep the module in memory to directly pass it to the next step (e.g. the LLVM module front-end)
         return LLVMIRResult{createLLVMCompilationData()};
     else
         return LLVMIRResult{std::make_unique<TemporaryFileCompilationData<SourceType::LLVM_IR_BIN>>()};
@@ -377,6 +381,36 @@ static std::string cleanOptions(std::string userOptions)
     return trim(std::move(userOptions));
 }
 
+/**
+ * Identifies the used clang front-end (including the OpenCL C default header provided by it), since PCHs can only be
+ * used with the exact clang version they were created by.
+ */
+static std::string getCompilerIdentity()
+{
+    if(hasClangLibrary())
+        return "clang library " + CLANG_RESOURCE_DIR;
+    auto clangPath = findToolLocation(CLANG_TOOL).value();
+    struct stat info;
+    if(stat(clangPath.data(), &info) != 0)
+        return clangPath;
+    // the resolved executable changes on any update of the clang installation
+    return clangPath + " " + std::to_string(info.st_size) + " " + std::to_string(info.st_mtime);
+}
+
+/**
+ * Identifies the content of the given file as well as the meta-data checked by clang when using a PCH which includes
+ * the file.
+ */
+static std::string getFileIdentity(const std::string& path)
+{
+    std::ifstream fis{path};
+    std::string identity = path + " " + readIntoString(fis);
+    struct stat info;
+    if(stat(path.data(), &info) == 0)
+        identity.append(" ").append(std::to_string(info.st_size)).append(" ").append(std::to_string(info.st_mtime));
+    return identity;
+}
+
 /**
  * Most of the time of a "normal" compilation for simple kernels is consumed by reading the clang provided OpenCL C
  * header file (e.g. in /usr/lib/clang/<version>/opencl-c.h), as reported by the clang "-ftime-trace" flag.
@@ -386,73 +420,45 @@ static std::string cleanOptions(std::string userOptions)
  *
  * To precompile the default OpenCL C header to a PCH, we simply precompile an empty OpenCL C kernel into PCH while
  * including the default header.
+ *
+ * The PCHs are stored in a persistent cache shared across all processes, keyed by the clang version, the VC4CL std-lib
+ * configuration header and the (cleaned) compilation options. The returned entry needs to be kept alive while the PCH
+ * is in use to guarantee the PCH to not be evicted in the meantime.
  */
-static Optional<std::string> getDefaultHeadersPCHPath(const std::string& userOptions)
+static std::unique_ptr<FileCache::Entry> getDefaultHeadersPCH(const std::string& userOptions)
 {
+    // limit the total size of the PCHs (a single PCH is a few MB) to not fill up the disk when compiling with a lot of
+    // different compilation flags (e.g. for VC4CL tests)
+    static constexpr uint64_t MAX_CACHE_SIZE = 256 * 1024 * 1024;
     static std::mutex pchsMutex;
-    // we keep a usage count to always discard the least used entries
-    static FastMap<std::string, std::pair<TemporaryFile, std::size_t>> cachedPCHs;
 
     auto checkOptions = cleanOptions(userOptions);
     std::lock_guard<std::mutex> guard(pchsMutex);
-    auto it = cachedPCHs.find(checkOptions);
-    PROFILE_COUNTER(vc4c::profiler::COUNTER_FRONTEND, "OpenCL C header PCH builds", it == cachedPCHs.end());
-    if(it != cachedPCHs.end())
-    {
-        ++it->second.second;
-        return it->second.first.fileName;
-    }
-
-    // keep a limit on the maximum cached PCHs to not run out of space in /tmp if a lot of kernels are compiled (e.g.
-    // for VC4CL tests)
-    if(cachedPCHs.size() >= 32)
+    try
     {
-        // remove all entries with single use at once to not have to do this check too often
-        for(auto it = cachedPCHs.begin(); it != cachedPCHs.end();)
-        {
-            if(it->second.second <= 1)
-            {
-                CPPLOG_LAZY(logging::Level::DEBUG,
-                    log << "Dropping precompiled OpenCL C header from cache due to cache full: "
-                        << it->second.first.fileName << " (options: '" << it->first
-                        << "', usages: " << it->second.second << ")" << logging::endl);
-                it = cachedPCHs.erase(it);
-            }
-            else
-                ++it;
-        }
+        static FileCache cache{getCacheDirectory() + "/pch", ".pch", MAX_CACHE_SIZE};
+        static const std::string compilerIdentity = getCompilerIdentity();
+        static const std::string headerIdentity = getFileIdentity(findStandardLibraryFiles().configurationHeader);
 
-        // if still too many entries, remove least used
-        if(cachedPCHs.size() > 16)
-        {
-            auto it = std::min_element(cachedPCHs.begin(), cachedPCHs.end(),
-                [](const auto& one, const auto& other) -> bool { return one.second.second < other.second.second; });
+        auto key = FileCache::buildKey({compilerIdentity, headerIdentity, checkOptions});
+        return std::make_unique<FileCache::Entry>(cache.getOrCreate(key, [&](const std::string& path) {
+            PROFILE_COUNTER(vc4c::profiler::COUNTER_FRONTEND, "OpenCL C header PCH builds", 1);
+            OpenCLSource emptySource{std::make_unique<RawCompilationData<SourceType::OPENCL_C>>("DefaultHeaderPCH")};
+            LLVMIRResult result{path};
             CPPLOG_LAZY(logging::Level::DEBUG,
-                log << "Dropping precompiled OpenCL C header from cache due to cache full: "
-                    << it->second.first.fileName << " (options: '" << it->first << "', usages: " << it->second.second
-                    << ")" << logging::endl);
-            cachedPCHs.erase(it);
-        }
+                log << "Precompiling default OpenCL C header to PCH to speed up further clang front-end runs for "
+                       "compilation flags: "
+                    << checkOptions << logging::endl);
+            auto config = parseConfig(checkOptions);
+            compileOpenCLToLLVMIR0<LLVMPCHTag>(emptySource, result, checkOptions, config);
+        }));
     }
-
-    it = cachedPCHs.emplace(checkOptions, std::make_pair(TemporaryFile{"/tmp/vc4c-openclc-pch-XXXXXX", true}, 1)).first;
-    try
-    {
-        OpenCLSource emptySource{std::make_unique<RawCompilationData<SourceType::OPENCL_C>>("DefaultHeaderPCH")};
-        LLVMIRResult result{it->second.first.fileName};
-        CPPLOG_LAZY(logging::Level::DEBUG,
-            log << "Precompiling default OpenCL C header to PCH to speed up further clang front-end runs for "
-                   "compilation flags: "
-                << checkOptions << logging::endl);
-        auto config = parseConfig(checkOptions);
-        compileOpenCLToLLVMIR0<LLVMPCHTag>(emptySource, result, checkOptions, config);
-        return it->second.first.fileName;
-    }
-    catch(const std::exception&)
+    catch(const std::exception& err)
     {
         // if we fail, just try to do the "normal" compilation without the PCH
-        cachedPCHs.erase(it);
-        return {};
+        CPPLOG_LAZY(logging::Level::WARNING,
+            log << "Failed to get precompiled OpenCL C header, compiling without: " << err.what() << logging::endl);
+        return nullptr;
     }
 }
 
@@ -460,11 +466,11 @@ static LLVMIRResult compileOpenCLWithDefaultHeader(const OpenCLSource& source, c
     PrecompilationConfig& config, LLVMIRResult&& desiredOutput = LLVMIRResult{})
 {
     PROFILE_START(PrecompileOpenCLCHeaderToPCH);
-    auto pchPath = getDefaultHeadersPCHPath(userOptions);
+    auto pch = getDefaultHeadersPCH(userOptions);
     PROFILE_END(PrecompileOpenCLCHeaderToPCH);
 
     PROFILE_START(CompileOpenCLWithDefaultHeader);
-    auto actualOptions = pchPath ? userOptions + " -include-pch " + *pchPath : userOptions;
+    auto actualOptions = pch ? userOptions + " -include-pch " + pch->path : userOptions;
     auto result = forwardOrCreateResult(std::move(desiredOutput));
     compileOpenCLToLLVMIR0<LLVMModuleTag>(source, result, actualOptions, config);
     PROFILE_END_EXTREMA(CompileOpenCLWithDefaultHeader, source.to_string());
@@ -655,13 +661,29 @@ LLVMIRResult precompilation::linkLLVMModules(
     // TODO add call to llvm-lto??!
     PROFILE_SCOPE_EXTREMA(LinkLLVMModules, desiredOutput.to_string());
 
+    if(sources.empty())
+        throw CompilationError(CompilationStep::PRECOMPILATION, "Cannot link without input files!");
+
+    if(hasLLVMFrontend())
+    {
+        // link in-process, which saves spawning the llvm-link process as well as writing all inputs to files
+        std::vector<std::reference_wrapper<const LLVMIRData>> inputs;
+        inputs.reserve(sources.size());
+        for(const auto& source : sources)
+            inputs.emplace_back(source.inner());
+
+        auto result = forwardOrCreateResult(std::move(desiredOutput));
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Linking " << sources.size() << " LLVM modules with LLVM library into '" << result.to_string()
+                << "'..." << logging::endl);
+        linkLLVMLibrary(inputs, userOptions.find("-only-needed") != std::string::npos, result.inner());
+        return result;
+    }
+
     auto llvm_link = findToolLocation(LLVM_LINK_TOOL);
     if(!llvm_link)
         throw CompilationError(CompilationStep::PRECOMPILATION, "llvm-link not found, can't link LLVM IR modules!");
 
-    if(sources.empty())
-        throw CompilationError(CompilationStep::PRECOMPILATION, "Cannot link without input files!");
-
     // only one input can be from a stream
     std::unique_ptr<std::istream> inputStream = nullptr;
     // this is needed, since we can use a maximum of 1 stream input
@@ -765,9 +787,10 @@ LLVMIRResult precompilation::compileOpenCLToLLVMIR(
 {
     // This check has the positive side-effect that if the VC4CLStdLib LLVM module is missing but the PCH exists,
     // then the compilation with PCH (a bit slower but functional) will be used.
-    auto llvm_link = findToolLocation(LLVM_LINK_TOOL, true);
+    // With the LLVM library, the module is linked in-process and we do not need the llvm-link executable.
+    auto canLink = hasLLVMFrontend() || findToolLocation(LLVM_LINK_TOOL, true);
     auto config = parseConfig(userOptions);
-    if(llvm_link && !findStandardLibraryFiles().llvmModule.empty())
+    if(canLink && !findStandardLibraryFiles().llvmModule.empty())
         return compileOpenCLAndLinkModule(source, userOptions, config, std::move(desiredOutput));
 
     if(!findStandardLibraryFiles().precompiledHeader.empty())
@@ -8,7 +8,9 @@
 
 #include "../Profiler.h"
 #include "../helper.h"
+#include "../performance.h"
 #include "CompilationError.h"
+#include "FrontendCompiler.h"
 #include "Precompiler.h"
 #include "log.h"
 #include "tool_paths.h"
@@ -31,6 +33,7 @@
 
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <sstream>
 
 using namespace vc4c;
@@ -112,12 +115,10 @@ std::unique_ptr<llvm::MemoryBuffer> precompilation::loadLLVMBuffer(const Compila
     return ::loadLLVMBuffer(ss);
 }
 
-LLVMModuleWithContext precompilation::loadLLVMModule(
-    const llvm::MemoryBuffer& buffer, const std::shared_ptr<llvm::LLVMContext>& context, LLVMModuleTag tag)
+static std::unique_ptr<llvm::Module> parseLLVMBitcode(const llvm::MemoryBuffer& buffer, llvm::LLVMContext& context)
 {
-    auto actualContext = context ? context : initializeLLVMContext();
     CPPLOG_LAZY(logging::Level::DEBUG, log << "Reading LLVM module from bit-code...");
-    auto expected = llvm::parseBitcodeFile(buffer.getMemBufferRef(), *actualContext);
+    auto expected = llvm::parseBitcodeFile(buffer.getMemBufferRef(), context);
     if(!expected)
     {
         LCOV_EXCL_START
@@ -137,10 +138,17 @@ LLVMModuleWithContext precompilation::loadLLVMModule(
         CPPLOG_LAZY(logging::Level::DEBUG,
             log << " " << (module->getName().empty() ? "(unknown)" : module->getName().str()) << logging::endl);
         // expected.get() is either std::unique_ptr<llvm::Module> or llvm::Module*
-        return {actualContext, std::move(module)};
+        return module;
     }
 }
 
+LLVMModuleWithContext precompilation::loadLLVMModule(
+    const llvm::MemoryBuffer& buffer, const std::shared_ptr<llvm::LLVMContext>& context, LLVMModuleTag tag)
+{
+    auto actualContext = context ? context : initializeLLVMContext();
+    return {actualContext, parseLLVMBitcode(buffer, *actualContext)};
+}
+
 LLVMModuleWithContext precompilation::loadLLVMModule(
     const llvm::MemoryBuffer& buffer, const std::shared_ptr<llvm::LLVMContext>& context, LLVMTextTag tag)
 {
@@ -179,6 +187,29 @@ LLVMModuleWithContext precompilation::loadLLVMModule(
     return loadLLVMModuleDispatch<LLVMTextTag>(data, context);
 }
 
+LLVMModuleWithContext precompilation::loadLazyLLVMModule(
+    const LLVMIRData& data, const std::shared_ptr<llvm::LLVMContext>& context)
+{
+    if(auto llvmData = dynamic_cast<const LLVMCompilationData*>(&data))
+        return llvmData->data;
+#if LLVM_LIBRARY_VERSION >= 40
+    auto actualContext = context ? context : initializeLLVMContext();
+    CPPLOG_LAZY(logging::Level::DEBUG, log << "Lazy loading LLVM module from bit-code..." << logging::endl);
+    // the module takes ownership of the buffer, since it needs to access it whenever a function is materialized
+    auto expected = llvm::getOwningLazyBitcodeModule(loadLLVMBuffer(data), *actualContext);
+    if(!expected)
+        throw CompilationError(
+            CompilationStep::PRECOMPILATION, "Error lazy loading LLVM module", llvm::toString(expected.takeError()));
+    std::shared_ptr<llvm::Module> module = std::move(expected.get());
+    if(auto error = module->materializeMetadata())
+        throw CompilationError(
+            CompilationStep::PRECOMPILATION, "Error loading LLVM module metadata", llvm::toString(std::move(error)));
+    return {actualContext, std::move(module)};
+#else
+    return loadLLVMModule(data, context);
+#endif
+}
+
 static void storeLLVMModule(
     const std::shared_ptr<llvm::Module>& module, const std::shared_ptr<llvm::LLVMContext>& context, LLVMIRData& data)
 {
@@ -219,6 +250,117 @@ void precompilation::assembleLLVMLibrary(const LLVMIRTextData& input, LLVMIRData
     storeLLVMModule(module.module, module.context, output);
 }
 
+const llvm::MemoryBuffer& precompilation::getStandardLibraryModuleBuffer()
+{
+    // The buffer is kept for the whole life-time of the process, since lazily loaded modules reference their buffer
+    static std::mutex bufferLock;
+    static std::unique_ptr<llvm::MemoryBuffer> buffer;
+    std::lock_guard<std::mutex> guard(bufferLock);
+    if(!buffer)
+    {
+        PROFILE_SCOPE(ReadStdlibModule);
+        PROFILE_COUNTER(profiler::COUNTER_FRONTEND, "VC4CL std-lib module read", 1);
+        // the file is memory-mapped if possible, so only the actually accessed parts are read from disk
+        auto file = llvm::MemoryBuffer::getFile(findStandardLibraryFiles().llvmModule);
+        if(!file)
+            throw std::system_error(file.getError(), "Failed to read VC4CL std-lib module into LLVM MemoryBuffer");
+        buffer = std::move(file.get());
+    }
+    return *buffer;
+}
+
+/*
+ * Loads the module from the given buffer without materializing any function bodies. The linker only materializes the
+ * functions it actually links in, which for the VC4CL std-lib module is only a fraction of all functions.
+ */
+static std::unique_ptr<llvm::Module> lazyLoadLLVMBitcode(const llvm::MemoryBuffer& buffer, llvm::LLVMContext& context)
+{
+#if LLVM_LIBRARY_VERSION >= 40
+    PROFILE_SCOPE(LoadLazyLLVMModule);
+    auto expected = llvm::getLazyBitcodeModule(buffer.getMemBufferRef(), context);
+    if(!expected)
+        throw CompilationError(
+            CompilationStep::PRECOMPILATION, "Error lazy loading LLVM module", llvm::toString(expected.takeError()));
+    auto module = std::move(expected.get());
+    // The metadata is not materialized lazily
+    if(auto error = module->materializeMetadata())
+        throw CompilationError(
+            CompilationStep::PRECOMPILATION, "Error loading LLVM module metadata", llvm::toString(std::move(error)));
+    return module;
+#else
+    return parseLLVMBitcode(buffer, context);
+#endif
+}
+
+static std::unique_ptr<llvm::Module> loadLinkerInput(
+    const LLVMIRData& data, const std::shared_ptr<llvm::LLVMContext>& context, bool lazyLoad)
+{
+    auto filePath = data.getFilePath();
+    if(lazyLoad && filePath && *filePath == findStandardLibraryFiles().llvmModule)
+    {
+        CPPLOG_LAZY(
+            logging::Level::DEBUG, log << "Lazy loading VC4CL std-lib module: " << *filePath << logging::endl);
+        PROFILE_COUNTER(profiler::COUNTER_FRONTEND, "VC4CL std-lib module lazy load", 1);
+        return lazyLoadLLVMBitcode(getStandardLibraryModuleBuffer(), *context);
+    }
+
+    auto llvmData = dynamic_cast<const LLVMCompilationData*>(&data);
+    if(llvmData && llvmData->data.context == context)
+    {
+        // The linker consumes (and modifies) its inputs, so we cannot use the module directly, since it might still be
+        // referenced by the caller
+#if LLVM_LIBRARY_VERSION >= 70
+        return llvm::CloneModule(*llvmData->data.module);
+#else
+        return llvm::CloneModule(llvmData->data.module.get());
+#endif
+    }
+    // This also handles in-memory modules living in another context, since modules can only be linked with other
+    // modules of the same context
+    auto buffer = loadLLVMBuffer(data);
+    return parseLLVMBitcode(*buffer, *context);
+}
+
+void precompilation::linkLLVMLibrary(
+    const std::vector<std::reference_wrapper<const LLVMIRData>>& inputs, bool onlyNeeded, LLVMIRData& output)
+{
+    if(inputs.empty())
+        throw CompilationError(CompilationStep::LINKER, "Cannot link without input modules!");
+
+    // Reuse the context of an in-memory input (e.g. the module just compiled by the clang library), so we do not need
+    // to serialize and parse this module again
+    std::shared_ptr<llvm::LLVMContext> context;
+    for(const auto& input : inputs)
+    {
+        if(auto llvmData = dynamic_cast<const LLVMCompilationData*>(&input.get()))
+        {
+            context = llvmData->data.context;
+            break;
+        }
+    }
+    if(!context)
+        context = initializeLLVMContext();
+
+    std::shared_ptr<llvm::Module> destination = loadLinkerInput(inputs.front(), context, false);
+    llvm::Linker linker(*destination);
+    for(auto it = std::next(inputs.begin()); it != inputs.end(); ++it)
+    {
+        /*
+         * Same as for linking with the llvm-link executable: If we have multiple input modules compiled with VC4C,
+         * they might all contain the definition of some VC4CL std-lib functions. To not fail on ODR violations, allow
+         * all but the first module to override already defined symbols.
+         */
+        unsigned flags = llvm::Linker::Flags::OverrideFromSrc;
+        if(onlyNeeded)
+            flags |= llvm::Linker::Flags::LinkOnlyNeeded;
+        CPPLOG_LAZY(logging::Level::DEBUG, log << "Linking in LLVM module: " << it->get().to_string() << logging::endl);
+        // Only when linking in the needed symbols, the input module can be loaded lazily
+        if(linker.linkInModule(loadLinkerInput(*it, context, onlyNeeded), flags))
+            throw CompilationError(CompilationStep::LINKER, "Failed to link LLVM module", it->get().to_string());
+    }
+    storeLLVMModule(destination, context, output);
+}
+
 LLVMCompilationData::LLVMCompilationData(LLVMModuleWithContext&& data) : data(std::move(data)) {}
 LLVMCompilationData::~LLVMCompilationData() = default;
 
@@ -11,6 +11,7 @@
 #include "CompilationData.h"
 
 #include <chrono>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -76,9 +77,29 @@ namespace vc4c
         LLVMModuleWithContext loadLLVMModule(const LLVMIRData& data, const std::shared_ptr<llvm::LLVMContext>& context);
         LLVMModuleWithContext loadLLVMModule(
             const LLVMIRTextData& data, const std::shared_ptr<llvm::LLVMContext>& context);
+        /*
+         * Loads the LLVM module without materializing any function bodies, the functions need to be explicitly
+         * materialized before accessing their bodies. Modules already in memory are returned as-is.
+         */
+        LLVMModuleWithContext loadLazyLLVMModule(
+            const LLVMIRData& data, const std::shared_ptr<llvm::LLVMContext>& context);
+
+        /*
+         * Returns the buffer containing the VC4CL std-lib LLVM module. The module file is only read once per process,
+         * all in-process links of the std-lib module lazily load their module from this shared buffer.
+         */
+        const llvm::MemoryBuffer& getStandardLibraryModuleBuffer();
 
         void disassembleLLVMLibrary(const LLVMIRData& input, LLVMIRTextData& output);
         void assembleLLVMLibrary(const LLVMIRTextData& input, LLVMIRData& output);
+        /*
+         * Links the given modules in-process via the LLVM linker library, the first module is used as destination.
+         *
+         * If onlyNeeded is set, only the symbols referenced by the previous modules are linked in from the successive
+         * modules (e.g. to only link the used functions of the VC4CL std-lib module).
+         */
+        void linkLLVMLibrary(
+            const std::vector<std::reference_wrapper<const LLVMIRData>>& inputs, bool onlyNeeded, LLVMIRData& output);
 
         struct LLVMCompilationData : public LLVMIRData
         {
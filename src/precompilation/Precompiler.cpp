@@ -159,6 +159,46 @@ CompilationData::CompilationData(std::vector<uint8_t>&& rawData, SourceType type
     }
 }
 
+CompilationData::CompilationData(
+    const uint8_t* rawData, std::size_t numBytes, SourceType type, const std::string& name)
+{
+    if(type == SourceType::UNKNOWN)
+    {
+        // the source type is determined by the first few bytes only
+        std::stringstream ss{std::string{reinterpret_cast<const char*>(rawData),
+            reinterpret_cast<const char*>(rawData) + std::min(numBytes, std::size_t{1024})}};
+        type = Precompiler::getSourceType(ss);
+    }
+
+    switch(type)
+    {
+    case SourceType::OPENCL_C:
+        data = std::make_unique<ExternalCompilationData<SourceType::OPENCL_C>>(rawData, numBytes, name);
+        break;
+    case SourceType::LLVM_IR_BIN:
+        data = std::make_unique<ExternalCompilationData<SourceType::LLVM_IR_BIN>>(rawData, numBytes, name);
+        break;
+    case SourceType::LLVM_IR_TEXT:
+        data = std::make_unique<ExternalCompilationData<SourceType::LLVM_IR_TEXT>>(rawData, numBytes, name);
+        break;
+    case SourceType::SPIRV_BIN:
+        data = std::make_unique<ExternalCompilationData<SourceType::SPIRV_BIN>>(rawData, numBytes, name);
+        break;
+    case SourceType::SPIRV_TEXT:
+        data = std::make_unique<ExternalCompilationData<SourceType::SPIRV_TEXT>>(rawData, numBytes, name);
+        break;
+    case SourceType::QPUASM_BIN:
+        data = std::make_unique<ExternalCompilationData<SourceType::QPUASM_BIN>>(rawData, numBytes, name);
+        break;
+    case SourceType::QPUASM_HEX:
+        data = std::make_unique<ExternalCompilationData<SourceType::QPUASM_HEX>>(rawData, numBytes, name);
+        break;
+    case SourceType::UNKNOWN:
+        data = std::make_unique<ExternalCompilationData<SourceType::UNKNOWN>>(rawData, numBytes, name);
+        break;
+    }
+}
+
 CompilationData::CompilationData(std::shared_ptr<CompilationDataPrivate>&& data) : data(std::move(data)) {}
 
 SourceType CompilationData::getType() const noexcept
@@ -279,7 +319,7 @@ SourceType Precompiler::getSourceType(std::istream& stream)
 
 static std::pair<bool, bool> determinePossibleLinkers(const std::vector<CompilationData>& inputs)
 {
-    bool llvmLinkerPossible = findToolLocation(LLVM_LINK_TOOL).has_value();
+    bool llvmLinkerPossible = hasLLVMFrontend() || findToolLocation(LLVM_LINK_TOOL).has_value();
     bool spirvLinkerPossible = hasSPIRVToolsFrontend() || findToolLocation(SPIRV_LINK_TOOL);
 
     for(const auto& input : inputs)
@@ -330,7 +370,7 @@ static NODISCARD LLVMIRSource compileToLLVM(const CompilationData& source)
     {
         return LLVMIRSource(compileOpenCLToLLVMIR(assertSource<SourceType::OPENCL_C>(source), ""));
     }
-    else if(source.getType() == SourceType::LLVM_IR_TEXT && findToolLocation(LLVM_AS_TOOL))
+    else if(source.getType() == SourceType::LLVM_IR_TEXT && (hasLLVMFrontend() || findToolLocation(LLVM_AS_TOOL)))
     {
         return LLVMIRSource(assembleLLVM(assertSource<SourceType::LLVM_IR_TEXT>(source), ""));
     }
@@ -351,8 +391,8 @@ CompilationData Precompiler::linkSourceCode(const std::vector<CompilationData>&
     bool spirvLinkerPossible = false;
     std::tie(llvmLinkerPossible, spirvLinkerPossible) = determinePossibleLinkers(inputs);
 
-    // prefer LLVM IR linker - although it requires spawning an extra process - since LLVM-SPIRV translation is not
-    // complete (e.g. some LLVM intrinsics are not supported)
+    // prefer LLVM IR linker - although it might require spawning an extra process - since LLVM-SPIRV translation is
+    // not complete (e.g. some LLVM intrinsics are not supported)
     if(llvmLinkerPossible)
     {
         std::vector<LLVMIRSource> sources;
@@ -398,7 +438,7 @@ bool Precompiler::isLinkerAvailable(const std::vector<CompilationData>& inputs)
         {
         case SourceType::OPENCL_C:
         case SourceType::LLVM_IR_BIN:
-            return findToolLocation(LLVM_LINK_TOOL).has_value();
+            return hasLLVMFrontend() || findToolLocation(LLVM_LINK_TOOL).has_value();
         case SourceType::LLVM_IR_TEXT:
         case SourceType::SPIRV_BIN:
         case SourceType::SPIRV_TEXT:
@@ -411,7 +451,7 @@ bool Precompiler::isLinkerAvailable(const std::vector<CompilationData>& inputs)
 
 bool Precompiler::isLinkerAvailable()
 {
-    if(hasSPIRVToolsFrontend())
+    if(hasSPIRVToolsFrontend() || hasLLVMFrontend())
         return true;
     if(findToolLocation(LLVM_LINK_TOOL))
         return true;
@@ -464,17 +504,18 @@ static CompilationData runPrecompiler(
     }
     else if(input.getType() == SourceType::LLVM_IR_TEXT)
     {
-        if(outputType == SourceType::SPIRV_BIN && findToolLocation(LLVM_AS_TOOL))
+        auto canAssembleLLVM = hasLLVMFrontend() || findToolLocation(LLVM_AS_TOOL);
+        if(outputType == SourceType::SPIRV_BIN && canAssembleLLVM)
         {
             auto tmp = assembleLLVM(assertSource<SourceType::LLVM_IR_TEXT>(input), extendedOptions);
             return compileLLVMToSPIRV(LLVMIRSource(std::move(tmp)), extendedOptions).publish();
         }
-        else if(outputType == SourceType::SPIRV_TEXT && findToolLocation(LLVM_AS_TOOL))
+        else if(outputType == SourceType::SPIRV_TEXT && canAssembleLLVM)
         {
             auto tmp = assembleLLVM(assertSource<SourceType::LLVM_IR_TEXT>(input), extendedOptions);
             return compileLLVMToSPIRVText(LLVMIRSource(std::move(tmp)), extendedOptions).publish();
         }
-        else if(outputType == SourceType::LLVM_IR_BIN && findToolLocation(LLVM_AS_TOOL))
+        else if(outputType == SourceType::LLVM_IR_BIN && canAssembleLLVM)
         {
             return assembleLLVM(assertSource<SourceType::LLVM_IR_TEXT>(input), extendedOptions).publish();
         }
@@ -489,7 +530,7 @@ static CompilationData runPrecompiler(
         {
             return compileLLVMToSPIRVText(assertSource<SourceType::LLVM_IR_BIN>(input), extendedOptions).publish();
         }
-        else if(outputType == SourceType::LLVM_IR_TEXT && findToolLocation(LLVM_DIS_TOOL))
+        else if(outputType == SourceType::LLVM_IR_TEXT && (hasLLVMFrontend() || findToolLocation(LLVM_DIS_TOOL)))
         {
             return disassembleLLVM(assertSource<SourceType::LLVM_IR_BIN>(input), extendedOptions).publish();
         }
@@ -14,6 +14,13 @@
 
 #include <algorithm>
 #include <array>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #ifdef __GNUC__
 #include <cxxabi.h>
@@ -735,26 +742,55 @@ std::vector<uint32_t> spirv::readStreamOfWords(std::istream& in)
     return words;
 }
 
-std::vector<uint32_t> spirv::readStreamOfWords(const CompilationDataPrivate& in)
+static SPIRVWordBuffer mapFileOfWords(const std::string& filePath)
 {
-    if(auto rawData = in.getRawData())
+    int fd = open(filePath.data(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+        throw CompilationError(CompilationStep::PARSER, "Failed to open SPIR-V input file", filePath);
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size <= 0 || !S_ISREG(info.st_mode))
     {
-        if((rawData->size() % sizeof(uint32_t)) != 0)
+        // e.g. empty file or pipe, which cannot be mapped
+        close(fd);
+        std::ifstream fis{filePath};
+        return SPIRVWordBuffer{readStreamOfWords(fis)};
+    }
+    auto size = static_cast<std::size_t>(info.st_size);
+    auto mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid after closing the file descriptor
+    close(fd);
+    if(mapping == MAP_FAILED)
+        throw CompilationError(CompilationStep::PARSER, "Failed to map SPIR-V input file", strerror(errno));
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Memory-mapped SPIR-V input file '" << filePath << "' with " << size << " bytes" << logging::endl);
+    // as with reading the stream of words, any trailing partial word is ignored
+    return SPIRVWordBuffer{static_cast<const uint32_t*>(mapping), size / sizeof(uint32_t),
+        std::shared_ptr<const void>(mapping, [size](const void* ptr) { munmap(const_cast<void*>(ptr), size); })};
+}
+
+SPIRVWordBuffer spirv::readStreamOfWords(const CompilationDataPrivate& in)
+{
+    auto rawBuffer = in.getRawDataBuffer();
+    if(rawBuffer.first)
+    {
+        if((rawBuffer.second % sizeof(uint32_t)) != 0)
             throw CompilationError(CompilationStep::PARSER, "SPIR-V input data size is not a multiple of 32-bit",
-                std::to_string(rawData->size()));
+                std::to_string(rawBuffer.second));
+        if((reinterpret_cast<uintptr_t>(rawBuffer.first) % alignof(uint32_t)) == 0)
+            // the buffer is owned by the input data, which lives at least as long as the parser using these words
+            return SPIRVWordBuffer{reinterpret_cast<const uint32_t*>(rawBuffer.first),
+                rawBuffer.second / sizeof(uint32_t)};
 
-        std::vector<uint32_t> words(rawData->size() / sizeof(uint32_t));
-        std::memcpy(words.data(), rawData->data(), rawData->size());
-        return words;
+        // misaligned buffer, need to copy to be able to access the words
+        std::vector<uint32_t> words(rawBuffer.second / sizeof(uint32_t));
+        std::memcpy(words.data(), rawBuffer.first, rawBuffer.second);
+        return SPIRVWordBuffer{std::move(words)};
     }
     if(auto filePath = in.getFilePath())
-    {
-        std::ifstream fis{*filePath};
-        return readStreamOfWords(fis);
-    }
+        return mapFileOfWords(*filePath);
     std::stringstream ss;
     in.readInto(ss);
-    return readStreamOfWords(ss);
+    return SPIRVWordBuffer{readStreamOfWords(ss)};
 }
 
 std::string spirv::demangleFunctionName(const std::string& name)
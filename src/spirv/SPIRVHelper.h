@@ -12,7 +12,9 @@
 
 #include "../Locals.h"
 
+#include <memory>
 #include <sstream>
+#include <vector>
 
 namespace vc4c
 {
@@ -42,8 +44,59 @@ namespace vc4c
         DataType getIntegerType(uint32_t bitWidth, uint32_t signedness);
         AddressSpace toAddressSpace(spv::StorageClass storageClass);
 
+        /*
+         * Read-only view of the words of a SPIR-V module.
+         *
+         * The words are either referenced directly from a buffer owned by someone else (e.g. an in-memory input buffer
+         * or a memory-mapped input file) or owned by this object, if they had to be copied.
+         */
+        class SPIRVWordBuffer : private NonCopyable
+        {
+        public:
+            SPIRVWordBuffer() noexcept : externalWords(nullptr), numExternalWords(0) {}
+            explicit SPIRVWordBuffer(std::vector<uint32_t>&& words) noexcept :
+                ownedWords(std::move(words)), externalWords(nullptr), numExternalWords(0)
+            {
+            }
+            SPIRVWordBuffer(const uint32_t* words, std::size_t numWords, std::shared_ptr<const void>&& owner = {}) :
+                owner(std::move(owner)), externalWords(words), numExternalWords(numWords)
+            {
+            }
+
+            const uint32_t* data() const noexcept
+            {
+                return externalWords ? externalWords : ownedWords.data();
+            }
+
+            std::size_t size() const noexcept
+            {
+                return externalWords ? numExternalWords : ownedWords.size();
+            }
+
+            const uint32_t* begin() const noexcept
+            {
+                return data();
+            }
+
+            const uint32_t* end() const noexcept
+            {
+                return data() + size();
+            }
+
+        private:
+            std::vector<uint32_t> ownedWords;
+            // keeps the external buffer alive, e.g. unmaps the memory-mapped file on destruction
+            std::shared_ptr<const void> owner;
+            const uint32_t* externalWords;
+            std::size_t numExternalWords;
+        };
+
         std::vector<uint32_t> readStreamOfWords(std::istream& in);
-        std::vector<uint32_t> readStreamOfWords(const CompilationDataPrivate& in);
+        /*
+         * Returns the words of the given input without copying them, if possible, i.e. if the input is a suitable
+         * aligned in-memory buffer or a file which can be memory-mapped.
+         */
+        SPIRVWordBuffer readStreamOfWords(const CompilationDataPrivate& in);
 
         std::string demangleFunctionName(const std::string& name);
 
@@ -12,6 +12,7 @@
 #include "SPIRVOperation.h"
 #include "log.h"
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstring>
@@ -81,12 +82,12 @@ uint32_t ModuleOperation::getTypeId() const noexcept
 
 std::size_t ModuleOperation::getNumWords() const noexcept
 {
-    return words.size();
+    return numWords;
 }
 
 uint32_t ModuleOperation::getWord(std::size_t wordIndex) const
 {
-    if(words.size() <= wordIndex)
+    if(numWords <= wordIndex)
         throw CompilationError(CompilationStep::PARSER, "Word index out of bounds", std::to_string(wordIndex));
     return words[wordIndex];
 }
@@ -94,11 +95,9 @@ uint32_t ModuleOperation::getWord(std::size_t wordIndex) const
 std::vector<uint32_t> ModuleOperation::parseArguments(std::size_t startIndex) const
 {
     std::vector<uint32_t> args;
-    if(words.size() <= startIndex)
+    if(numWords <= startIndex)
         return args;
-    args.reserve(words.size() - startIndex);
-    for(std::size_t i = startIndex; i < words.size(); ++i)
-        args.push_back(words[i]);
+    args.assign(words + startIndex, words + numWords);
     return args;
 }
 
@@ -108,8 +107,8 @@ std::string ModuleOperation::readLiteralString(std::size_t operandIndex) const
     // word. I.e. this would be wrong when accessing second (or further) string operand!
     auto startWord = 1 /* opcode + size */ + operandIndex;
     const size_t length =
-        strnlen(reinterpret_cast<const char*>(words.data() + startWord), sizeof(uint32_t) * (words.size() - startWord));
-    return std::string(reinterpret_cast<const char*>(words.data() + startWord), length);
+        strnlen(reinterpret_cast<const char*>(words + startWord), sizeof(uint32_t) * (numWords - startWord));
+    return std::string(reinterpret_cast<const char*>(words + startWord), length);
 }
 
 static std::pair<spv::Op, uint16_t> splitFirstWord(uint32_t word) noexcept
@@ -148,57 +147,68 @@ static std::string getErrorMessage(ParseResultCode error)
 
 SPIRVLexer::~SPIRVLexer() = default;
 
-void SPIRVLexer::doParse(const std::vector<uint32_t>& module)
+void SPIRVLexer::doParse(const SPIRVWordBuffer& module)
 {
     auto start = parseHeader(module);
     parseBody(module, start.second, start.first);
 }
 
-std::pair<EndinanessConverter, std::vector<uint32_t>::const_iterator> SPIRVLexer::parseHeader(
-    const std::vector<uint32_t>& input)
+std::pair<EndinanessConverter, const uint32_t*> SPIRVLexer::parseHeader(const SPIRVWordBuffer& input)
 {
     if(input.size() < 6)
         return std::make_pair(nullptr, input.end());
     auto it = input.begin();
     // first word -> magic number
     uint32_t magicNumber = *(it++);
+    // The input words are only converted if they are not already in host byte order. This allows to parse the words
+    // directly from the input buffer (or memory-mapped file) without copying them for the most common case.
+    EndinanessConverter converter = isHostOrder(magicNumber) ? nullptr : swapEndianess;
+    auto convert = converter ? converter : dummyConvert;
     // second word -> version number with one byte per (high to low): 0 | major | minor | 0
-    uint32_t versionNumber = *(it++);
+    uint32_t versionNumber = convert(*(it++));
     // third word -> generator ID, defaults to zero
-    uint32_t generatorId = *(it++);
+    uint32_t generatorId = convert(*(it++));
     // fourth word -> bound, upper ID limit
-    uint32_t idBound = *(it++);
+    uint32_t idBound = convert(*(it++));
     // fifth word -> reserved
     ++it;
 
+    magicNumber = convert(magicNumber);
     CPPLOG_LAZY(logging::Level::DEBUG,
         log << "SPIR-V header parsed: magic-number 0x" << std::hex << magicNumber << ", version 0x" << versionNumber
             << ", generator " << generatorId << ", max-ID " << std::dec << idBound << logging::endl);
     SPIRVParserBase::parseHeader(magicNumber, versionNumber, generatorId, idBound);
 
-    auto converter = isHostOrder(magicNumber) ? dummyConvert : swapEndianess;
     return std::make_pair(converter, it);
 }
 
-bool SPIRVLexer::parseBody(const std::vector<uint32_t>& input, std::vector<uint32_t>::const_iterator startIt,
-    EndinanessConverter convertEndianess)
+bool SPIRVLexer::parseBody(const SPIRVWordBuffer& input, const uint32_t* startIt, EndinanessConverter convertEndianess)
 {
     ModuleOperation currentOp;
     auto it = startIt;
     while(it != input.end())
     {
-        auto opcode = splitFirstWord(convertEndianess(*it));
-        currentOp.opCode = opcode.first;
-        currentOp.typeId = convertEndianess(extractTypeId(opcode.first, &*it).value_or(UNDEFINED_ID));
-        currentOp.resultId = convertEndianess(extractResultId(opcode.first, &*it).value_or(UNDEFINED_ID));
-        currentOp.words.resize(opcode.second);
+        auto opcode = splitFirstWord(convertEndianess ? convertEndianess(*it) : *it);
+        if(opcode.second == 0)
+            throw CompilationError(CompilationStep::PARSER, "Invalid operation with zero words",
+                std::to_string(static_cast<unsigned>(opcode.first)));
+        if(static_cast<std::ptrdiff_t>(opcode.second) > input.end() - it)
+            throw CompilationError(CompilationStep::PARSER, "Reached end-of-stream while parsing operation");
 
-        uint16_t i = 0;
-        for(; i < opcode.second && it != input.end(); ++i, ++it)
-            currentOp.words[i] = convertEndianess(*it);
+        if(convertEndianess)
+        {
+            currentOp.convertedWords.resize(opcode.second);
+            std::transform(it, it + opcode.second, currentOp.convertedWords.begin(), convertEndianess);
+            currentOp.words = currentOp.convertedWords.data();
+        }
+        else
+            currentOp.words = it;
+        currentOp.numWords = opcode.second;
+        currentOp.opCode = opcode.first;
+        currentOp.typeId = extractTypeId(opcode.first, currentOp.words).value_or(UNDEFINED_ID);
+        currentOp.resultId = extractResultId(opcode.first, currentOp.words).value_or(UNDEFINED_ID);
+        it += opcode.second;
 
-        if(it == input.end() && i != opcode.second)
-            throw CompilationError(CompilationStep::PARSER, "Reached end-of-stream while parsing operation");
         auto result = parseInstruction(currentOp);
         if(result != ParseResultCode::SUCCESS)
         {
@@ -44,7 +44,11 @@ namespace vc4c
             spv::Op opCode;
             uint32_t typeId;
             uint32_t resultId;
-            std::vector<uint32_t> words;
+            // the words of the operation, either referencing the input words directly or the converted words
+            const uint32_t* words = nullptr;
+            std::size_t numWords = 0;
+            // only used if the input is not in host byte order
+            std::vector<uint32_t> convertedWords;
         };
 
         class SPIRVLexer final : public SPIRVParserBase
@@ -58,18 +62,19 @@ namespace vc4c
             ~SPIRVLexer() override;
 
         private:
-            std::vector<uint32_t> assembleTextToBinary(const std::vector<uint32_t>& module) override
+            std::vector<uint32_t> assembleTextToBinary(const SPIRVWordBuffer& module) override
             {
                 throw CompilationError(
                     CompilationStep::PARSER, "Assembling SPIR-V text to binary is not supported by this front-end!");
             }
 
-            void doParse(const std::vector<uint32_t>& module) override;
+            void doParse(const SPIRVWordBuffer& module) override;
 
-            std::pair<EndinanessConverter, std::vector<uint32_t>::const_iterator> parseHeader(
-                const std::vector<uint32_t>& input);
-            bool parseBody(const std::vector<uint32_t>& input, std::vector<uint32_t>::const_iterator startIt,
-                EndinanessConverter convertEndianess);
+            /*
+             * Returns the converter to apply to all words or NULL if the input is in host byte order
+             */
+            std::pair<EndinanessConverter, const uint32_t*> parseHeader(const SPIRVWordBuffer& input);
+            bool parseBody(const SPIRVWordBuffer& input, const uint32_t* startIt, EndinanessConverter convertEndianess);
         };
     } // namespace spirv
 } // namespace vc4c
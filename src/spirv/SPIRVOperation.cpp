@@ -23,11 +23,13 @@
 using namespace vc4c;
 using namespace vc4c::spirv;
 
+/*
+ * NOTE: This does not update the (global) local type mapping, since it is accessed concurrently while mapping the
+ * instructions of different functions. The type of any local created here can be looked up in the local mapping.
+ */
 static Value toNewLocal(Method& method, const uint32_t id, const uint32_t typeID, const TypeMapping& typeMappings,
-    LocalTypeMapping& localTypes, LocalMapping& localMapping)
+    LocalMapping& localMapping)
 {
-    localTypes[id] = typeID;
-
     auto it = localMapping.find(id);
     if(it != localMapping.end())
         // local is "defined" (at compilation time) before its definition (in code), this can e.g. happen for back-edges
@@ -114,7 +116,7 @@ SPIRVInstruction::SPIRVInstruction(const uint32_t id, SPIRVMethod& method, const
 void SPIRVInstruction::mapInstruction(TypeMapping& types, ConstantMapping& constants, LocalTypeMapping& localTypes,
     MethodMapping& methods, LocalMapping& localMapping)
 {
-    Value dest = toNewLocal(*method.method, id, typeID, types, localTypes, localMapping);
+    Value dest = toNewLocal(*method.method, id, typeID, types, localMapping);
     Value arg0 = getValue(operands.at(0), *method.method, types, constants, localTypes, localMapping);
     Optional<Value> arg1(NO_VALUE);
     std::string opCode = opcode;
@@ -242,7 +244,7 @@ SPIRVComparison::SPIRVComparison(const uint32_t id, SPIRVMethod& method, const s
 void SPIRVComparison::mapInstruction(TypeMapping& types, ConstantMapping& constants, LocalTypeMapping& localTypes,
     MethodMapping& methods, LocalMapping& localMapping)
 {
-    Value dest = toNewLocal(*method.method, id, typeID, types, localTypes, localMapping);
+    Value dest = toNewLocal(*method.method, id, typeID, types, localMapping);
     Value arg0 = getValue(operands.at(0), *method.method, types, constants, localTypes, localMapping);
     Value arg1 = getValue(operands.at(1), *method.method, types, constants, localTypes, localMapping);
     CPPLOG_LAZY(logging::Level::DEBUG,
@@ -330,7 +332,7 @@ void SPIRVCallSite::mapInstruction(TypeMapping& types, ConstantMapping& constant
     MethodMapping& methods, LocalMapping& localMapping)
 {
     Value dest =
-        id == UNDEFINED_ID ? UNDEFINED_VALUE : toNewLocal(*method.method, id, typeID, types, localTypes, localMapping);
+        id == UNDEFINED_ID ? UNDEFINED_VALUE : toNewLocal(*method.method, id, typeID, types, localMapping);
     std::string calledFunction = methodName.value_or("");
     if(methodID)
         calledFunction = methods.at(methodID.value()).method->name;
@@ -483,7 +485,7 @@ SPIRVBoolCallSite::SPIRVBoolCallSite(uint32_t id, SPIRVMethod& method, const std
 void SPIRVBoolCallSite::mapInstruction(TypeMapping& types, ConstantMapping& constants, LocalTypeMapping& localTypes,
     MethodMapping& methods, LocalMapping& localMapping)
 {
-    Value dest = toNewLocal(*method.method, id, typeID, types, localTypes, localMapping);
+    Value dest = toNewLocal(*method.method, id, typeID, types, localMapping);
     std::string calledFunction = methodName.value_or("");
     if(methodID)
         calledFunction = methods.at(methodID.value()).method->name;
@@ -638,7 +640,7 @@ void SPIRVConversion::mapInstruction(TypeMapping& types, ConstantMapping& consta
     MethodMapping& methods, LocalMapping& localMapping)
 {
     Value source = getValue(sourceID, *method.method, types, constants, localTypes, localMapping);
-    Value dest = toNewLocal(*method.method, id, typeID, types, localTypes, localMapping);
+    Value dest = toNewLocal(*method.method, id, typeID, types, localMapping);
     bool isSaturated = has_flag(decorations, intermediate::InstructionDecorations::SATURATED_CONVERSION);
     // The rest of the compiler does not handle this decoration at all
     decorations = remove_flag(decorations, intermediate::InstructionDecorations::SATURATED_CONVERSION);
@@ -843,7 +845,7 @@ void SPIRVCopy::mapInstruction(TypeMapping& types, ConstantMapping& constants, L
         }
     }
     else
-        dest = toNewLocal(*method.method, id, typeID, types, localTypes, localMapping);
+        dest = toNewLocal(*method.method, id, typeID, types, localMapping);
     if(auto builtin = dynamic_cast<SPIRVBuiltin*>(source.checkLocal()))
     {
         // this is a "load" from a built-in variable -> convert to intrinsic function which will then be handled by
@@ -959,7 +961,7 @@ void SPIRVInsertionExtraction::mapInstruction(TypeMapping& types, ConstantMappin
     LocalTypeMapping& localTypes, MethodMapping& methods, LocalMapping& localMapping)
 {
     Value container = getValue(containerId, *method.method, types, constants, localTypes, localMapping);
-    Value dest = toNewLocal(*method.method, id, typeID, types, localTypes, localMapping);
+    Value dest = toNewLocal(*method.method, id, typeID, types, localMapping);
     auto element =
         elementId ? getValue(*elementId, *method.method, types, constants, localTypes, localMapping) : NO_VALUE;
 
@@ -1023,7 +1025,7 @@ void SPIRVShuffle::mapInstruction(TypeMapping& types, ConstantMapping& constants
     MethodMapping& methods, LocalMapping& localMapping)
 {
     // shuffling = iteration over all elements in both vectors and re-ordering in order given
-    Value dest = toNewLocal(*method.method, id, typeID, types, localTypes, localMapping);
+    Value dest = toNewLocal(*method.method, id, typeID, types, localMapping);
     Value src0 = getValue(source0, *method.method, types, constants, localTypes, localMapping);
     Value src1 = getValue(source1, *method.method, types, constants, localTypes, localMapping);
     Value index(UNDEFINED_VALUE);
@@ -1090,7 +1092,7 @@ void SPIRVIndexOf::mapInstruction(TypeMapping& types, ConstantMapping& constants
 {
     // need to get pointer/address -> reference to content
     // a[i] of type t is at position &a + i * sizeof(t)
-    Value dest = toNewLocal(*method.method, id, typeID, types, localTypes, localMapping);
+    Value dest = toNewLocal(*method.method, id, typeID, types, localMapping);
     Value container = getValue(this->container, *method.method, types, constants, localTypes, localMapping);
 
     std::vector<Value> indexValues;
@@ -1230,7 +1232,7 @@ SPIRVPhi::SPIRVPhi(const uint32_t id, SPIRVMethod& method, const uint32_t result
 void SPIRVPhi::mapInstruction(TypeMapping& types, ConstantMapping& constants, LocalTypeMapping& localTypes,
     MethodMapping& methods, LocalMapping& localMapping)
 {
-    Value dest = toNewLocal(*method.method, id, typeID, types, localTypes, localMapping);
+    Value dest = toNewLocal(*method.method, id, typeID, types, localMapping);
 
     CPPLOG_LAZY(logging::Level::DEBUG,
         log << "Generating Phi-Node with " << sources.size() << " options into " << dest.to_string() << logging::endl);
@@ -1266,7 +1268,7 @@ void SPIRVSelect::mapInstruction(TypeMapping& types, ConstantMapping& constants,
     const Value sourceTrue = getValue(trueID, *method.method, types, constants, localTypes, localMapping);
     const Value sourceFalse = getValue(falseID, *method.method, types, constants, localTypes, localMapping);
     const Value condition = getValue(condID, *method.method, types, constants, localTypes, localMapping);
-    const Value dest = toNewLocal(*method.method, id, typeID, types, localTypes, localMapping);
+    const Value dest = toNewLocal(*method.method, id, typeID, types, localMapping);
 
     CPPLOG_LAZY(logging::Level::DEBUG,
         log << "Generating intermediate select on " << condition.to_string() << " whether to write "
@@ -1395,7 +1397,7 @@ SPIRVImageQuery::SPIRVImageQuery(const uint32_t id, SPIRVMethod& method, const u
 void SPIRVImageQuery::mapInstruction(TypeMapping& types, ConstantMapping& constants, LocalTypeMapping& localTypes,
     MethodMapping& methods, LocalMapping& localMapping)
 {
-    const Value dest = toNewLocal(*method.method, id, typeID, types, localTypes, localMapping);
+    const Value dest = toNewLocal(*method.method, id, typeID, types, localMapping);
     const Value image = getValue(imageID, *method.method, types, constants, localTypes, localMapping);
     Value param(UNDEFINED_VALUE);
     if(lodOrCoordinate != UNDEFINED_ID)
@@ -1527,7 +1529,7 @@ SPIRVFoldInstruction::SPIRVFoldInstruction(uint32_t id, SPIRVMethod& method, uin
 void SPIRVFoldInstruction::mapInstruction(TypeMapping& types, ConstantMapping& constants, LocalTypeMapping& localTypes,
     MethodMapping& methods, LocalMapping& localMapping)
 {
-    Value dest = toNewLocal(*method.method, id, typeID, types, localTypes, localMapping);
+    Value dest = toNewLocal(*method.method, id, typeID, types, localMapping);
     Value src = getValue(sourceID, *method.method, types, constants, localTypes, localMapping);
     auto code = OpCode::toOpCode(foldOperation);
     CPPLOG_LAZY(logging::Level::DEBUG,
@@ -52,6 +52,11 @@ namespace vc4c
             virtual Optional<Value> precalculate(const TypeMapping& types, const ConstantMapping& constants,
                 const LocalMapping& memoryAllocated) const = 0;
 
+            const SPIRVMethod& getMethod() const noexcept
+            {
+                return method;
+            }
+
         protected:
             const uint32_t id;
             SPIRVMethod& method;
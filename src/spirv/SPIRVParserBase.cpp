@@ -6,6 +6,9 @@
 
 #include "SPIRVParserBase.h"
 
+#include "../Logger.h"
+#include "../Profiler.h"
+#include "../ThreadPool.h"
 #include "../intermediate/IntermediateInstruction.h"
 #include "../intrinsics/Images.h"
 #include "../precompilation/CompilationData.h"
@@ -13,6 +16,7 @@
 #include "SPIRVHelper.h"
 #include "log.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <cstring>
@@ -42,7 +46,7 @@ void SPIRVParserBase::parse(Module& module)
     // if input is SPIR-V text, convert to binary representation
     if(isTextInput)
     {
-        inputWords = assembleTextToBinary(inputWords);
+        inputWords = SPIRVWordBuffer{assembleTextToBinary(inputWords)};
     }
     else
     {
@@ -54,6 +58,9 @@ void SPIRVParserBase::parse(Module& module)
     CPPLOG_LAZY(logging::Level::DEBUG, log << "Starting parsing..." << logging::endl);
     doParse(inputWords);
     CPPLOG_LAZY(logging::Level::DEBUG, log << "SPIR-V binary successfully parsed" << logging::endl);
+    PROFILE_COUNTER(vc4c::profiler::COUNTER_FRONTEND, "SPIR-V operations parsed", instructions.size());
+    // the input is fully represented by the parsed operations, so release the (assembled or memory-mapped) words
+    inputWords = SPIRVWordBuffer{};
 
     // resolve method parameters
     // set names, e.g. for methods, parameters
@@ -105,10 +112,7 @@ void SPIRVParserBase::parse(Module& module)
 
     // map SPIRVOperations to IntermediateInstructions
     CPPLOG_LAZY(logging::Level::DEBUG, log << "Mapping instructions to intermediate..." << logging::endl);
-    for(const auto& op : instructions)
-    {
-        op->mapInstruction(typeMappings, constantMappings, localTypes, methods, memoryAllocatedData);
-    }
+    mapInstructions();
 
     // apply kernel meta-data, decorations, ...
     for(const auto& pair : metadataMappings)
@@ -190,6 +194,45 @@ void SPIRVParserBase::parse(Module& module)
     addFunctionAliases(module);
 }
 
+void SPIRVParserBase::mapInstructions()
+{
+    PROFILE_SCOPE(MapSPIRVInstructions);
+    // Move the operations to the function they are located in, retaining their order within each function
+    FastMap<uint32_t, std::vector<std::unique_ptr<SPIRVOperation>>> functionOperations;
+    std::vector<uint32_t> functionIds;
+    for(auto& op : instructions)
+    {
+        auto& ops = functionOperations[op->getMethod().id];
+        if(ops.empty())
+            functionIds.push_back(op->getMethod().id);
+        ops.emplace_back(std::move(op));
+    }
+    instructions.clear();
+    instructions.shrink_to_fit();
+
+    // SPIR-V does not allow to reference IDs defined in other functions, so the functions can be mapped independently
+    // of each other. All module-level mappings are completed by the (sequential) parsing and are only read here, the
+    // module-level types and constant vectors created while mapping are synchronized by the module itself.
+    const auto mapFunction = [&](const uint32_t& functionId) {
+        // the only mapping modified, by inserting the function-local values
+        LocalMapping localMapping = memoryAllocatedData;
+        for(auto& op : functionOperations.at(functionId))
+        {
+            op->mapInstruction(typeMappings, constantMappings, localTypes, methods, localMapping);
+            // Forward references (e.g. phi-node operands, branch targets) are resolved via the local mapping, so the
+            // operation is no longer required. Freeing it right away lowers the peak memory usage while mapping, the
+            // operations of all not yet mapped functions are still held in memory though.
+            op.reset();
+        }
+    };
+    if(functionIds.size() > 1)
+        ThreadPool::scheduleAll<uint32_t, std::vector<uint32_t>>(
+            "SPIR-V mapping", functionIds, mapFunction, THREAD_LOGGER.get());
+    else
+        std::for_each(functionIds.begin(), functionIds.end(), mapFunction);
+    PROFILE_COUNTER(vc4c::profiler::COUNTER_FRONTEND, "SPIR-V functions mapped", functionIds.size());
+}
+
 ParseResultCode SPIRVParserBase::parseHeader(uint32_t magic, uint32_t version, uint32_t generator, uint32_t id_bound)
 {
     // see:
@@ -11,6 +11,7 @@
 #include "../performance.h"
 #include "CompilationError.h"
 #include "Precompiler.h"
+#include "SPIRVHelper.h"
 #include "SPIRVOperation.h"
 
 #include "spirv/unified1/spirv.hpp11"
@@ -84,8 +85,8 @@ namespace vc4c
             const bool isTextInput;
             // all global methods in the module
             MethodMapping methods;
-            // the input words
-            std::vector<uint32_t> inputWords;
+            // the input words, referencing the input buffer or memory-mapped file if possible
+            SPIRVWordBuffer inputWords;
             // the currently processed method, only valid while parsing
             SPIRVMethod* currentMethod;
             // the global mapping of ID -> constants
@@ -117,14 +118,18 @@ namespace vc4c
             Module* module;
 
             ParseResultCode parseDecoration(const ParsedInstruction& parsed_instruction, uint32_t value);
+            /*
+             * Maps the parsed operations to intermediate instructions, processing the functions in parallel
+             */
+            void mapInstructions();
 
             ParseResultCode consumeOpenCLInstruction(const ParsedInstruction& instruction);
             ParseResultCode consumeDebugInfoInstruction(const ParsedInstruction& instruction);
             ParseResultCode consumeOpenCLDebugInfoInstruction(const ParsedInstruction& instruction);
             ParseResultCode consumeNonSemanticInstruction(const ParsedInstruction& instruction);
 
-            virtual std::vector<uint32_t> assembleTextToBinary(const std::vector<uint32_t>& module) = 0;
-            virtual void doParse(const std::vector<uint32_t>& module) = 0;
+            virtual std::vector<uint32_t> assembleTextToBinary(const SPIRVWordBuffer& module) = 0;
+            virtual void doParse(const SPIRVWordBuffer& module) = 0;
         };
     } // namespace spirv
 } // namespace vc4c
@@ -190,7 +190,7 @@ static std::string getErrorPosition(spv_diagnostic diagnostics)
 
 SPIRVToolsParser::~SPIRVToolsParser() = default;
 
-std::vector<uint32_t> SPIRVToolsParser::assembleTextToBinary(const std::vector<uint32_t>& module)
+std::vector<uint32_t> SPIRVToolsParser::assembleTextToBinary(const SPIRVWordBuffer& module)
 {
     spvtools::SpirvTools tools(SPV_ENV_OPENCL_EMBEDDED_1_2);
     tools.SetMessageConsumer(consumeSPIRVMessage);
@@ -202,7 +202,7 @@ std::vector<uint32_t> SPIRVToolsParser::assembleTextToBinary(const std::vector<u
     return {};
 }
 
-void SPIRVToolsParser::doParse(const std::vector<uint32_t>& module)
+void SPIRVToolsParser::doParse(const SPIRVWordBuffer& module)
 {
     spv_diagnostic diagnostics = nullptr;
     spv_context context = spvContextCreate(SPV_ENV_OPENCL_EMBEDDED_1_2);
@@ -230,10 +230,20 @@ void SPIRVToolsParser::doParse(const std::vector<uint32_t>& module)
 void spirv::linkSPIRVModules(const std::vector<std::reference_wrapper<const precompilation::SPIRVData>>& sources,
     precompilation::SPIRVData& output)
 {
-    std::vector<std::vector<uint32_t>> binaries;
+    std::vector<SPIRVWordBuffer> binaries;
     binaries.reserve(sources.size());
     std::transform(sources.begin(), sources.end(), std::back_inserter(binaries),
         [](const auto& source) { return readStreamOfWords(source.get()); });
+    // use the raw pointer interface of the linker to not have to copy the input words into vectors
+    std::vector<const uint32_t*> binaryWords;
+    std::vector<std::size_t> binarySizes;
+    binaryWords.reserve(binaries.size());
+    binarySizes.reserve(binaries.size());
+    for(const auto& binary : binaries)
+    {
+        binaryWords.push_back(binary.data());
+        binarySizes.push_back(binary.size());
+    }
 
     spvtools::LinkerOptions options;
     options.SetCreateLibrary(false);
@@ -244,7 +254,8 @@ void spirv::linkSPIRVModules(const std::vector<std::reference_wrapper<const prec
     spvtools::Context spvContext(SPV_ENV_OPENCL_EMBEDDED_1_2);
 
     std::vector<uint32_t> linkedModules;
-    spv_result_t result = spvtools::Link(spvContext, binaries, &linkedModules, options);
+    spv_result_t result = spvtools::Link(
+        spvContext, binaryWords.data(), binarySizes.data(), binaries.size(), &linkedModules, options);
 
     if(result != SPV_SUCCESS)
         throw CompilationError(CompilationStep::PARSER, getErrorMessage(result));
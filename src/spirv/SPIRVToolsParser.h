@@ -58,8 +58,8 @@ namespace vc4c
             ~SPIRVToolsParser() override;
 
         protected:
-            std::vector<uint32_t> assembleTextToBinary(const std::vector<uint32_t>& module) override;
-            void doParse(const std::vector<uint32_t>& module) override;
+            std::vector<uint32_t> assembleTextToBinary(const SPIRVWordBuffer& module) override;
+            void doParse(const SPIRVWordBuffer& module) override;
         };
 
         void linkSPIRVModules(
@@ -98,12 +98,12 @@ namespace vc4c
             ~SPIRVToolsParser() override = default;
 
         protected:
-            void doParse(const std::vector<uint32_t>& module) override
+            void doParse(const SPIRVWordBuffer& module) override
             {
                 throw CompilationError(CompilationStep::GENERAL, "SPIR-V Tools is not available!");
             }
 
-            std::vector<uint32_t> assembleTextToBinary(const std::vector<uint32_t>& module) override
+            std::vector<uint32_t> assembleTextToBinary(const SPIRVWordBuffer& module) override
             {
                 throw CompilationError(CompilationStep::PARSER, "SPIR-V Tools is not available!");
             }
@@ -14,10 +14,14 @@
 #include "../asm/KernelInfo.h"
 #include "../asm/LoadInstruction.h"
 #include "../asm/SemaphoreInstruction.h"
+#include "../intrinsics/Images.h"
 #include "../periphery/SFU.h"
 #include "../periphery/VPM.h"
 #include "CompilationError.h"
 #include "Compiler.h"
+#include "Profile.h"
+#include "Snapshot.h"
+#include "Trace.h"
 
 #include "log.h"
 
@@ -45,7 +49,7 @@ struct ExecutionBase : NonCopyable
 {
     virtual ~ExecutionBase() noexcept = default;
 
-    virtual bool operator()(uint32_t currentCycle) = 0;
+    virtual bool operator()(uint64_t currentCycle) = 0;
 };
 
 template <typename Func>
@@ -54,7 +58,7 @@ struct ExecutionWrapper final : ExecutionBase
     ExecutionWrapper(Func&& func) : func(std::move(func)) {}
     ~ExecutionWrapper() override = default;
 
-    bool operator()(uint32_t currentCycle) override
+    bool operator()(uint64_t currentCycle) override
     {
         return func(currentCycle);
     }
@@ -79,7 +83,7 @@ struct vc4c::tools::AsynchronousExecution : NonCopyable
     {
     }
 
-    bool operator()(uint32_t currentCycle)
+    bool operator()(uint64_t currentCycle)
     {
         return (*func)(currentCycle);
     }
@@ -88,7 +92,17 @@ struct vc4c::tools::AsynchronousExecution : NonCopyable
 class vc4c::tools::EmulationClock
 {
 public:
-    uint32_t currentCycle = 0;
+    uint64_t currentCycle = 0;
+    /*
+     * The optional sink for the execution trace
+     */
+    TraceWriter* trace = nullptr;
+
+    inline void traceEvent(uint8_t qpu, ProgramCounter pc, TraceEvent event, uint32_t data = 0)
+    {
+        if(trace)
+            trace->write(TraceRecord{currentCycle, pc, data, qpu, event, 0, 0});
+    }
 
     template <typename Func>
     void schedule(std::string&& name, Func&& func)
@@ -119,6 +133,11 @@ public:
         return !executions.empty();
     }
 
+    void discardPendingExecutions()
+    {
+        executions.clear();
+    }
+
     LCOV_EXCL_START
     void logPendingExecutions()
     {
@@ -188,64 +207,163 @@ static std::string toDataString(const Container& container)
     return ss.str();
 }
 
-tools::Word* Memory::getWordAddress(MemoryAddress address)
+static constexpr tools::Word UNALLOCATED_MEMORY_VALUE = 0xDEADBEEF;
+static constexpr std::size_t WORDS_PER_PAGE = Memory::MEMORY_PAGE_SIZE / sizeof(tools::Word);
+
+static const tools::Word* getUnallocatedPage()
+{
+    // reads from owned memory never written before return this "garbage", so we do not need to allocate the page
+    static const auto page = []() {
+        std::array<tools::Word, WORDS_PER_PAGE> tmp{};
+        tmp.fill(UNALLOCATED_MEMORY_VALUE);
+        return tmp;
+    }();
+    return page.data();
+}
+
+Memory::Memory(std::size_t size)
+{
+    addOwnedMemory(0, size * sizeof(Word));
+}
+
+Memory::Memory(const std::map<uint32_t, std::reference_wrapper<std::vector<uint8_t>>>& buffers)
+{
+    for(const auto& buffer : buffers)
+        mapHostMemory(buffer.first, buffer.second.get().data(), buffer.second.get().size());
+}
+
+void Memory::addOwnedMemory(MemoryAddress address, std::size_t numBytes)
+{
+    if(address % sizeof(Word) != 0)
+        throw CompilationError(
+            CompilationStep::GENERAL, "Owned memory needs to be word-aligned", toAddressString(address));
+    Region region{address, numBytes, nullptr, {}};
+    region.ownedPages.resize((numBytes + MEMORY_PAGE_SIZE - 1) / MEMORY_PAGE_SIZE);
+    addRegion(std::move(region));
+}
+
+void Memory::mapHostMemory(MemoryAddress address, uint8_t* hostData, std::size_t numBytes)
+{
+    if(!hostData)
+        throw CompilationError(
+            CompilationStep::GENERAL, "Cannot map host memory without data", toAddressString(address));
+    addRegion(Region{address, numBytes, hostData, {}});
+}
+
+void Memory::addRegion(Region&& region)
 {
-    if(auto direct = VariantNamespace::get_if<DirectBuffer>(&data))
+    if(region.numBytes == 0)
+        // nothing can be accessed anyway
+        return;
+    if(static_cast<uint64_t>(region.start) + region.numBytes > (uint64_t{1} << 32))
+        throw CompilationError(CompilationStep::GENERAL, "Memory region exceeds the 32-bit address space",
+            toAddressString(region.start) + " + " + std::to_string(region.numBytes));
+    auto next = regions.lower_bound(region.start);
+    if((next != regions.end() && next->first < region.start + region.numBytes) ||
+        (next != regions.begin() &&
+            std::prev(next)->second.start + std::prev(next)->second.numBytes > region.start))
+        throw CompilationError(CompilationStep::GENERAL, "Memory region overlaps already mapped memory",
+            toAddressString(region.start) + " + " + std::to_string(region.numBytes));
+    regions.emplace(region.start, std::move(region));
+
+    // rebuild the page table for the whole range covered by any region
+    const auto& lastRegion = regions.rbegin()->second;
+    auto firstPage = regions.begin()->first / MEMORY_PAGE_SIZE;
+    auto endPage = (lastRegion.start + lastRegion.numBytes + MEMORY_PAGE_SIZE - 1) / MEMORY_PAGE_SIZE;
+    pageTableBase = firstPage * MEMORY_PAGE_SIZE;
+    pageTable.assign(endPage - firstPage, nullptr);
+    std::vector<bool> pageUsed(pageTable.size(), false);
+    for(auto& entry : regions)
     {
-        if(address >= direct->size() * sizeof(Word))
+        auto& current = entry.second;
+        auto currentEndPage = (current.start + current.numBytes + MEMORY_PAGE_SIZE - 1) / MEMORY_PAGE_SIZE;
+        for(auto page = current.start / MEMORY_PAGE_SIZE; page < currentEndPage; ++page)
         {
-            logging::warn() << "Buffer: [" << toAddressString(0) << ", "
-                            << toAddressString(direct->size() * sizeof(Word)) << ")" << logging::endl;
-            throw CompilationError(CompilationStep::GENERAL,
-                "Memory address is out of bounds, consider using larger buffer", toAddressString(address));
+            auto index = page - firstPage;
+            // pages shared by multiple regions are resolved via the region map
+            pageTable[index] = pageUsed[index] ? nullptr : &current;
+            pageUsed[index] = true;
         }
-        return direct->data() + (address / sizeof(Word));
     }
-    auto& buffers = VariantNamespace::get<MappedBuffers>(data);
-    for(const auto& buf : buffers)
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Mapped memory region [" << toAddressString(lastRegion.start) << ", "
+            << toAddressString(lastRegion.start + lastRegion.numBytes) << "), page table has " << pageTable.size()
+            << " entries" << logging::endl);
+}
+
+const Memory::Region* Memory::findRegion(MemoryAddress address) const
+{
+    if(address >= pageTableBase)
     {
-        if(buf.first <= address && (buf.first + buf.second.get().size()) > address)
-        {
-            auto wordBoundsAddress = (address / sizeof(Word)) * sizeof(Word);
-            return reinterpret_cast<Word*>(buf.second.get().data() + wordBoundsAddress - buf.first);
-        }
+        auto index = (address - pageTableBase) / MEMORY_PAGE_SIZE;
+        if(index < pageTable.size() && pageTable[index] && pageTable[index]->contains(address))
+            return pageTable[index];
     }
+    // slow path for pages shared by multiple regions or not mapped at all
+    auto it = regions.upper_bound(address);
+    if(it == regions.begin())
+        return nullptr;
+    --it;
+    return it->second.contains(address) ? &it->second : nullptr;
+}
+
+const Memory::Region& Memory::getRegion(MemoryAddress address, std::size_t numBytes) const
+{
+    auto region = findRegion(address);
+    if(region && region->contains(address, numBytes))
+        return *region;
     logging::logLazy(logging::Level::WARNING, [&]() {
-        for(const auto& buffer : buffers)
-            logging::warn() << "Buffer: [" << toAddressString(buffer.first) << ", "
-                            << toAddressString(buffer.first + buffer.second.get().size()) << ")" << logging::endl;
+        for(const auto& entry : regions)
+            logging::warn() << "Buffer: [" << toAddressString(entry.first) << ", "
+                            << toAddressString(entry.first + entry.second.numBytes) << ")" << logging::endl;
     });
-    throw CompilationError(CompilationStep::GENERAL, "Address is not part of any buffer", toAddressString(address));
+    throw CompilationError(CompilationStep::GENERAL, "Address is not part of any buffer",
+        "(" + toAddressString(address) + ", " + std::to_string(numBytes) + ")");
 }
 
-const tools::Word* Memory::getWordAddress(MemoryAddress address) const
+Memory::Region& Memory::getRegion(MemoryAddress address, std::size_t numBytes)
 {
-    if(auto direct = VariantNamespace::get_if<DirectBuffer>(&data))
-    {
-        if(address >= direct->size() * sizeof(Word))
-        {
-            logging::warn() << "Buffer: [" << toAddressString(0) << ", "
-                            << toAddressString(direct->size() * sizeof(Word)) << ")" << logging::endl;
-            throw CompilationError(CompilationStep::GENERAL,
-                "Memory address is out of bounds, consider using larger buffer", toAddressString(address));
-        }
-        return direct->data() + (address / sizeof(Word));
-    }
-    auto& buffers = VariantNamespace::get<MappedBuffers>(data);
-    for(const auto& buf : buffers)
+    return const_cast<Region&>(static_cast<const Memory*>(this)->getRegion(address, numBytes));
+}
+
+std::pair<const uint8_t*, std::size_t> Memory::Region::toHostMemory(MemoryAddress address) const
+{
+    auto offset = static_cast<std::size_t>(address - start);
+    if(hostData)
+        return std::make_pair(hostData + offset, numBytes - offset);
+    auto pageOffset = offset % MEMORY_PAGE_SIZE;
+    const auto& page = ownedPages[offset / MEMORY_PAGE_SIZE];
+    return std::make_pair(reinterpret_cast<const uint8_t*>(page ? page.get() : getUnallocatedPage()) + pageOffset,
+        std::min(MEMORY_PAGE_SIZE - pageOffset, numBytes - offset));
+}
+
+std::pair<uint8_t*, std::size_t> Memory::Region::toHostMemory(MemoryAddress address)
+{
+    auto offset = static_cast<std::size_t>(address - start);
+    if(hostData)
+        return std::make_pair(hostData + offset, numBytes - offset);
+    auto pageOffset = offset % MEMORY_PAGE_SIZE;
+    auto& page = ownedPages[offset / MEMORY_PAGE_SIZE];
+    if(!page)
     {
-        if(buf.first <= address && (buf.first + buf.second.get().size()) > address)
-        {
-            auto wordBoundsAddress = (address / sizeof(Word)) * sizeof(Word);
-            return reinterpret_cast<const Word*>(buf.second.get().data() + wordBoundsAddress - buf.first);
-        }
+        page = std::make_unique<Word[]>(WORDS_PER_PAGE);
+        std::fill_n(page.get(), WORDS_PER_PAGE, UNALLOCATED_MEMORY_VALUE);
+        PROFILE_COUNTER(vc4c::profiler::COUNTER_EMULATOR, "memory pages allocated", 1);
     }
-    logging::logLazy(logging::Level::WARNING, [&]() {
-        for(const auto& buffer : buffers)
-            logging::warn() << "Buffer: [" << toAddressString(buffer.first) << ", "
-                            << toAddressString(buffer.first + buffer.second.get().size()) << ")" << logging::endl;
-    });
-    throw CompilationError(CompilationStep::GENERAL, "Address is not part of any buffer", toAddressString(address));
+    return std::make_pair(reinterpret_cast<uint8_t*>(page.get()) + pageOffset,
+        std::min(MEMORY_PAGE_SIZE - pageOffset, numBytes - offset));
+}
+
+tools::Word* Memory::getWordAddress(MemoryAddress address)
+{
+    auto wordBoundsAddress = static_cast<MemoryAddress>((address / sizeof(Word)) * sizeof(Word));
+    return reinterpret_cast<Word*>(getRegion(address, 1).toHostMemory(wordBoundsAddress).first);
+}
+
+const tools::Word* Memory::getWordAddress(MemoryAddress address) const
+{
+    auto wordBoundsAddress = static_cast<MemoryAddress>((address / sizeof(Word)) * sizeof(Word));
+    return reinterpret_cast<const Word*>(getRegion(address, 1).toHostMemory(wordBoundsAddress).first);
 }
 
 tools::Word Memory::readWord(MemoryAddress address) const
@@ -260,6 +378,36 @@ tools::Word Memory::readWord(MemoryAddress address) const
     return *getWordAddress(address);
 }
 
+void Memory::readBytes(MemoryAddress address, uint8_t* output, std::size_t numBytes) const
+{
+    const auto& region = getRegion(address, numBytes);
+    while(numBytes > 0)
+    {
+        // owned memory is only contiguous within a single page
+        auto hostMemory = region.toHostMemory(address);
+        auto chunkSize = std::min(numBytes, hostMemory.second);
+        std::memcpy(output, hostMemory.first, chunkSize);
+        output += chunkSize;
+        address += static_cast<MemoryAddress>(chunkSize);
+        numBytes -= chunkSize;
+    }
+}
+
+void Memory::writeBytes(MemoryAddress address, const uint8_t* input, std::size_t numBytes)
+{
+    auto& region = getRegion(address, numBytes);
+    while(numBytes > 0)
+    {
+        // owned memory is only contiguous within a single page
+        auto hostMemory = region.toHostMemory(address);
+        auto chunkSize = std::min(numBytes, hostMemory.second);
+        std::memcpy(hostMemory.first, input, chunkSize);
+        input += chunkSize;
+        address += static_cast<MemoryAddress>(chunkSize);
+        numBytes -= chunkSize;
+    }
+}
+
 MemoryAddress Memory::incrementAddress(MemoryAddress address, DataType typeSize) const
 {
     return address + typeSize.getInMemoryWidth();
@@ -267,47 +415,25 @@ MemoryAddress Memory::incrementAddress(MemoryAddress address, DataType typeSize)
 
 MemoryAddress Memory::getMaximumAddress() const
 {
-    if(auto direct = VariantNamespace::get_if<DirectBuffer>(&data))
-        return static_cast<MemoryAddress>(direct->size() * sizeof(Word));
-    return VariantNamespace::get<MappedBuffers>(data).rbegin()->first +
-        static_cast<Word>(VariantNamespace::get<MappedBuffers>(data).rbegin()->second.get().size());
+    if(regions.empty())
+        return 0;
+    return static_cast<MemoryAddress>(regions.rbegin()->first + regions.rbegin()->second.numBytes);
+}
+
+bool Memory::isAddressMapped(MemoryAddress address) const
+{
+    return findRegion(address) != nullptr;
 }
 
 void Memory::assertAddressInMemory(MemoryAddress address, std::size_t numBytes) const
 {
-    if(auto direct = VariantNamespace::get_if<DirectBuffer>(&data))
-    {
-        if((address + numBytes) > (direct->size() * sizeof(Word)))
-        {
-            logging::warn() << "Buffer: [" << toAddressString(0) << ", "
-                            << toAddressString(direct->size() * sizeof(Word)) << ")" << logging::endl;
-            throw CompilationError(CompilationStep::GENERAL,
-                "Memory address is out of bounds, consider using larger buffer",
-                "(" + toAddressString(address) + ", " + std::to_string(numBytes) + ")");
-        }
-        return;
-    }
-    auto& buffers = VariantNamespace::get<MappedBuffers>(data);
-    for(auto& buffer : buffers)
-    {
-        if(buffer.first <= address && (buffer.first + buffer.second.get().size()) >= (address + numBytes))
-            // the address fits into this buffer
-            return;
-    }
-    logging::logLazy(logging::Level::WARNING, [&]() {
-        for(const auto& buffer : buffers)
-            logging::warn() << "Buffer: [" << toAddressString(buffer.first) << ", "
-                            << toAddressString(buffer.first + buffer.second.get().size()) << ")" << logging::endl;
-    });
-    throw CompilationError(CompilationStep::GENERAL, "Address is not part of any buffer",
-        "(" + toAddressString(address) + ", " + std::to_string(numBytes) + ")");
+    // throws if the range is not completely inside a single region
+    static_cast<void>(getRegion(address, numBytes));
 }
 
 void Memory::setUniforms(const std::vector<Word>& uniforms, MemoryAddress address)
 {
-    std::size_t offset = address / sizeof(Word);
-    std::copy_n(uniforms.begin(), uniforms.size(),
-        VariantNamespace::get<DirectBuffer>(data).begin() + static_cast<std::vector<Word>::difference_type>(offset));
+    writeBytes(address, reinterpret_cast<const uint8_t*>(uniforms.data()), uniforms.size() * sizeof(Word));
 }
 
 bool Mutex::isLocked() const
@@ -392,23 +518,47 @@ void Registers::writeRegister(Register reg, const SIMDVector& val, std::bitset<1
     else if(reg.num == REG_VPM_IO.num)
         qpu.vpm.writeValue(val);
     else if(reg == REG_VPM_IN_SETUP)
+    {
         qpu.vpm.setReadSetup(val);
+        qpu.clock.traceEvent(qpu.ID, qpu.pc, TraceEvent::VPM_READ_QUEUE, qpu.vpm.getReadQueueSize());
+    }
     else if(reg == REG_VPM_OUT_SETUP)
         qpu.vpm.setWriteSetup(val);
     else if(reg == REG_VPM_DMA_LOAD_ADDR)
+    {
+        qpu.clock.traceEvent(qpu.ID, qpu.pc, TraceEvent::VPM_DMA_READ, val[0].unsignedInt());
         qpu.vpm.setDMAReadAddress(val);
+    }
     else if(reg == REG_VPM_DMA_STORE_ADDR)
+    {
+        qpu.clock.traceEvent(qpu.ID, qpu.pc, TraceEvent::VPM_DMA_WRITE, val[0].unsignedInt());
         qpu.vpm.setDMAWriteAddress(val);
+    }
     else if(reg.num == REG_MUTEX.num)
+    {
+        qpu.clock.traceEvent(qpu.ID, qpu.pc, TraceEvent::MUTEX_RELEASE);
         qpu.mutex.unlock(qpu.ID);
+    }
     else if(reg.num == REG_SFU_RECIP.num)
+    {
+        qpu.clock.traceEvent(qpu.ID, qpu.pc, TraceEvent::SFU_START);
         qpu.sfu.startRecip(val, qpu.lastR4Value);
+    }
     else if(reg.num == REG_SFU_RECIP_SQRT.num)
+    {
+        qpu.clock.traceEvent(qpu.ID, qpu.pc, TraceEvent::SFU_START);
         qpu.sfu.startRecipSqrt(val, qpu.lastR4Value);
+    }
     else if(reg.num == REG_SFU_EXP2.num)
+    {
+        qpu.clock.traceEvent(qpu.ID, qpu.pc, TraceEvent::SFU_START);
         qpu.sfu.startExp2(val, qpu.lastR4Value);
+    }
     else if(reg.num == REG_SFU_LOG2.num)
+    {
+        qpu.clock.traceEvent(qpu.ID, qpu.pc, TraceEvent::SFU_START);
         qpu.sfu.startLog2(val, qpu.lastR4Value);
+    }
     else if(reg.num == REG_TMU0_COORD_S_U_X.num)
         qpu.tmus.setTMURegisterS(0, val);
     else if(reg.num == REG_TMU0_COORD_T_V_Y.num)
@@ -464,7 +614,10 @@ std::pair<SIMDVector, bool> Registers::readRegister(Register reg, bool anyElemen
         {
             auto res = qpu.uniforms.readUniform();
             if(!res.second)
+            {
+                qpu.clock.traceEvent(qpu.ID, qpu.pc, TraceEvent::STALL_UNIFORM);
                 return std::make_pair(SIMDVector{}, false);
+            }
             it = setReadCache(REG_UNIFORM, res.first);
         }
         return std::make_pair(it->second, true);
@@ -507,22 +660,43 @@ std::pair<SIMDVector, bool> Registers::readRegister(Register reg, bool anyElemen
     {
         auto it = readCache.find(REG_VPM_IO);
         if(it == readCache.end())
+        {
             it = setReadCache(REG_VPM_IO, qpu.vpm.readValue());
+            qpu.clock.traceEvent(qpu.ID, qpu.pc, TraceEvent::VPM_READ_QUEUE, qpu.vpm.getReadQueueSize());
+        }
         return std::make_pair(it->second, true);
     }
     case REG_VPM_DMA_LOAD_WAIT.num:
         if(reg == REG_VPM_DMA_LOAD_WAIT)
-            return std::make_pair(SIMDVector{}, qpu.vpm.waitDMARead());
+        {
+            if(qpu.vpm.waitDMARead())
+                return std::make_pair(SIMDVector{}, true);
+            qpu.clock.traceEvent(qpu.ID, qpu.pc, TraceEvent::STALL_VPM_DMA_READ);
+            return std::make_pair(SIMDVector{}, false);
+        }
         if(reg == REG_VPM_DMA_STORE_WAIT)
-            return std::make_pair(SIMDVector{}, qpu.vpm.waitDMAWrite());
+        {
+            if(qpu.vpm.waitDMAWrite())
+                return std::make_pair(SIMDVector{}, true);
+            qpu.clock.traceEvent(qpu.ID, qpu.pc, TraceEvent::STALL_VPM_DMA_WRITE);
+            return std::make_pair(SIMDVector{}, false);
+        }
         // should never happen
         break;
     case REG_MUTEX.num:
     {
         auto it = readCache.find(REG_MUTEX);
         if(it == readCache.end())
-            it = setReadCache(
-                REG_MUTEX, qpu.mutex.lock(qpu.ID) ? SIMDVector(Literal(true)) : SIMDVector(Literal(false)));
+        {
+            bool isLocked = qpu.mutex.lock(qpu.ID);
+            qpu.clock.traceEvent(qpu.ID, qpu.pc, isLocked ? TraceEvent::MUTEX_ACQUIRE : TraceEvent::STALL_MUTEX);
+            if(!isLocked)
+            {
+                std::lock_guard<std::mutex> instrumentationGuard(instrumentationLock);
+                ++qpu.instrumentation.at(qpu.pc).numMutexStalls;
+            }
+            it = setReadCache(REG_MUTEX, SIMDVector(Literal(isLocked)));
+        }
         return std::make_pair(it->second, it->second[0].isTrue());
     }
     }
@@ -569,6 +743,16 @@ SIMDVector Registers::readStorageRegister(Register reg, bool anyElementUsed)
     return vec.first;
 }
 
+const SIMDVector* Registers::getDefinedStorageRegister(Register reg) const
+{
+    const auto& vec = storageRegisters.at(toIndex(reg));
+    if(vec.first.isUndefined())
+        return nullptr;
+    if(reg.isGeneralPurpose() && qpu.getCurrentCycle() - 1 <= vec.second)
+        return nullptr;
+    return &vec.first;
+}
+
 static SIMDVector toStorageValue(
     const SIMDVector& oldVal, const SIMDVector& newVal, std::bitset<16> elementMask, BitMask bitMask)
 {
@@ -691,6 +875,214 @@ void UniformFifo::triggerFifoFill()
     }
 }
 
+std::vector<std::future<tools::Word>> UniformFifo::takeUniforms(unsigned numUniforms)
+{
+    if(lastAddressSetCycle != 0 && lastAddressSetCycle + 2 > qpu.getCurrentCycle())
+        // see Broadcom specification, page 22
+        throw CompilationError(CompilationStep::GENERAL, "Reading UNIFORM within 2 cycles of last UNIFORM reset!");
+
+    std::vector<std::future<Word>> uniforms;
+    uniforms.reserve(numUniforms);
+    for(unsigned i = 0; i < numUniforms; ++i)
+    {
+        triggerFifoFill();
+        uniforms.emplace_back(std::move(fifo.front()));
+        fifo.pop_front();
+    }
+    triggerFifoFill();
+    PROFILE_COUNTER(vc4c::profiler::COUNTER_EMULATOR, "UNIFORM read by TMU", numUniforms);
+    return uniforms;
+}
+
+TextureSetup::TextureSetup(Word config0, Word config1) :
+    baseAddress(config0 & 0xFFFFF000), type(static_cast<Type>(((config0 >> 4) & 0xF) | ((config1 >> 31) << 4))),
+    width((config1 >> 8) & 0x7FF), height((config1 >> 20) & 0x7FF), flipY((config0 >> 8) & 0x1),
+    linearFilter(((config1 >> 7) & 0x1) == 0), wrapS(static_cast<WrapMode>(config1 & 0x3)),
+    wrapT(static_cast<WrapMode>((config1 >> 2) & 0x3))
+{
+    // a value of zero represents the maximum size of 2048
+    width = width == 0 ? 2048 : width;
+    height = height == 0 ? 2048 : height;
+    if((config0 >> 9) & 0x1)
+        throw CompilationError(CompilationStep::GENERAL, "Cube map textures are not supported");
+    // check the texture type is supported
+    static_cast<void>(getBytesPerTexel());
+}
+
+uint32_t TextureSetup::getBytesPerTexel() const
+{
+    switch(type)
+    {
+    case RGBA8888:
+    case RGBX8888:
+    case RGBA32R:
+        return 4;
+    case RGBA4444:
+    case RGBA5551:
+    case RGB565:
+    case LUMALPHA:
+        return 2;
+    case LUMINANCE:
+    case ALPHA:
+        return 1;
+    }
+    throw CompilationError(
+        CompilationStep::GENERAL, "Unsupported texture type", std::to_string(static_cast<unsigned>(type)));
+}
+
+MemoryAddress TextureSetup::getTexelAddress(uint32_t x, uint32_t y) const
+{
+    auto bytesPerTexel = getBytesPerTexel();
+    if(type == RGBA32R)
+        return baseAddress + (y * width + x) * bytesPerTexel;
+
+    // the textures consist of 64 byte micro-tiles with the texels stored in raster order
+    uint32_t microTileWidth = bytesPerTexel == 4 ? 4 : 8;
+    uint32_t microTileHeight = bytesPerTexel == 1 ? 8 : 4;
+    uint32_t microTileX = x / microTileWidth;
+    uint32_t microTileY = y / microTileHeight;
+    uint32_t offsetInMicroTile = ((y % microTileHeight) * microTileWidth + (x % microTileWidth)) * bytesPerTexel;
+
+    if(width <= 4 * microTileWidth || height <= 4 * microTileHeight)
+    {
+        // LT-format, the micro-tiles are stored in raster order
+        uint32_t microTilesPerRow = (width + microTileWidth - 1) / microTileWidth;
+        return baseAddress + (microTileY * microTilesPerRow + microTileX) * 64 + offsetInMicroTile;
+    }
+
+    // T-format, 4KB tiles of 2x2 1KB sub-tiles of 4x4 micro-tiles. The tiles are stored in raster order for even rows
+    // and in reverse order for odd rows, the order of the sub-tiles within a tile also depends on the row.
+    uint32_t tilesPerRow = (width + 8 * microTileWidth - 1) / (8 * microTileWidth);
+    uint32_t tileX = microTileX / 8;
+    uint32_t tileY = microTileY / 8;
+    bool isOddRow = (tileY & 1) != 0;
+    if(isOddRow)
+        tileX = tilesPerRow - tileX - 1;
+    static const std::array<uint32_t, 4> evenSubTileMap{0, 3, 1, 2};
+    static const std::array<uint32_t, 4> oddSubTileMap{2, 1, 3, 0};
+    uint32_t subTileIndex = ((microTileY >> 2) & 1) * 2 + ((microTileX >> 2) & 1);
+    uint32_t subTileOffset = 1024 * (isOddRow ? oddSubTileMap : evenSubTileMap)[subTileIndex];
+    uint32_t microTileOffset = 64 * ((microTileY & 3) * 4 + (microTileX & 3));
+    return baseAddress + (tileY * tilesPerRow + tileX) * 4096 + subTileOffset + microTileOffset + offsetInMicroTile;
+}
+
+// replicates the upper bits to expand a value with the given bit width to 8 bits
+static tools::Word expandTo8Bit(tools::Word val, uint32_t numBits)
+{
+    return (val << (8 - numBits)) | (val >> (2 * numBits - 8));
+}
+
+static tools::Word toColor(tools::Word red, tools::Word green, tools::Word blue, tools::Word alpha)
+{
+    return (alpha << 24) | (blue << 16) | (green << 8) | red;
+}
+
+tools::Word TextureSetup::toRGBA8888(tools::Word texel) const
+{
+    switch(type)
+    {
+    case RGBA8888:
+    case RGBA32R:
+        return texel;
+    case RGBX8888:
+        return texel | 0xFF000000;
+    case RGBA4444:
+        return toColor(((texel >> 12) & 0xF) * 17, ((texel >> 8) & 0xF) * 17, ((texel >> 4) & 0xF) * 17,
+            (texel & 0xF) * 17);
+    case RGBA5551:
+        return toColor(expandTo8Bit((texel >> 11) & 0x1F, 5), expandTo8Bit((texel >> 6) & 0x1F, 5),
+            expandTo8Bit((texel >> 1) & 0x1F, 5), (texel & 0x1) * 0xFF);
+    case RGB565:
+        return toColor(expandTo8Bit((texel >> 11) & 0x1F, 5), expandTo8Bit((texel >> 5) & 0x3F, 6),
+            expandTo8Bit(texel & 0x1F, 5), 0xFF);
+    case LUMINANCE:
+        return toColor(texel & 0xFF, texel & 0xFF, texel & 0xFF, 0xFF);
+    case ALPHA:
+        return toColor(0, 0, 0, texel & 0xFF);
+    case LUMALPHA:
+        return toColor(texel & 0xFF, texel & 0xFF, texel & 0xFF, (texel >> 8) & 0xFF);
+    }
+    throw CompilationError(
+        CompilationStep::GENERAL, "Unsupported texture type", std::to_string(static_cast<unsigned>(type)));
+}
+
+// Returns the wrapped texel coordinate or a negative value for the border color
+static int32_t wrapTexelCoordinate(int32_t coord, uint32_t size, TextureSetup::WrapMode mode)
+{
+    auto signedSize = static_cast<int32_t>(size);
+    switch(mode)
+    {
+    case TextureSetup::REPEAT:
+        return ((coord % signedSize) + signedSize) % signedSize;
+    case TextureSetup::CLAMP:
+        return std::min(std::max(coord, 0), signedSize - 1);
+    case TextureSetup::MIRROR:
+    {
+        auto mirrored = ((coord % (2 * signedSize)) + 2 * signedSize) % (2 * signedSize);
+        return mirrored < signedSize ? mirrored : (2 * signedSize - 1 - mirrored);
+    }
+    case TextureSetup::BORDER:
+        return coord < 0 || coord >= signedSize ? -1 : coord;
+    }
+    throw CompilationError(
+        CompilationStep::GENERAL, "Invalid texture wrap mode", std::to_string(static_cast<unsigned>(mode)));
+}
+
+static tools::Word readTexel(const TextureSetup& setup, int32_t x, int32_t y, tools::Word borderColor,
+    const std::function<tools::Word(MemoryAddress)>& readWord)
+{
+    x = wrapTexelCoordinate(x, setup.width, setup.wrapS);
+    y = wrapTexelCoordinate(y, setup.height, setup.wrapT);
+    if(x < 0 || y < 0)
+        return borderColor;
+    if(setup.flipY)
+        y = static_cast<int32_t>(setup.height) - 1 - y;
+    auto address = setup.getTexelAddress(static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+    auto word = readWord(address & ~MemoryAddress{3}) >> ((address & 3) * 8);
+    auto numBits = setup.getBytesPerTexel() * 8;
+    return setup.toRGBA8888(numBits == 32 ? word : (word & ((1u << numBits) - 1u)));
+}
+
+// converts the normalized coordinate to the texel coordinate, limited to not overflow for huge or invalid coordinates
+static float toTexelCoordinate(float coord, uint32_t size)
+{
+    if(!std::isfinite(coord))
+        return 0.0f;
+    return std::min(std::max(coord, -1024.0f), 1024.0f) * static_cast<float>(size);
+}
+
+tools::Word tools::sampleTexture(const TextureSetup& setup, float s, float t, tools::Word borderColor,
+    const std::function<tools::Word(MemoryAddress)>& readWord)
+{
+    auto u = toTexelCoordinate(s, setup.width);
+    auto v = toTexelCoordinate(t, setup.height);
+    if(!setup.linearFilter)
+        return readTexel(setup, static_cast<int32_t>(std::floor(u)), static_cast<int32_t>(std::floor(v)),
+            borderColor, readWord);
+
+    // bi-linear interpolation of the 2x2 texels around the coordinate
+    u -= 0.5f;
+    v -= 0.5f;
+    auto x = static_cast<int32_t>(std::floor(u));
+    auto y = static_cast<int32_t>(std::floor(v));
+    auto fractionX = u - std::floor(u);
+    auto fractionY = v - std::floor(v);
+    std::array<Word, 4> texels{readTexel(setup, x, y, borderColor, readWord),
+        readTexel(setup, x + 1, y, borderColor, readWord), readTexel(setup, x, y + 1, borderColor, readWord),
+        readTexel(setup, x + 1, y + 1, borderColor, readWord)};
+    std::array<float, 4> weights{(1.0f - fractionX) * (1.0f - fractionY), fractionX * (1.0f - fractionY),
+        (1.0f - fractionX) * fractionY, fractionX * fractionY};
+    Word result = 0;
+    for(uint32_t channel = 0; channel < 4; ++channel)
+    {
+        float sum = 0.0f;
+        for(std::size_t i = 0; i < texels.size(); ++i)
+            sum += weights[i] * static_cast<float>((texels[i] >> (channel * 8)) & 0xFF);
+        result |= std::min(static_cast<Word>(std::lround(sum)), Word{0xFF}) << (channel * 8);
+    }
+    return result;
+}
+
 void TMUs::setTMUNoSwap(const SIMDVector& swapVal)
 {
     // XXX or per-element?
@@ -707,25 +1099,44 @@ void TMUs::setTMURegisterS(uint8_t tmu, const SIMDVector& val)
 
     if(requestQueue.size() >= 8)
         throw CompilationError(CompilationStep::GENERAL, "TMU request queue is full!");
-    requestQueue.emplace(readMemoryAddress(tmu, val));
+    if(textureCoordinates[tmu])
+    {
+        // any other coordinate written before the s-coordinate makes this a texture lookup
+        requestQueue.emplace(
+            readTexture(tmu, val, *textureCoordinates[tmu], borderColors[tmu] ? *borderColors[tmu] : SIMDVector{}));
+        textureCoordinates[tmu] = {};
+        borderColors[tmu] = {};
+    }
+    else
+        requestQueue.emplace(readMemoryAddress(tmu, val));
+    clock.traceEvent(qpu.ID, qpu.pc, tmu == 1 ? TraceEvent::TMU1_QUEUE : TraceEvent::TMU0_QUEUE,
+        static_cast<uint32_t>(requestQueue.size()));
 }
 
 void TMUs::setTMURegisterT(uint8_t tmu, const SIMDVector& val)
 {
     checkTMUWriteCycle();
-    throw CompilationError(CompilationStep::GENERAL, "Image reads via TMU are currently not supported!");
+    textureCoordinates[toRealTMU(tmu)] = val;
 }
 
 void TMUs::setTMURegisterR(uint8_t tmu, const SIMDVector& val)
 {
     checkTMUWriteCycle();
-    throw CompilationError(CompilationStep::GENERAL, "Image reads via TMU are currently not supported!");
+    tmu = toRealTMU(tmu);
+    // for 2D textures, the r-parameter is only used as border color
+    borderColors[tmu] = val;
+    if(!textureCoordinates[tmu])
+        // coordinates not written default to zero
+        textureCoordinates[tmu] = SIMDVector(Literal(0.0f));
 }
 
 void TMUs::setTMURegisterB(uint8_t tmu, const SIMDVector& val)
 {
     checkTMUWriteCycle();
-    throw CompilationError(CompilationStep::GENERAL, "Image reads via TMU are currently not supported!");
+    tmu = toRealTMU(tmu);
+    // the LOD bias is ignored, since only textures with a single mipmap level are supported
+    if(!textureCoordinates[tmu])
+        textureCoordinates[tmu] = SIMDVector(Literal(0.0f));
 }
 
 bool TMUs::triggerTMURead(uint8_t tmu, SIMDVector& r4Register)
@@ -743,6 +1154,7 @@ bool TMUs::triggerTMURead(uint8_t tmu, SIMDVector& r4Register)
         // still loading
         // a single emulation cycle is 4 HW clock cycles, due to 4-way serial SIMD
         PROFILE_COUNTER(vc4c::profiler::COUNTER_EMULATOR, "TMU stall cycles", 4);
+        clock.traceEvent(qpu.ID, qpu.pc, TraceEvent::STALL_TMU);
         return false;
     }
 
@@ -752,6 +1164,8 @@ bool TMUs::triggerTMURead(uint8_t tmu, SIMDVector& r4Register)
         PROFILE_COUNTER_SCOPE(vc4c::profiler::COUNTER_EMULATOR, "TMU1 read trigger", 1);
 
     requestQueue.pop();
+    clock.traceEvent(qpu.ID, qpu.pc, tmu == 1 ? TraceEvent::TMU1_QUEUE : TraceEvent::TMU0_QUEUE,
+        static_cast<uint32_t>(requestQueue.size()));
     CPPLOG_LAZY(
         logging::Level::DEBUG, log << "Reading from TMU into r4: " << val.first.to_string(true) << logging::endl);
     r4Register = val.first;
@@ -787,7 +1201,7 @@ std::future<SIMDVector> TMUs::readMemoryAddress(uint8_t tmu, const SIMDVector& a
     }
     clock.schedule("TMU read",
         [handle{std::move(handle)}, address, results{std::move(wordResults)}, pending{std::move(pendingLoads)}](
-            uint32_t currentCycle) mutable -> bool {
+            uint64_t currentCycle) mutable -> bool {
             // wait until all elements are loaded from cache/memory
             for(auto it = pending.begin(); it != pending.end();)
             {
@@ -817,6 +1231,73 @@ std::future<SIMDVector> TMUs::readMemoryAddress(uint8_t tmu, const SIMDVector& a
     return future;
 }
 
+std::future<SIMDVector> TMUs::readTexture(
+    uint8_t tmu, const SIMDVector& sCoords, const SIMDVector& tCoords, const SIMDVector& borderColor)
+{
+    AsynchronousHandle<SIMDVector> handle{};
+    auto future = handle.get_future();
+    // the TMU reads the texture config parameters 0 and 1 from the UNIFORMs of the QPU triggering the lookup
+    auto setupWords = qpu.uniforms.takeUniforms(2);
+    clock.schedule("TMU texture read",
+        [this, tmu, handle{std::move(handle)}, setupWords{std::move(setupWords)}, sCoords, tCoords, borderColor,
+            setup = std::unique_ptr<TextureSetup>{}, texelWords = std::map<MemoryAddress, std::future<Word>>{},
+            pending = std::vector<AsynchronousExecution>{}](uint64_t currentCycle) mutable -> bool {
+            if(!setup)
+            {
+                if(std::any_of(setupWords.begin(), setupWords.end(), [](const std::future<Word>& word) -> bool {
+                       return word.wait_for(std::chrono::seconds{0}) != std::future_status::ready;
+                   }))
+                    return false;
+                auto config0 = setupWords[0].get();
+                setup = std::make_unique<TextureSetup>(config0, setupWords[1].get());
+                // start loading all memory words containing the texels required for the lookups
+                auto startLoad = [&](MemoryAddress address) -> Word {
+                    if(texelWords.find(address) == texelWords.end())
+                    {
+                        AsynchronousHandle<Word> wordHandle{};
+                        texelWords.emplace(address, wordHandle.get_future());
+                        pending.emplace_back(slice.startTMURead(tmu, std::move(wordHandle), address));
+                    }
+                    return 0;
+                };
+                for(uint8_t i = 0; i < NATIVE_VECTOR_SIZE; ++i)
+                    static_cast<void>(sampleTexture(
+                        *setup, sCoords[i].real(), tCoords[i].real(), borderColor[i].unsignedInt(), startLoad));
+            }
+
+            // wait until all texels are loaded from cache/memory
+            for(auto it = pending.begin(); it != pending.end();)
+            {
+                if((*it)(currentCycle))
+                    it = pending.erase(it);
+                else
+                    ++it;
+            }
+            if(!pending.empty())
+                return false;
+            if(std::any_of(texelWords.begin(), texelWords.end(), [](const auto& word) -> bool {
+                   return word.second.wait_for(std::chrono::seconds{0}) != std::future_status::ready;
+               }))
+                return false;
+
+            std::map<MemoryAddress, Word> loadedWords;
+            for(auto& word : texelWords)
+                loadedWords.emplace(word.first, word.second.get());
+            auto readLoadedWord = [&](MemoryAddress address) -> Word { return loadedWords.at(address); };
+            SIMDVector res;
+            for(uint8_t i = 0; i < NATIVE_VECTOR_SIZE; ++i)
+                res[i] = Literal(sampleTexture(
+                    *setup, sCoords[i].real(), tCoords[i].real(), borderColor[i].unsignedInt(), readLoadedWord));
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Reading via TMU from texture at " << toAddressString(setup->baseAddress) << " with coordinates "
+                    << sCoords.to_string(true) << " and " << tCoords.to_string(true) << ": " << res.to_string(true)
+                    << logging::endl);
+            handle.set_value(res);
+            return true;
+        });
+    return future;
+}
+
 uint8_t TMUs::toRealTMU(uint8_t tmu) const
 {
     bool upperHalf = (qpu.ID % 4) >= 2;
@@ -858,7 +1339,7 @@ void SFU::startLog2(const SIMDVector& val, SIMDVector& r4Register)
 void SFU::startOperation(SIMDVector&& result, SIMDVector& r4Register)
 {
     clock.schedule("SFU calculation",
-        [remainingCycles{2}, &r4Register, output{std::move(result)}](uint32_t currentCycle) mutable -> bool {
+        [remainingCycles{2}, &r4Register, output{std::move(result)}](uint64_t currentCycle) mutable -> bool {
             if(remainingCycles > 0)
             {
                 --remainingCycles;
@@ -968,6 +1449,8 @@ SIMDVector VPM::readValue()
         static_cast<uint8_t>(setup.genericSetup.getAddress() + setup.genericSetup.getStride()));
     setup.genericSetup.setNumber(static_cast<uint8_t>((16 + setup.genericSetup.getNumber() - 1) % 16));
     vpmReadSetup = setup.value;
+    if(numQueuedReads > 0)
+        --numQueuedReads;
 
     logging::logLazy(logging::Level::DEBUG, [&]() {
         logging::debug() << "Read value from VPM: " << result.to_string(true) << logging::endl;
@@ -1064,9 +1547,13 @@ void VPM::setReadSetup(const SIMDVector& val)
     if(setup.isDMASetup())
         dmaReadSetup = setup.value;
     else if(setup.isGenericSetup())
+    {
         // TODO warn/error if there is still VPM read pending from previous setup. TODO or create VPM read queue like
         // for TMU?
         vpmReadSetup = setup.value;
+        auto numVectors = setup.genericSetup.getNumber();
+        numQueuedReads = static_cast<uint8_t>(numVectors == 0 ? 16 : numVectors);
+    }
     else if(setup.isStrideSetup())
         readStrideSetup = setup.value;
     else
@@ -1120,8 +1607,7 @@ void VPM::setDMAWriteAddress(const SIMDVector& val)
     {
         for(uint32_t i = 0; i < sizes.first; ++i)
         {
-            memory.assertAddressInMemory(address, typeSize * sizes.second);
-            memcpy(reinterpret_cast<uint8_t*>(memory.getWordAddress(address)) + address % sizeof(Word),
+            memory.writeBytes(address,
                 reinterpret_cast<uint8_t*>(&cache.at(vpmBaseAddress.first).at(vpmBaseAddress.second)) + byteOffset,
                 typeSize * sizes.second);
             logging::debug() << "\tVPM row: " << toDataString(cache.at(vpmBaseAddress.first)) << logging::endl;
@@ -1137,7 +1623,7 @@ void VPM::setDMAWriteAddress(const SIMDVector& val)
             memory.assertAddressInMemory(address, typeSize * sizes.first);
             for(uint32_t k = 0; k < sizes.first; ++k)
             {
-                memcpy(reinterpret_cast<uint8_t*>(memory.getWordAddress(address)) + address % sizeof(Word),
+                memory.writeBytes(address,
                     reinterpret_cast<uint8_t*>(&cache.at(vpmBaseAddress.first + k).at(vpmBaseAddress.second + i)) +
                         byteOffset,
                     typeSize);
@@ -1209,11 +1695,12 @@ void VPM::setDMAReadAddress(const SIMDVector& val)
             memory.assertAddressInMemory(address, typeSize * sizes.first);
             for(uint32_t k = 0; k < sizes.first; ++k)
             {
-                memcpy(reinterpret_cast<uint8_t*>(&cache.at(vpmBaseAddress.first + k).at(vpmBaseAddress.second + i)) +
+                memory.readBytes(address + k * typeSize,
+                    reinterpret_cast<uint8_t*>(&cache.at(vpmBaseAddress.first + k).at(vpmBaseAddress.second + i)) +
                         byteOffset,
-                    reinterpret_cast<uint8_t*>(memory.getWordAddress(address)) + address % sizeof(Word), typeSize);
-                address += typeSize;
+                    typeSize);
             }
+            // read pitch is start-to-start for vertical mode too
             address += pitch;
         }
 
@@ -1226,9 +1713,8 @@ void VPM::setDMAReadAddress(const SIMDVector& val)
     {
         for(uint32_t i = 0; i < sizes.first; ++i)
         {
-            memory.assertAddressInMemory(address, typeSize * sizes.second);
-            memcpy(reinterpret_cast<uint8_t*>(&cache.at(vpmBaseAddress.first).at(vpmBaseAddress.second)) + byteOffset,
-                reinterpret_cast<uint8_t*>(memory.getWordAddress(address)) + address % sizeof(Word),
+            memory.readBytes(address,
+                reinterpret_cast<uint8_t*>(&cache.at(vpmBaseAddress.first).at(vpmBaseAddress.second)) + byteOffset,
                 typeSize * sizes.second);
             logging::debug() << "\tVPM row: " << toDataString(cache.at(vpmBaseAddress.first)) << logging::endl;
             vpmBaseAddress.first += static_cast<uint32_t>((vpitch * typeSize) / sizeof(Word));
@@ -1245,11 +1731,11 @@ void VPM::setDMAReadAddress(const SIMDVector& val)
 bool VPM::waitDMAWrite() const
 {
     // XXX how many cycles?
-    auto numCyclesLeft = static_cast<int>(lastDMAWriteTrigger) + 12 - static_cast<int>(clock.currentCycle);
+    auto numCyclesLeft = static_cast<int64_t>(lastDMAWriteTrigger + 12) - static_cast<int64_t>(clock.currentCycle);
     PROFILE_COUNTER(vc4c::profiler::COUNTER_EMULATOR, "wait DMA write", numCyclesLeft > 0);
     if(numCyclesLeft > 0)
         // TODO remove this dummy asynchronous execution once we move DMA access to the new schema
-        clock.schedule("DMA write wait", [remainingCycles{numCyclesLeft}](uint32_t currentClock) mutable -> bool {
+        clock.schedule("DMA write wait", [remainingCycles{numCyclesLeft}](uint64_t currentClock) mutable -> bool {
             if(remainingCycles > 0)
             {
                 --remainingCycles;
@@ -1263,12 +1749,12 @@ bool VPM::waitDMAWrite() const
 bool VPM::waitDMARead() const
 {
     // XXX how many cycles?
-    auto numCyclesLeft = static_cast<int>(lastDMAReadTrigger) + 12 - static_cast<int>(clock.currentCycle);
+    auto numCyclesLeft = static_cast<int64_t>(lastDMAReadTrigger + 12) - static_cast<int64_t>(clock.currentCycle);
     PROFILE_COUNTER(vc4c::profiler::COUNTER_EMULATOR, "wait DMA read", numCyclesLeft > 0);
     if(numCyclesLeft > 0)
         // TODO remove this dummy asynchronous execution once we move DMA access to the new schema
         clock.schedule("DMA read wait",
-            [remainingCycles{lastDMAReadTrigger + 12 - clock.currentCycle}](uint32_t currentClock) mutable -> bool {
+            [remainingCycles{lastDMAReadTrigger + 12 - clock.currentCycle}](uint64_t currentClock) mutable -> bool {
                 if(remainingCycles > 0)
                 {
                     --remainingCycles;
@@ -1449,7 +1935,7 @@ AsynchronousExecution L2Cache::startCacheLineRead(
         // cache and L2 cache into the L1 caches to be identical
         clock.schedule("Memory read",
             [remainingCycles{8}, &cacheLine, data{std::move(tmpData)}, setIndex{cacheEntry.second}](
-                uint32_t currentCycle) mutable -> bool {
+                uint64_t currentCycle) mutable -> bool {
                 if(remainingCycles > 0)
                 {
                     --remainingCycles;
@@ -1469,7 +1955,7 @@ AsynchronousExecution L2Cache::startCacheLineRead(
     // XXX Since TMU and UNIFORM have similar cache access timings, we for now assume the load speed memory into L2
     // cache and L2 cache into the L1 caches to be identical
     return {
-        "L2 read", [remainingCycles{3}, &cacheLine, handle{std::move(handle)}](uint32_t currentCycle) mutable -> bool {
+        "L2 read", [remainingCycles{3}, &cacheLine, handle{std::move(handle)}](uint64_t currentCycle) mutable -> bool {
             if(cacheLine.isBeingFilled)
                 return false;
 
@@ -1524,7 +2010,7 @@ AsynchronousExecution L2Cache::startCacheLineRead(
         // cache and L2 cache into the L1 caches to be identical
         clock.schedule("Memory read",
             [remainingCycles{8}, &cacheLine, data{std::move(tmpData)}, setIndex{cacheEntry.second}](
-                uint32_t currentCycle) mutable -> bool {
+                uint64_t currentCycle) mutable -> bool {
                 if(remainingCycles > 0)
                 {
                     --remainingCycles;
@@ -1543,7 +2029,7 @@ AsynchronousExecution L2Cache::startCacheLineRead(
     // XXX Since TMU and UNIFORM have similar cache access timings, we for now assume the load speed memory into L2
     // cache and L2 cache into the L1 caches to be identical
     return {
-        "L2 read", [remainingCycles{3}, &cacheLine, handle{std::move(handle)}](uint32_t currentCycle) mutable -> bool {
+        "L2 read", [remainingCycles{3}, &cacheLine, handle{std::move(handle)}](uint64_t currentCycle) mutable -> bool {
             if(cacheLine.isBeingFilled)
                 return false;
 
@@ -1620,7 +2106,7 @@ AsynchronousExecution Slice::startUniformRead(AsynchronousHandle<Word>&& handle,
 
         clock.schedule("UNIFORM cache fill",
             [id{id}, &cacheLine, memoryRead{std::move(l2Read)}, loadedData{std::move(fut)}](
-                uint32_t currentCycle) mutable -> bool {
+                uint64_t currentCycle) mutable -> bool {
                 if(!memoryRead(currentCycle))
                     return false;
 
@@ -1637,7 +2123,7 @@ AsynchronousExecution Slice::startUniformRead(AsynchronousHandle<Word>&& handle,
     // XXX tests suggest the lookup times are similar than for TMU
     return {"UNIFORM cache read",
         [remainingCycles{9}, &cacheLine, this, address, handle{std::move(handle)}](
-            uint32_t currentCycle) mutable -> bool {
+            uint64_t currentCycle) mutable -> bool {
             if(cacheLine.isBeingFilled)
                 return false;
 
@@ -1672,7 +2158,7 @@ AsynchronousExecution Slice::startTMURead(uint8_t tmuIndex, AsynchronousHandle<W
             // TODO log for performance, since this is a very bad case!
             return {"TMU cache blocked",
                 [remainingCycles{1}, handle{std::move(handle)}, address, &cacheLine, this, tmuIndex](
-                    uint32_t currentCycle) mutable -> bool {
+                    uint64_t currentCycle) mutable -> bool {
                     if(cacheLine.isBeingFilled)
                         return false;
 
@@ -1704,7 +2190,7 @@ AsynchronousExecution Slice::startTMURead(uint8_t tmuIndex, AsynchronousHandle<W
 
         clock.schedule("TMU cache fill",
             [id{id}, &cacheLine, memoryRead{std::move(l2Read)}, loadedData{std::move(fut)}, tmuIndex](
-                uint32_t currentCycle) mutable -> bool {
+                uint64_t currentCycle) mutable -> bool {
                 if(!memoryRead(currentCycle))
                     return false;
 
@@ -1723,7 +2209,7 @@ AsynchronousExecution Slice::startTMURead(uint8_t tmuIndex, AsynchronousHandle<W
     // read from cache, takes 9 cycles
     return {"TMU cache read",
         [remainingCycles{9}, &cacheLine, this, address, handle{std::move(handle)}, result{0u}](
-            uint32_t currentCycle) mutable -> bool {
+            uint64_t currentCycle) mutable -> bool {
             if(cacheLine.isBeingFilled)
                 return false;
 
@@ -1777,7 +2263,7 @@ std::pair<qpu_asm::Instruction, bool> Slice::readInstruction(ProgramCounter pc)
 
         clock.schedule("Instruction cache fill",
             [id{id}, &cacheLine, memoryRead{std::move(l2Read)}, loadedData{std::move(fut)},
-                setIndex{cacheEntry.second}](uint32_t currentCycle) mutable -> bool {
+                setIndex{cacheEntry.second}](uint64_t currentCycle) mutable -> bool {
                 if(!memoryRead(currentCycle))
                     return false;
 
@@ -1803,7 +2289,7 @@ std::pair<qpu_asm::Instruction, bool> Slice::readInstruction(ProgramCounter pc)
     return std::make_pair(qpu_asm::Instruction{result}, true);
 }
 
-uint32_t QPU::getCurrentCycle() const
+uint64_t QPU::getCurrentCycle() const
 {
     return clock.currentCycle;
 }
@@ -1852,6 +2338,16 @@ bool QPU::execute()
     if(stopExecution)
         return false;
 
+    if(translatedCode && pc < translatedCode->size() && (*translatedCode)[pc].isTranslated)
+    {
+        auto currentPC = pc;
+        if(executeTranslated((*translatedCode)[pc]))
+        {
+            clock.traceEvent(ID, currentPC, TraceEvent::INSTRUCTION);
+            return true;
+        }
+    }
+
     {
         std::lock_guard<std::mutex> instrumentationGuard(instrumentationLock);
         ++instrumentation.at(pc).numExecutions;
@@ -1864,7 +2360,10 @@ bool QPU::execute()
     {
         auto val = slice.readInstruction(pc);
         if(!val.second)
+        {
+            clock.traceEvent(ID, pc, TraceEvent::STALL_INSTRUCTION_FETCH);
             return true;
+        }
         inst = val.first;
     }
     lastInstruction = std::make_pair(pc, inst.toBinaryCode());
@@ -1905,6 +2404,7 @@ bool QPU::execute()
                     targetPC = nextPC + 4 /* Branch starts at PC + 4 */ + static_cast<ProgramCounter>(offset);
                 else
                     targetPC = static_cast<ProgramCounter>(offset);
+                clock.traceEvent(ID, pc, TraceEvent::BRANCH, targetPC);
 
                 // see Broadcom specification, page 34
                 registers.writeRegister(toRegister(br->getAddOut(), br->getWriteSwap() == WriteSwap::SWAP),
@@ -1914,7 +2414,7 @@ bool QPU::execute()
 
                 // schedule the jump after the next 3 instructions
                 clock.schedule(
-                    "Branch delay", [this, remainingCycles{3}, targetPC](uint32_t currentCycle) mutable -> bool {
+                    "Branch delay", [this, remainingCycles{3}, targetPC](uint64_t currentCycle) mutable -> bool {
                         if(remainingCycles > 0)
                         {
                             --remainingCycles;
@@ -1996,10 +2496,14 @@ bool QPU::execute()
                         semaphore->getAddCondition() != COND_NEVER ? semaphore->getAddCondition() :
                                                                      semaphore->getMulCondition(),
                         {});
+                clock.traceEvent(ID, pc,
+                    semaphore->getAcquire() ? TraceEvent::SEMAPHORE_DECREMENT : TraceEvent::SEMAPHORE_INCREMENT,
+                    static_cast<uint32_t>(semaphore->getSemaphore()));
                 ++nextPC;
             }
             else
             {
+                clock.traceEvent(ID, pc, TraceEvent::STALL_SEMAPHORE);
                 std::lock_guard<std::mutex> instrumentationGuard(instrumentationLock);
                 ++instrumentation.at(pc).numStalls;
             }
@@ -2011,6 +2515,9 @@ bool QPU::execute()
     // clear cache for registers already read this instruction
     registers.clearReadCache();
 
+    if(nextPC != pc)
+        // otherwise, the stall reason is already traced
+        clock.traceEvent(ID, pc, TraceEvent::INSTRUCTION);
     pc = nextPC;
     return true;
 }
@@ -2025,6 +2532,111 @@ uint32_t QPU::getCurrentInstructionIndex() const
     return pc;
 }
 
+static const SIMDVector* toTranslatedInput(
+    const TranslatedInput& input, const Registers& registers, const SIMDVector& lastR4Value)
+{
+    if(input.readsR4)
+        return &lastR4Value;
+    if(input.reg == REG_NOP)
+        return &input.constant;
+    return registers.getDefinedStorageRegister(input.reg);
+}
+
+static bool calculateTranslated(const TranslatedOperation& op, const Registers& registers,
+    const SIMDVector& lastR4Value, SIMDVector& result, VectorFlags& resultFlags)
+{
+    static const SIMDVector UNUSED_INPUT{};
+    if(!op.operation)
+        return true;
+    auto firstInput = toTranslatedInput(op.firstInput, registers, lastR4Value);
+    auto secondInput =
+        op.code->numOperands > 1 ? toTranslatedInput(op.secondInput, registers, lastR4Value) : &UNUSED_INPUT;
+    if(!firstInput || !secondInput)
+        // register is undefined or cannot be read yet, let the interpreter handle (and report) that
+        return false;
+    return op.operation(*op.code, *firstInput, *secondInput, result, resultFlags);
+}
+
+bool QPU::executeTranslated(const TranslatedInstruction& inst)
+{
+    // Calculate both results before modifying any state, so we can still fall back to the interpreter
+    SIMDVector addResult{};
+    SIMDVector mulResult{};
+    VectorFlags addFlags{};
+    VectorFlags mulFlags{};
+    if(!calculateTranslated(inst.addOperation, registers, lastR4Value, addResult, addFlags) ||
+        !calculateTranslated(inst.mulOperation, registers, lastR4Value, mulResult, mulFlags))
+        return false;
+
+    {
+        std::lock_guard<std::mutex> instrumentationGuard(instrumentationLock);
+        ++instrumentation.at(pc).numExecutions;
+        ++instrumentation.at(pc).numTranslatedExecutions;
+    }
+    lastInstruction = std::make_pair(pc, inst.binaryCode);
+    CPPLOG_LAZY(logging::Level::INFO,
+        log << "QPU " << static_cast<unsigned>(ID) << " (0x" << std::hex << pc << std::dec
+            << "): " << qpu_asm::Instruction{inst.binaryCode}.toASMString() << " (translated)" << logging::endl);
+
+    if(inst.isLoadImmediate)
+    {
+        writeTranslated(inst.addOperation, addResult, false, true);
+        writeTranslated(inst.mulOperation, mulResult, false, false);
+        if(inst.addOperation.setsFlags)
+            setFlags(addResult, inst.addOperation.condition, addFlags);
+        else if(inst.mulOperation.setsFlags)
+            setFlags(mulResult, inst.mulOperation.condition, mulFlags);
+    }
+    else
+    {
+        if(inst.addOperation.operation)
+        {
+            writeTranslated(inst.addOperation, addResult, true, true);
+            if(inst.addOperation.setsFlags)
+                setFlags(addResult, inst.addOperation.condition, addFlags);
+        }
+        if(inst.mulOperation.operation)
+        {
+            // same as for the interpreter, the mul ALU write depends on the flags set by the add ALU
+            writeTranslated(inst.mulOperation, mulResult, true, false);
+            if(inst.mulOperation.setsFlags)
+                setFlags(mulResult, inst.mulOperation.condition, mulFlags);
+        }
+    }
+
+    PROFILE_COUNTER(vc4c::profiler::COUNTER_EMULATOR, "translated instructions", 1);
+    ++pc;
+    return true;
+}
+
+void QPU::writeTranslated(const TranslatedOperation& op, const SIMDVector& result, bool isALU, bool isAddALU)
+{
+    std::bitset<16> elementMask{};
+    if(op.condition == COND_ALWAYS)
+        elementMask.set();
+    else if(op.condition != COND_NEVER)
+    {
+        for(uint8_t i = 0; i < NATIVE_VECTOR_SIZE; ++i)
+        {
+            if(flags[i].matchesCondition(op.condition))
+                elementMask.set(i);
+        }
+    }
+    if(op.condition != COND_NEVER)
+        // also write with an empty mask to update the register write cycle, same as the interpreter
+        registers.writeRegister(op.output, result, elementMask, BITMASK_ALL);
+
+    if(isALU)
+    {
+        std::lock_guard<std::mutex> instrumentationGuard(instrumentationLock);
+        auto& counter = isAddALU ? (elementMask.any() ? instrumentation.at(pc).numAddALUExecuted :
+                                                        instrumentation.at(pc).numAddALUSkipped) :
+                                   (elementMask.any() ? instrumentation.at(pc).numMulALUExecuted :
+                                                        instrumentation.at(pc).numMulALUSkipped);
+        ++counter;
+    }
+}
+
 static std::pair<SIMDVector, bool> toInputValue(Registers& registers, InputMultiplex mux, Address addressA,
     Address addressB, bool regBIsImmediate, bool anyElementExecuted)
 {
@@ -2401,7 +3013,8 @@ bool QPU::executeSignal(Signaling signal)
     else if(signal == SIGNAL_END_PROGRAM)
     {
         // end program after the next 2 instructions
-        clock.schedule("Thread end", [this, remainingCycles{2}](uint32_t currentCycle) mutable -> bool {
+        clock.traceEvent(ID, pc, TraceEvent::THREAD_END);
+        clock.schedule("Thread end", [this, remainingCycles{2}](uint64_t currentCycle) mutable -> bool {
             if(remainingCycles > 0)
             {
                 --remainingCycles;
@@ -2503,6 +3116,408 @@ std::vector<MemoryAddress> tools::buildUniforms(Memory& memory, MemoryAddress ba
     return res;
 }
 
+static constexpr uint64_t SNAPSHOT_MAGIC = 0x50414E5343344356; /* "VC4CSNAP" */
+// needs to be incremented on every change of the snapshot layout, incl. the raw InstrumentationResult
+static constexpr uint32_t SNAPSHOT_VERSION = 6;
+
+template <typename T>
+static T extractSnapshotValue(std::future<T>& future)
+{
+    auto value = extractValue(future);
+    if(!value.second)
+        throw CompilationError(
+            CompilationStep::GENERAL, "Cannot take snapshot while asynchronous executions are pending");
+    return value.first;
+}
+
+template <typename T>
+static std::future<T> toReadyFuture(const T& value)
+{
+    AsynchronousHandle<T> handle{};
+    handle.set_value(value);
+    return handle.get_future();
+}
+
+void Memory::saveState(SnapshotWriter& out) const
+{
+    out.write(static_cast<uint32_t>(regions.size()));
+    for(const auto& entry : regions)
+    {
+        const auto& region = entry.second;
+        out.write(region.start);
+        out.write(static_cast<uint64_t>(region.numBytes));
+        out.write(region.hostData != nullptr);
+        if(region.hostData)
+        {
+            out.writeBytes(region.hostData, region.numBytes);
+            continue;
+        }
+        auto numPages = std::count_if(region.ownedPages.begin(), region.ownedPages.end(),
+            [](const std::unique_ptr<Word[]>& page) -> bool { return page != nullptr; });
+        out.write(static_cast<uint32_t>(numPages));
+        for(uint32_t i = 0; i < region.ownedPages.size(); ++i)
+        {
+            if(!region.ownedPages[i])
+                continue;
+            out.write(i);
+            out.writeBytes(region.ownedPages[i].get(), MEMORY_PAGE_SIZE);
+        }
+    }
+}
+
+void Memory::restoreState(SnapshotReader& in)
+{
+    if(in.read<uint32_t>() != regions.size())
+        throw CompilationError(CompilationStep::GENERAL, "Number of memory regions in snapshot does not match");
+    for(auto& entry : regions)
+    {
+        auto& region = entry.second;
+        auto start = in.read<MemoryAddress>();
+        auto numBytes = in.read<uint64_t>();
+        auto isHostMemory = in.read<bool>();
+        if(start != region.start || numBytes != region.numBytes || isHostMemory != (region.hostData != nullptr))
+            throw CompilationError(CompilationStep::GENERAL, "Memory region in snapshot does not match",
+                toAddressString(start) + " + " + std::to_string(numBytes));
+        if(region.hostData)
+        {
+            in.readBytes(region.hostData, region.numBytes);
+            continue;
+        }
+        // pages not contained in the snapshot were never written before the snapshot was taken
+        for(auto& page : region.ownedPages)
+            page.reset();
+        auto numPages = in.read<uint32_t>();
+        for(uint32_t i = 0; i < numPages; ++i)
+        {
+            auto index = in.read<uint32_t>();
+            if(index >= region.ownedPages.size())
+                throw CompilationError(
+                    CompilationStep::GENERAL, "Invalid memory page in snapshot", std::to_string(index));
+            auto& page = region.ownedPages[index];
+            page = std::make_unique<Word[]>(WORDS_PER_PAGE);
+            in.readBytes(page.get(), MEMORY_PAGE_SIZE);
+        }
+    }
+}
+
+void Mutex::saveState(SnapshotWriter& out) const
+{
+    out.write(lockedOwner.load());
+}
+
+void Mutex::restoreState(SnapshotReader& in)
+{
+    lockedOwner = in.read<uint8_t>();
+}
+
+void Registers::saveState(SnapshotWriter& out) const
+{
+    // the read cache is cleared at the end of every instruction and therefore not part of the state
+    for(const auto& reg : storageRegisters)
+    {
+        out.write(reg.first);
+        out.write(reg.second);
+    }
+    out.write(hostInterrupt.has_value());
+    if(hostInterrupt)
+        out.write(hostInterrupt.value());
+}
+
+void Registers::restoreState(SnapshotReader& in)
+{
+    for(auto& reg : storageRegisters)
+    {
+        reg.first = in.readVector();
+        reg.second = in.read<uint64_t>();
+    }
+    hostInterrupt = {};
+    if(in.read<bool>())
+        hostInterrupt = in.readVector();
+    readCache.clear();
+}
+
+void UniformFifo::saveState(SnapshotWriter& out)
+{
+    out.write(uniformAddress);
+    out.write(lastAddressSetCycle);
+    out.write(static_cast<uint32_t>(fifo.size()));
+    for(auto& entry : fifo)
+    {
+        // the value of a future can only be retrieved once
+        auto value = extractSnapshotValue(entry);
+        out.write(value);
+        entry = toReadyFuture(value);
+    }
+}
+
+void UniformFifo::restoreState(SnapshotReader& in)
+{
+    uniformAddress = in.read<MemoryAddress>();
+    lastAddressSetCycle = in.read<uint64_t>();
+    fifo.clear();
+    auto numEntries = in.read<uint32_t>();
+    for(uint32_t i = 0; i < numEntries; ++i)
+        fifo.emplace_back(toReadyFuture(in.read<Word>()));
+}
+
+static void saveQueue(SnapshotWriter& out, std::queue<std::future<SIMDVector>>& queue)
+{
+    out.write(static_cast<uint32_t>(queue.size()));
+    // the value of a future can only be retrieved once, so we need to rebuild the queue
+    std::queue<std::future<SIMDVector>> tmp;
+    while(!queue.empty())
+    {
+        auto value = extractSnapshotValue(queue.front());
+        queue.pop();
+        out.write(value);
+        tmp.emplace(toReadyFuture(value));
+    }
+    queue.swap(tmp);
+}
+
+static void restoreQueue(SnapshotReader& in, std::queue<std::future<SIMDVector>>& queue)
+{
+    queue = {};
+    auto numEntries = in.read<uint32_t>();
+    for(uint32_t i = 0; i < numEntries; ++i)
+        queue.emplace(toReadyFuture(in.readVector()));
+}
+
+void TMUs::saveState(SnapshotWriter& out)
+{
+    out.write(tmuNoSwap);
+    out.write(lastTMUNoSwap);
+    saveQueue(out, tmu0Queue);
+    saveQueue(out, tmu1Queue);
+    for(std::size_t i = 0; i < textureCoordinates.size(); ++i)
+    {
+        // texture parameters written but not yet triggered by the s-coordinate
+        out.write(textureCoordinates[i].has_value());
+        if(textureCoordinates[i])
+            out.write(textureCoordinates[i].value());
+        out.write(borderColors[i].has_value());
+        if(borderColors[i])
+            out.write(borderColors[i].value());
+    }
+}
+
+void TMUs::restoreState(SnapshotReader& in)
+{
+    tmuNoSwap = in.read<bool>();
+    lastTMUNoSwap = in.read<uint64_t>();
+    restoreQueue(in, tmu0Queue);
+    restoreQueue(in, tmu1Queue);
+    for(std::size_t i = 0; i < textureCoordinates.size(); ++i)
+    {
+        textureCoordinates[i] = {};
+        if(in.read<bool>())
+            textureCoordinates[i] = in.readVector();
+        borderColors[i] = {};
+        if(in.read<bool>())
+            borderColors[i] = in.readVector();
+    }
+}
+
+void VPM::saveState(SnapshotWriter& out) const
+{
+    out.write(vpmReadSetup);
+    out.write(vpmWriteSetup);
+    out.write(dmaReadSetup);
+    out.write(dmaWriteSetup);
+    out.write(readStrideSetup);
+    out.write(writeStrideSetup);
+    out.write(lastDMAReadTrigger);
+    out.write(lastDMAWriteTrigger);
+    out.write(numQueuedReads);
+    out.write(cache);
+}
+
+void VPM::restoreState(SnapshotReader& in)
+{
+    vpmReadSetup = in.read<uint32_t>();
+    vpmWriteSetup = in.read<uint32_t>();
+    dmaReadSetup = in.read<uint32_t>();
+    dmaWriteSetup = in.read<uint32_t>();
+    readStrideSetup = in.read<uint32_t>();
+    writeStrideSetup = in.read<uint32_t>();
+    lastDMAReadTrigger = in.read<uint64_t>();
+    lastDMAWriteTrigger = in.read<uint64_t>();
+    numQueuedReads = in.read<uint8_t>();
+    cache = in.read<decltype(cache)>();
+}
+
+void Semaphores::saveState(SnapshotWriter& out) const
+{
+    out.write(counter);
+}
+
+void Semaphores::restoreState(SnapshotReader& in)
+{
+    std::lock_guard<std::mutex> guard(counterLock);
+    counter = in.read<decltype(counter)>();
+}
+
+void L2Cache::saveState(SnapshotWriter& out) const
+{
+    out.write(cache);
+}
+
+void L2Cache::restoreState(SnapshotReader& in)
+{
+    cache = in.read<decltype(cache)>();
+}
+
+void Slice::saveState(SnapshotWriter& out) const
+{
+    out.write(id);
+    out.write(tmu0Cache);
+    out.write(tmu1Cache);
+    out.write(instructionCache);
+    out.write(uniformCache);
+}
+
+void Slice::restoreState(SnapshotReader& in)
+{
+    if(in.read<uint8_t>() != id)
+        throw CompilationError(CompilationStep::GENERAL, "Slice in snapshot does not match", std::to_string(id));
+    tmu0Cache = in.read<decltype(tmu0Cache)>();
+    tmu1Cache = in.read<decltype(tmu1Cache)>();
+    instructionCache = in.read<decltype(instructionCache)>();
+    uniformCache = in.read<decltype(uniformCache)>();
+}
+
+void QPU::saveState(SnapshotWriter& out)
+{
+    out.write(ID);
+    out.write(pc);
+    out.write(lastInstruction.first);
+    out.write(lastInstruction.second);
+    out.write(flags);
+    out.write(lastR4Value);
+    out.write(stopExecution);
+    registers.saveState(out);
+    uniforms.saveState(out);
+    tmus.saveState(out);
+}
+
+void QPU::restoreState(SnapshotReader& in)
+{
+    if(in.read<uint8_t>() != ID)
+        throw CompilationError(
+            CompilationStep::GENERAL, "QPU in snapshot does not match", std::to_string(static_cast<unsigned>(ID)));
+    pc = in.read<ProgramCounter>();
+    lastInstruction.first = in.read<ProgramCounter>();
+    lastInstruction.second = in.read<uint64_t>();
+    flags = in.read<VectorFlags>();
+    lastR4Value = in.readVector();
+    stopExecution = in.read<bool>();
+    registers.restoreState(in);
+    uniforms.restoreState(in);
+    tmus.restoreState(in);
+}
+
+static uint64_t calculateCodeChecksum(
+    std::vector<qpu_asm::Instruction>::const_iterator firstInstruction, std::size_t numInstructions)
+{
+    // FNV-1a over the machine code, to not resume with a snapshot of another kernel
+    uint64_t checksum = 0xcbf29ce484222325;
+    for(std::size_t i = 0; i < numInstructions; ++i, ++firstInstruction)
+    {
+        checksum ^= firstInstruction->toBinaryCode();
+        checksum *= 0x100000001b3;
+    }
+    return checksum;
+}
+
+/*
+ * References to all the state of a single emulation run
+ */
+struct EmulationState
+{
+    EmulationClock& clock;
+    Memory& memory;
+    Mutex& mutex;
+    Semaphores& semaphores;
+    VPM& vpm;
+    L2Cache& l2Cache;
+    std::vector<Slice>& slices;
+    std::vector<QPU>& qpus;
+    std::bitset<NATIVE_VECTOR_SIZE>& activeQPUs;
+    InstrumentationResults& instrumentation;
+    uint64_t codeChecksum;
+};
+
+static void writeSnapshot(const std::string& fileName, EmulationState& state)
+{
+    PROFILE_SCOPE(WriteSnapshot);
+    SnapshotWriter out(fileName);
+    out.write(SNAPSHOT_MAGIC);
+    out.write(SNAPSHOT_VERSION);
+    out.write(state.codeChecksum);
+    out.write(static_cast<uint32_t>(state.instrumentation.size()));
+    out.write(static_cast<uint32_t>(state.qpus.size()));
+    out.write(static_cast<uint32_t>(state.activeQPUs.to_ulong()));
+    out.write(state.clock.currentCycle);
+
+    state.memory.saveState(out);
+    state.mutex.saveState(out);
+    state.semaphores.saveState(out);
+    state.vpm.saveState(out);
+    state.l2Cache.saveState(out);
+    for(const auto& slice : state.slices)
+        slice.saveState(out);
+    for(auto& qpu : state.qpus)
+        qpu.saveState(out);
+    out.writeBytes(state.instrumentation.data(), state.instrumentation.size() * sizeof(InstrumentationResult));
+    out.write(SNAPSHOT_MAGIC);
+    out.commit();
+
+    PROFILE_COUNTER(vc4c::profiler::COUNTER_EMULATOR, "snapshots written", 1);
+    CPPLOG_LAZY(logging::Level::INFO,
+        log << "Written emulation snapshot after " << state.clock.currentCycle << " cycles to: " << fileName
+            << logging::endl);
+}
+
+static void restoreSnapshot(const std::string& fileName, EmulationState& state)
+{
+    PROFILE_SCOPE(RestoreSnapshot);
+    SnapshotReader in(fileName);
+    if(in.read<uint64_t>() != SNAPSHOT_MAGIC)
+        throw CompilationError(CompilationStep::GENERAL, "File is not an emulation snapshot", fileName);
+    auto version = in.read<uint32_t>();
+    if(version != SNAPSHOT_VERSION)
+        throw CompilationError(CompilationStep::GENERAL, "Unsupported snapshot version", std::to_string(version));
+    if(in.read<uint64_t>() != state.codeChecksum ||
+        in.read<uint32_t>() != static_cast<uint32_t>(state.instrumentation.size()))
+        throw CompilationError(CompilationStep::GENERAL, "Snapshot was taken for a different kernel code", fileName);
+    auto numQPUs = in.read<uint32_t>();
+    if(numQPUs != state.qpus.size())
+        throw CompilationError(CompilationStep::GENERAL, "Snapshot was taken for a different number of QPUs",
+            std::to_string(numQPUs));
+    state.activeQPUs = in.read<uint32_t>();
+
+    // the pending executions (e.g. initial UNIFORM loads) belong to a fresh start, the restored state has none
+    state.clock.discardPendingExecutions();
+    state.clock.currentCycle = in.read<uint64_t>();
+
+    state.memory.restoreState(in);
+    state.mutex.restoreState(in);
+    state.semaphores.restoreState(in);
+    state.vpm.restoreState(in);
+    state.l2Cache.restoreState(in);
+    for(auto& slice : state.slices)
+        slice.restoreState(in);
+    for(auto& qpu : state.qpus)
+        qpu.restoreState(in);
+    in.readBytes(state.instrumentation.data(), state.instrumentation.size() * sizeof(InstrumentationResult));
+    if(in.read<uint64_t>() != SNAPSHOT_MAGIC || !in.isAtEnd())
+        throw CompilationError(CompilationStep::GENERAL, "Snapshot file is corrupted", fileName);
+
+    CPPLOG_LAZY(logging::Level::INFO,
+        log << "Resuming emulation from snapshot after " << state.clock.currentCycle << " cycles: " << fileName
+            << logging::endl);
+}
+
 static void emulateStep(std::vector<QPU>& qpus, std::bitset<NATIVE_VECTOR_SIZE>& activeQPUs)
 {
     for(std::size_t i = 0; i < qpus.size(); ++i)
@@ -2529,13 +3544,15 @@ static void emulateStep(std::vector<QPU>& qpus, std::bitset<NATIVE_VECTOR_SIZE>&
 
 bool tools::emulate(std::vector<qpu_asm::Instruction>::const_iterator firstInstruction, Memory& memory,
     const std::vector<MemoryAddress>& uniformAddresses, InstrumentationResults& instrumentation,
-    const std::string& name, uint32_t maxCycles)
+    const std::string& name, uint64_t maxCycles, const TranslatedCode* translatedCode, const SnapshotConfig* snapshots,
+    TraceWriter* trace)
 {
     if(uniformAddresses.size() > NUM_QPUS)
         throw CompilationError(CompilationStep::GENERAL, "Cannot use more than 12 QPUs!");
 
     Mutex mutex;
     EmulationClock clock{};
+    clock.trace = trace;
     // FIXME is SFU execution per QPU or need SFUs be locked?
     std::vector<Slice> slices;
     slices.reserve(3);
@@ -2566,10 +3583,17 @@ bool tools::emulate(std::vector<qpu_asm::Instruction>::const_iterator firstInstr
         if(slices.size() <= (numQPU / 4))
             slices.emplace_back(Slice(static_cast<uint8_t>(slices.size()), clock, l2Cache));
         qpus.emplace_back(numQPU, clock, slices.at(numQPU / 4), mutex, sfus.at(numQPU), vpm, semaphores, uniformPointer,
-            instrumentation);
+            instrumentation, translatedCode);
         ++numQPU;
     }
 
+    EmulationState state{clock, memory, mutex, semaphores, vpm, l2Cache, slices, qpus, activeQPUs, instrumentation,
+        snapshots ? calculateCodeChecksum(firstInstruction, instrumentation.size()) : 0};
+    if(snapshots && !snapshots->restoreFile.empty())
+        restoreSnapshot(snapshots->restoreFile, state);
+    bool writeSnapshots = snapshots && !snapshots->snapshotFile.empty() && snapshots->interval > 0;
+    uint64_t nextSnapshotCycle = writeSnapshots ? uint64_t{clock.currentCycle} + snapshots->interval : 0;
+
     // Additional information to keep track of any hangs
     // We track the actual instructions in addition to the program counters to only abort if the instruction already
     // have been loaded and not already once the instruction cache is just filled up
@@ -2586,7 +3610,7 @@ bool tools::emulate(std::vector<qpu_asm::Instruction>::const_iterator firstInstr
         emulateStep(qpus, activeQPUs);
         clock.executeClockCycle();
 
-        if(clock.currentCycle == maxCycles)
+        if(clock.currentCycle >= maxCycles)
         {
             logging::error() << "After the maximum number of execution cycles, following QPUs are still running: "
                              << logging::endl;
@@ -2620,6 +3644,13 @@ bool tools::emulate(std::vector<qpu_asm::Instruction>::const_iterator firstInstr
             }
             lastInstructionHadNoAsynchronousExecutions = true;
             lastProgramCounters = std::move(currentProgramCounters);
+
+            // snapshots can only be taken without any pending asynchronous execution
+            if(writeSnapshots && clock.currentCycle >= nextSnapshotCycle && activeQPUs.any())
+            {
+                writeSnapshot(snapshots->snapshotFile, state);
+                nextSnapshotCycle = uint64_t{clock.currentCycle} + snapshots->interval;
+            }
         }
         else
             lastInstructionHadNoAsynchronousExecutions = false;
@@ -2645,7 +3676,7 @@ bool tools::emulate(std::vector<qpu_asm::Instruction>::const_iterator firstInstr
 bool tools::emulateTask(std::vector<qpu_asm::Instruction>::const_iterator firstInstruction,
     const std::vector<MemoryAddress>& parameter, Memory& memory, MemoryAddress uniformBaseAddress,
     MemoryAddress globalData, const KernelUniforms& uniformsUsed, InstrumentationResults& instrumentation,
-    const std::string& name, uint32_t maxCycles)
+    const std::string& name, uint64_t maxCycles)
 {
     WorkGroupConfig config;
     config.dimensions = 1;
@@ -2657,6 +3688,38 @@ bool tools::emulateTask(std::vector<qpu_asm::Instruction>::const_iterator firstI
     return emulate(firstInstruction, memory, uniformAddresses, instrumentation, name, maxCycles);
 }
 
+// the texture base address only contains the upper 20 bits, see Broadcom specification, table 15
+static constexpr MemoryAddress TEXTURE_BASE_ALIGNMENT = 4096;
+
+/*
+ * Writes the image-configuration incl. the texture setup table as read by intrinsics for the image parameter, see
+ * intermediate::NUM_TEXTURE_SETUPS
+ */
+static void writeImageConfiguration(
+    Memory& mem, MemoryAddress globalDataAddress, const ImageSetup& image, MemoryAddress textureAddress)
+{
+    // a width or height of 2048 is stored as zero
+    tools::Word config0 = textureAddress | ((image.textureType & 0xFu) << 4u);
+    tools::Word config1 = (static_cast<tools::Word>(image.textureType >> 4u) << 31u) |
+        ((image.height & 0x7FFu) << 20u) | ((image.width & 0x7FFu) << 8u);
+    auto wordSize = static_cast<MemoryAddress>(sizeof(tools::Word));
+    auto configAddress = globalDataAddress + image.configurationOffset * wordSize;
+    *mem.getWordAddress(configAddress) = config0;
+    *mem.getWordAddress(configAddress + wordSize) = config1;
+    // the channel order is stored in the lower half of the channel-info entry
+    *mem.getWordAddress(configAddress + 4 * wordSize) = image.channelOrder;
+    for(unsigned i = 0; i < intermediate::NUM_TEXTURE_SETUPS; ++i)
+    {
+        auto wrapMode =
+            static_cast<tools::Word>(intermediate::toTextureWrapMode(static_cast<intermediate::AddressingMode>(i / 2)));
+        // nearest filtering sets the magnification filter bit and the minification filter to 1, linear to 0
+        tools::Word filter = (i % 2) == 0 ? ((1u << 7u) | (1u << 4u)) : 0u;
+        auto setupAddress = configAddress + (6 + 2 * i) * wordSize;
+        *mem.getWordAddress(setupAddress) = config0;
+        *mem.getWordAddress(setupAddress + wordSize) = config1 | filter | (wrapMode << 2u) | wrapMode;
+    }
+}
+
 static Memory fillMemory(const StableList<Global>& globalData, const EmulationData& settings,
     MemoryAddress& uniformBaseAddressOut, MemoryAddress& globalDataAddressOut,
     std::vector<MemoryAddress>& parameterAddressesOut)
@@ -2674,6 +3737,8 @@ static Memory fillMemory(const StableList<Global>& globalData, const EmulationDa
     while((size % 64) != 0)
         ++size;
     size += settings.calcNumWorkItems() * (16 + settings.parameter.size());
+    // space for aligning the image parameters to the texture base address
+    size += settings.images.size() * (TEXTURE_BASE_ALIGNMENT / sizeof(tools::Word));
     Memory mem(size);
 
     MemoryAddress currentAddress = 0;
@@ -2707,16 +3772,22 @@ static Memory fillMemory(const StableList<Global>& globalData, const EmulationDa
     }
 
     parameterAddressesOut.reserve(settings.parameter.size());
-    for(const auto& pair : settings.parameter)
+    for(std::size_t i = 0; i < settings.parameter.size(); ++i)
     {
-        tools::Word* addr = mem.getWordAddress(currentAddress);
-        if(pair.second)
+        const auto& pair = settings.parameter[i];
+        if(settings.hostBuffers.find(i) != settings.hostBuffers.end())
+            // address is assigned when mapping the host buffer below
+            parameterAddressesOut.emplace_back(0);
+        else if(pair.second)
         {
+            if(settings.images.find(i) != settings.images.end() && (currentAddress % TEXTURE_BASE_ALIGNMENT) != 0)
+                currentAddress += TEXTURE_BASE_ALIGNMENT - (currentAddress % TEXTURE_BASE_ALIGNMENT);
             CPPLOG_LAZY(logging::Level::DEBUG,
                 log << "\tParameter at offset " << toAddressString(currentAddress) << " with " << pair.second->size()
                     << " words" << logging::endl);
             parameterAddressesOut.emplace_back(currentAddress);
-            std::copy_n(pair.second->data(), pair.second->size(), addr);
+            mem.writeBytes(currentAddress, reinterpret_cast<const uint8_t*>(pair.second->data()),
+                pair.second->size() * sizeof(uint32_t));
             currentAddress += static_cast<MemoryAddress>(pair.second->size() * sizeof(uint32_t));
         }
         else
@@ -2724,6 +3795,15 @@ static Memory fillMemory(const StableList<Global>& globalData, const EmulationDa
             parameterAddressesOut.emplace_back(pair.first);
     }
 
+    for(const auto& image : settings.images)
+    {
+        if(image.first >= parameterAddressesOut.size() || !settings.parameter[image.first].second ||
+            settings.hostBuffers.find(image.first) != settings.hostBuffers.end())
+            throw CompilationError(
+                CompilationStep::GENERAL, "Image setup given for invalid parameter", std::to_string(image.first));
+        writeImageConfiguration(mem, globalDataAddressOut, image.second, parameterAddressesOut[image.first]);
+    }
+
     // align UNIFORMs to boundary of memory dump
     if(currentAddress % (sizeof(tools::Word) * 8) != 0)
         currentAddress +=
@@ -2731,6 +3811,26 @@ static Memory fillMemory(const StableList<Global>& globalData, const EmulationDa
 
     uniformBaseAddressOut = currentAddress;
 
+    // host buffers are mapped page-aligned behind the memory owned by the emulator, their contents are not copied
+    auto hostAddress = static_cast<uint64_t>(mem.getMaximumAddress());
+    for(const auto& buffer : settings.hostBuffers)
+    {
+        if(buffer.first >= parameterAddressesOut.size())
+            throw CompilationError(
+                CompilationStep::GENERAL, "Host buffer given for invalid parameter", std::to_string(buffer.first));
+        hostAddress =
+            ((hostAddress + Memory::MEMORY_PAGE_SIZE - 1) / Memory::MEMORY_PAGE_SIZE) * Memory::MEMORY_PAGE_SIZE;
+        if(hostAddress + buffer.second.size > std::numeric_limits<MemoryAddress>::max())
+            throw CompilationError(CompilationStep::GENERAL, "Host buffers exceed the 32-bit address space",
+                std::to_string(buffer.second.size));
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "\tParameter at offset " << toAddressString(hostAddress) << " mapped from host buffer with "
+                << buffer.second.size << " bytes" << logging::endl);
+        mem.mapHostMemory(static_cast<MemoryAddress>(hostAddress), buffer.second.data, buffer.second.size);
+        parameterAddressesOut[buffer.first] = static_cast<MemoryAddress>(hostAddress);
+        hostAddress += buffer.second.size;
+    }
+
     return mem;
 }
 
@@ -2745,6 +3845,12 @@ static void dumpMemory(const Memory& memory, const std::string& fileName, Memory
     MemoryAddress addr = 0;
     while(addr != memory.getMaximumAddress())
     {
+        if(!memory.isAddressMapped(addr))
+        {
+            // skip gaps between the memory regions
+            addr += static_cast<MemoryAddress>(sizeof(tools::Word));
+            continue;
+        }
         if(uniformAddress == addr)
             f << "Uniforms: " << std::endl;
         if(addr % (sizeof(tools::Word) * 8) == 0)
@@ -2792,6 +3898,18 @@ std::string InstrumentationResult::to_string() const
         parts.emplace_back(tmp.str());
         tmp = std::stringstream{};
     }
+    if(numMutexStalls > 0)
+    {
+        tmp << "mutex: " << numMutexStalls;
+        parts.emplace_back(tmp.str());
+        tmp = std::stringstream{};
+    }
+    if(numTranslatedExecutions > 0)
+    {
+        tmp << "translated: " << numTranslatedExecutions;
+        parts.emplace_back(tmp.str());
+        tmp = std::stringstream{};
+    }
 
     return vc4c::to_string<std::string>(parts);
 }
@@ -2835,11 +3953,21 @@ EmulationResult tools::emulate(const EmulationData& data)
     if(!data.memoryDump.empty())
         dumpMemory(mem, data.memoryDump, uniformAddress, true);
 
+    auto firstInstruction = instructions.begin() +
+        static_cast<std::vector<qpu_asm::Instruction>::difference_type>(
+            (kernel->getOffset() - module.kernels.front().getOffset()));
+    TranslatedCode translatedCode;
+    if(data.translateCode)
+        translatedCode = translateCode(firstInstruction,
+            firstInstruction + static_cast<std::vector<qpu_asm::Instruction>::difference_type>(kernel->getLength()));
+
+    SnapshotConfig snapshots{data.snapshotFile, data.snapshotInterval, data.restoreSnapshot};
+    std::unique_ptr<TraceWriter> trace;
+    if(!data.traceFile.empty())
+        trace = std::make_unique<TraceWriter>(data.traceFile);
     InstrumentationResults instrumentation(kernel->getLength());
-    bool status = emulate(instructions.begin() +
-            static_cast<std::vector<qpu_asm::Instruction>::difference_type>(
-                (kernel->getOffset() - module.kernels.front().getOffset())),
-        mem, uniformAddresses, instrumentation, data.kernelName, data.maxEmulationCycles);
+    bool status = emulate(firstInstruction, mem, uniformAddresses, instrumentation, data.kernelName,
+        data.maxEmulationCycles, data.translateCode ? &translatedCode : nullptr, &snapshots, trace.get());
 
     if(!data.memoryDump.empty())
         dumpMemory(mem, data.memoryDump, uniformAddress, false);
@@ -2849,13 +3977,17 @@ EmulationResult tools::emulate(const EmulationData& data)
     result.results.reserve(data.parameter.size());
     for(std::size_t i = 0; i < data.parameter.size(); ++i)
     {
-        if(!data.parameter[i].second)
+        if(data.hostBuffers.find(i) != data.hostBuffers.end())
+            // the kernel wrote directly into the host buffer
+            result.results.emplace_back(std::make_pair(paramAddresses[i], Optional<std::vector<uint32_t>>{}));
+        else if(!data.parameter[i].second)
             result.results.emplace_back(std::make_pair(data.parameter[i].first, Optional<std::vector<uint32_t>>{}));
         else
         {
-            result.results.emplace_back(std::make_pair(paramAddresses[i], std::vector<uint32_t>{}));
-            std::copy_n(mem.getWordAddress(paramAddresses[i]), data.parameter[i].second->size(),
-                std::back_inserter(*result.results[i].second));
+            result.results.emplace_back(
+                std::make_pair(paramAddresses[i], std::vector<uint32_t>(data.parameter[i].second->size())));
+            mem.readBytes(paramAddresses[i], reinterpret_cast<uint8_t*>(result.results[i].second->data()),
+                result.results[i].second->size() * sizeof(uint32_t));
         }
     }
 
@@ -2869,12 +4001,36 @@ EmulationResult tools::emulate(const EmulationData& data)
     {
         auto& it = instructions.at(baseIndex + i);
         result.instrumentation.emplace_back(instrumentation.at(i));
+        result.mutexWaitCycles += instrumentation[i].numMutexStalls;
         if(dumpInstrumentation)
             *dumpInstrumentation << std::left << std::setw(80) << it.toASMString() << "//"
                                  << instrumentation[i].to_string() << std::endl;
         if(it.getSig() == SIGNAL_END_PROGRAM)
             break;
     }
+    CPPLOG_LAZY(logging::Level::INFO,
+        log << "QPUs spent " << result.mutexWaitCycles << " cycles waiting for the hardware mutex" << logging::endl);
+
+    if(!data.profileMapping.empty())
+    {
+        std::ifstream mapping(data.profileMapping);
+        if(!mapping)
+            throw CompilationError(CompilationStep::GENERAL, "Failed to open profile mapping", data.profileMapping);
+        auto regions = readCodeRegions(mapping, kernel->name);
+        if(regions.empty())
+            CPPLOG_LAZY(logging::Level::WARNING,
+                log << "Profile mapping has no code regions for kernel: " << kernel->name << logging::endl);
+        if(!data.profileReport.empty())
+        {
+            std::ofstream report(data.profileReport);
+            writeHotSpotReport(report, regions, result.instrumentation);
+        }
+        if(!data.profileFoldedStacks.empty())
+        {
+            std::ofstream stacks(data.profileFoldedStacks);
+            writeFoldedStacks(stacks, regions, result.instrumentation);
+        }
+    }
 
     return result;
 }
@@ -2903,9 +4059,17 @@ LowLevelEmulationResult tools::emulate(const LowLevelEmulationData& data)
     auto instructions = extractInstructions(data.kernelAddress, data.numInstructions);
     Memory mem(data.buffers);
 
+    TranslatedCode translatedCode;
+    if(data.translateCode)
+        translatedCode = translateCode(instructions.begin(), instructions.end());
+
+    SnapshotConfig snapshots{data.snapshotFile, data.snapshotInterval, data.restoreSnapshot};
+    std::unique_ptr<TraceWriter> trace;
+    if(!data.traceFile.empty())
+        trace = std::make_unique<TraceWriter>(data.traceFile);
     InstrumentationResults instrumentation(instructions.size());
-    bool status =
-        emulate(instructions.begin(), mem, data.uniformAddresses, instrumentation, "", data.maxEmulationCycles);
+    bool status = emulate(instructions.begin(), mem, data.uniformAddresses, instrumentation, "",
+        data.maxEmulationCycles, data.translateCode ? &translatedCode : nullptr, &snapshots, trace.get());
 
     LowLevelEmulationResult result{data};
     result.executionSuccessful = status;
@@ -2919,12 +4083,15 @@ LowLevelEmulationResult tools::emulate(const LowLevelEmulationData& data)
     {
         auto& it = instructions[i];
         result.instrumentation.emplace_back(instrumentation.at(i));
+        result.mutexWaitCycles += instrumentation[i].numMutexStalls;
         if(dumpInstrumentation)
             *dumpInstrumentation << std::left << std::setw(80) << it.toASMString() << "//"
                                  << instrumentation[i].to_string() << std::endl;
         if(it.getSig() == SIGNAL_END_PROGRAM)
             break;
     }
+    CPPLOG_LAZY(logging::Level::INFO,
+        log << "QPUs spent " << result.mutexWaitCycles << " cycles waiting for the hardware mutex" << logging::endl);
 
     return result;
 }
@@ -11,6 +11,7 @@
 #include "../Values.h"
 #include "../asm/OpCodes.h"
 #include "../performance.h"
+#include "Translator.h"
 #include "config.h"
 #include "tools.h"
 
@@ -19,8 +20,11 @@
 #include <bitset>
 #include <cstdint>
 #include <deque>
+#include <functional>
 #include <future>
 #include <limits>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <queue>
 
@@ -44,43 +48,115 @@ namespace vc4c
         using AsynchronousHandle = std::promise<T>;
 
         struct AsynchronousExecution;
+        class SnapshotWriter;
+        class SnapshotReader;
+        class TraceWriter;
 
         using MemoryAddress = uint32_t;
         using Word = uint32_t;
 
+        /*
+         * The memory accessible by the emulated QPUs.
+         *
+         * The memory consists of non-overlapping regions, which are either owned by the emulator (and allocated page by
+         * page on first write) or mapped without copying from existing host memory. Addresses are resolved via a flat
+         * page table, so the region lookup does not depend on the number of regions.
+         */
         class Memory : private NonCopyable
         {
         public:
             /*
-             * Use a direct buffer
+             * The granularity of the page table and of the lazy allocation of owned memory
              */
-            explicit Memory(std::size_t size) : data(DirectBuffer(size, 0xDEADBEEF)) {}
+            static constexpr MemoryAddress MEMORY_PAGE_SIZE = 4096;
+
+            /*
+             * Use a memory area owned by the emulator with the given number of words, starting at address zero
+             */
+            explicit Memory(std::size_t size);
             /*
              * Use a mapping of existing buffers
              *
              * The first element is the start "device address", the second element the buffer mapped for the part
              * [start "device address", start "device address"+ buffer.size())
              */
-            explicit Memory(const std::map<uint32_t, std::reference_wrapper<std::vector<uint8_t>>>& buffers) :
-                data(MappedBuffers(buffers))
-            {
-            }
+            explicit Memory(const std::map<uint32_t, std::reference_wrapper<std::vector<uint8_t>>>& buffers);
+
+            /*
+             * Adds a memory area owned by the emulator for the given address range.
+             *
+             * The memory is only allocated (page-wise) when it is written to.
+             */
+            void addOwnedMemory(MemoryAddress address, std::size_t numBytes);
+            /*
+             * Maps the given host memory (e.g. a buffer or a memory-mapped file) for the given address range.
+             *
+             * The host memory is accessed directly without copying, so it needs to outlive this object.
+             */
+            void mapHostMemory(MemoryAddress address, uint8_t* hostData, std::size_t numBytes);
 
             Word* getWordAddress(MemoryAddress address);
             const Word* getWordAddress(MemoryAddress address) const;
 
             Word readWord(MemoryAddress address) const;
+            void readBytes(MemoryAddress address, uint8_t* output, std::size_t numBytes) const;
+            void writeBytes(MemoryAddress address, const uint8_t* input, std::size_t numBytes);
             AsynchronousExecution startMemoryRead(AsynchronousHandle<Word>&& handle, MemoryAddress address) const;
             MemoryAddress incrementAddress(MemoryAddress address, DataType typeSize) const;
 
             MemoryAddress getMaximumAddress() const;
+            bool isAddressMapped(MemoryAddress address) const;
             void assertAddressInMemory(MemoryAddress address, std::size_t numBytes) const;
             void setUniforms(const std::vector<Word>& uniforms, MemoryAddress address);
 
+            /*
+             * Writes the contents of all regions into the snapshot. Only allocated pages of owned memory are written.
+             *
+             * On restore, the memory needs to have the same regions as the memory the snapshot was taken from.
+             */
+            void saveState(SnapshotWriter& out) const;
+            void restoreState(SnapshotReader& in);
+
         private:
-            using DirectBuffer = std::vector<Word>;
-            using MappedBuffers = std::map<uint32_t, std::reference_wrapper<std::vector<uint8_t>>>;
-            Variant<DirectBuffer, MappedBuffers> data;
+            struct Region
+            {
+                MemoryAddress start;
+                std::size_t numBytes;
+                /*
+                 * The mapped host memory, nullptr for memory owned by the emulator
+                 */
+                uint8_t* hostData;
+                /*
+                 * The lazily allocated pages for owned memory, relative to the region start
+                 */
+                std::vector<std::unique_ptr<Word[]>> ownedPages;
+
+                inline bool contains(MemoryAddress address, std::size_t size = 1) const noexcept
+                {
+                    return start <= address && (static_cast<std::size_t>(address) + size) <= (start + numBytes);
+                }
+
+                /*
+                 * Returns the host memory for the given address and the number of bytes accessible contiguously from
+                 * there. The non-const version allocates not yet allocated pages of owned memory.
+                 */
+                std::pair<const uint8_t*, std::size_t> toHostMemory(MemoryAddress address) const;
+                std::pair<uint8_t*, std::size_t> toHostMemory(MemoryAddress address);
+            };
+
+            std::map<MemoryAddress, Region> regions;
+            /*
+             * Maps all pages from the page table base address to the single region containing them. Pages not mapped
+             * at all or shared between regions (e.g. for unaligned host buffers) have a nullptr entry and are looked
+             * up in the sorted region map.
+             */
+            std::vector<Region*> pageTable;
+            MemoryAddress pageTableBase = 0;
+
+            void addRegion(Region&& region);
+            const Region* findRegion(MemoryAddress address) const;
+            const Region& getRegion(MemoryAddress address, std::size_t numBytes) const;
+            Region& getRegion(MemoryAddress address, std::size_t numBytes);
         };
 
         class Mutex : private NonCopyable
@@ -90,6 +166,9 @@ namespace vc4c
             NODISCARD bool lock(uint8_t qpu);
             void unlock(uint8_t qpu);
 
+            void saveState(SnapshotWriter& out) const;
+            void restoreState(SnapshotReader& in);
+
         private:
             static constexpr uint8_t NO_OWNER = 255;
             std::atomic<std::uint8_t> lockedOwner{NO_OWNER};
@@ -105,11 +184,20 @@ namespace vc4c
 
             SIMDVector getInterruptValue() const;
 
+            /*
+             * Returns the value of the given accumulator or physical register if it can be read without any side-effect
+             * (e.g. it is defined and not written in the previous instruction) or nullptr otherwise.
+             */
+            const SIMDVector* getDefinedStorageRegister(Register reg) const;
+
             void clearReadCache();
 
+            void saveState(SnapshotWriter& out) const;
+            void restoreState(SnapshotReader& in);
+
         private:
             QPU& qpu;
-            std::array<std::pair<SIMDVector, uint32_t>, 4 * 64> storageRegisters;
+            std::array<std::pair<SIMDVector, uint64_t>, 4 * 64> storageRegisters;
             Optional<SIMDVector> hostInterrupt;
             SortedMap<Register, SIMDVector> readCache;
 
@@ -128,23 +216,99 @@ namespace vc4c
 
             std::pair<SIMDVector, bool> readUniform();
             void setUniformAddress(const SIMDVector& val);
+            /*
+             * Removes the given number of UNIFORMs from the FIFO, e.g. for the TMU reading the texture setup
+             */
+            std::vector<std::future<Word>> takeUniforms(unsigned numUniforms);
 
             void triggerFifoFill();
 
+            /*
+             * Writes the UNIFORM address and the values in the FIFO into the snapshot.
+             *
+             * All FIFO values need to be loaded already (i.e. no asynchronous execution is pending), their futures are
+             * replaced with new ready ones.
+             */
+            void saveState(SnapshotWriter& out);
+            void restoreState(SnapshotReader& in);
+
         private:
             EmulationClock& clock;
             QPU& qpu;
             Slice& slice;
             MemoryAddress uniformAddress;
-            uint32_t lastAddressSetCycle;
+            uint64_t lastAddressSetCycle;
             std::deque<std::future<Word>> fifo;
         };
 
+        /*
+         * The texture setup read by the TMU from the UNIFORMs for texture lookups (texture config parameters 0 and 1),
+         * see Broadcom specification, pages 40+
+         *
+         * NOTE: Only 2D textures with a single mipmap level are supported.
+         */
+        struct TextureSetup
+        {
+            enum Type : uint8_t
+            {
+                RGBA8888 = 0,
+                RGBX8888 = 1,
+                RGBA4444 = 2,
+                RGBA5551 = 3,
+                RGB565 = 4,
+                LUMINANCE = 5,
+                ALPHA = 6,
+                LUMALPHA = 7,
+                RGBA32R = 16
+            };
+
+            enum WrapMode : uint8_t
+            {
+                REPEAT = 0,
+                CLAMP = 1,
+                MIRROR = 2,
+                BORDER = 3
+            };
+
+            MemoryAddress baseAddress;
+            Type type;
+            uint32_t width;
+            uint32_t height;
+            bool flipY;
+            bool linearFilter;
+            WrapMode wrapS;
+            WrapMode wrapT;
+
+            TextureSetup(Word config0, Word config1);
+
+            uint32_t getBytesPerTexel() const;
+            /*
+             * Returns the address of the texel at the given position.
+             *
+             * Texels of the raster format (RGBA32R) are stored row by row, all other formats are stored in the T-format
+             * or in the LT-format for small textures (see Broadcom specification, pages 105+).
+             */
+            MemoryAddress getTexelAddress(uint32_t x, uint32_t y) const;
+            /*
+             * Converts the given raw texel value to the RGBA8888 color returned by the TMU, with red in the lowest byte
+             */
+            Word toRGBA8888(Word texel) const;
+        };
+
+        /*
+         * Performs the texture lookup for the given normalized coordinates and returns the RGBA8888 color.
+         *
+         * The given function is called to read the (word-aligned) memory containing the texels.
+         */
+        Word sampleTexture(const TextureSetup& setup, float s, float t, Word borderColor,
+            const std::function<Word(MemoryAddress)>& readWord);
+
         class TMUs : private NonCopyable
         {
         public:
             TMUs(EmulationClock& clock, QPU& qpu, Slice& slice) :
-                clock(clock), qpu(qpu), tmuNoSwap(false), lastTMUNoSwap(0), slice(slice)
+                clock(clock), qpu(qpu), tmuNoSwap(false), lastTMUNoSwap(0), slice(slice), textureCoordinates{},
+                borderColors{}
             {
             }
 
@@ -156,19 +320,31 @@ namespace vc4c
 
             NODISCARD bool triggerTMURead(uint8_t tmu, SIMDVector& r4Register);
 
+            /*
+             * Writes the TMU configuration and the loaded values in the response queues into the snapshot, see
+             * UniformFifo#saveState()
+             */
+            void saveState(SnapshotWriter& out);
+            void restoreState(SnapshotReader& in);
+
         private:
             EmulationClock& clock;
             QPU& qpu;
             bool tmuNoSwap;
-            uint32_t lastTMUNoSwap;
+            uint64_t lastTMUNoSwap;
             Slice& slice;
             // Technically there are 2 FIFOs per TMU (request and response), but from a functional view, this makes no
             // difference, since we provide the response for a request immediately in the emulator
             std::queue<std::future<SIMDVector>> tmu0Queue;
             std::queue<std::future<SIMDVector>> tmu1Queue;
+            // The t-coordinates written since the last s-coordinate write. If set, the next lookup is a texture lookup.
+            std::array<Optional<SIMDVector>, 2> textureCoordinates;
+            std::array<Optional<SIMDVector>, 2> borderColors;
 
             void checkTMUWriteCycle() const;
             std::future<SIMDVector> readMemoryAddress(uint8_t tmu, const SIMDVector& address) const;
+            std::future<SIMDVector> readTexture(
+                uint8_t tmu, const SIMDVector& sCoords, const SIMDVector& tCoords, const SIMDVector& borderColor);
             uint8_t toRealTMU(uint8_t tmu) const;
         };
 
@@ -193,7 +369,8 @@ namespace vc4c
         public:
             explicit VPM(EmulationClock& clock, Memory& memory) :
                 clock(clock), memory(memory), vpmReadSetup(0), vpmWriteSetup(0), dmaReadSetup(0), dmaWriteSetup(0),
-                readStrideSetup(0), writeStrideSetup(0), lastDMAReadTrigger(0), lastDMAWriteTrigger(0), cache({})
+                readStrideSetup(0), writeStrideSetup(0), lastDMAReadTrigger(0), lastDMAWriteTrigger(0),
+                numQueuedReads(0), cache({})
             {
                 // just some dummy data to simulate previous values
                 std::for_each(cache.begin(), cache.end(), [](auto& entry) { entry.fill(0xDEADDEAD); });
@@ -211,8 +388,19 @@ namespace vc4c
             NODISCARD bool waitDMAWrite() const;
             NODISCARD bool waitDMARead() const;
 
+            /*
+             * Returns the number of vectors of the current generic read setup which are not yet read
+             */
+            uint8_t getReadQueueSize() const noexcept
+            {
+                return numQueuedReads;
+            }
+
             void dumpContents() const;
 
+            void saveState(SnapshotWriter& out) const;
+            void restoreState(SnapshotReader& in);
+
         private:
             EmulationClock& clock;
             Memory& memory;
@@ -222,8 +410,9 @@ namespace vc4c
             uint32_t dmaWriteSetup;
             uint32_t readStrideSetup;
             uint32_t writeStrideSetup;
-            uint32_t lastDMAReadTrigger;
-            uint32_t lastDMAWriteTrigger;
+            uint64_t lastDMAReadTrigger;
+            uint64_t lastDMAWriteTrigger;
+            uint8_t numQueuedReads;
 
             std::array<std::array<Word, 16>, 64> cache;
         };
@@ -241,6 +430,9 @@ namespace vc4c
 
             void checkAllZero() const;
 
+            void saveState(SnapshotWriter& out) const;
+            void restoreState(SnapshotReader& in);
+
         private:
             std::mutex counterLock;
             std::array<uint8_t, 16> counter;
@@ -257,7 +449,7 @@ namespace vc4c
             uint32_t numCurrentAccesses = 0;
             uint16_t lineNum;
             std::array<Element, NumElements> data{};
-            uint32_t cycleWritten = 0;
+            uint64_t cycleWritten = 0;
 
             static constexpr auto LINE_SIZE = NumElements * sizeof(Element);
 
@@ -293,6 +485,9 @@ namespace vc4c
             void validateMemoryWord(MemoryAddress address, Word word) const;
             void validateInstruction(ProgramCounter pc, uint64_t instruction) const;
 
+            void saveState(SnapshotWriter& out) const;
+            void restoreState(SnapshotReader& in);
+
         private:
             EmulationClock& clock;
             Memory& memory;
@@ -322,6 +517,9 @@ namespace vc4c
                 uint8_t tmuIndex, AsynchronousHandle<Word>&& handle, MemoryAddress address);
             std::pair<qpu_asm::Instruction, bool> readInstruction(ProgramCounter pc);
 
+            void saveState(SnapshotWriter& out) const;
+            void restoreState(SnapshotReader& in);
+
         private:
             uint8_t id;
             EmulationClock& clock;
@@ -339,12 +537,13 @@ namespace vc4c
         {
         public:
             QPU(uint8_t id, EmulationClock& clock, Slice& slice, Mutex& mutex, SFU& sfu, VPM& vpm,
-                Semaphores& semaphores, MemoryAddress uniformAddress, InstrumentationResults& instrumentation) :
+                Semaphores& semaphores, MemoryAddress uniformAddress, InstrumentationResults& instrumentation,
+                const TranslatedCode* translatedCode = nullptr) :
                 ID(id),
                 clock(clock), slice(slice), mutex(mutex), registers(*this),
                 uniforms(clock, *this, slice, uniformAddress), tmus(clock, *this, slice), sfu(sfu), vpm(vpm),
                 semaphores(semaphores), pc(0), lastInstruction{0xDEADDEAD, 0}, instrumentation(instrumentation),
-                stopExecution(false)
+                translatedCode(translatedCode), stopExecution(false)
             {
                 // initially trigger the loading of the first UNIFORM values into the FIFO
                 uniforms.triggerFifoFill();
@@ -352,13 +551,23 @@ namespace vc4c
 
             const uint8_t ID;
 
-            uint32_t getCurrentCycle() const;
+            uint64_t getCurrentCycle() const;
 
             NODISCARD bool execute();
 
             qpu_asm::Instruction getCurrentInstruction() const;
             uint32_t getCurrentInstructionIndex() const;
 
+            /*
+             * Writes the complete QPU state into the snapshot.
+             *
+             * Snapshots can only be taken between two cycles without any pending asynchronous execution, since e.g.
+             * pending branches, SFU calculations or memory loads are scheduled as host functions, which cannot be
+             * serialized. At these points, the state of the SFU is completely contained in the QPU registers.
+             */
+            void saveState(SnapshotWriter& out);
+            void restoreState(SnapshotReader& in);
+
             inline bool operator<(const QPU& other) const noexcept
             {
                 return ID < other.ID;
@@ -378,6 +587,7 @@ namespace vc4c
             ProgramCounter pc;
             std::pair<ProgramCounter, uint64_t> lastInstruction;
             InstrumentationResults& instrumentation;
+            const TranslatedCode* translatedCode;
             SIMDVector lastR4Value;
             bool stopExecution;
 
@@ -388,6 +598,8 @@ namespace vc4c
             friend class VPM;
 
             NODISCARD bool executeALU(const qpu_asm::ALUInstruction* aluInst);
+            NODISCARD bool executeTranslated(const TranslatedInstruction& inst);
+            void writeTranslated(const TranslatedOperation& op, const SIMDVector& result, bool isALU, bool isAddALU);
             void writeConditional(Register dest, const SIMDVector& in, ConditionCode cond, BitMask bitMask,
                 const qpu_asm::ALUInstruction* addInst = nullptr, const qpu_asm::ALUInstruction* mulInst = nullptr);
             bool isConditionMet(BranchCond cond) const;
@@ -395,16 +607,39 @@ namespace vc4c
             void setFlags(const SIMDVector& output, ConditionCode cond, const VectorFlags& newFlags);
         };
 
+        /*
+         * Configuration for periodically checkpointing the emulation state and resuming from a checkpoint
+         */
+        struct SnapshotConfig
+        {
+            /*
+             * The path of the snapshot file written periodically, no snapshots are written if empty
+             */
+            std::string snapshotFile;
+            /*
+             * The minimum number of cycles between two snapshots. The snapshot is delayed until the next cycle without
+             * any pending asynchronous execution.
+             */
+            uint32_t interval = 0;
+            /*
+             * The path of the snapshot file to resume the emulation from, the emulation starts from the beginning if
+             * empty
+             */
+            std::string restoreFile;
+        };
+
         std::vector<MemoryAddress> buildUniforms(Memory& memory, MemoryAddress baseAddress,
             const std::vector<MemoryAddress>& parameter, const WorkGroupConfig& config, MemoryAddress globalData,
             const KernelUniforms& uniformsUsed, uint8_t workItemMergeFactor = 1);
         bool emulate(std::vector<qpu_asm::Instruction>::const_iterator firstInstruction, Memory& memory,
             const std::vector<MemoryAddress>& uniformAddresses, InstrumentationResults& instrumentation,
-            const std::string& name = "", uint32_t maxCycles = std::numeric_limits<uint32_t>::max());
+            const std::string& name = "", uint64_t maxCycles = std::numeric_limits<uint64_t>::max(),
+            const TranslatedCode* translatedCode = nullptr, const SnapshotConfig* snapshots = nullptr,
+            TraceWriter* trace = nullptr);
         bool emulateTask(std::vector<qpu_asm::Instruction>::const_iterator firstInstruction,
             const std::vector<MemoryAddress>& parameter, Memory& memory, MemoryAddress uniformBaseAddress,
             MemoryAddress globalData, const KernelUniforms& uniformsUsed, InstrumentationResults& instrumentation,
-            const std::string& name = "", uint32_t maxCycles = std::numeric_limits<uint32_t>::max());
+            const std::string& name = "", uint64_t maxCycles = std::numeric_limits<uint64_t>::max());
     } // namespace tools
 } // namespace vc4c
 
@@ -0,0 +1,111 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vc4c
+{
+    namespace tools
+    {
+        /**
+         * Immutable map from strings to values, which is optimized for looking up the longest key which is a prefix of
+         * a given string.
+         *
+         * A lookup only walks the characters of the given string once (and stops at the first character not
+         * continuing any key), independent of the number of keys stored.
+         */
+        template <typename T>
+        class PrefixTrie
+        {
+            static constexpr uint32_t NO_VALUE = ~uint32_t{0};
+
+            struct Node
+            {
+                // sorted by the character
+                std::vector<std::pair<char, uint32_t>> children;
+                uint32_t valueIndex = NO_VALUE;
+            };
+
+        public:
+            PrefixTrie(std::initializer_list<std::pair<std::string, T>> entries) : nodes(1)
+            {
+                values.reserve(entries.size());
+                for(const auto& entry : entries)
+                {
+                    uint32_t current = 0;
+                    for(auto c : entry.first)
+                        current = getOrCreateChild(current, c);
+                    if(nodes[current].valueIndex == NO_VALUE)
+                    {
+                        nodes[current].valueIndex = static_cast<uint32_t>(values.size());
+                        values.emplace_back(entry.second);
+                    }
+                }
+            }
+
+            /**
+             * Returns the value of the longest key which is a prefix of the character sequence in the range
+             * [begin, end) together with the length of that key, or a null-pointer if no key is a prefix of it.
+             */
+            std::pair<const T*, std::size_t> findLongestPrefix(const char* begin, const char* end) const
+            {
+                std::pair<const T*, std::size_t> result{nullptr, 0};
+                uint32_t current = 0;
+                for(auto it = begin;; ++it)
+                {
+                    if(nodes[current].valueIndex != NO_VALUE)
+                        result = std::make_pair(
+                            &values[nodes[current].valueIndex], static_cast<std::size_t>(it - begin));
+                    if(it == end)
+                        break;
+                    const auto& children = nodes[current].children;
+                    auto childIt = std::lower_bound(children.begin(), children.end(), *it,
+                        [](const std::pair<char, uint32_t>& child, char val) -> bool { return child.first < val; });
+                    if(childIt == children.end() || childIt->first != *it)
+                        break;
+                    current = childIt->second;
+                }
+                return result;
+            }
+
+            std::pair<const T*, std::size_t> findLongestPrefix(const std::string& string, std::size_t offset = 0) const
+            {
+                offset = std::min(offset, string.size());
+                return findLongestPrefix(string.data() + offset, string.data() + string.size());
+            }
+
+            std::size_t size() const noexcept
+            {
+                return values.size();
+            }
+
+        private:
+            std::vector<Node> nodes;
+            std::vector<T> values;
+
+            uint32_t getOrCreateChild(uint32_t node, char c)
+            {
+                auto& children = nodes[node].children;
+                auto childIt = std::lower_bound(children.begin(), children.end(), c,
+                    [](const std::pair<char, uint32_t>& child, char val) -> bool { return child.first < val; });
+                if(childIt != children.end() && childIt->first == c)
+                    return childIt->second;
+                auto index = static_cast<uint32_t>(nodes.size());
+                children.emplace(childIt, c, index);
+                // NOTE: This might invalidate the references to the nodes!
+                nodes.emplace_back();
+                return index;
+            }
+        };
+    } // namespace tools
+} // namespace vc4c
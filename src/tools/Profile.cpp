@@ -0,0 +1,154 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+
+#include "Profile.h"
+
+#include "../helper.h"
+#include "CompilationError.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+using namespace vc4c;
+using namespace vc4c::tools;
+
+static const std::string NO_LOOPS = "-";
+
+void tools::writeCodeRegions(std::ostream& out, const std::vector<CodeRegion>& regions)
+{
+    out << "# kernel\tfirst instruction\tnumber of instructions\tbasic block\tloop headers" << std::endl;
+    for(const auto& region : regions)
+    {
+        auto loops = region.loops.empty() ? NO_LOOPS : to_string<std::string>(region.loops, std::string{";"});
+        out << region.kernel << '\t' << region.firstInstruction << '\t' << region.numInstructions << '\t'
+            << region.block << '\t' << loops << std::endl;
+    }
+}
+
+std::vector<CodeRegion> tools::readCodeRegions(std::istream& in, const std::string& kernelName)
+{
+    std::vector<CodeRegion> regions;
+    std::string line;
+    while(std::getline(in, line))
+    {
+        if(line.empty() || line[0] == '#')
+            continue;
+        std::istringstream ss(line);
+        CodeRegion region;
+        std::string loops;
+        if(!std::getline(ss, region.kernel, '\t') || !(ss >> region.firstInstruction >> region.numInstructions) ||
+            !(ss >> std::ws) || !std::getline(ss, region.block, '\t') || !std::getline(ss, loops))
+            throw CompilationError(CompilationStep::GENERAL, "Invalid code region mapping", line);
+        if(region.kernel != kernelName)
+            continue;
+        if(loops != NO_LOOPS)
+        {
+            std::istringstream loopStream(loops);
+            std::string header;
+            while(std::getline(loopStream, header, ';'))
+                region.loops.emplace_back(std::move(header));
+        }
+        regions.emplace_back(std::move(region));
+    }
+    return regions;
+}
+
+namespace
+{
+    struct ProfileEntry
+    {
+        uint64_t cycles = 0;
+        uint64_t stalls = 0;
+        uint64_t aluOperations = 0;
+
+        void add(const InstrumentationResult& result)
+        {
+            cycles += result.numExecutions;
+            stalls += result.numStalls;
+            aluOperations += result.numAddALUExecuted + result.numMulALUExecuted;
+        }
+
+        double getALUUtilization() const
+        {
+            auto issuedInstructions = cycles - std::min(cycles, stalls);
+            // there are 2 ALUs per instruction
+            if(issuedInstructions == 0)
+                return 0.0;
+            return static_cast<double>(aluOperations) / static_cast<double>(2 * issuedInstructions);
+        }
+    };
+} // namespace
+
+static ProfileEntry aggregateRegion(const CodeRegion& region, const std::vector<InstrumentationResult>& instrumentation)
+{
+    ProfileEntry entry;
+    auto end = std::min(static_cast<std::size_t>(region.firstInstruction) + region.numInstructions,
+        instrumentation.size());
+    for(std::size_t i = region.firstInstruction; i < end; ++i)
+        entry.add(instrumentation[i]);
+    return entry;
+}
+
+static void writeHotSpots(
+    std::ostream& out, std::vector<std::pair<std::string, ProfileEntry>>&& entries, uint64_t totalCycles)
+{
+    std::sort(entries.begin(), entries.end(),
+        [](const auto& one, const auto& other) -> bool { return one.second.cycles > other.second.cycles; });
+    out << std::setw(12) << "cycles" << std::setw(9) << "share" << std::setw(12) << "stalls" << std::setw(9) << "ALU"
+        << "  name" << std::endl;
+    for(const auto& entry : entries)
+    {
+        if(entry.second.cycles == 0)
+            continue;
+        auto share = static_cast<double>(entry.second.cycles) / static_cast<double>(std::max(totalCycles, uint64_t{1}));
+        out << std::setw(12) << entry.second.cycles << std::setw(8) << std::fixed << std::setprecision(2)
+            << (100.0 * share) << '%' << std::setw(12) << entry.second.stalls << std::setw(8)
+            << (100.0 * entry.second.getALUUtilization()) << "%  " << entry.first << std::endl;
+    }
+}
+
+void tools::writeHotSpotReport(std::ostream& out, const std::vector<CodeRegion>& regions,
+    const std::vector<InstrumentationResult>& instrumentation)
+{
+    uint64_t totalCycles = 0;
+    std::vector<std::pair<std::string, ProfileEntry>> blocks;
+    std::map<std::string, ProfileEntry> loops;
+    for(const auto& region : regions)
+    {
+        auto entry = aggregateRegion(region, instrumentation);
+        totalCycles += entry.cycles;
+        blocks.emplace_back(region.block, entry);
+        for(const auto& header : region.loops)
+        {
+            auto& loop = loops[header];
+            loop.cycles += entry.cycles;
+            loop.stalls += entry.stalls;
+            loop.aluOperations += entry.aluOperations;
+        }
+    }
+
+    out << "Hot-spots by basic block:" << std::endl;
+    writeHotSpots(out, std::move(blocks), totalCycles);
+    out << std::endl << "Hot-spots by loop (identified by the loop header block):" << std::endl;
+    writeHotSpots(out, std::vector<std::pair<std::string, ProfileEntry>>(loops.begin(), loops.end()), totalCycles);
+}
+
+void tools::writeFoldedStacks(std::ostream& out, const std::vector<CodeRegion>& regions,
+    const std::vector<InstrumentationResult>& instrumentation)
+{
+    for(const auto& region : regions)
+    {
+        auto entry = aggregateRegion(region, instrumentation);
+        if(entry.cycles == 0)
+            continue;
+        out << region.kernel;
+        for(const auto& header : region.loops)
+            out << ";loop " << header;
+        out << ';' << region.block << ' ' << entry.cycles << std::endl;
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+
+#ifndef VC4C_TOOLS_PROFILE_H
+#define VC4C_TOOLS_PROFILE_H
+
+#include "tools.h"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace vc4c
+{
+    namespace tools
+    {
+        /*
+         * The range of machine code instructions generated for a single basic block of a kernel
+         */
+        struct CodeRegion
+        {
+            std::string kernel;
+            /*
+             * The index of the first instruction, relative to the start of the kernel code
+             */
+            uint32_t firstInstruction;
+            uint32_t numInstructions;
+            /*
+             * The label of the basic block
+             */
+            std::string block;
+            /*
+             * The labels of the headers of all loops containing the basic block, from the outermost to the innermost
+             * loop
+             */
+            std::vector<std::string> loops;
+        };
+
+        /*
+         * Writes the mapping of the code regions as text, one region per line
+         */
+        void writeCodeRegions(std::ostream& out, const std::vector<CodeRegion>& regions);
+        /*
+         * Reads the code regions of the given kernel from the mapping written by #writeCodeRegions()
+         */
+        std::vector<CodeRegion> readCodeRegions(std::istream& in, const std::string& kernelName);
+
+        /*
+         * Writes the cycles, stalls and ALU utilization aggregated by basic blocks and loops, sorted by the number of
+         * cycles spent
+         */
+        void writeHotSpotReport(std::ostream& out, const std::vector<CodeRegion>& regions,
+            const std::vector<InstrumentationResult>& instrumentation);
+        /*
+         * Writes the cycles per basic block in the folded stack format (kernel;outer loop;inner loop;block cycles)
+         * used to generate flame graphs
+         */
+        void writeFoldedStacks(std::ostream& out, const std::vector<CodeRegion>& regions,
+            const std::vector<InstrumentationResult>& instrumentation);
+    } // namespace tools
+} // namespace vc4c
+
+#endif /* VC4C_TOOLS_PROFILE_H */
@@ -0,0 +1,124 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+
+#include "Snapshot.h"
+
+#include "CompilationError.h"
+#include "log.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace vc4c;
+using namespace vc4c::tools;
+
+SnapshotWriter::SnapshotWriter(const std::string& fileName) :
+    fileName(fileName), temporaryFileName(fileName + ".tmp"),
+    output(temporaryFileName, std::ios::out | std::ios::binary | std::ios::trunc)
+{
+    if(!output)
+        throw CompilationError(CompilationStep::GENERAL, "Failed to open snapshot file for writing", temporaryFileName);
+}
+
+SnapshotWriter::~SnapshotWriter() noexcept
+{
+    if(output.is_open())
+    {
+        // not committed, e.g. due to an error while writing the snapshot
+        output.close();
+        std::remove(temporaryFileName.data());
+    }
+}
+
+void SnapshotWriter::write(const SIMDVector& vector)
+{
+    for(Literal lit : vector)
+    {
+        write(lit.type);
+        write(lit.unsignedInt());
+    }
+}
+
+void SnapshotWriter::writeBytes(const void* data, std::size_t numBytes)
+{
+    output.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(numBytes));
+}
+
+void SnapshotWriter::commit()
+{
+    output.close();
+    if(output.fail())
+        throw CompilationError(CompilationStep::GENERAL, "Failed to write snapshot file", temporaryFileName);
+    if(std::rename(temporaryFileName.data(), fileName.data()) != 0)
+        throw CompilationError(CompilationStep::GENERAL, "Failed to replace snapshot file", strerror(errno));
+    CPPLOG_LAZY(logging::Level::DEBUG, log << "Written emulator snapshot: " << fileName << logging::endl);
+}
+
+SnapshotReader::SnapshotReader(const std::string& fileName) :
+    fileName(fileName), data(nullptr), size(0), offset(0)
+{
+    int fd = open(fileName.data(), O_RDONLY);
+    if(fd < 0)
+        throw CompilationError(CompilationStep::GENERAL, "Failed to open snapshot file", strerror(errno));
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size <= 0)
+    {
+        close(fd);
+        throw CompilationError(CompilationStep::GENERAL, "Invalid snapshot file", fileName);
+    }
+    size = static_cast<std::size_t>(info.st_size);
+    auto mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid after closing the file descriptor
+    close(fd);
+    if(mapping == MAP_FAILED)
+        throw CompilationError(CompilationStep::GENERAL, "Failed to map snapshot file", strerror(errno));
+    data = static_cast<const uint8_t*>(mapping);
+}
+
+SnapshotReader::~SnapshotReader() noexcept
+{
+    munmap(const_cast<uint8_t*>(data), size);
+}
+
+SIMDVector SnapshotReader::readVector()
+{
+    SIMDVector vector;
+    for(auto& element : vector)
+    {
+        auto type = read<LiteralType>();
+        Literal lit(read<uint32_t>());
+        if(type == LiteralType::TOMBSTONE)
+            lit = UNDEFINED_LITERAL;
+        else
+            lit.type = type;
+        element = lit;
+    }
+    return vector;
+}
+
+void SnapshotReader::readBytes(void* output, std::size_t numBytes)
+{
+    std::memcpy(output, readRaw(numBytes), numBytes);
+}
+
+const uint8_t* SnapshotReader::readRaw(std::size_t numBytes)
+{
+    if(numBytes > size - offset)
+        throw CompilationError(CompilationStep::GENERAL, "Snapshot file is truncated", fileName);
+    auto ptr = data + offset;
+    offset += numBytes;
+    return ptr;
+}
+
+bool SnapshotReader::isAtEnd() const noexcept
+{
+    return offset == size;
+}
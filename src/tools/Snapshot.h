@@ -0,0 +1,92 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+
+#ifndef VC4C_TOOLS_SNAPSHOT_H
+#define VC4C_TOOLS_SNAPSHOT_H
+
+#include "../SIMDVector.h"
+#include "../helper.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+
+namespace vc4c
+{
+    namespace tools
+    {
+        /*
+         * Writes the state of the emulator into a compact binary snapshot file.
+         *
+         * All values are written in host byte-order without any padding between them, so a snapshot can only be
+         * restored on a host with the same architecture. The data is written into a temporary file which only replaces
+         * the target file on #commit(), so an interrupted checkpoint never destroys the previous snapshot.
+         */
+        class SnapshotWriter : private NonCopyable
+        {
+        public:
+            explicit SnapshotWriter(const std::string& fileName);
+            ~SnapshotWriter() noexcept;
+
+            template <typename T>
+            void write(const T& value)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written");
+                writeBytes(&value, sizeof(T));
+            }
+
+            void write(const SIMDVector& vector);
+            void writeBytes(const void* data, std::size_t numBytes);
+
+            void commit();
+
+        private:
+            std::string fileName;
+            std::string temporaryFileName;
+            std::ofstream output;
+        };
+
+        /*
+         * Reads a snapshot file written by the SnapshotWriter.
+         *
+         * The file is memory-mapped, so large memory contents are copied directly from the page-cache into the
+         * emulated memory without any intermediate buffering.
+         */
+        class SnapshotReader : private NonCopyable
+        {
+        public:
+            explicit SnapshotReader(const std::string& fileName);
+            ~SnapshotReader() noexcept;
+
+            template <typename T>
+            T read()
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be read");
+                T value;
+                readBytes(&value, sizeof(T));
+                return value;
+            }
+
+            SIMDVector readVector();
+            void readBytes(void* output, std::size_t numBytes);
+            /*
+             * Returns a pointer to the given number of bytes directly in the mapped file and skips them
+             */
+            const uint8_t* readRaw(std::size_t numBytes);
+
+            bool isAtEnd() const noexcept;
+
+        private:
+            std::string fileName;
+            const uint8_t* data;
+            std::size_t size;
+            std::size_t offset;
+        };
+    } // namespace tools
+} // namespace vc4c
+
+#endif /* VC4C_TOOLS_SNAPSHOT_H */
@@ -0,0 +1,190 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+
+#include "Trace.h"
+
+#include "CompilationError.h"
+#include "log.h"
+
+#include <cerrno>
+#include <cstring>
+#include <map>
+
+using namespace vc4c;
+using namespace vc4c::tools;
+
+static constexpr uint64_t TRACE_MAGIC = 0x4543525443344356; /* "VC4CTRCE" */
+static constexpr uint32_t TRACE_VERSION = 3;
+static constexpr std::size_t TRACE_BUFFER_SIZE = 64 * 1024;
+
+std::string tools::toString(TraceEvent event)
+{
+    switch(event)
+    {
+    case TraceEvent::INSTRUCTION:
+        return "execute";
+    case TraceEvent::STALL_INSTRUCTION_FETCH:
+        return "stall (instruction fetch)";
+    case TraceEvent::STALL_UNIFORM:
+        return "stall (UNIFORM)";
+    case TraceEvent::STALL_TMU:
+        return "stall (TMU)";
+    case TraceEvent::STALL_VPM_DMA_READ:
+        return "stall (VPM DMA read)";
+    case TraceEvent::STALL_VPM_DMA_WRITE:
+        return "stall (VPM DMA write)";
+    case TraceEvent::STALL_MUTEX:
+        return "stall (mutex)";
+    case TraceEvent::STALL_SEMAPHORE:
+        return "stall (semaphore)";
+    case TraceEvent::TMU0_QUEUE:
+        return "TMU0 queue";
+    case TraceEvent::TMU1_QUEUE:
+        return "TMU1 queue";
+    case TraceEvent::VPM_READ_QUEUE:
+        return "VPM read queue";
+    case TraceEvent::VPM_DMA_READ:
+        return "VPM DMA read";
+    case TraceEvent::VPM_DMA_WRITE:
+        return "VPM DMA write";
+    case TraceEvent::SFU_START:
+        return "SFU";
+    case TraceEvent::MUTEX_ACQUIRE:
+        return "mutex acquire";
+    case TraceEvent::MUTEX_RELEASE:
+        return "mutex release";
+    case TraceEvent::SEMAPHORE_INCREMENT:
+        return "semaphore increment";
+    case TraceEvent::SEMAPHORE_DECREMENT:
+        return "semaphore decrement";
+    case TraceEvent::BRANCH:
+        return "branch";
+    case TraceEvent::THREAD_END:
+        return "thread end";
+    }
+    throw CompilationError(CompilationStep::GENERAL, "Unhandled trace event type",
+        std::to_string(static_cast<unsigned>(event)));
+}
+
+static bool isStateEvent(TraceEvent event) noexcept
+{
+    return event <= TraceEvent::STALL_SEMAPHORE;
+}
+
+TraceWriter::TraceWriter(const std::string& fileName) : fileName(fileName), file(fopen(fileName.data(), "wb"))
+{
+    if(!file)
+        throw CompilationError(CompilationStep::GENERAL, "Failed to open trace file", strerror(errno));
+    uint64_t header[2] = {TRACE_MAGIC, TRACE_VERSION};
+    fwrite(header, sizeof(header), 1, file);
+    buffer.reserve(TRACE_BUFFER_SIZE);
+}
+
+TraceWriter::~TraceWriter() noexcept
+{
+    flush();
+    fclose(file);
+    CPPLOG_LAZY(logging::Level::INFO, log << "Written execution trace to: " << fileName << logging::endl);
+}
+
+void TraceWriter::flush()
+{
+    if(!buffer.empty() && fwrite(buffer.data(), sizeof(TraceRecord), buffer.size(), file) != buffer.size())
+        CPPLOG_LAZY(logging::Level::WARNING, log << "Failed to write execution trace: " << fileName << logging::endl);
+    buffer.clear();
+}
+
+namespace
+{
+    /*
+     * The currently open slice of a single QPU
+     */
+    struct OpenSlice
+    {
+        TraceEvent event;
+        uint64_t startCycle;
+        uint64_t lastCycle;
+        uint32_t startPC;
+    };
+} // namespace
+
+static void writeSeparator(std::ostream& json, bool& isFirst)
+{
+    if(!isFirst)
+        json << ",\n";
+    isFirst = false;
+}
+
+static void writeSlice(std::ostream& json, bool& isFirst, uint8_t qpu, const OpenSlice& slice)
+{
+    writeSeparator(json, isFirst);
+    json << R"({"name":")" << toString(slice.event) << R"(","cat":"qpu","ph":"X","pid":0,"tid":)"
+         << static_cast<unsigned>(qpu) << R"(,"ts":)" << slice.startCycle
+         << R"(,"dur":)" << (slice.lastCycle - slice.startCycle + 1) << R"(,"args":{"pc":)" << slice.startPC << "}}";
+}
+
+void tools::convertTraceToJSON(std::istream& trace, std::ostream& json)
+{
+    uint64_t header[2] = {};
+    if(!trace.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != TRACE_MAGIC)
+        throw CompilationError(CompilationStep::GENERAL, "Input is not an emulator execution trace");
+    if(header[1] != TRACE_VERSION)
+        throw CompilationError(
+            CompilationStep::GENERAL, "Unsupported execution trace version", std::to_string(header[1]));
+
+    json << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool isFirst = true;
+    std::map<uint8_t, OpenSlice> openSlices;
+    std::vector<TraceRecord> records(TRACE_BUFFER_SIZE);
+    while(trace)
+    {
+        trace.read(reinterpret_cast<char*>(records.data()),
+            static_cast<std::streamsize>(records.size() * sizeof(TraceRecord)));
+        auto numRecords = static_cast<std::size_t>(trace.gcount()) / sizeof(TraceRecord);
+        for(std::size_t i = 0; i < numRecords; ++i)
+        {
+            const auto& record = records[i];
+            if(isStateEvent(record.event))
+            {
+                auto it = openSlices.find(record.qpu);
+                if(it == openSlices.end())
+                {
+                    // first event of this QPU
+                    writeSeparator(json, isFirst);
+                    json << R"({"name":"thread_name","ph":"M","pid":0,"tid":)" << static_cast<unsigned>(record.qpu)
+                         << R"(,"args":{"name":"QPU )" << static_cast<unsigned>(record.qpu) << "\"}}";
+                    openSlices.emplace(
+                        record.qpu, OpenSlice{record.event, record.cycle, record.cycle, record.pc});
+                }
+                else if(it->second.event == record.event && record.cycle <= it->second.lastCycle + 1)
+                    it->second.lastCycle = record.cycle;
+                else
+                {
+                    writeSlice(json, isFirst, record.qpu, it->second);
+                    it->second = OpenSlice{record.event, record.cycle, record.cycle, record.pc};
+                }
+            }
+            else if(record.event == TraceEvent::TMU0_QUEUE || record.event == TraceEvent::TMU1_QUEUE ||
+                record.event == TraceEvent::VPM_READ_QUEUE)
+            {
+                writeSeparator(json, isFirst);
+                json << R"({"name":")" << toString(record.event) << " QPU " << static_cast<unsigned>(record.qpu)
+                     << R"(","ph":"C","pid":0,"ts":)" << record.cycle << R"(,"args":{"entries":)" << record.data
+                     << "}}";
+            }
+            else
+            {
+                writeSeparator(json, isFirst);
+                json << R"({"name":")" << toString(record.event) << R"(","cat":"periphery","ph":"i","s":"t","pid":0,)"
+                     << R"("tid":)" << static_cast<unsigned>(record.qpu) << R"(,"ts":)" << record.cycle
+                     << R"(,"args":{"pc":)" << record.pc << R"(,"data":)" << record.data << "}}";
+            }
+        }
+    }
+    for(const auto& slice : openSlices)
+        writeSlice(json, isFirst, slice.first, slice.second);
+    json << "\n]}\n";
+}
@@ -0,0 +1,130 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+
+#ifndef VC4C_TOOLS_TRACE_H
+#define VC4C_TOOLS_TRACE_H
+
+#include "../helper.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace vc4c
+{
+    namespace tools
+    {
+        /*
+         * The type of an event recorded in the execution trace
+         */
+        enum class TraceEvent : uint8_t
+        {
+            /*
+             * The QPU executed the instruction at the given PC
+             */
+            INSTRUCTION,
+            /*
+             * The QPU stalled waiting for the given reason
+             */
+            STALL_INSTRUCTION_FETCH,
+            STALL_UNIFORM,
+            STALL_TMU,
+            STALL_VPM_DMA_READ,
+            STALL_VPM_DMA_WRITE,
+            STALL_MUTEX,
+            STALL_SEMAPHORE,
+            /*
+             * A request was added to or a response was taken from the TMU queue, the data is the new queue occupancy
+             */
+            TMU0_QUEUE,
+            TMU1_QUEUE,
+            /*
+             * The VPM generic read setup was written or a vector was read, the data is the number of vectors still
+             * queued for reading
+             */
+            VPM_READ_QUEUE,
+            /*
+             * A DMA transfer between VPM and memory was started, the data is the memory address
+             */
+            VPM_DMA_READ,
+            VPM_DMA_WRITE,
+            /*
+             * A SFU calculation was started
+             */
+            SFU_START,
+            MUTEX_ACQUIRE,
+            MUTEX_RELEASE,
+            /*
+             * The data is the index of the semaphore
+             */
+            SEMAPHORE_INCREMENT,
+            SEMAPHORE_DECREMENT,
+            /*
+             * A branch was taken, the data is the target PC
+             */
+            BRANCH,
+            THREAD_END
+        };
+
+        std::string toString(TraceEvent event);
+
+        /*
+         * A single record of the binary execution trace
+         */
+        struct TraceRecord
+        {
+            uint64_t cycle;
+            uint32_t pc;
+            uint32_t data;
+            uint8_t qpu;
+            TraceEvent event;
+            // explicitly zeroed, so records do not contain any uninitialized bytes
+            uint16_t padding;
+            uint32_t padding2;
+        };
+        static_assert(sizeof(TraceRecord) == 24, "Trace records are not packed");
+
+        /*
+         * Streams trace records into a binary file.
+         *
+         * The records are collected in a buffer and written in large blocks to keep the overhead of tracing low.
+         */
+        class TraceWriter : private NonCopyable
+        {
+        public:
+            explicit TraceWriter(const std::string& fileName);
+            ~TraceWriter() noexcept;
+
+            inline void write(const TraceRecord& record)
+            {
+                buffer.push_back(record);
+                if(buffer.size() == buffer.capacity())
+                    flush();
+            }
+
+            void flush();
+
+        private:
+            std::string fileName;
+            FILE* file;
+            std::vector<TraceRecord> buffer;
+        };
+
+        /*
+         * Converts the binary trace file into the JSON format of the Chrome trace event viewer (also supported by
+         * Perfetto).
+         *
+         * Consecutive cycles of a QPU executing instructions or stalling for the same reason are merged into a single
+         * slice, the TMU and VPM read queue occupancies are written as counters and all other events as instant
+         * events. One cycle is displayed as one microsecond.
+         */
+        void convertTraceToJSON(std::istream& trace, std::ostream& json);
+    } // namespace tools
+} // namespace vc4c
+
+#endif /* VC4C_TOOLS_TRACE_H */
@@ -0,0 +1,420 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+
+#include "Translator.h"
+
+#include "../Profiler.h"
+#include "../asm/ALUInstruction.h"
+#include "../asm/Instruction.h"
+#include "../asm/LoadInstruction.h"
+#include "../intermediate/IntermediateInstruction.h"
+#include "log.h"
+
+#include <algorithm>
+
+using namespace vc4c;
+using namespace vc4c::tools;
+
+static bool hasUndefinedElements(const SIMDVector& vector)
+{
+    return std::any_of(vector.begin(), vector.end(), [](Literal lit) -> bool { return lit.isUndefined(); });
+}
+
+static ElementFlags toFlags(uint32_t result, bool carry, bool overflow) noexcept
+{
+    ElementFlags flags;
+    flags.zero = result == 0 ? FlagStatus::SET : FlagStatus::CLEAR;
+    flags.negative = static_cast<int32_t>(result) < 0 ? FlagStatus::SET : FlagStatus::CLEAR;
+    flags.carry = carry ? FlagStatus::SET : FlagStatus::CLEAR;
+    flags.overflow = overflow ? FlagStatus::SET : FlagStatus::CLEAR;
+    return flags;
+}
+
+/*
+ * The native host implementations of the integer ALU operations.
+ *
+ * These need to calculate the exact same results and flags as the op-code precalculation (see OpCodes.cpp).
+ */
+namespace
+{
+    struct NativeAdd
+    {
+        uint32_t operator()(uint32_t a, uint32_t b, bool& carry, bool& overflow) const noexcept
+        {
+            auto signedVal =
+                static_cast<int64_t>(static_cast<int32_t>(a)) + static_cast<int64_t>(static_cast<int32_t>(b));
+            carry = (static_cast<uint64_t>(a) + static_cast<uint64_t>(b)) > uint64_t{0xFFFFFFFF};
+            overflow = signedVal > static_cast<int64_t>(std::numeric_limits<int32_t>::max()) ||
+                signedVal < static_cast<int64_t>(std::numeric_limits<int32_t>::min());
+            return a + b;
+        }
+    };
+
+    struct NativeSub
+    {
+        uint32_t operator()(uint32_t a, uint32_t b, bool& carry, bool& overflow) const noexcept
+        {
+            auto sa = static_cast<int32_t>(a);
+            auto sb = static_cast<int32_t>(b);
+            auto extendedVal = static_cast<int64_t>(sa) - static_cast<int64_t>(sb);
+            carry = (sa >= 0 && sb < 0 && extendedVal != 0) || (sa >= 0 && sb > 0 && extendedVal < 0) ||
+                (sa < 0 && sb < 0 && extendedVal < 0);
+            overflow = extendedVal > static_cast<int64_t>(std::numeric_limits<int32_t>::max()) ||
+                extendedVal < static_cast<int64_t>(std::numeric_limits<int32_t>::min());
+            return a - b;
+        }
+    };
+
+    struct NativeShr
+    {
+        uint32_t operator()(uint32_t a, uint32_t b, bool& carry, bool& /* overflow */) const noexcept
+        {
+            auto offset = b & 0x1F;
+            carry = offset != 0 && ((a >> (offset - 1)) & 1);
+            return a >> offset;
+        }
+    };
+
+    struct NativeAsr
+    {
+        uint32_t operator()(uint32_t a, uint32_t b, bool& carry, bool& /* overflow */) const noexcept
+        {
+            auto offset = b & 0x1F;
+            carry = offset != 0 && ((a >> (offset - 1)) & 1);
+            // the manual shifting is only required for hosts without arithmetic signed right shift
+            if((-1 >> 31u) == -1)
+                return static_cast<uint32_t>(static_cast<int32_t>(a) >> offset);
+            return offset == 0 ? a : ((a >> offset) | ((a & 0x80000000u) ? ~(0xFFFFFFFFu >> offset) : 0u));
+        }
+    };
+
+    struct NativeRor
+    {
+        uint32_t operator()(uint32_t a, uint32_t b, bool& /* carry */, bool& /* overflow */) const noexcept
+        {
+            auto offset = b & 0x1F;
+            return offset == 0 ? a : ((a >> offset) | (a << (32 - offset)));
+        }
+    };
+
+    struct NativeShl
+    {
+        uint32_t operator()(uint32_t a, uint32_t b, bool& carry, bool& /* overflow */) const noexcept
+        {
+            auto offset = b & 0x1F;
+            carry = (((static_cast<uint64_t>(a) << offset) >> 32) & 1) == 1;
+            return a << offset;
+        }
+    };
+
+    struct NativeMin
+    {
+        uint32_t operator()(uint32_t a, uint32_t b, bool& carry, bool& /* overflow */) const noexcept
+        {
+            carry = static_cast<int32_t>(a) > static_cast<int32_t>(b);
+            return carry ? b : a;
+        }
+    };
+
+    struct NativeMax
+    {
+        uint32_t operator()(uint32_t a, uint32_t b, bool& carry, bool& /* overflow */) const noexcept
+        {
+            carry = static_cast<int32_t>(a) > static_cast<int32_t>(b);
+            return carry ? a : b;
+        }
+    };
+
+    struct NativeAnd
+    {
+        uint32_t operator()(uint32_t a, uint32_t b, bool& /* carry */, bool& /* overflow */) const noexcept
+        {
+            return a & b;
+        }
+    };
+
+    struct NativeOr
+    {
+        uint32_t operator()(uint32_t a, uint32_t b, bool& /* carry */, bool& /* overflow */) const noexcept
+        {
+            return a | b;
+        }
+    };
+
+    struct NativeXor
+    {
+        uint32_t operator()(uint32_t a, uint32_t b, bool& /* carry */, bool& /* overflow */) const noexcept
+        {
+            return a ^ b;
+        }
+    };
+
+    struct NativeNot
+    {
+        uint32_t operator()(uint32_t a, uint32_t /* b */, bool& /* carry */, bool& /* overflow */) const noexcept
+        {
+            return ~a;
+        }
+    };
+
+    struct NativeMul24
+    {
+        uint32_t operator()(uint32_t a, uint32_t b, bool& carry, bool& /* overflow */) const noexcept
+        {
+            auto extendedVal = static_cast<uint64_t>(a & 0xFFFFFFu) * static_cast<uint64_t>(b & 0xFFFFFFu);
+            carry = extendedVal > static_cast<uint64_t>(0xFFFFFFFFul);
+            return (a & 0xFFFFFFu) * (b & 0xFFFFFFu);
+        }
+    };
+
+    struct NativeMove
+    {
+        uint32_t operator()(uint32_t a, uint32_t /* b */, bool& /* carry */, bool& /* overflow */) const noexcept
+        {
+            return a;
+        }
+    };
+} // namespace
+
+template <typename Operation>
+static bool calculateLanes(const OpCode& code, const SIMDVector& firstInput, const SIMDVector& secondInput,
+    SIMDVector& output, VectorFlags& flags)
+{
+    // undefined elements are resolved differently by the op-code calculation, so let the interpreter handle them
+    if(hasUndefinedElements(firstInput) || (code.numOperands > 1 && hasUndefinedElements(secondInput)))
+        return false;
+    Operation op{};
+    // fixed number of iterations without any branching, so the host compiler can fully unroll/vectorize this
+    for(uint8_t i = 0; i < NATIVE_VECTOR_SIZE; ++i)
+    {
+        bool carry = false;
+        bool overflow = false;
+        auto result = op(firstInput[i].unsignedInt(), secondInput[i].unsignedInt(), carry, overflow);
+        output[i] = Literal(result);
+        flags[i] = toFlags(result, carry, overflow);
+    }
+    return true;
+}
+
+static bool calculateGeneric(const OpCode& code, const SIMDVector& firstInput, const SIMDVector& secondInput,
+    SIMDVector& output, VectorFlags& flags)
+{
+    auto tmp = code(firstInput, secondInput);
+    if(!tmp.first || tmp.first->isUndefined())
+        return false;
+    output = std::move(tmp.first).value();
+    flags = tmp.second;
+    return true;
+}
+
+static LaneOperation toLaneOperation(const OpCode& code)
+{
+    if(code == OP_ADD)
+        return calculateLanes<NativeAdd>;
+    if(code == OP_SUB)
+        return calculateLanes<NativeSub>;
+    if(code == OP_SHR)
+        return calculateLanes<NativeShr>;
+    if(code == OP_ASR)
+        return calculateLanes<NativeAsr>;
+    if(code == OP_ROR)
+        return calculateLanes<NativeRor>;
+    if(code == OP_SHL)
+        return calculateLanes<NativeShl>;
+    if(code == OP_MIN)
+        return calculateLanes<NativeMin>;
+    if(code == OP_MAX)
+        return calculateLanes<NativeMax>;
+    if(code == OP_AND)
+        return calculateLanes<NativeAnd>;
+    if(code == OP_OR)
+        return calculateLanes<NativeOr>;
+    if(code == OP_XOR)
+        return calculateLanes<NativeXor>;
+    if(code == OP_NOT)
+        return calculateLanes<NativeNot>;
+    if(code == OP_MUL24)
+        return calculateLanes<NativeMul24>;
+    // all other (e.g. floating-point) operations use the more complex op-code calculation
+    return calculateGeneric;
+}
+
+static bool translateInput(TranslatedInput& input, InputMultiplex mux, const qpu_asm::ALUInstruction& inst)
+{
+    switch(mux)
+    {
+    case InputMultiplex::ACC0:
+        input.reg = REG_ACC0;
+        return true;
+    case InputMultiplex::ACC1:
+        input.reg = REG_ACC1;
+        return true;
+    case InputMultiplex::ACC2:
+        input.reg = REG_ACC2;
+        return true;
+    case InputMultiplex::ACC3:
+        input.reg = REG_ACC3;
+        return true;
+    case InputMultiplex::ACC4:
+        input.readsR4 = true;
+        return true;
+    case InputMultiplex::ACC5:
+        input.reg = REG_ACC5;
+        return true;
+    case InputMultiplex::REGA:
+        input.reg = Register{RegisterFile::PHYSICAL_A, inst.getInputA()};
+        // only physical registers are translated, all other registers access some periphery
+        return input.reg.isGeneralPurpose();
+    case InputMultiplex::REGB:
+        if(inst.getSig() == SIGNAL_ALU_IMMEDIATE)
+        {
+            auto lit = SmallImmediate{inst.getInputB()}.toLiteral();
+            if(!lit)
+                return false;
+            input.reg = REG_NOP;
+            input.constant = SIMDVector(*lit);
+            return true;
+        }
+        input.reg = Register{RegisterFile::PHYSICAL_B, inst.getInputB()};
+        return input.reg.isGeneralPurpose();
+    }
+    return false;
+}
+
+static bool isTranslatableOutput(Register reg)
+{
+    // physical registers, r0 to r3 and the NOP register. Writing r4 (TMU no-swap) or r5 (replication) have side-effects
+    return reg.isGeneralPurpose() || (reg.isAccumulator() && reg.num < REG_TMU_NOSWAP.num) || reg.num == REG_NOP.num;
+}
+
+static bool translateOperation(TranslatedOperation& op, const OpCode& code, ConditionCode cond, Register output,
+    InputMultiplex muxA, InputMultiplex muxB, const qpu_asm::ALUInstruction& inst)
+{
+    op.output = output;
+    op.condition = cond;
+    if(cond == COND_NEVER || code == OP_NOP)
+        // operation is not executed at all
+        return true;
+    if(!isTranslatableOutput(output))
+        return false;
+    if(!translateInput(op.firstInput, muxA, inst))
+        return false;
+    if(code.numOperands > 1 && !translateInput(op.secondInput, muxB, inst))
+        return false;
+    op.code = &code;
+    op.operation = toLaneOperation(code);
+    return true;
+}
+
+static bool translateALU(TranslatedInstruction& result, const qpu_asm::ALUInstruction& inst)
+{
+    if(inst.getSig() != SIGNAL_NONE && inst.getSig() != SIGNAL_ALU_IMMEDIATE)
+        return false;
+    if(inst.getPack().hasEffect() || inst.getUnpack().hasEffect())
+        return false;
+    if(inst.getSig() == SIGNAL_ALU_IMMEDIATE && SmallImmediate{inst.getInputB()}.isVectorRotation())
+        return false;
+
+    const OpCode& addCode = OpCode::toOpCode(inst.getAddition(), false);
+    const OpCode& mulCode = OpCode::toOpCode(inst.getMultiplication(), true);
+    auto addOut = Register{
+        inst.getWriteSwap() == WriteSwap::SWAP ? RegisterFile::PHYSICAL_B : RegisterFile::PHYSICAL_A, inst.getAddOut()};
+    auto mulOut = Register{inst.getWriteSwap() == WriteSwap::DONT_SWAP ? RegisterFile::PHYSICAL_B :
+                                                                         RegisterFile::PHYSICAL_A,
+        inst.getMulOut()};
+
+    if(!translateOperation(result.addOperation, addCode, inst.getAddCondition(), addOut, inst.getAddMultiplexA(),
+           inst.getAddMultiplexB(), inst))
+        return false;
+    if(!translateOperation(result.mulOperation, mulCode, inst.getMulCondition(), mulOut, inst.getMulMultiplexA(),
+           inst.getMulMultiplexB(), inst))
+        return false;
+    result.addOperation.setsFlags = inst.getSetFlag() == SetFlag::SET_FLAGS;
+    result.mulOperation.setsFlags =
+        inst.getSetFlag() == SetFlag::SET_FLAGS && isFlagSetByMulALU(inst.getAddition(), inst.getMultiplication());
+    return true;
+}
+
+static bool translateLoad(TranslatedInstruction& result, const qpu_asm::LoadInstruction& inst)
+{
+    if(inst.getPack().hasEffect())
+        return false;
+
+    SIMDVector loadedValues;
+    switch(inst.getType())
+    {
+    case OpLoad::LOAD_IMM_32:
+        loadedValues = SIMDVector(Literal(inst.getImmediateInt()));
+        break;
+    case OpLoad::LOAD_SIGNED:
+        loadedValues = intermediate::LoadImmediate::toLoadedValues(
+            inst.getImmediateInt(), intermediate::LoadType::PER_ELEMENT_SIGNED);
+        break;
+    case OpLoad::LOAD_UNSIGNED:
+        loadedValues = intermediate::LoadImmediate::toLoadedValues(
+            inst.getImmediateInt(), intermediate::LoadType::PER_ELEMENT_UNSIGNED);
+        break;
+    default:
+        return false;
+    }
+
+    auto addOut = Register{
+        inst.getWriteSwap() == WriteSwap::SWAP ? RegisterFile::PHYSICAL_B : RegisterFile::PHYSICAL_A, inst.getAddOut()};
+    auto mulOut = Register{inst.getWriteSwap() == WriteSwap::DONT_SWAP ? RegisterFile::PHYSICAL_B :
+                                                                         RegisterFile::PHYSICAL_A,
+        inst.getMulOut()};
+    if(!isTranslatableOutput(addOut) || !isTranslatableOutput(mulOut))
+        return false;
+
+    result.isLoadImmediate = true;
+    for(auto op : {&result.addOperation, &result.mulOperation})
+    {
+        op->code = &OP_OR;
+        op->operation = calculateLanes<NativeMove>;
+        op->firstInput.constant = loadedValues;
+        op->secondInput.constant = loadedValues;
+    }
+    result.addOperation.output = addOut;
+    result.addOperation.condition = inst.getAddCondition();
+    result.mulOperation.output = mulOut;
+    result.mulOperation.condition = inst.getMulCondition();
+    // the flags are set once after both values are written, depending on the add condition if set
+    result.addOperation.setsFlags = inst.getSetFlag() == SetFlag::SET_FLAGS && inst.getAddCondition() != COND_NEVER;
+    result.mulOperation.setsFlags = inst.getSetFlag() == SetFlag::SET_FLAGS && inst.getAddCondition() == COND_NEVER;
+    return true;
+}
+
+TranslatedCode tools::translateCode(std::vector<qpu_asm::Instruction>::const_iterator begin,
+    std::vector<qpu_asm::Instruction>::const_iterator end)
+{
+    PROFILE_SCOPE(TranslateCode);
+    TranslatedCode code;
+    code.reserve(static_cast<std::size_t>(std::distance(begin, end)));
+    std::size_t numTranslated = 0;
+    for(auto it = begin; it != end; ++it)
+    {
+        TranslatedInstruction result;
+        if(auto alu = it->as<qpu_asm::ALUInstruction>())
+            result.isTranslated = translateALU(result, *alu);
+        else if(auto load = it->as<qpu_asm::LoadInstruction>())
+            result.isTranslated = translateLoad(result, *load);
+        // branches, semaphores and all other signals are always executed by the interpreter
+
+        if(result.isTranslated)
+        {
+            ++numTranslated;
+            code.emplace_back(std::move(result));
+        }
+        else
+            // drop any partial translation
+            code.emplace_back();
+        code.back().binaryCode = it->toBinaryCode();
+    }
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Translated " << numTranslated << " of " << code.size() << " instructions into host code"
+            << logging::endl);
+    return code;
+}
@@ -0,0 +1,112 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+
+#ifndef VC4C_TOOLS_TRANSLATOR_H
+#define VC4C_TOOLS_TRANSLATOR_H
+
+#include "../Register.h"
+#include "../SIMDVector.h"
+#include "../asm/OpCodes.h"
+#include "../helper.h"
+
+#include <vector>
+
+namespace vc4c
+{
+    namespace qpu_asm
+    {
+        class Instruction;
+    } // namespace qpu_asm
+
+    namespace tools
+    {
+        /*
+         * Calculates a single ALU operation for all 16 SIMD elements at once.
+         *
+         * Returns whether the result could be calculated. If not, the instruction needs to be executed by the
+         * interpreter instead.
+         */
+        using LaneOperation = FunctionPointer<bool(const OpCode& code, const SIMDVector& firstInput,
+            const SIMDVector& secondInput, SIMDVector& output, VectorFlags& flags)>;
+
+        /*
+         * The pre-decoded source of a translated ALU operand
+         */
+        struct TranslatedInput
+        {
+            /*
+             * The register to read, REG_NOP if the constant value is used instead
+             */
+            Register reg = REG_NOP;
+            /*
+             * Whether to read the r4 register (the result of the last SFU/TMU access)
+             */
+            bool readsR4 = false;
+            /*
+             * The constant value (small immediate or loaded immediate), only valid if no register is read
+             */
+            SIMDVector constant;
+        };
+
+        /*
+         * A single pre-decoded operation of the add or mul ALU
+         */
+        struct TranslatedOperation
+        {
+            /*
+             * The op-code to execute, nullptr if the ALU does not execute anything in this instruction
+             */
+            const OpCode* code = nullptr;
+            /*
+             * The host function calculating the operation
+             */
+            LaneOperation operation = nullptr;
+            TranslatedInput firstInput;
+            TranslatedInput secondInput;
+            Register output = REG_NOP;
+            ConditionCode condition = COND_NEVER;
+            bool setsFlags = false;
+        };
+
+        /*
+         * A single QPU instruction translated ahead-of-time into host code.
+         *
+         * Only instructions which access no periphery (e.g. pure ALU instructions and load immediates operating on
+         * accumulators and physical registers) are translated, all other instructions are executed by the interpreter.
+         */
+        struct TranslatedInstruction
+        {
+            /*
+             * The machine code of the original instruction
+             */
+            uint64_t binaryCode = 0;
+            /*
+             * Whether the instruction has been translated into host code
+             */
+            bool isTranslated = false;
+            /*
+             * Whether the instruction is a load immediate instruction, which writes the same value into both outputs
+             * before setting the flags
+             */
+            bool isLoadImmediate = false;
+            TranslatedOperation addOperation;
+            TranslatedOperation mulOperation;
+        };
+
+        using TranslatedCode = std::vector<TranslatedInstruction>;
+
+        /*
+         * Translates the given range of instructions into host code.
+         *
+         * The resulting list contains exactly one entry per instruction, indexed by the program counter (relative to
+         * the first instruction given).
+         */
+        TranslatedCode translateCode(std::vector<qpu_asm::Instruction>::const_iterator begin,
+            std::vector<qpu_asm::Instruction>::const_iterator end);
+    } // namespace tools
+} // namespace vc4c
+
+#endif /* VC4C_TOOLS_TRANSLATOR_H */
@@ -129,6 +129,11 @@ bool tools::parseConfigurationParameter(Configuration& config, const std::string
         config.stopWhenVerificationFailed = false;
         return true;
     }
+    if(arg.find("--profile-map=") == 0)
+    {
+        config.profileMappingFile = arg.substr(std::string("--profile-map=").size());
+        return true;
+    }
 
     std::string passName;
     if(arg.find("--fno-") == 0)
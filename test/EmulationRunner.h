@@ -16,15 +16,34 @@
 class EmulationRunner : public test_data::TestRunner, protected TestCompilationHelper
 {
 public:
-    explicit EmulationRunner(
-        const vc4c::Configuration& config, vc4c::FastMap<std::string, vc4c::CompilationData>& cache) :
+    explicit EmulationRunner(const vc4c::Configuration& config,
+        vc4c::FastMap<std::string, vc4c::CompilationData>& cache, bool translateCode = false,
+        bool useHostBuffers = false) :
         TestCompilationHelper(config),
-        compilationCache(cache)
+        compilationCache(cache), useHostBuffers(useHostBuffers)
     {
+        currentData.translateCode = translateCode;
     }
 
     ~EmulationRunner() noexcept override;
 
+    void setSnapshots(const std::string& snapshotFile, uint32_t interval, const std::string& restoreFile)
+    {
+        currentData.snapshotFile = snapshotFile;
+        currentData.snapshotInterval = interval;
+        currentData.restoreSnapshot = restoreFile;
+    }
+
+    void setTraceFile(const std::string& traceFile)
+    {
+        currentData.traceFile = traceFile;
+    }
+
+    const vc4c::tools::EmulationResult* getResult() const
+    {
+        return currentResult.get();
+    }
+
     test_data::Result compile(
         const std::string& sourceCode, const std::string& options, const std::string& name) override
     try
@@ -49,6 +68,8 @@ public:
         currentData.kernelName = name;
         // reset kernel configuration
         currentData.parameter.clear();
+        currentData.hostBuffers.clear();
+        hostBuffers.clear();
         currentData.workGroup = {};
         return test_data::RESULT_OK;
     }
@@ -72,7 +93,15 @@ public:
             auto bufferSize = numBytes / sizeof(uint32_t) + (numBytes % sizeof(uint32_t) != 0 ? 1 : 0);
             std::vector<uint32_t> tmp(bufferSize, 0x42424242);
             std::memcpy(tmp.data(), byteData, numBytes);
-            currentData.parameter[index] = std::make_pair(0, std::move(tmp));
+            if(useHostBuffers)
+            {
+                auto& buffer = hostBuffers[index] = std::move(tmp);
+                currentData.hostBuffers[index] = vc4c::tools::HostBuffer{
+                    reinterpret_cast<uint8_t*>(buffer.data()), buffer.size() * sizeof(uint32_t)};
+                currentData.parameter[index] = std::make_pair(0, vc4c::Optional<std::vector<uint32_t>>{});
+            }
+            else
+                currentData.parameter[index] = std::make_pair(0, std::move(tmp));
         }
         return test_data::RESULT_OK;
     }
@@ -104,7 +133,11 @@ public:
         if(!currentResult || index >= currentResult->results.size())
             return test_data::Result{false, "Argument index out of bounds!"};
         auto& arg = currentResult->results[index];
-        if(arg.second)
+        auto hostIt = hostBuffers.find(index);
+        if(hostIt != hostBuffers.end())
+            std::memcpy(
+                byteData, hostIt->second.data(), std::min(hostIt->second.size() * sizeof(uint32_t), bufferSize));
+        else if(arg.second)
         {
             const auto& vector = arg.second.value();
             std::memcpy(byteData, vector.data(), std::min(vector.size() * sizeof(uint32_t), bufferSize));
@@ -124,6 +157,9 @@ protected:
     vc4c::tools::EmulationData currentData;
     std::unique_ptr<vc4c::tools::EmulationResult> currentResult;
     vc4c::FastMap<std::string, vc4c::CompilationData>& compilationCache;
+    bool useHostBuffers;
+    // the buffers mapped directly into the emulated memory
+    std::map<std::size_t, std::vector<uint32_t>> hostBuffers;
 };
 
 #endif /* VC4C_TEST_EMULATION_RUNNER_H */
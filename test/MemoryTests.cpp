@@ -200,6 +200,52 @@ __kernel void test(const __global TYPE* in, __global STORAGE* out, __global STOR
         out16[i + k] = data[k] + 1;
 })";
 
+static const std::string TILE_ROWS = R"(
+#ifndef PITCH
+#define PITCH pitch
+#endif
+
+__kernel void test(__global uint4* data, const uint pitch) {
+  size_t gid = get_global_id(0);
+  // the unrolled reads of a column of 4 rows can be combined into a single DMA read with pitch
+  __global uint4* src = data + gid;
+  uint4 row0 = src[0];
+  uint4 row1 = src[PITCH];
+  uint4 row2 = src[2 * PITCH];
+  uint4 row3 = src[3 * PITCH];
+  // as well as the unrolled writes of the 4 rows below
+  __global uint4* dst = data + 4 * PITCH + gid;
+  dst[0] = row0 + 1;
+  dst[PITCH] = row1 + 2;
+  dst[2 * PITCH] = row2 + 3;
+  dst[3 * PITCH] = row3 + 4;
+}
+)";
+
+static const std::string LOOP_DMA = R"(
+__kernel void test(__global uint16* restrict out, __global uint16* in, const uint count) {
+  size_t gid = get_global_id(0);
+  // the read of the next row and the write of the previous row can be executed asynchronously to the loop body
+  for(uint i = 0; i < count; ++i) {
+    uint16 val = in[gid * count + i];
+    out[gid * count + i] = val * 2 + (uint16)(i);
+  }
+  // makes sure the input is read via DMA and not via TMU
+  in[gid * count] = (uint16)(0);
+}
+
+// only with a single work-item per work-group, the mutex can be held for the whole loop without stalling other QPUs
+__attribute__((reqd_work_group_size(1, 1, 1)))
+__kernel void test_single(__global uint16* restrict out, __global uint16* in, const uint count) {
+  size_t gid = get_global_id(0);
+  for(uint i = 0; i < count; ++i) {
+    uint16 val = in[gid * count + i];
+    out[gid * count + i] = val * 2 + (uint16)(i);
+  }
+  in[gid * count] = (uint16)(0);
+}
+)";
+
 template <typename T, T divisor>
 static bool checkIsMultipleOf(T val, std::size_t index)
 {
@@ -253,6 +299,25 @@ static std::vector<T> maskOffOddEntries(const std::vector<T>& input, std::size_t
     return result;
 }
 
+static std::vector<uint32_t> toLoopDMAResult(uint32_t numWorkItems, uint32_t count)
+{
+    // every work-item writes count rows of 16 elements
+    auto result = test_data::toRange<uint32_t>(0, numWorkItems * count * 16);
+    for(auto i = 0u; i < result.size(); ++i)
+        result[i] = result[i] * 2 + (i / 16) % count;
+    return result;
+}
+
+static std::vector<uint32_t> toTileRowsResult(uint32_t pitch)
+{
+    // 8 rows of pitch uint4 columns each, the lower 4 rows are the upper 4 rows incremented by their row index + 1
+    const auto rowSize = 4 * pitch;
+    auto result = test_data::toRange<uint32_t>(0, 8 * rowSize);
+    for(auto i = 4 * rowSize; i < result.size(); ++i)
+        result[i] = result[i - 4 * rowSize] + (i / rowSize) - 3;
+    return result;
+}
+
 template <typename T>
 static void registerPrivateAliasingTests(const std::string& typeName)
 {
@@ -413,6 +478,39 @@ void test_data::registerMemoryTests()
             {0x0FF00001, 0x0FF00003, 0x0FF00005, 0x0FF00007, 0x0FF00009, 0x0FF0000B, 0x0FF0000D, 0x0FF0000F});
     }
 
+    for(std::string type : {"constant", "dynamic"})
+    {
+        // the pitch is the number of uint4 columns, i.e. the number of work-items
+        TestDataBuilder<Buffer<uint32_t>, uint32_t> builder("tile_rows_" + type + "_pitch", TILE_ROWS, "test",
+            type == "constant" ? "-DPITCH=8" : "");
+        builder.setFlags(DataFilter::MEMORY_ACCESS);
+        builder.setDimensions(8);
+        builder.setParameter<0>(toRange<uint32_t>(0, 8 * 4 * 8));
+        builder.setParameter<1>(8);
+        builder.checkParameterEquals<0>(toTileRowsResult(8));
+    }
+
+    {
+        TestDataBuilder<Buffer<uint32_t>, Buffer<uint32_t>, uint32_t> builder("loop_dma", LOOP_DMA, "test");
+        builder.setFlags(DataFilter::MEMORY_ACCESS);
+        builder.setDimensions(4);
+        builder.allocateParameter<0>(4 * 8 * 16, 0x42);
+        builder.setParameter<1>(toRange<uint32_t>(0, 4 * 8 * 16));
+        builder.setParameter<2>(8);
+        builder.checkParameterEquals<0>(toLoopDMAResult(4, 8));
+    }
+
+    {
+        TestDataBuilder<Buffer<uint32_t>, Buffer<uint32_t>, uint32_t> builder(
+            "loop_dma_single", LOOP_DMA, "test_single");
+        builder.setFlags(DataFilter::MEMORY_ACCESS);
+        builder.setDimensions(1, 1, 1, 4);
+        builder.allocateParameter<0>(4 * 8 * 16, 0x42);
+        builder.setParameter<1>(toRange<uint32_t>(0, 4 * 8 * 16));
+        builder.setParameter<2>(8);
+        builder.checkParameterEquals<0>(toLoopDMAResult(4, 8));
+    }
+
     for(std::string type : {"", "dynamic_offset", "static_offset"})
     {
         auto suffix = type.empty() ? "" : ("_" + type);
@@ -655,6 +753,16 @@ void test_data::registerMemoryTests()
         builder.checkParameterEquals<2>({0x42, 0x17 + 42});
     }
 
+    {
+        TestDataBuilder<Buffer<uint32_t>, Buffer<uint32_t>> builder(
+            "constant_table_loop", test_constant_load_cl_string, "test_constant_table");
+        builder.setFlags(DataFilter::MEMORY_ACCESS);
+        builder.setDimensions(12);
+        builder.allocateParameter<0>(12, 0x42);
+        builder.setParameter<1>({1, 2, 3, 4, 5, 6, 7, 1, 2, 3, 4, 5});
+        builder.checkParameterEquals<0>({3, 55, 156, 306, 505, 753, 826, 52, 153, 303, 502, 750});
+    }
+
     {
         TestDataBuilder<int32_t, Buffer<int32_t>> builder("global_data", test_other_cl_string, "test_global_data");
         builder.setFlags(DataFilter::MEMORY_ACCESS | DataFilter::ASYNC_BARRIER);
@@ -691,6 +799,26 @@ void test_data::registerMemoryTests()
         builder.checkParameterMatches<1>(24, checkIsMultipleOf<uint32_t, 7u>, "7 divides value");
     }
 
+    {
+        TestDataBuilder<Buffer<int32_t>, Buffer<int32_t>> builder(
+            "local_storage_sections", local_private_storage_cl_string, "test_local_storage_sections");
+        builder.setFlags(DataFilter::MEMORY_ACCESS | DataFilter::ASYNC_BARRIER);
+        builder.setDimensions(12);
+        builder.setParameter<0>(toRange<int32_t>(0, 12));
+        builder.allocateParameter<1>(12, 0x42);
+        builder.checkParameterEquals<1>({63, 57, 51, 45, 39, 33, 27, 21, 15, 9, 3, 3});
+    }
+
+    {
+        TestDataBuilder<Buffer<uint32_t>, Buffer<uint32_t>> builder(
+            "local_dependent_index", local_private_storage_cl_string, "test_local_dependent_index");
+        builder.setFlags(DataFilter::MEMORY_ACCESS | DataFilter::ASYNC_BARRIER);
+        builder.setDimensions(12);
+        builder.setParameter<0>(toRange<uint32_t>(100, 112));
+        builder.allocateParameter<1>(12, 0x42);
+        builder.checkParameterEquals<1>({300, 315, 330, 309, 324, 303, 318, 333, 312, 327, 306, 321});
+    }
+
     {
         TestDataBuilder<Buffer<uint32_t>, Buffer<uint32_t>> builder(
             "private_storage", local_private_storage_cl_string, "test_private_storage");
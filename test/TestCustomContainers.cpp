@@ -6,6 +6,7 @@
 
 #include "TestCustomContainers.h"
 
+#include "tools/PrefixTrie.h"
 #include "tools/SmallMap.h"
 #include "tools/SmallSet.h"
 
@@ -18,6 +19,8 @@ TestCustomContainers::TestCustomContainers()
 
     TEST_ADD(TestCustomContainers::testFixedSortedPointerSet);
     TEST_ADD(TestCustomContainers::testSmallSortedPointerSet);
+
+    TEST_ADD(TestCustomContainers::testPrefixTrie);
 }
 
 TestCustomContainers::~TestCustomContainers() = default;
@@ -373,6 +376,32 @@ void TestCustomContainers::testSmallSortedPointerSet()
     TEST_ASSERT(hasSameSetContent(reference, set0));
 }
 
+void TestCustomContainers::testPrefixTrie()
+{
+    PrefixTrie<int> trie = {{"fmax", 1}, {"fmaxabs", 2}, {"fmin", 3}, {"max", 4}, {"fmax", 5}};
+    // duplicate keys are ignored
+    TEST_ASSERT_EQUALS(4u, trie.size());
+
+    auto result = trie.findLongestPrefix("fmaxabsff");
+    TEST_ASSERT(result.first != nullptr);
+    TEST_ASSERT_EQUALS(2, *result.first);
+    TEST_ASSERT_EQUALS(7u, result.second);
+
+    result = trie.findLongestPrefix("fmaxaff");
+    TEST_ASSERT(result.first != nullptr);
+    TEST_ASSERT_EQUALS(1, *result.first);
+    TEST_ASSERT_EQUALS(4u, result.second);
+
+    result = trie.findLongestPrefix("_Z4fminff", 3);
+    TEST_ASSERT(result.first != nullptr);
+    TEST_ASSERT_EQUALS(3, *result.first);
+
+    TEST_ASSERT(trie.findLongestPrefix("_Z4fminff").first == nullptr);
+    TEST_ASSERT(trie.findLongestPrefix("fma").first == nullptr);
+    TEST_ASSERT(trie.findLongestPrefix("").first == nullptr);
+    TEST_ASSERT(trie.findLongestPrefix("max", 10).first == nullptr);
+}
+
 template <typename T, typename U>
 static bool hasSameMapContent(const T& first, const U& second)
 {
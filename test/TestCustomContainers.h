@@ -20,6 +20,8 @@ public:
     
     void testFixedSortedPointerSet();
     void testSmallSortedPointerSet();
+
+    void testPrefixTrie();
 };
 
 #endif /* VC4C_TEST_CUSTOM_CONTAINERS_H */
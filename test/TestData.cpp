@@ -387,6 +387,26 @@ void test_data::registerGeneralTests()
             {11, 0x1F1F1F1F1F1F, 17 + 0x1234500000000, 0x12345 + 0x1234500000000, 0x42 + 0x0FFF0000FFFF0000, 42});
     }
 
+    {
+        TestDataBuilder<Buffer<int32_t>, Buffer<int32_t>> builder(
+            "conditional_diamond", test_branches_cl_string, "test_conditional_diamond");
+        builder.setFlags(DataFilter::CONTROL_FLOW);
+        builder.setDimensions(8);
+        builder.setParameter<0>({0, 1, 7, 20, -3, 100, 13, 42});
+        builder.allocateParameter<1>(8, 0x42);
+        builder.checkParameterEquals<1>({18018, 1002, 17000, 66060, -12994, 306006, 35020, 132024});
+    }
+
+    {
+        TestDataBuilder<Buffer<int32_t>, Buffer<int32_t>> builder(
+            "conditional_triangle", test_branches_cl_string, "test_conditional_triangle");
+        builder.setFlags(DataFilter::CONTROL_FLOW);
+        builder.setDimensions(8);
+        builder.setParameter<0>({0, 1, 7, 20, -3, 100, 13, 42});
+        builder.allocateParameter<1>(8, 0x42);
+        builder.checkParameterEquals<1>({8, 1009, 11017, 9023, -2988, 34042, 18028, 21027});
+    }
+
     {
         TestDataBuilder<Buffer<int32_t>, Buffer<int32_t>> builder(
             "expect_assume", test_expect_assume_cl_string, "test_expect_assume");
@@ -787,6 +807,114 @@ void test_data::registerGeneralTests()
         builder.checkParameterEquals<1>({324088});
     }
 
+    {
+        TestDataBuilder<Buffer<int32_t>, Buffer<int32_t>, Buffer<int32_t>> builder(
+            "vectorization20", test_vectorization_cl_string, "test20");
+        builder.setFlags(DataFilter::WORK_GROUP);
+        builder.setDimensions(16, 1, 1, 2);
+        builder.allocateParameterRange<0>(0, 32);
+        builder.allocateParameterRange<1>(1, 33);
+        builder.allocateParameter<2>(32, 0x42);
+        builder.checkParameterEquals<2>({0, 3, 8, 15, 24, 35, 48, 63, 80, 99, 120, 143, 168, 195, 224, 255,
+            288, 323, 360, 399, 440, 483, 528, 575, 624, 675, 728, 783, 840, 899, 960, 1023});
+    }
+
+    {
+        TestDataBuilder<Buffer<int32_t>, Buffer<int32_t>> builder(
+            "vectorization20_divergent", test_vectorization_cl_string, "test20_divergent");
+        builder.setFlags(DataFilter::WORK_GROUP | DataFilter::CONTROL_FLOW);
+        builder.setDimensions(8, 1, 1, 2);
+        builder.allocateParameterRange<0>(0, 16);
+        builder.allocateParameter<1>(16, 0x42);
+        builder.checkParameterEquals<1>({0, 1, 3, 3, 4, 5, 6, 7, 36, 45, 55, 11, 12, 13, 14, 15});
+    }
+
+    {
+        std::vector<int32_t> result(512, 0x42);
+        for(int32_t i = 0; i < 256; ++i)
+            result[static_cast<std::size_t>(i * 2)] = i * 3 + 1;
+        TestDataBuilder<Buffer<int32_t>, Buffer<int32_t>> builder(
+            "vectorization21", test_vectorization_cl_string, "test21");
+        builder.setFlags(DataFilter::CONTROL_FLOW | DataFilter::MEMORY_ACCESS | DataFilter::SPIRV_DISABLED);
+        builder.allocateParameterRange<0>(0, 768);
+        builder.allocateParameter<1>(512, 0x42);
+        builder.checkParameterEquals<1>(std::move(result));
+    }
+
+    {
+        std::vector<int32_t> result(256);
+        for(int32_t i = 0; i < 256; ++i)
+            result[static_cast<std::size_t>(i)] = 100 + (i % 16) + i;
+        TestDataBuilder<Buffer<int32_t>, Buffer<int32_t>, Buffer<int32_t>> builder(
+            "vectorization22", test_vectorization_cl_string, "test22");
+        builder.setFlags(DataFilter::CONTROL_FLOW | DataFilter::MEMORY_ACCESS | DataFilter::SPIRV_DISABLED);
+        builder.allocateParameterRange<0>(0, 256);
+        builder.allocateParameterRange<1>(100, 116);
+        builder.allocateParameter<2>(256, 0x42);
+        builder.checkParameterEquals<2>(std::move(result));
+    }
+
+    {
+        int32_t hash = 0x12345678;
+        int32_t mask = 0;
+        for(int32_t i = -100; i < 156; ++i)
+        {
+            hash ^= i;
+            mask |= i;
+        }
+        TestDataBuilder<Buffer<int32_t>, Buffer<int32_t>> builder(
+            "vectorization23", test_vectorization_cl_string, "test23");
+        builder.setFlags(DataFilter::CONTROL_FLOW | DataFilter::SPIRV_DISABLED);
+        builder.allocateParameterRange<0>(-100, 156);
+        builder.allocateParameter<1>(4, 0x42);
+        builder.checkParameterEquals<1>({-100, 155, hash, mask});
+    }
+
+    {
+        TestDataBuilder<Buffer<float>, Buffer<float>, Buffer<float>> builder(
+            "vectorization24", test_vectorization_cl_string, "test24");
+        builder.setFlags(DataFilter::CONTROL_FLOW | DataFilter::FLOAT_ARITHMETIC | DataFilter::SPIRV_DISABLED);
+        builder.allocateParameterRange<0>(0.0f, 256.0f);
+        builder.allocateParameter<1>(256, 0.5f);
+        builder.allocateParameter<2>(1, 0.0f);
+        builder.checkParameterEquals<2>({(255.0f * 256.0f) / 4.0f});
+    }
+
+    {
+        std::vector<int32_t> result(257);
+        for(int32_t i = 0; i < 256; ++i)
+            result[static_cast<std::size_t>(i)] = (i * (i + 1)) / 2;
+        result[256] = (255 * 256) / 2;
+        TestDataBuilder<Buffer<int32_t>, Buffer<int32_t>> builder(
+            "vectorization25", test_vectorization_cl_string, "test25");
+        builder.setFlags(DataFilter::CONTROL_FLOW | DataFilter::SPIRV_DISABLED);
+        builder.allocateParameterRange<0>(0, 256);
+        builder.allocateParameter<1>(257, 0x42);
+        builder.checkParameterEquals<1>(std::move(result));
+    }
+
+    {
+        std::vector<int32_t> result(259);
+        int32_t sum = 7;
+        int32_t mask = 7;
+        for(int32_t i = 0; i < 256; ++i)
+        {
+            sum += i - 100;
+            mask |= i - 100;
+            result[static_cast<std::size_t>(i)] = sum;
+        }
+        result[256] = 156;
+        result[257] = mask;
+        result[258] = sum;
+        TestDataBuilder<Buffer<int32_t>, Buffer<int32_t>, int32_t> builder(
+            "vectorization26", test_vectorization_cl_string, "test26");
+        builder.setFlags(DataFilter::CONTROL_FLOW | DataFilter::SPIRV_DISABLED);
+        builder.allocateParameterRange<0>(-100, 157);
+        builder.allocateParameter<1>(259, 0x42);
+        builder.setParameter<2>(7);
+        builder.checkParameterEquals<1>(std::move(result));
+    }
+
     {
         TestDataBuilder<Buffer<uint32_t>> builder("work_item", test_work_item_cl_string, "test_work_item");
         builder.setFlags(DataFilter::WORK_GROUP);
@@ -7,19 +7,44 @@
 #include "TestEmulator.h"
 
 #include "../src/Profiler.h"
+#include "../src/precompilation/FrontendCompiler.h"
+#include "../src/tools/Emulator.h"
+#include "../src/tools/Profile.h"
+#include "../src/tools/Trace.h"
 #include "EmulationRunner.h"
 #include "helper.h"
 
 #include "TestData.h"
 
 #include <cstring>
+#include <fstream>
 #include <numeric>
+#include <sstream>
 
 using namespace vc4c;
 using namespace vc4c::tools;
 
 auto defaultFilter = test_data::DataFilter::DISABLED | test_data::DataFilter::VECTOR_PARAM;
 
+/*
+ * The TMU texture lookups are only used by VC4CLStdLib versions whose read_imagef() calls the vc4cl_image_read()
+ * intrinsic, so check the std-lib image header for it
+ */
+static bool hasTextureReadIntrinsic()
+{
+    const auto& mainHeader = precompilation::findStandardLibraryFiles().mainHeader;
+    if(mainHeader.empty())
+        return false;
+    std::ifstream imagesHeader(mainHeader.substr(0, mainHeader.find_last_of('/') + 1) + "_images.h");
+    std::string line;
+    while(std::getline(imagesHeader, line))
+    {
+        if(line.find("vc4cl_image_read") != std::string::npos)
+            return true;
+    }
+    return false;
+}
+
 TestEmulator::TestEmulator(const vc4c::Configuration& config) :
     TestEmulator(config,
         test_data::getAllTests(defaultFilter |
@@ -45,6 +70,54 @@ TestEmulator::TestEmulator(const vc4c::Configuration& config,
     {
         TEST_ADD_TWO_ARGUMENTS(TestEmulator::runTestData, std::string{test.first}, true);
     }
+    // run some tests additionally with the code translated into host code
+    for(auto name : {"fibonacci", "CRC16", "vector_arithmetic", "VectorAdd"})
+    {
+        if(testData.find(name) != testData.end())
+        {
+            TEST_ADD_WITH_STRING(TestEmulator::runTranslatedTestData, std::string{name});
+        }
+    }
+    // run some tests additionally with the buffers mapped directly into the emulated memory
+    for(auto name : {"CRC16", "VectorAdd"})
+    {
+        if(testData.find(name) != testData.end())
+        {
+            TEST_ADD_WITH_STRING(TestEmulator::runHostBufferTestData, std::string{name});
+        }
+    }
+    // run some tests additionally with writing snapshots and resuming from the last snapshot
+    for(auto name : {"CRC16"})
+    {
+        if(testData.find(name) != testData.end())
+        {
+            TEST_ADD_WITH_STRING(TestEmulator::runSnapshotTestData, std::string{name});
+        }
+    }
+    // run some tests additionally with writing the execution trace
+    for(auto name : {"VectorAdd"})
+    {
+        if(testData.find(name) != testData.end())
+        {
+            TEST_ADD_WITH_STRING(TestEmulator::runTracedTestData, std::string{name});
+        }
+    }
+    // run some tests additionally checking the time spent waiting for the hardware mutex
+    for(auto name : {"local_storage_sections"})
+    {
+        if(testData.find(name) != testData.end())
+        {
+            TEST_ADD_WITH_STRING(TestEmulator::runMutexStallTestData, std::string{name});
+        }
+    }
+    TEST_ADD(TestEmulator::testTraceConversion);
+    TEST_ADD(TestEmulator::testProfileReports);
+    TEST_ADD(TestEmulator::testTextureLookups);
+    if(hasTextureReadIntrinsic())
+    {
+        TEST_ADD(TestEmulator::testImageRead);
+        TEST_ADD(TestEmulator::testImageReadBorderColor);
+    }
     if(!testData.empty())
     {
         TEST_ADD(TestEmulator::printProfilingInfo);
@@ -78,6 +151,323 @@ void TestEmulator::runTestData(std::string dataName, vc4c::FastMap<std::string,
         TEST_ASSERT_EQUALS("(no error)", result.error);
 }
 
+void TestEmulator::runTranslatedTestData(std::string dataName)
+{
+    EmulationRunner runner(config, compilationCache, true);
+    auto test = test_data::getTest(dataName);
+    auto result = test_data::execute(test, runner);
+    TEST_ASSERT(result.wasSuccess)
+    if(!result.error.empty())
+        TEST_ASSERT_EQUALS("(no error)", result.error);
+
+    // make sure the instructions are actually executed via the translated code and not all by the interpreter
+    auto emulationResult = runner.getResult();
+    TEST_ASSERT(emulationResult != nullptr)
+    if(!emulationResult)
+        return;
+    uint64_t numTranslated = 0;
+    uint64_t numExecuted = 0;
+    for(const auto& instrumentation : emulationResult->instrumentation)
+    {
+        numTranslated += instrumentation.numTranslatedExecutions;
+        numExecuted += instrumentation.numExecutions;
+    }
+    TEST_ASSERT(numTranslated > 0)
+    TEST_ASSERT(numTranslated <= numExecuted)
+}
+
+void TestEmulator::runHostBufferTestData(std::string dataName)
+{
+    EmulationRunner runner(config, compilationCache, false, true);
+    auto test = test_data::getTest(dataName);
+    auto result = test_data::execute(test, runner);
+    TEST_ASSERT(result.wasSuccess)
+    if(!result.error.empty())
+        TEST_ASSERT_EQUALS("(no error)", result.error);
+}
+
+void TestEmulator::runSnapshotTestData(std::string dataName)
+{
+    // unique file, so parallel or repeated runs do not overwrite each others snapshots, removed on destruction
+    vc4c::TemporaryFile snapshotFile{};
+    auto test = test_data::getTest(dataName);
+    {
+        EmulationRunner runner(config, compilationCache);
+        runner.setSnapshots(snapshotFile.fileName, 32, "");
+        auto result = test_data::execute(test, runner);
+        TEST_ASSERT(result.wasSuccess)
+        if(!result.error.empty())
+            TEST_ASSERT_EQUALS("(no error)", result.error);
+    }
+    {
+        // resume from the last snapshot written, which should produce the same results
+        EmulationRunner runner(config, compilationCache);
+        runner.setSnapshots("", 0, snapshotFile.fileName);
+        auto result = test_data::execute(test, runner);
+        TEST_ASSERT(result.wasSuccess)
+        if(!result.error.empty())
+            TEST_ASSERT_EQUALS("(no error)", result.error);
+    }
+}
+
+void TestEmulator::runTracedTestData(std::string dataName)
+{
+    // unique file, so parallel or repeated runs do not overwrite each others traces, removed on destruction
+    vc4c::TemporaryFile traceFile{};
+    {
+        EmulationRunner runner(config, compilationCache);
+        runner.setTraceFile(traceFile.fileName);
+        auto test = test_data::getTest(dataName);
+        auto result = test_data::execute(test, runner);
+        TEST_ASSERT(result.wasSuccess)
+        if(!result.error.empty())
+            TEST_ASSERT_EQUALS("(no error)", result.error);
+    }
+
+    std::ifstream trace(traceFile.fileName, std::ios::in | std::ios::binary);
+    std::stringstream json;
+    vc4c::tools::convertTraceToJSON(trace, json);
+    TEST_ASSERT(json.str().find("\"name\":\"execute\"") != std::string::npos)
+    TEST_ASSERT(json.str().find("\"name\":\"thread end\"") != std::string::npos)
+}
+
+void TestEmulator::runMutexStallTestData(std::string dataName)
+{
+    EmulationRunner runner(config, compilationCache);
+    auto test = test_data::getTest(dataName);
+    auto result = test_data::execute(test, runner);
+    TEST_ASSERT(result.wasSuccess)
+    if(!result.error.empty())
+        TEST_ASSERT_EQUALS("(no error)", result.error);
+
+    auto emulationResult = runner.getResult();
+    TEST_ASSERT(emulationResult != nullptr)
+    if(!emulationResult)
+        return;
+    // all work-items access memory guarded by the mutex at roughly the same time, so some of them need to wait
+    TEST_ASSERT(emulationResult->mutexWaitCycles > 0)
+    uint64_t numStalls = 0;
+    for(const auto& instrumentation : emulationResult->instrumentation)
+        numStalls += instrumentation.numMutexStalls;
+    TEST_ASSERT_EQUALS(numStalls, emulationResult->mutexWaitCycles);
+}
+
+void TestEmulator::testTraceConversion()
+{
+    vc4c::TemporaryFile traceFile{};
+    {
+        TraceWriter writer(traceFile.fileName);
+        writer.write(TraceRecord{1, 0, 0, 0, TraceEvent::INSTRUCTION, 0, 0});
+        writer.write(TraceRecord{2, 1, 0, 0, TraceEvent::INSTRUCTION, 0, 0});
+        writer.write(TraceRecord{2, 1, 4, 0, TraceEvent::VPM_READ_QUEUE, 0, 0});
+        writer.write(TraceRecord{3, 2, 0, 0, TraceEvent::STALL_TMU, 0, 0});
+        writer.write(TraceRecord{4, 2, 1, 0, TraceEvent::TMU0_QUEUE, 0, 0});
+        writer.write(TraceRecord{4, 2, 0, 0, TraceEvent::THREAD_END, 0, 0});
+        // cycles beyond the 32-bit range are still merged into a single slice
+        writer.write(TraceRecord{0xFFFFFFFFull, 0, 0, 1, TraceEvent::INSTRUCTION, 0, 0});
+        writer.write(TraceRecord{0x100000000ull, 1, 0, 1, TraceEvent::INSTRUCTION, 0, 0});
+        writer.write(TraceRecord{0x100000001ull, 1, 0, 1, TraceEvent::THREAD_END, 0, 0});
+    }
+
+    std::ifstream trace(traceFile.fileName, std::ios::in | std::ios::binary);
+    std::stringstream json;
+    vc4c::tools::convertTraceToJSON(trace, json);
+    // the two consecutive instructions are merged into a single slice
+    TEST_ASSERT(json.str().find(R"({"name":"execute","cat":"qpu","ph":"X","pid":0,"tid":0,"ts":1,"dur":2,)") !=
+        std::string::npos)
+    TEST_ASSERT(json.str().find("\"name\":\"stall (TMU)\"") != std::string::npos)
+    TEST_ASSERT(json.str().find(R"({"name":"VPM read queue QPU 0","ph":"C","pid":0,"ts":2,"args":{"entries":4}})") !=
+        std::string::npos)
+    TEST_ASSERT(json.str().find(R"({"name":"TMU0 queue QPU 0","ph":"C","pid":0,"ts":4,"args":{"entries":1}})") !=
+        std::string::npos)
+    TEST_ASSERT(json.str().find(R"({"name":"execute","cat":"qpu","ph":"X","pid":0,"tid":1,"ts":4294967295,"dur":2,)") !=
+        std::string::npos)
+}
+
+void TestEmulator::testProfileReports()
+{
+    using namespace vc4c::tools;
+    std::vector<CodeRegion> regions{{"foo", 0, 2, "%start", {}}, {"foo", 2, 3, "%loop", {"%loop"}},
+        {"foo", 5, 1, "%inner", {"%loop", "%inner"}}, {"bar", 0, 4, "%start", {}}};
+    std::stringstream mapping;
+    writeCodeRegions(mapping, regions);
+    auto readRegions = readCodeRegions(mapping, "foo");
+    TEST_ASSERT_EQUALS(3u, readRegions.size())
+    TEST_ASSERT_EQUALS(2u, readRegions[1].firstInstruction)
+    TEST_ASSERT_EQUALS(3u, readRegions[1].numInstructions)
+    TEST_ASSERT_EQUALS("%loop", readRegions[1].block)
+    TEST_ASSERT_EQUALS(2u, readRegions[2].loops.size())
+    TEST_ASSERT_EQUALS("%inner", readRegions[2].loops.back())
+
+    std::vector<InstrumentationResult> instrumentation(6);
+    instrumentation[0].numExecutions = 1;
+    instrumentation[1].numExecutions = 1;
+    for(std::size_t i = 2; i < 5; ++i)
+        instrumentation[i].numExecutions = 10;
+    instrumentation[5].numExecutions = 100;
+    instrumentation[5].numStalls = 20;
+
+    std::stringstream stacks;
+    writeFoldedStacks(stacks, readRegions, instrumentation);
+    TEST_ASSERT_EQUALS("foo;%start 2\nfoo;loop %loop;%loop 30\nfoo;loop %loop;loop %inner;%inner 100\n", stacks.str())
+
+    std::stringstream report;
+    writeHotSpotReport(report, readRegions, instrumentation);
+    // the loop containing the inner loop accounts for all but 2 cycles and is listed first
+    auto loopsStart = report.str().find("by loop");
+    TEST_ASSERT(loopsStart != std::string::npos)
+    TEST_ASSERT(report.str().find("130", loopsStart) < report.str().find("100", loopsStart))
+}
+
+void TestEmulator::testTextureLookups()
+{
+    using namespace vc4c::tools;
+    std::map<MemoryAddress, Word> memory;
+    auto readWord = [&](MemoryAddress address) -> Word {
+        auto it = memory.find(address);
+        return it == memory.end() ? 0 : it->second;
+    };
+
+    // 4x2 raster texture (RGBA32R) with nearest filtering and the texel values set to their coordinates
+    for(Word y = 0; y < 2; ++y)
+    {
+        for(Word x = 0; x < 4; ++x)
+            memory[0x1000 + (y * 4 + x) * 4] = y * 16 + x;
+    }
+    Word rasterConfig1 = (1u << 31) | (2u << 20) | (4u << 8) | 0x80;
+    TextureSetup repeat(0x1000, rasterConfig1 | 0x0);
+    TEST_ASSERT_EQUALS(18u, sampleTexture(repeat, 2.5f / 4.0f, 1.5f / 2.0f, 0, readWord))
+    TEST_ASSERT_EQUALS(18u, sampleTexture(repeat, 6.5f / 4.0f, 1.5f / 2.0f, 0, readWord))
+    TextureSetup clamp(0x1000, rasterConfig1 | 0x1);
+    TEST_ASSERT_EQUALS(19u, sampleTexture(clamp, 2.0f, 1.5f / 2.0f, 0, readWord))
+    TextureSetup mirror(0x1000, rasterConfig1 | 0x2);
+    TEST_ASSERT_EQUALS(19u, sampleTexture(mirror, 4.5f / 4.0f, 1.5f / 2.0f, 0, readWord))
+    TextureSetup border(0x1000, rasterConfig1 | 0x3);
+    TEST_ASSERT_EQUALS(0x42u, sampleTexture(border, -0.1f, 0.25f, 0x42, readWord))
+
+    // bi-linear filtering between two texels
+    memory[0x1000] = 0;
+    memory[0x1004] = 0x02020202;
+    TextureSetup linear(0x1000, (rasterConfig1 & ~0x80u) | (0x1 << 2) | 0x1);
+    TEST_ASSERT_EQUALS(0x01010101u, sampleTexture(linear, 0.25f, 0.25f, 0, readWord))
+
+    // 4x4 RGB565 texture fits into a single 8x4 micro-tile (LT-format)
+    // the texel (1, 2) is stored in the upper half-word at offset 2 * 16 + 1 * 2
+    memory[0x2000 + 2 * 16] = 0xF800u << 16;
+    TextureSetup rgb565(0x2000 | (4u << 4), (4u << 20) | (4u << 8) | 0x80);
+    TEST_ASSERT_EQUALS(2u, rgb565.getBytesPerTexel())
+    TEST_ASSERT_EQUALS(0xFF0000FFu, sampleTexture(rgb565, 1.5f / 4.0f, 2.5f / 4.0f, 0, readWord))
+}
+
+static const std::string IMAGE_READ = R"(
+__kernel void test_read_image(__read_only image2d_t image, __global float4* out)
+{
+    const sampler_t unnormalized = CLK_NORMALIZED_COORDS_FALSE | CLK_ADDRESS_CLAMP_TO_EDGE | CLK_FILTER_NEAREST;
+    const sampler_t normalized = CLK_NORMALIZED_COORDS_TRUE | CLK_ADDRESS_REPEAT | CLK_FILTER_NEAREST;
+    int gid = get_global_id(0);
+    int2 coords = (int2)(gid % 4, gid / 4);
+    out[gid * 2] = read_imagef(image, unnormalized, coords);
+    // the same texel addressed via normalized coordinates
+    out[gid * 2 + 1] = read_imagef(image, normalized, (float2)((coords.x + 0.5f) / 4.0f, (coords.y + 0.5f) / 2.0f));
+}
+)";
+
+void TestEmulator::testImageRead()
+{
+    using namespace vc4c::tools;
+    EmulationData data;
+    data.kernelName = "test_read_image";
+    data.module = compileString(IMAGE_READ, "", "test_read_image");
+    data.workGroup.dimensions = 1;
+    data.workGroup.localSizes[0] = 8;
+
+    // 4x2 raster texture (RGBA32R) with the red and green channels depending on the texel coordinates
+    std::vector<uint32_t> texels(8);
+    for(uint32_t y = 0; y < 2; ++y)
+    {
+        for(uint32_t x = 0; x < 4; ++x)
+            texels[y * 4 + x] = 0xFF800000u | ((y * 0x40u) << 8u) | (x * 0x20u);
+    }
+    data.parameter.emplace_back(0, texels);
+    data.parameter.emplace_back(0, std::vector<uint32_t>(8 * 2 * 4));
+    // the image-configuration is the only global data of the kernel
+    data.images.emplace(0, ImageSetup{0, TextureSetup::RGBA32R, 4, 2});
+
+    const auto result = emulate(data);
+    TEST_ASSERT(result.executionSuccessful)
+    TEST_ASSERT_EQUALS(2u, result.results.size())
+    if(!result.executionSuccessful || result.results.size() != 2 || !result.results[1].second)
+        return;
+
+    const auto& out = result.results[1].second.value();
+    for(uint32_t i = 0; i < 8 * 2; ++i)
+    {
+        // both reads of a work-item return the texel at its coordinates as normalized RGBA
+        auto texel = texels[i / 2];
+        for(uint32_t channel = 0; channel < 4; ++channel)
+        {
+            float value = 0.0f;
+            std::memcpy(&value, &out[i * 4 + channel], sizeof(float));
+            TEST_ASSERT_DELTA(static_cast<float>((texel >> (channel * 8u)) & 0xFFu) / 255.0f, value, 0.001f)
+        }
+    }
+}
+
+static const std::string IMAGE_READ_BORDER = R"(
+__kernel void test_read_image_border(__read_only image2d_t image, __global float4* out)
+{
+    const sampler_t clamp = CLK_NORMALIZED_COORDS_FALSE | CLK_ADDRESS_CLAMP | CLK_FILTER_NEAREST;
+    int gid = get_global_id(0);
+    // the odd work-items read outside of the image, which returns the border color
+    out[gid] = read_imagef(image, clamp, (int2)(gid % 2 ? -1 : gid / 2, 0));
+}
+)";
+
+void TestEmulator::testImageReadBorderColor()
+{
+    using namespace vc4c::tools;
+    // the same texels are read as image without (CL_RGB) and with alpha channel (CL_RGBA)
+    for(uint16_t channelOrder : {0x10B4, 0x10B5})
+    {
+        EmulationData data;
+        data.kernelName = "test_read_image_border";
+        data.module = compileString(IMAGE_READ_BORDER, "", "test_read_image_border");
+        data.workGroup.dimensions = 1;
+        data.workGroup.localSizes[0] = 4;
+
+        // 2x1 raster texture (RGBA32R) with an alpha channel of 0.5
+        std::vector<uint32_t> texels{0x80000020u, 0x80004000u};
+        data.parameter.emplace_back(0, texels);
+        data.parameter.emplace_back(0, std::vector<uint32_t>(4 * 4));
+        ImageSetup image{0, TextureSetup::RGBA32R, 2, 1};
+        image.channelOrder = channelOrder;
+        data.images.emplace(0, image);
+
+        const auto result = emulate(data);
+        TEST_ASSERT(result.executionSuccessful)
+        TEST_ASSERT_EQUALS(2u, result.results.size())
+        if(!result.executionSuccessful || result.results.size() != 2 || !result.results[1].second)
+            return;
+
+        const auto& out = result.results[1].second.value();
+        bool hasAlpha = channelOrder == 0x10B5;
+        for(uint32_t i = 0; i < 4; ++i)
+        {
+            // the border color is (0, 0, 0, 0) for images with and (0, 0, 0, 1) for images without alpha channel
+            auto texel = (i % 2) ? 0u : texels[i / 2];
+            for(uint32_t channel = 0; channel < 4; ++channel)
+            {
+                float expected = static_cast<float>((texel >> (channel * 8u)) & 0xFFu) / 255.0f;
+                if(channel == 3 && !hasAlpha)
+                    expected = 1.0f;
+                float value = 0.0f;
+                std::memcpy(&value, &out[i * 4 + channel], sizeof(float));
+                TEST_ASSERT_DELTA(expected, value, 0.001f)
+            }
+        }
+    }
+}
+
 void TestEmulator::runNoSuchTestData(std::string dataName)
 {
     TEST_ASSERT_EQUALS("(no error)", "There is no test data with the name '" + dataName + "'");
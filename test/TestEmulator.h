@@ -39,6 +39,16 @@ public:
     void printProfilingInfo();
     void runTestData(std::string dataName, bool useCompilationCache);
     void runTestData(std::string dataName, vc4c::FastMap<std::string, vc4c::CompilationData>& cache);
+    void runTranslatedTestData(std::string dataName);
+    void runHostBufferTestData(std::string dataName);
+    void runSnapshotTestData(std::string dataName);
+    void runTracedTestData(std::string dataName);
+    void runMutexStallTestData(std::string dataName);
+    void testTraceConversion();
+    void testProfileReports();
+    void testTextureLookups();
+    void testImageRead();
+    void testImageReadBorderColor();
     void runNoSuchTestData(std::string dataName);
 
     static std::map<std::string, const test_data::TestData*> getAllTestData();
@@ -12,9 +12,12 @@
 #include "VC4C.h"
 #include "asm/Instruction.h"
 #include "asm/KernelInfo.h"
+#include "llvm/BitcodeReader.h"
+#include "precompilation/FileCache.h"
 #include "precompilation/FrontendCompiler.h"
 #include "precompilation/LLVMLibrary.h"
 #include "spirv/SPIRVHelper.h"
+#include "spirv/SPIRVLexer.h"
 #include "tool_paths.h"
 #include "tools.h"
 
@@ -26,11 +29,17 @@
 using namespace vc4c::spirv;
 
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 using namespace vc4c;
 
@@ -47,6 +56,9 @@ TestFrontends::TestFrontends()
     {
         // FIXME this SEGFAULTs in llvm-spirv translator
         TEST_ADD(TestFrontends::testLinking);
+        TEST_ADD(TestFrontends::testInProcessLinking);
+        TEST_ADD(TestFrontends::testStandardLibraryModuleReuse);
+        TEST_ADD(TestFrontends::testLazyFunctionMaterialization);
     }
 
     TEST_ADD(TestFrontends::testSourceTypeDetection);
@@ -89,6 +101,10 @@ TestFrontends::TestFrontends()
 
     TEST_ADD(TestFrontends::testCompilationDataSerialization);
     TEST_ADD(TestFrontends::testPrecompileStandardLibrary);
+    TEST_ADD(TestFrontends::testFileCache);
+    TEST_ADD(TestFrontends::testSPIRVInputWords);
+    TEST_ADD(TestFrontends::testSPIRVParsing);
+    TEST_ADD(TestFrontends::testBatchCompilation);
     TEST_ADD(TestFrontends::printProfilingInfo);
 }
 
@@ -152,6 +168,117 @@ void TestFrontends::testLinking()
     TEST_ASSERT_EQUALS(res.results[0].second->at(0), res.results[1].second->at(0))
 }
 
+void TestFrontends::testInProcessLinking()
+{
+#ifdef USE_LLVM_LIBRARY
+    // compiles via the clang library (if available) and links via the LLVM linker library, all in memory
+    std::vector<precompilation::LLVMIRSource> sources;
+    for(const auto* file : {TESTING_FILES "test_linking_0.cl", TESTING_FILES "test_linking_1.cl",
+            TESTING_FILES "test_linking_2.cl"})
+    {
+        auto module = precompilation::compileOpenCLToLLVMIR(precompilation::OpenCLSource{std::string{file}}, "");
+        TEST_ASSERT(dynamic_cast<precompilation::LLVMCompilationData*>(&module.inner()) != nullptr);
+        TEST_ASSERT(!module.getFilePath());
+        sources.emplace_back(std::move(module));
+    }
+
+    auto linked = precompilation::linkLLVMModules(sources, "");
+    auto linkedData = dynamic_cast<precompilation::LLVMCompilationData*>(&linked.inner());
+    TEST_ASSERT(linkedData != nullptr);
+    TEST_ASSERT(!linked.getFilePath());
+    if(!linkedData)
+        return;
+    for(const auto* name : {"test_linker", "get_value", "get_value_inner"})
+    {
+        auto func = linkedData->data.module->getFunction(name);
+        TEST_ASSERT(func != nullptr);
+        TEST_ASSERT(func && !func->isDeclaration());
+    }
+
+    Configuration config{};
+    config.outputMode = OutputMode::BINARY;
+    auto out = Compiler::compile(std::move(linked).publish(), config);
+    TEST_ASSERT_EQUALS(SourceType::QPUASM_BIN, out.first.getType());
+#endif
+}
+
+void TestFrontends::testStandardLibraryModuleReuse()
+{
+#ifdef USE_LLVM_LIBRARY
+    if(precompilation::findStandardLibraryFiles().llvmModule.empty())
+        // to not unexpectedly fail if the std-lib module is not available
+        return;
+
+    std::stringstream source{R"(
+__kernel void test(__global float* out, const __global float* in) {
+  out[get_global_id(0)] = fabs(in[get_global_id(0)]);
+}
+)"};
+    auto module =
+        precompilation::LLVMIRSource{precompilation::compileOpenCLToLLVMIR(precompilation::OpenCLSource{source}, "")};
+
+    auto first = precompilation::linkInStdlibModule(module, "");
+    const auto* stdlibBuffer = &precompilation::getStandardLibraryModuleBuffer();
+    auto numReads = profiler::getCounterValue("VC4CL std-lib module read");
+    auto numLazyLoads = profiler::getCounterValue("VC4CL std-lib module lazy load");
+    auto second = precompilation::linkInStdlibModule(module, "");
+
+    // the second link reuses the std-lib module buffer read by the first one
+    TEST_ASSERT_EQUALS(stdlibBuffer, &precompilation::getStandardLibraryModuleBuffer());
+    TEST_ASSERT_EQUALS(numReads, profiler::getCounterValue("VC4CL std-lib module read"));
+    if(numLazyLoads != 0)
+        // profiling is enabled
+        TEST_ASSERT_EQUALS(numLazyLoads + 1, profiler::getCounterValue("VC4CL std-lib module lazy load"));
+
+    // only the used std-lib functions are linked in
+    auto stdlib = precompilation::loadLLVMModule(
+        precompilation::getStandardLibraryModuleBuffer(), nullptr, precompilation::LLVMModuleTag{});
+    for(auto* result : {&first, &second})
+    {
+        auto linkedData = dynamic_cast<precompilation::LLVMCompilationData*>(&result->inner());
+        TEST_ASSERT(linkedData != nullptr);
+        if(linkedData)
+            TEST_ASSERT(linkedData->data.module->size() < stdlib.module->size());
+    }
+#endif
+}
+
+void TestFrontends::testLazyFunctionMaterialization()
+{
+#ifdef USE_LLVM_LIBRARY
+    std::stringstream source{R"(
+int unused_function(int a, int b) {
+  return a * b + (a ^ b);
+}
+
+__kernel void test_lazy(__global int* out, const __global int* in) {
+  out[get_global_id(0)] = in[get_global_id(0)] + 42;
+}
+)"};
+    // write the module to a file, since in-memory modules are used as-is and not loaded lazily
+    auto moduleFile = precompilation::compileOpenCLToLLVMIR(precompilation::OpenCLSource{source}, "",
+        precompilation::LLVMIRResult{
+            std::make_unique<precompilation::TemporaryFileCompilationData<SourceType::LLVM_IR_BIN>>()});
+    TEST_ASSERT(!!moduleFile.getFilePath());
+
+    auto numMaterialized = profiler::getCounterValue("LLVM functions materialized");
+    auto numSkipped = profiler::getCounterValue("LLVM functions skipped");
+    Configuration config{};
+    Module module{config};
+    llvm2qasm::BitcodeReader reader{moduleFile.inner()};
+    reader.parse(module);
+
+    TEST_ASSERT_EQUALS(1u, module.getKernels().size());
+    for(const auto& method : module)
+        TEST_ASSERT(method->name.find("unused_function") == std::string::npos);
+    if(profiler::getCounterValue("LLVM functions materialized") != numMaterialized)
+    {
+        // profiling is enabled, the unused function (and any unused std-lib function) is never materialized
+        TEST_ASSERT(profiler::getCounterValue("LLVM functions skipped") > numSkipped);
+    }
+#endif
+}
+
 void TestFrontends::testSourceTypeDetection()
 {
     {
@@ -394,6 +521,199 @@ void TestFrontends::testCompilationDataSerialization()
 #endif
 }
 
+namespace
+{
+    /*
+     * Unique temporary directory, which is removed together with all its (non-directory) entries on destruction
+     */
+    struct TemporaryDirectory
+    {
+        TemporaryDirectory()
+        {
+            std::string pathTemplate = "/tmp/vc4cc-cache-XXXXXX";
+            if(mkdtemp(&pathTemplate[0]))
+                path = pathTemplate;
+        }
+
+        TemporaryDirectory(const TemporaryDirectory&) = delete;
+        TemporaryDirectory(TemporaryDirectory&&) noexcept = delete;
+
+        ~TemporaryDirectory()
+        {
+            if(path.empty())
+                return;
+            if(auto dir = opendir(path.data()))
+            {
+                while(auto entry = readdir(dir))
+                {
+                    if(std::strcmp(entry->d_name, ".") != 0 && std::strcmp(entry->d_name, "..") != 0)
+                        std::remove((path + "/" + entry->d_name).data());
+                }
+                closedir(dir);
+            }
+            rmdir(path.data());
+        }
+
+        TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+        TemporaryDirectory& operator=(TemporaryDirectory&&) noexcept = delete;
+
+        std::string path;
+    };
+} // namespace
+
+void TestFrontends::testFileCache()
+{
+    // use a unique directory to not interfere with concurrent test runs or stale entries of previous runs
+    TemporaryDirectory tempDirectory{};
+    TEST_ASSERT(!tempDirectory.path.empty());
+    const std::string& directory = tempDirectory.path;
+    // room for a single entry only
+    precompilation::FileCache cache{directory, ".test", 16};
+    unsigned numCreated = 0;
+    auto createEntry = [&](const std::string& path) {
+        std::ofstream fos{path};
+        fos << "0123456789";
+        ++numCreated;
+    };
+
+    auto firstKey = precompilation::FileCache::buildKey({"first", "options"});
+    TEST_ASSERT(firstKey != precompilation::FileCache::buildKey({"firs", "toptions"}));
+    std::string firstPath;
+    {
+        auto entry = cache.getOrCreate(firstKey, createEntry);
+        firstPath = entry.path;
+        TEST_ASSERT_EQUALS(1u, numCreated);
+        auto sameEntry = cache.getOrCreate(firstKey, createEntry);
+        TEST_ASSERT_EQUALS(firstPath, sameEntry.path);
+        TEST_ASSERT_EQUALS(1u, numCreated);
+    }
+
+    // the first entry is no longer in use and evicted when the cache size is exceeded
+    auto secondEntry = cache.getOrCreate(precompilation::FileCache::buildKey({"second"}), createEntry);
+    TEST_ASSERT_EQUALS(2u, numCreated);
+    TEST_ASSERT(access(firstPath.data(), F_OK) != 0);
+    TEST_ASSERT_EQUALS(0, access(secondEntry.path.data(), R_OK));
+}
+
+void TestFrontends::testSPIRVInputWords()
+{
+    static constexpr uint32_t SPIRV_MAGIC_NUMBER = 0x07230203;
+    std::ifstream sourceStream{TESTING_FILES "formats/test.spv"};
+    precompilation::RawCompilationData<SourceType::SPIRV_BIN> rawData{sourceStream};
+
+    {
+        // memory-mapped file
+        precompilation::FileCompilationData<SourceType::SPIRV_BIN> fileData{TESTING_FILES "formats/test.spv"};
+        auto words = readStreamOfWords(fileData);
+        TEST_ASSERT_EQUALS(rawData.data.size() / sizeof(uint32_t), words.size());
+        TEST_ASSERT_EQUALS(SPIRV_MAGIC_NUMBER, *words.begin());
+        TEST_ASSERT_EQUALS(0, std::memcmp(rawData.data.data(), words.data(), rawData.data.size()));
+    }
+
+    {
+        // in-memory buffers are referenced directly
+        auto words = readStreamOfWords(rawData);
+        TEST_ASSERT_EQUALS(reinterpret_cast<const uint32_t*>(rawData.data.data()), words.data());
+
+        precompilation::ExternalCompilationData<SourceType::SPIRV_BIN> externalData{
+            rawData.data.data(), rawData.data.size()};
+        auto externalWords = readStreamOfWords(externalData);
+        TEST_ASSERT_EQUALS(words.data(), externalWords.data());
+        TEST_ASSERT_EQUALS(words.size(), externalWords.size());
+    }
+
+    {
+        // misaligned buffers are copied
+        std::vector<uint8_t> buffer(rawData.data.size() + 1);
+        std::copy(rawData.data.begin(), rawData.data.end(), buffer.begin() + 1);
+        precompilation::ExternalCompilationData<SourceType::SPIRV_BIN> externalData{
+            buffer.data() + 1, rawData.data.size()};
+        auto words = readStreamOfWords(externalData);
+        TEST_ASSERT(reinterpret_cast<const uint8_t*>(words.data()) != buffer.data() + 1);
+        TEST_ASSERT_EQUALS(SPIRV_MAGIC_NUMBER, *words.begin());
+        TEST_ASSERT_EQUALS(0, std::memcmp(rawData.data.data(), words.data(), rawData.data.size()));
+    }
+
+    {
+        // the public API type-detects and compiles from the caller-owned buffer
+        CompilationData data{rawData.data.data(), rawData.data.size()};
+        TEST_ASSERT_EQUALS(SourceType::SPIRV_BIN, data.getType());
+        std::vector<uint8_t> copy;
+        TEST_ASSERT(data.getRawData(copy));
+        TEST_ASSERT(copy == rawData.data);
+    }
+}
+
+void TestFrontends::testSPIRVParsing()
+{
+    // the operations are released while being mapped, so make sure parsing the same input twice yields the same result
+    precompilation::FileCompilationData<SourceType::SPIRV_BIN> input{TESTING_FILES "formats/test.spv"};
+    std::vector<std::pair<std::string, std::size_t>> firstMethods;
+    for(unsigned i = 0; i < 2; ++i)
+    {
+        auto numMapped = profiler::getCounterValue("SPIR-V functions mapped");
+        Configuration config{};
+        Module module{config};
+        spirv::SPIRVLexer parser{input};
+        parser.parse(module);
+
+        TEST_ASSERT(!module.getKernels().empty());
+        std::vector<std::pair<std::string, std::size_t>> methods;
+        for(const auto& method : module)
+            methods.emplace_back(method->name, method->countInstructions());
+        if(numMapped != 0)
+            // profiling is enabled, every remaining function has been mapped
+            TEST_ASSERT(profiler::getCounterValue("SPIR-V functions mapped") >= numMapped + methods.size());
+
+        if(i == 0)
+            firstMethods = std::move(methods);
+        else
+            TEST_ASSERT(firstMethods == methods);
+    }
+}
+
+void TestFrontends::testBatchCompilation()
+{
+    CompilationData fibonacci{EXAMPLE_FILES "fibonacci.cl", SourceType::OPENCL_C};
+    CompilationData attributes{ATTRIBUTE_KERNEL.begin(), ATTRIBUTE_KERNEL.end(), SourceType::OPENCL_C};
+    const std::string invalidKernel = "__kernel void invalid(__global int* out) { *out = undefined; }";
+    CompilationData invalid{invalidKernel.begin(), invalidKernel.end(), SourceType::OPENCL_C};
+
+    Configuration config{};
+    config.outputMode = OutputMode::BINARY;
+    std::vector<BatchCompilationInput> inputs;
+    inputs.push_back(BatchCompilationInput{&fibonacci, config, "", ""});
+    inputs.push_back(BatchCompilationInput{&invalid, config, "", ""});
+    inputs.push_back(BatchCompilationInput{&attributes, config, "-cl-fast-relaxed-math", ""});
+
+    std::mutex callbackLock;
+    std::vector<std::size_t> finishedInputs;
+    std::vector<std::size_t> failedInputs;
+    bool validCallbackArguments = true;
+    auto results = Compiler::compileAll(
+        inputs, [&](std::size_t index, const Compiler::Result* result, std::exception_ptr error) {
+            // the callback is run on the worker threads, so only record the arguments here
+            std::lock_guard<std::mutex> guard(callbackLock);
+            (result ? finishedInputs : failedInputs).push_back(index);
+            validCallbackArguments = validCallbackArguments && ((result == nullptr) == static_cast<bool>(error));
+        });
+    TEST_ASSERT_EQUALS(inputs.size(), results.size());
+
+    testEmulation(results[0].get().first);
+    TEST_THROWS(results[1].get(), CompilationError);
+    TEST_ASSERT(results[2].get().second > 0);
+
+    // the promise is fulfilled after the callback returned
+    std::lock_guard<std::mutex> guard(callbackLock);
+    TEST_ASSERT(validCallbackArguments);
+    std::sort(finishedInputs.begin(), finishedInputs.end());
+    TEST_ASSERT_EQUALS(2u, finishedInputs.size());
+    TEST_ASSERT_EQUALS(0u, finishedInputs.at(0));
+    TEST_ASSERT_EQUALS(2u, finishedInputs.at(1));
+    TEST_ASSERT_EQUALS(1u, failedInputs.size());
+    TEST_ASSERT_EQUALS(1u, failedInputs.at(0));
+}
+
 void TestFrontends::testPrecompileStandardLibrary()
 {
     auto srcHeader = precompilation::findStandardLibraryFiles().mainHeader;
@@ -19,6 +19,9 @@ public:
 
     void testSPIRVCapabilitiesSupport();
     void testLinking();
+    void testInProcessLinking();
+    void testStandardLibraryModuleReuse();
+    void testLazyFunctionMaterialization();
     void testSourceTypeDetection();
     void testDisassembler();
     void testCompilation(vc4c::SourceType type);
@@ -26,6 +29,10 @@ public:
     void testFrontendConversions(std::string sourceFile, vc4c::SourceType destType);
     void testCompilationDataSerialization();
     void testPrecompileStandardLibrary();
+    void testFileCache();
+    void testSPIRVInputWords();
+    void testSPIRVParsing();
+    void testBatchCompilation();
     void printProfilingInfo();
 
 private:
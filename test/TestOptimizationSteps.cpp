@@ -15,7 +15,9 @@
 #include "optimization/ControlFlow.h"
 #include "optimization/Eliminator.h"
 #include "optimization/Flags.h"
+#include "optimization/Memory.h"
 #include "optimization/Vector.h"
+#include "periphery/VPM.h"
 
 #include <cmath>
 
@@ -43,6 +45,7 @@ TestOptimizationSteps::TestOptimizationSteps()
     TEST_ADD(TestOptimizationSteps::testRemoveConditionalFlags);
     TEST_ADD(TestOptimizationSteps::testCombineVectorElementCopies);
     TEST_ADD(TestOptimizationSteps::testLoopInvariantCodeMotion);
+    TEST_ADD(TestOptimizationSteps::testMinimizeMutexSections);
 }
 
 static bool checkEquals(
@@ -2844,3 +2847,125 @@ void TestOptimizationSteps::testLoopInvariantCodeMotion()
     it.nextInMethod();
     TEST_ASSERT(!!it.get<Branch>());
 }
+
+static void checkBlockInstructions(
+    BasicBlock& block, const FastAccessList<const intermediate::IntermediateInstruction*>& expectedInstructions)
+{
+    FastAccessList<const intermediate::IntermediateInstruction*> instructions;
+    // skip the label
+    for(auto it = block.walk().nextInBlock(); !it.isEndOfBlock(); it.nextInBlock())
+    {
+        if(it.has())
+            instructions.emplace_back(it.get());
+    }
+    TEST_ASSERT_EQUALS(expectedInstructions.size(), instructions.size());
+    for(std::size_t i = 0; i < std::min(expectedInstructions.size(), instructions.size()); ++i)
+    {
+        if(expectedInstructions[i] != instructions[i])
+        {
+            TEST_ASSERT_EQUALS(expectedInstructions[i]->to_string(), instructions[i]->to_string());
+        }
+    }
+}
+
+void TestOptimizationSteps::testMinimizeMutexSections()
+{
+    using namespace vc4c::intermediate;
+    Configuration config{};
+    Module module{config};
+    Method method(module);
+
+    const auto& area = method.vpm->getScratchArea();
+    auto in = method.addNewLocal(TYPE_INT32, "%in");
+
+    auto insert = [](InstructionWalker& it, std::unique_ptr<IntermediateInstruction>&& inst) {
+        auto ptr = inst.get();
+        it.emplace(std::move(inst));
+        it.nextInBlock();
+        return ptr;
+    };
+    auto read = [&](const Value& dest, const Value& offset) -> std::unique_ptr<IntermediateInstruction> {
+        return std::make_unique<CacheAccessInstruction>(
+            MemoryOperation::READ, dest, std::make_shared<periphery::VPMCacheEntry>(area, TYPE_INT32, offset));
+    };
+
+    // independent instructions are moved out of and between the sections, which are then merged
+    auto& mergeBlock = method.createAndInsertNewBlock(method.end(), "%merge");
+    FastAccessList<const IntermediateInstruction*> mergeInstructions;
+    {
+        auto it = mergeBlock.walkEnd();
+        auto a = method.addNewLocal(TYPE_INT32, "%a");
+        auto b = method.addNewLocal(TYPE_INT32, "%b");
+        auto c = method.addNewLocal(TYPE_INT32, "%c");
+        auto d = method.addNewLocal(TYPE_INT32, "%d");
+        auto firstLock = insert(it, std::make_unique<MutexLock>(MutexAccess::LOCK));
+        auto readA = insert(it, read(a, INT_ZERO));
+        auto opB = insert(it, std::make_unique<Operation>(OP_ADD, b, in, INT_ONE));
+        insert(it, std::make_unique<MutexLock>(MutexAccess::RELEASE));
+        auto opC = insert(it, std::make_unique<Operation>(OP_ADD, c, in, Value(Literal(2u), TYPE_INT32)));
+        insert(it, std::make_unique<MutexLock>(MutexAccess::LOCK));
+        auto readD = insert(it, read(d, Value(Literal(64u), TYPE_INT32)));
+        auto secondRelease = insert(it, std::make_unique<MutexLock>(MutexAccess::RELEASE));
+        mergeInstructions = {opB, opC, firstLock, readA, readD, secondRelease};
+    }
+
+    // the offset of the second section depends on the value read in the first one
+    auto& dependentSectionsBlock = method.createAndInsertNewBlock(method.end(), "%dependentSections");
+    FastAccessList<const IntermediateInstruction*> dependentSectionsInstructions;
+    {
+        auto it = dependentSectionsBlock.walkEnd();
+        auto index = method.addNewLocal(TYPE_INT32, "%index");
+        auto offset = method.addNewLocal(TYPE_INT32, "%offset");
+        auto data = method.addNewLocal(TYPE_INT32, "%data");
+        dependentSectionsInstructions.emplace_back(insert(it, std::make_unique<MutexLock>(MutexAccess::LOCK)));
+        dependentSectionsInstructions.emplace_back(insert(it, read(index, INT_ZERO)));
+        dependentSectionsInstructions.emplace_back(insert(it, std::make_unique<MutexLock>(MutexAccess::RELEASE)));
+        dependentSectionsInstructions.emplace_back(
+            insert(it, std::make_unique<Operation>(OP_SHL, offset, index, Value(Literal(2u), TYPE_INT32))));
+        dependentSectionsInstructions.emplace_back(insert(it, std::make_unique<MutexLock>(MutexAccess::LOCK)));
+        dependentSectionsInstructions.emplace_back(insert(it, read(data, offset)));
+        dependentSectionsInstructions.emplace_back(insert(it, std::make_unique<MutexLock>(MutexAccess::RELEASE)));
+    }
+
+    // the offset calculated inside the section is used by a later access of the same section
+    auto& dependentIndexBlock = method.createAndInsertNewBlock(method.end(), "%dependentIndex");
+    FastAccessList<const IntermediateInstruction*> dependentIndexInstructions;
+    {
+        auto it = dependentIndexBlock.walkEnd();
+        auto index = method.addNewLocal(TYPE_INT32, "%index");
+        auto offset = method.addNewLocal(TYPE_INT32, "%offset");
+        auto data = method.addNewLocal(TYPE_INT32, "%data");
+        dependentIndexInstructions.emplace_back(insert(it, std::make_unique<MutexLock>(MutexAccess::LOCK)));
+        dependentIndexInstructions.emplace_back(insert(it, read(index, INT_ZERO)));
+        dependentIndexInstructions.emplace_back(
+            insert(it, std::make_unique<Operation>(OP_SHL, offset, index, Value(Literal(2u), TYPE_INT32))));
+        dependentIndexInstructions.emplace_back(insert(it, read(data, offset)));
+        dependentIndexInstructions.emplace_back(insert(it, std::make_unique<MutexLock>(MutexAccess::RELEASE)));
+    }
+
+    // the section only accesses the per-QPU DMA buffer, so the mutex lock is removed
+    auto& perQPUBlock = method.createAndInsertNewBlock(method.end(), "%perQPU");
+    FastAccessList<const IntermediateInstruction*> perQPUInstructions;
+    {
+        auto bufferArea = method.vpm->addDMABufferArea(1);
+        TEST_ASSERT(bufferArea != nullptr);
+        TEST_ASSERT(bufferArea->isPerQPU());
+        auto it = perQPUBlock.walkEnd();
+        auto data = method.addNewLocal(TYPE_INT32, "%data");
+        auto sum = method.addNewLocal(TYPE_INT32, "%sum");
+        insert(it, std::make_unique<MutexLock>(MutexAccess::LOCK));
+        perQPUInstructions.emplace_back(insert(it,
+            std::make_unique<CacheAccessInstruction>(MemoryOperation::READ, data,
+                std::make_shared<periphery::VPMCacheEntry>(*bufferArea, TYPE_INT32, INT_ZERO))));
+        perQPUInstructions.emplace_back(insert(it, std::make_unique<Operation>(OP_ADD, sum, data, in)));
+        insert(it, std::make_unique<MutexLock>(MutexAccess::RELEASE));
+    }
+
+    // run pass
+    minimizeMutexSections(module, method, config);
+
+    checkBlockInstructions(mergeBlock, mergeInstructions);
+    checkBlockInstructions(dependentSectionsBlock, dependentSectionsInstructions);
+    checkBlockInstructions(dependentIndexBlock, dependentIndexInstructions);
+    checkBlockInstructions(perQPUBlock, perQPUInstructions);
+}
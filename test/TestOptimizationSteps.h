@@ -36,6 +36,7 @@ public:
     void testRemoveConditionalFlags();
     void testCombineVectorElementCopies();
     void testLoopInvariantCodeMotion();
+    void testMinimizeMutexSections();
 
 private:
     void testMethodsEquals(vc4c::Method& m1, vc4c::Method& m2);
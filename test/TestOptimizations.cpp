@@ -9,6 +9,7 @@
 #include "InstructionWalker.h"
 #include "Method.h"
 #include "Module.h"
+#include "EmulationRunner.h"
 #include "Profiler.h"
 #include "emulation_helper.h"
 #include "intermediate/IntermediateInstruction.h"
@@ -34,9 +35,12 @@ TestOptimizations::TestOptimizations(const vc4c::Configuration& config) : TestEm
     TEST_ADD_WITH_STRING(TestOptimizations::testFibonacci, "");
     TEST_ADD_WITH_STRING(TestOptimizations::testStruct, "");
     TEST_ADD_WITH_STRING(TestOptimizations::testCopy, "");
+    TEST_ADD_WITH_STRING(TestOptimizations::testTileRows, "");
+    TEST_ADD_WITH_STRING(TestOptimizations::testLoopDMA, "");
     TEST_ADD_WITH_STRING(TestOptimizations::testAtomics, "");
     TEST_ADD_WITH_STRING(TestOptimizations::testF2I, "");
     TEST_ADD_WITH_STRING(TestOptimizations::testGlobalData, "");
+    TEST_ADD_WITH_STRING(TestOptimizations::testConstantData, "");
     TEST_ADD_WITH_STRING(TestOptimizations::testSelect, "");
     TEST_ADD_WITH_STRING(TestOptimizations::testDot3Local, "");
     TEST_ADD_WITH_STRING(TestOptimizations::testVectorAdd, "");
@@ -70,9 +74,12 @@ TestOptimizations::TestOptimizations(const vc4c::Configuration& config) : TestEm
         TEST_ADD_WITH_STRING(TestOptimizations::testFibonacci, pass.parameterName);
         TEST_ADD_WITH_STRING(TestOptimizations::testStruct, pass.parameterName);
         TEST_ADD_WITH_STRING(TestOptimizations::testCopy, pass.parameterName);
+        TEST_ADD_WITH_STRING(TestOptimizations::testTileRows, pass.parameterName);
+        TEST_ADD_WITH_STRING(TestOptimizations::testLoopDMA, pass.parameterName);
         TEST_ADD_WITH_STRING(TestOptimizations::testAtomics, pass.parameterName);
         TEST_ADD_WITH_STRING(TestOptimizations::testF2I, pass.parameterName);
         TEST_ADD_WITH_STRING(TestOptimizations::testGlobalData, pass.parameterName);
+        TEST_ADD_WITH_STRING(TestOptimizations::testConstantData, pass.parameterName);
         TEST_ADD_WITH_STRING(TestOptimizations::testSelect, pass.parameterName);
         TEST_ADD_WITH_STRING(TestOptimizations::testDot3Local, pass.parameterName);
         TEST_ADD_WITH_STRING(TestOptimizations::testVectorAdd, pass.parameterName);
@@ -91,8 +98,11 @@ TestOptimizations::TestOptimizations(const vc4c::Configuration& config) : TestEm
         TEST_ADD_WITH_STRING(TestOptimizations::testVectorizations, pass.parameterName);
         TEST_ADD_WITH_STRING(TestOptimizations::testStructTypeHandling, pass.parameterName);
         TEST_ADD_WITH_STRING(TestOptimizations::testVstoreAlias, pass.parameterName);
-        counterNames.emplace(pass.name);
+        if(pass)
+            // passes without an own function (e.g. only enabling behavior in the normalization) have no counter
+            counterNames.emplace(pass.name);
     }
+    TEST_ADD(TestOptimizations::testIfConversionCycles);
     TEST_ADD(TestOptimizations::checkTestQuality);
     TEST_ADD(TestOptimizations::printProfilingInfo);
 }
@@ -170,6 +180,61 @@ void TestOptimizations::testBranches(std::string passParamName)
     config.optimizationLevel = OptimizationLevel::NONE;
 
     TestEmulator::runTestData("branches", false);
+    // if-else and if without else with arms simple enough to be executed conditionally
+    TestEmulator::runTestData("conditional_diamond", false);
+    TestEmulator::runTestData("conditional_triangle", false);
+}
+
+/*
+ * Returns the number of cycles spent by all QPUs (executed instructions and stalls) and the number of taken branches
+ */
+static std::pair<uint64_t, uint64_t> countCyclesAndBranches(const EmulationResult& result)
+{
+    uint64_t numCycles = 0;
+    uint64_t numBranches = 0;
+    for(const auto& instrumentation : result.instrumentation)
+    {
+        numCycles += instrumentation.numExecutions + instrumentation.numStalls;
+        numBranches += instrumentation.numBranchTaken;
+    }
+    return std::make_pair(numCycles, numBranches);
+}
+
+void TestOptimizations::testIfConversionCycles()
+{
+    config.optimizationLevel = OptimizationLevel::NONE;
+    auto test = test_data::getTest("conditional_diamond");
+    std::pair<uint64_t, uint64_t> branchCosts{};
+    std::pair<uint64_t, uint64_t> conditionalCosts{};
+    auto numConverted = profiler::getCounterValue("Branches converted to conditional execution");
+    for(bool convert : {false, true})
+    {
+        config.additionalEnabledOptimizations.clear();
+        if(convert)
+            config.additionalEnabledOptimizations.emplace("if-conversion");
+        // separate caches, since the cached binaries do not depend on the configuration
+        FastMap<std::string, CompilationData> cache{};
+        EmulationRunner runner(config, cache);
+        auto result = test_data::execute(test, runner);
+        TEST_ASSERT(result.wasSuccess)
+        if(!result.error.empty())
+            TEST_ASSERT_EQUALS("(no error)", result.error);
+        auto emulationResult = runner.getResult();
+        TEST_ASSERT(emulationResult != nullptr)
+        if(!emulationResult)
+            return;
+        (convert ? conditionalCosts : branchCosts) = countCyclesAndBranches(*emulationResult);
+    }
+
+    // the if-else inside the loop is executed conditionally, so only the loop branches remain...
+    TEST_ASSERT(conditionalCosts.second < branchCosts.second)
+    if(auto val = profiler::getCounterValue("Branches converted to conditional execution"))
+    {
+        // only if profiling is enabled
+        TEST_ASSERT(val > numConverted)
+    }
+    // ... which saves more cycles than executing both arms takes
+    TEST_ASSERT(conditionalCosts.first < branchCosts.first)
 }
 
 void TestOptimizations::testWorkItem(std::string passParamName)
@@ -222,6 +287,27 @@ void TestOptimizations::testCopy(std::string passParamName)
     TestEmulator::runTestData("copy_vector", false);
 }
 
+void TestOptimizations::testTileRows(std::string passParamName)
+{
+    config.additionalEnabledOptimizations = {std::move(passParamName), requiredOptimization};
+    config.optimizationLevel = OptimizationLevel::NONE;
+
+    FastMap<std::string, CompilationData> cache{};
+    // These trigger e.g. the coalescing of DMA row accesses
+    TestEmulator::runTestData("tile_rows_constant_pitch", cache);
+    TestEmulator::runTestData("tile_rows_dynamic_pitch", cache);
+}
+
+void TestOptimizations::testLoopDMA(std::string passParamName)
+{
+    config.additionalEnabledOptimizations = {std::move(passParamName), requiredOptimization};
+    config.optimizationLevel = OptimizationLevel::NONE;
+
+    TestEmulator::runTestData("loop_dma", false);
+    // This triggers the asynchronous DMA accesses, which are only applied for a single work-item per work-group
+    TestEmulator::runTestData("loop_dma_single", false);
+}
+
 void TestOptimizations::testAtomics(std::string passParamName)
 {
     config.additionalEnabledOptimizations = {std::move(passParamName), requiredOptimization};
@@ -246,6 +332,17 @@ void TestOptimizations::testGlobalData(std::string passParamName)
     TestEmulator::runTestData("global_data", false);
 }
 
+void TestOptimizations::testConstantData(std::string passParamName)
+{
+    config.additionalEnabledOptimizations = {std::move(passParamName), requiredOptimization};
+    config.optimizationLevel = OptimizationLevel::NONE;
+
+    FastMap<std::string, CompilationData> cache{};
+    // These trigger e.g. the preloading of constant data into VPM with the cache-memory pass
+    TestEmulator::runTestData("constant_load", cache);
+    TestEmulator::runTestData("constant_table_loop", cache);
+}
+
 void TestOptimizations::testSelect(std::string passParamName)
 {
     config.additionalEnabledOptimizations = {std::move(passParamName), requiredOptimization};
@@ -435,6 +532,10 @@ void TestOptimizations::testIntLocalStorage(std::string passParamName)
     config.optimizationLevel = OptimizationLevel::NONE;
 
     TestEmulator::runTestData("storage_local_int", false);
+    // Two local buffers sharing the same VPM rows in different barrier sections
+    TestEmulator::runTestData("local_storage_sections", false);
+    // Index read from one local buffer used as offset into another local buffer
+    TestEmulator::runTestData("local_dependent_index", false);
 }
 
 void TestOptimizations::testIntGlobalStorage(std::string passParamName)
@@ -473,6 +574,14 @@ void TestOptimizations::testVectorizations(std::string passParamName)
     TestEmulator::runTestData("vectorization17", cache);
     TestEmulator::runTestData("vectorization18", cache);
     TestEmulator::runTestData("vectorization19", cache);
+    TestEmulator::runTestData("vectorization20", cache);
+    TestEmulator::runTestData("vectorization20_divergent", cache);
+    TestEmulator::runTestData("vectorization21", cache);
+    TestEmulator::runTestData("vectorization22", cache);
+    TestEmulator::runTestData("vectorization23", cache);
+    TestEmulator::runTestData("vectorization24", cache);
+    TestEmulator::runTestData("vectorization25", cache);
+    TestEmulator::runTestData("vectorization26", cache);
 }
 
 void TestOptimizations::testStructTypeHandling(std::string passParamName)
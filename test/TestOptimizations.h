@@ -33,9 +33,12 @@ public:
     void testFibonacci(std::string passParamName);
     void testStruct(std::string passParamName);
     void testCopy(std::string passParamName);
+    void testTileRows(std::string passParamName);
+    void testLoopDMA(std::string passParamName);
     void testAtomics(std::string passParamName);
     void testF2I(std::string passParamName);
     void testGlobalData(std::string passParamName);
+    void testConstantData(std::string passParamName);
     void testSelect(std::string passParamName);
     void testDot3Local(std::string passParamName);
     void testVectorAdd(std::string passParamName);
@@ -58,6 +61,8 @@ public:
 
     void testVstoreAlias(std::string passParamName);
 
+    void testIfConversionCycles();
+
     void checkTestQuality();
 
 private:
@@ -13,6 +13,42 @@ __kernel void test_local_storage(__global int* in, __global int* out)
     out[gid] = loc[lid];
 }
 
+// The two local buffers are only accessed in disjoint barrier-delimited sections, so they can share the same VPM rows
+__kernel void test_local_storage_sections(__global int* in, __global int* out)
+{
+    size_t gid = get_global_id(0);
+    uchar lid = get_local_id(0);
+    uchar lsize = get_local_size(0);
+
+    __local int first[12];
+    __local int second[12];
+
+    first[lid] = in[gid] * 2;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    int tmp = first[lsize - 1 - lid] + 1;
+    // all reads of the first buffer need to be done before the second buffer (possibly the same rows) is written
+    barrier(CLK_LOCAL_MEM_FENCE);
+    second[lid] = tmp * 3;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    out[gid] = second[min(lid + 1, lsize - 1)];
+}
+
+// The index read from one local buffer is used as offset into the other local buffer
+__kernel void test_local_dependent_index(__global uint* in, __global uint* out)
+{
+    size_t gid = get_global_id(0);
+    uchar lid = get_local_id(0);
+
+    __local uint lidx[12];
+    __local uint ldata[12];
+
+    lidx[lid] = (lid * 5) % 12;
+    ldata[lid] = in[gid] * 3;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    uint j = lidx[lid];
+    out[gid] = ldata[j];
+}
+
 __kernel void test_private_storage(__global int* in, __global int* out)
 {
     size_t gid = get_global_id(0);
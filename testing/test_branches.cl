@@ -120,3 +120,46 @@ __kernel void test_long_switch(const __global long* in, __global long* out)
         out[gid] = val;
     }
 }
+
+// Both arms of the if-else read the values written by the respective other arm, so executing both arms conditionally
+// must keep the values of the arm not taken
+__kernel void test_conditional_diamond(const __global int* in, __global int* out)
+{
+    uint gid = get_global_id(0);
+    int a = in[gid];
+    int b = (int) gid;
+    for(int i = 0; i < 4; ++i)
+    {
+        if((a + i) & 1)
+        {
+            int tmp = a;
+            a = b + i;
+            b = tmp * 3;
+        }
+        else
+        {
+            int tmp = b;
+            b = a - i;
+            a = tmp ^ 5;
+        }
+    }
+    out[gid] = a * 1000 + b;
+}
+
+// The if without else reads and writes the values which are also used after the conditional block
+__kernel void test_conditional_triangle(const __global int* in, __global int* out)
+{
+    uint gid = get_global_id(0);
+    int a = in[gid];
+    int b = (int) gid;
+    for(int i = 0; i < 4; ++i)
+    {
+        if(a > b)
+        {
+            a = b * 3 + i;
+            b = a ^ 6;
+        }
+        b += 2;
+    }
+    out[gid] = a * 1000 + b;
+}
@@ -21,4 +21,17 @@ __kernel void test_constant_load(__global uint* out0, __global ushort* out1, __g
     out0[1] = int_constant[index + 1] + 42;
     out1[1] = short_constant[index + 1] + 42;
     out2[1] = char_constant[index + 1] + 42;
-}
\ No newline at end of file
+}
+
+// Small table which is read often enough (in a loop) to be preloaded into VPM
+__constant uint table_constant[32] = {3, 10, 17, 24, 31, 38, 45, 52, 59, 66, 73, 80, 87, 94, 101, 108, 115, 122, 129,
+    136, 143, 150, 157, 164, 171, 178, 185, 192, 199, 206, 213, 220};
+
+__kernel void test_constant_table(__global uint* out, __global const uint* in)
+{
+    uint gid = get_global_id(0);
+    uint sum = 0;
+    for(uint i = 0; i < in[gid]; ++i)
+        sum += table_constant[(gid + i * 5) % 32];
+    out[gid] = sum;
+}
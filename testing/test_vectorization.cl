@@ -196,3 +196,96 @@ kernel void test19(global int *A, global int *B) {
   }
   *B = sum;
 }
+
+__attribute__((reqd_work_group_size(16, 1, 1))) __kernel void test20(
+    const __global int* A, const __global int* B, __global int* C)
+{
+  size_t gid = get_global_id(0);
+  C[gid] = A[gid] * B[gid] + (int) gid;
+}
+
+__attribute__((reqd_work_group_size(8, 1, 1))) __kernel void test20_divergent(const __global int* A, __global int* B)
+{
+  //Expected: work-items cannot be merged, since the control flow diverges between the work-items of a work-group
+  size_t gid = get_global_id(0);
+  int val = A[gid];
+  if(get_local_id(0) < 3)
+  {
+    for(size_t i = 0; i < gid; ++i)
+      val += A[i];
+  }
+  B[gid] = val;
+}
+
+kernel void test21(const global int *A, global int *B) {
+  //Expected: should be able to be vectorized
+  //Attention: need to make sure only every third element is read and only every second element is written
+  for (int i = 0; i < 256; ++i) {
+    B[i * 2] = A[i * 3] + 1;
+  }
+}
+
+kernel void test22(const global int *A, const global int *table, global int *B) {
+  //Expected: should be able to be vectorized
+  //Attention: need to make sure every element reads the table entry selected by its own index
+  for (int i = 0; i < 256; ++i) {
+    B[i] = table[A[i] % 16] + i;
+  }
+}
+
+kernel void test23(const global int *A, global int *B) {
+  //Expected: should be able to be vectorized
+  //Attention: need to make sure all reductions are folded correctly, also with non-identity initial values
+  int minimum = 1000;
+  int maximum = 0;
+  int hash = 0x12345678;
+  int mask = 0;
+  for (int i = 0; i < 256; ++i) {
+    minimum = min(minimum, A[i]);
+    maximum = max(maximum, A[i]);
+    hash ^= A[i];
+    mask |= A[i];
+  }
+  B[0] = minimum;
+  B[1] = maximum;
+  B[2] = hash;
+  B[3] = mask;
+}
+
+kernel void test24(const global float4 *A, const global float4 *B, global float *C) {
+  //Expected: should be able to be vectorized
+  //Attention: need to make sure the vector accumulator is folded back into a float4 before the horizontal sum
+  float4 sum = (float4) (0.0f);
+  for (int i = 0; i < 64; ++i) {
+    sum += A[i] * B[i];
+  }
+  *C = sum.x + sum.y + sum.z + sum.w;
+}
+
+kernel void test25(const global int *A, global int *B) {
+  //Expected: should be able to be vectorized
+  //Attention: need to make sure every element holds the sum of all previous elements and iterations
+  int sum = 0;
+  for (int i = 0; i < 256; ++i) {
+    sum += A[i];
+    B[i] = sum;
+  }
+  B[256] = sum;
+}
+
+kernel void test26(const global int *A, global int *B, const int start) {
+  //Expected: should be able to be vectorized
+  //Attention: need to make sure the non-literal initial values are replicated into all elements
+  int maximum = A[256];
+  int mask = start;
+  int sum = start;
+  for (int i = 0; i < 256; ++i) {
+    maximum = max(maximum, A[i]);
+    mask |= A[i];
+    sum += A[i];
+    B[i] = sum;
+  }
+  B[256] = maximum;
+  B[257] = mask;
+  B[258] = sum;
+}
@@ -22,6 +22,11 @@
 #include <sstream>
 #include <type_traits>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 using namespace vc4c;
 using namespace vc4c::tools;
 
@@ -64,6 +69,15 @@ void printValue(uint32_t val, BufferType type)
     }
 }
 
+static void printBuffer(const uint32_t* begin, const uint32_t* end, BufferType type)
+{
+    std::for_each(begin, end, [type](uint32_t val) {
+        printValue(val, type);
+        std::cout << " ";
+    });
+    std::cout << "(" << (end - begin) << " entries)" << std::endl;
+}
+
 static std::vector<tools::Word> readBinaryFile(const std::string& fileName)
 {
     std::ifstream s(fileName);
@@ -78,6 +92,27 @@ static std::vector<tools::Word> readBinaryFile(const std::string& fileName)
     return res;
 }
 
+static HostBuffer mapFile(const std::string& fileName)
+{
+    HostBuffer buffer{nullptr, 0};
+    int fd = open(fileName.c_str(), O_RDWR);
+    if(fd < 0)
+        return buffer;
+    struct stat fileStats
+    {
+    };
+    if(fstat(fd, &fileStats) == 0 && fileStats.st_size > 0)
+    {
+        auto size = static_cast<std::size_t>(fileStats.st_size);
+        // shared mapping, so the results written by the kernel end up in the file
+        auto ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if(ptr != MAP_FAILED)
+            buffer = HostBuffer{static_cast<uint8_t*>(ptr), size};
+    }
+    close(fd);
+    return buffer;
+}
+
 static std::vector<tools::Word> readDirectData(const std::string& data)
 {
     std::vector<tools::Word> words;
@@ -165,11 +200,33 @@ static void printHelp()
     std::cout << "\t-i <dump-file>\t\tWrites the result of the instrumentation into the file specified" << std::endl;
     std::cout << "\t-o <number>\t\tSpecifies the given parameter index as output and prints it when finished"
               << std::endl;
+    std::cout << "\t-t, --translate\t\tTranslates the kernel code into host code for faster, but not cycle-accurate "
+                 "emulation"
+              << std::endl;
+    std::cout << "\t--snapshot <file> <cycles>\tPeriodically writes a snapshot of the emulation state into the "
+                 "given file at most every <cycles> cycles"
+              << std::endl;
+    std::cout << "\t--restore <file>\tResumes the emulation from the given snapshot" << std::endl;
+    std::cout << "\t--trace <file>\t\tStreams the binary execution trace into the given file, can be converted with "
+                 "qpu_trace_converter"
+              << std::endl;
+    std::cout << "\t--profile-map <file>\tUses the mapping of instructions to basic blocks and loops written by the "
+                 "compiler with --profile-map=<file>"
+              << std::endl;
+    std::cout << "\t--profile-report <file>\tWrites the hot-spots per basic block and loop into the given file, "
+                 "requires --profile-map"
+              << std::endl;
+    std::cout << "\t--folded-stacks <file>\tWrites the cycles per basic block in the folded stack format for flame "
+                 "graphs, requires --profile-map"
+              << std::endl;
     std::cout << "\t-h, --help\t\tPrint this help message" << std::endl;
     std::cout << "\t-q, --quiet\t\tQuiet all debug output" << std::endl;
     std::cout << "\t--verbose\t\tPrint verbose debug output" << std::endl;
     std::cout << "[args] specify the values for the input parameters and can take following values:" << std::endl;
     std::cout << "\t-f <file-name>\t\tRead <file-name> as binary file" << std::endl;
+    std::cout << "\t-mf <file-name>\t\tMap <file-name> into memory without copying, the kernel writes directly "
+                 "into the file"
+              << std::endl;
     std::cout << "\t-s <string>\t\tUse <string> as input string" << std::endl;
     std::cout << "\t-b <num>\t\tAllocate an empty buffer with <num> words of size" << std::endl;
     std::cout << "\t-ib <values>\t\tAllocate a buffer containing the given signed integer values. The values are "
@@ -256,6 +313,19 @@ int main(int argc, char** argv)
             data.parameter.emplace_back(0u, readBinaryFile(argv[i]));
             bufferTypes.push_back(BufferType::BINARY);
         }
+        else if(std::string("-mf") == argv[i])
+        {
+            ++i;
+            auto buffer = mapFile(argv[i]);
+            if(!buffer.data)
+            {
+                std::cerr << "Failed to map file: " << argv[i] << std::endl;
+                return 1;
+            }
+            data.hostBuffers.emplace(data.parameter.size(), buffer);
+            data.parameter.emplace_back(0u, Optional<std::vector<uint32_t>>{});
+            bufferTypes.push_back(BufferType::BINARY);
+        }
         else if(std::string("-s") == argv[i])
         {
             ++i;
@@ -292,6 +362,40 @@ int main(int argc, char** argv)
             ++i;
             outParam = std::atoi(argv[i]);
         }
+        else if(std::string("-t") == argv[i] || std::string("--translate") == argv[i])
+        {
+            data.translateCode = true;
+        }
+        else if(std::string("--snapshot") == argv[i])
+        {
+            data.snapshotFile = argv[++i];
+            data.snapshotInterval = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        }
+        else if(std::string("--restore") == argv[i])
+        {
+            ++i;
+            data.restoreSnapshot = argv[i];
+        }
+        else if(std::string("--trace") == argv[i])
+        {
+            ++i;
+            data.traceFile = argv[i];
+        }
+        else if(std::string("--profile-map") == argv[i])
+        {
+            ++i;
+            data.profileMapping = argv[i];
+        }
+        else if(std::string("--profile-report") == argv[i])
+        {
+            ++i;
+            data.profileReport = argv[i];
+        }
+        else if(std::string("--folded-stacks") == argv[i])
+        {
+            ++i;
+            data.profileFoldedStacks = argv[i];
+        }
         else if(std::string("-q") == argv[i] || std::string("--quiet") == argv[i])
         {
             setLogger(std::wcout, true, LogLevel::WARNING);
@@ -315,14 +419,17 @@ int main(int argc, char** argv)
     {
         std::cout << "Result (buffer " << outParam << "): ";
         const auto& out = result.results[static_cast<unsigned>(outParam)];
-        if(out.second)
+        auto hostBuffer = data.hostBuffers.find(static_cast<std::size_t>(outParam));
+        if(hostBuffer != data.hostBuffers.end())
         {
-            std::for_each(out.second->begin(), out.second->end(), [&bufferTypes, outParam](uint32_t val) {
-                printValue(val, bufferTypes[static_cast<unsigned>(outParam)]);
-                std::cout << " ";
-            });
-            std::cout << "(" << out.second->size() << " entries)" << std::endl;
+            // the kernel wrote directly into the mapped file, so the result only contains the buffer address
+            const auto* words = reinterpret_cast<const uint32_t*>(hostBuffer->second.data);
+            printBuffer(words, words + hostBuffer->second.size / sizeof(uint32_t),
+                bufferTypes[static_cast<unsigned>(outParam)]);
         }
+        else if(out.second)
+            printBuffer(out.second->data(), out.second->data() + out.second->size(),
+                bufferTypes[static_cast<unsigned>(outParam)]);
         else
         {
             printValue(out.first, bufferTypes[static_cast<unsigned>(outParam)]);
@@ -330,6 +437,9 @@ int main(int argc, char** argv)
         }
     }
 
+    for(const auto& buffer : data.hostBuffers)
+        munmap(buffer.second.data, buffer.second.size);
+
 #ifndef NDEBUG
     vc4c::profiler::dumpProfileResults(true);
 #endif
@@ -0,0 +1,53 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+
+#include "tools/Trace.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace vc4c;
+
+static void printHelp()
+{
+    std::cout << "Converts the binary execution trace written by the emulator into the Chrome trace event JSON format, "
+                 "which can be viewed e.g. in chrome://tracing or https://ui.perfetto.dev"
+              << std::endl;
+    std::cout << "Usage: qpu_trace_converter <trace-file> <json-file>" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    if(argc != 3)
+    {
+        printHelp();
+        return 1;
+    }
+
+    std::ifstream trace(argv[1], std::ios::in | std::ios::binary);
+    if(!trace)
+    {
+        std::cerr << "Failed to open trace file: " << argv[1] << std::endl;
+        return 2;
+    }
+    std::ofstream json(argv[2], std::ios::out | std::ios::trunc);
+    if(!json)
+    {
+        std::cerr << "Failed to open output file: " << argv[2] << std::endl;
+        return 2;
+    }
+
+    try
+    {
+        tools::convertTraceToJSON(trace, json);
+    }
+    catch(const std::exception& err)
+    {
+        std::cerr << "Failed to convert trace: " << err.what() << std::endl;
+        return 3;
+    }
+    return 0;
+}